@@ -103,6 +103,24 @@ send_data_chunk (echo_client_main_t * ecm, eclient_session_t * s)
 						s->thread_index,
 						SESSION_IO_EVT_TX);
 	}
+      else if (ecm->dgram_size)
+	{
+	  /* Queue several whole dgrams, only the first one adds an event */
+	  svm_fifo_t *f = s->data.tx_fifo;
+	  u32 n_bytes, n_sent = 0;
+
+	  while (n_sent < bytes_this_chunk)
+	    {
+	      n_bytes = clib_min (ecm->dgram_size, bytes_this_chunk - n_sent);
+	      if (svm_fifo_max_enqueue_prod (f)
+		  < sizeof (session_dgram_hdr_t) + n_bytes)
+		break;
+	      n_sent += app_send_dgram (&s->data,
+					test_data + test_buf_offset + n_sent,
+					n_bytes, 0);
+	    }
+	  rv = n_sent;
+	}
       else
 	rv = app_send_dgram (&s->data, test_data + test_buf_offset,
 			     bytes_this_chunk, 0);
@@ -797,6 +815,7 @@ echo_clients_command_fn (vlib_main_t * vm,
   ecm->vlib_main = vm;
   ecm->tls_engine = CRYPTO_ENGINE_OPENSSL;
   ecm->no_copy = 0;
+  ecm->dgram_size = 0;
   ecm->run_test = ECHO_CLIENTS_STARTING;
 
   if (thread_main->n_vlib_mains > 1)
@@ -860,6 +879,8 @@ echo_clients_command_fn (vlib_main_t * vm,
 	ecm->test_bytes = 1;
       else if (unformat (input, "tls-engine %d", &ecm->tls_engine))
 	;
+      else if (unformat (input, "dgram-size %u", &ecm->dgram_size))
+	;
       else
 	return clib_error_return (0, "failed: unknown input `%U'",
 				  format_unformat_error, input);
@@ -1040,7 +1061,7 @@ VLIB_CLI_COMMAND (echo_clients_command, static) =
       "[test-timeout <time>][syn-timeout <time>][no-return][fifo-size <size>]"
       "[private-segment-count <count>][private-segment-size <bytes>[m|g]]"
       "[preallocate-fifos][preallocate-sessions][client-batch <batch-size>]"
-      "[uri <tcp://ip/port>][test-bytes][no-output]",
+      "[uri <tcp://ip/port>][test-bytes][no-output][dgram-size <bytes>]",
   .function = echo_clients_command_fn,
   .is_mp_safe = 1,
 };
@@ -544,7 +544,8 @@ echo_server_create_command_fn (vlib_main_t * vm, unformat_input_t * input,
   if ((rv = parse_uri ((char *) esm->server_uri, &sep)))
     return clib_error_return (0, "Uri parse error: %d", rv);
   esm->transport_proto = sep.transport_proto;
-  esm->is_dgram = (sep.transport_proto == TRANSPORT_PROTO_UDP);
+  esm->is_dgram = (sep.transport_proto == TRANSPORT_PROTO_UDP
+		   || sep.transport_proto == TRANSPORT_PROTO_UDPC);
 
   rv = echo_server_create (vm, appns_id, appns_flags, appns_secret);
   vec_free (appns_id);
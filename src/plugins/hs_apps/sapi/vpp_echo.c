@@ -1333,6 +1333,7 @@ main (int argc, char **argv)
   /* *INDENT-ON* */
   cfg->consumer_pid = getpid ();
   cfg->n_rings = 1;
+  cfg->flags = 0;
   cfg->q_nitems = rpc_queue_size;
   cfg->ring_cfgs = rc;
   em->rpc_msq_queue = svm_msg_q_alloc (cfg);
@@ -76,6 +76,43 @@ typedef enum
   HTTP_BUILTIN_METHOD_POST,
 } http_builtin_method_type_t;
 
+/** \brief Content encodings served from precompressed files, in order
+    of preference: token, file extension
+ */
+#define foreach_http_static_encoding		\
+  _(BR, "br", "br")				\
+  _(GZIP, "gzip", "gz")
+
+typedef enum
+{
+#define _(sym, token, ext) HTTP_STATIC_ENCODING_##sym,
+  foreach_http_static_encoding
+#undef _
+    HTTP_STATIC_N_ENCODINGS,
+} http_static_encoding_t;
+
+/** \brief Parsed request, offsets are relative to the session rx buffer
+ */
+typedef struct
+{
+  /** GET or POST */
+  http_builtin_method_type_t method;
+  /** Request target, without the leading '/' */
+  u32 target_offset;
+  u32 target_length;
+  /** Length of the request headers, 0 until all of them are in */
+  u32 header_length;
+  /** Length of the request, headers and body included */
+  u32 length;
+  /** Connection should be kept open after the response */
+  u8 keep_alive;
+  /** Bitmap of http_static_encoding_t accepted by the client */
+  u8 accept_encodings;
+} http_static_request_t;
+
+/** Largest request header we are willing to buffer */
+#define HTTP_STATIC_MAX_REQUEST_HDR_SIZE (8 << 10)
+
 
 /** \brief Application session
  */
@@ -103,6 +140,12 @@ typedef struct
   u32 data_offset;
   /** Need to free data in detach_cache_entry */
   int free_data;
+  /** Keep the connection open after the current response */
+  u8 keep_alive;
+  /** Encoding of data, HTTP_STATIC_N_ENCODINGS if not encoded */
+  u8 encoding;
+  /** Encoded variants of the file exist, response varies by encoding */
+  u8 has_variants;
 
   /** File cache pool index */
   u32 cache_pool_index;
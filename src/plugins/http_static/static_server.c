@@ -289,7 +289,9 @@ static const char *http_response_template =
     "Date: %U GMT\r\n"
     "Expires: %U GMT\r\n"
     "Server: VPP Static\r\n"
+    "Connection: %s\r\n"
     "Content-Type: %s\r\n"
+    "%s"
     "Content-Length: %d\r\n\r\n";
 
 /* *INDENT-ON* */
@@ -368,8 +370,9 @@ session_rx_request (http_session_t * hs)
 
   cursize = vec_len (hs->rx_buf);
   max_dequeue = svm_fifo_max_dequeue (hs->rx_fifo);
+  /* Pipelined requests may already be buffered */
   if (PREDICT_FALSE (max_dequeue == 0))
-    return -1;
+    return cursize ? 0 : -1;
 
   vec_validate (hs->rx_buf, cursize + max_dequeue - 1);
   n_read = app_recv_stream_raw (hs->rx_fifo, hs->rx_buf + cursize,
@@ -567,25 +570,331 @@ void http_static_server_register_builtin_handler
     hsm->post_url_handlers = builtin_table;
 }
 
+/** \brief Check if a comma separated header value lists a token
+ */
+static int
+http_header_has_token (u8 * value, u32 len, char *token)
+{
+  u32 token_len = strlen (token), n;
+  u8 *end = value + len, *next, *q;
+
+  while (value < end)
+    {
+      while (value < end && (*value == ' ' || *value == '\t'))
+	value++;
+      next = memchr (value, ',', end - value);
+      if (!next)
+	next = end;
+      /* token, possibly followed by parameters, e.g., "gzip;q=0.8" */
+      n = next - value;
+      if (n >= token_len && !strncasecmp ((char *) value, token, token_len)
+	  && (n == token_len || value[token_len] == ';'
+	      || value[token_len] == ' '))
+	{
+	  /* A zero quality value means the token is not acceptable */
+	  q = value + token_len;
+	  while (q < next && (*q == ';' || *q == ' '))
+	    q++;
+	  if (next - q < 3 || (q[0] | 0x20) != 'q' || q[1] != '='
+	      || q[2] != '0')
+	    return 1;
+	  q += 3;
+	  if (q < next && *q == '.')
+	    q++;
+	  while (q < next && *q == '0')
+	    q++;
+	  return q < next && *q >= '1' && *q <= '9';
+	}
+      value = next + 1;
+    }
+  return 0;
+}
+
+#define HTTP_PARSE_INCOMPLETE 0
+#define HTTP_PARSE_OK 1
+#define HTTP_PARSE_BAD_REQUEST -1
+#define HTTP_PARSE_BAD_METHOD -2
+
+/** \brief Parse the first request in a buffer
+    Lines are found with memchr, which is vectorized by libc, instead of
+    walking the request a byte at a time. Only the headers the server
+    acts on are looked at.
+    @param buf - buffer, may hold several pipelined requests
+    @param len - number of bytes in the buffer
+    @param max_body - largest Content-Length accepted
+    @param req - parsed request
+    @return HTTP_PARSE_OK if a full request is available,
+    HTTP_PARSE_INCOMPLETE if more data is needed, < 0 on error
+*/
 static int
-v_find_index (u8 * vec, char *str)
+http_static_parse_request (u8 * buf, u32 len, u32 max_body,
+			   http_static_request_t * req)
 {
-  int start_index;
-  u32 slen = (u32) strnlen_s_inline (str, 8);
-  u32 vlen = vec_len (vec);
+  u8 *p = buf, *end = buf + len, *eol, *line_end, *target, *sp, *colon;
+  u8 *value;
+  u32 content_length = 0, n;
+  u8 have_content_length = 0;
+  u64 cl;
 
-  ASSERT (slen > 0);
+  req->header_length = 0;
 
-  if (vlen <= slen)
-    return -1;
+  /* Tolerate empty lines ahead of the request line, RFC7230 3.5 */
+  while (p < end && (*p == '\r' || *p == '\n'))
+    p++;
 
-  for (start_index = 0; start_index < (vlen - slen); start_index++)
+  eol = memchr (p, '\n', end - p);
+  if (!eol)
+    return HTTP_PARSE_INCOMPLETE;
+
+  if (eol - p > 4 && !memcmp (p, "GET ", 4))
+    {
+      req->method = HTTP_BUILTIN_METHOD_GET;
+      target = p + 4;
+    }
+  else if (eol - p > 5 && !memcmp (p, "POST ", 5))
     {
-      if (!memcmp (vec, str, slen))
-	return start_index;
+      req->method = HTTP_BUILTIN_METHOD_POST;
+      target = p + 5;
     }
+  else
+    return HTTP_PARSE_BAD_METHOD;
+
+  /* Browsers sporadically send more than one leading '/' */
+  while (target < eol && *target == '/')
+    target++;
+  sp = memchr (target, ' ', eol - target);
+  if (!sp)
+    return HTTP_PARSE_BAD_REQUEST;
+  req->target_offset = target - buf;
+  req->target_length = sp - target;
+
+  /* HTTP/1.1 connections are persistent unless told otherwise */
+  req->keep_alive = (eol - sp > 8 && !memcmp (sp + 1, "HTTP/1.1", 8));
+  req->accept_encodings = 0;
+
+  p = eol + 1;
+  while (1)
+    {
+      eol = memchr (p, '\n', end - p);
+      if (!eol)
+	return HTTP_PARSE_INCOMPLETE;
+      line_end = eol;
+      if (line_end > p && line_end[-1] == '\r')
+	line_end--;
+      /* Empty line, end of headers */
+      if (line_end == p)
+	break;
 
-  return -1;
+      colon = memchr (p, ':', line_end - p);
+      if (!colon)
+	return HTTP_PARSE_BAD_REQUEST;
+      value = colon + 1;
+      n = colon - p;
+
+      if (n == 10 && !strncasecmp ((char *) p, "connection", 10))
+	{
+	  if (http_header_has_token (value, line_end - value, "close"))
+	    req->keep_alive = 0;
+	  else if (http_header_has_token (value, line_end - value,
+					  "keep-alive"))
+	    req->keep_alive = 1;
+	}
+      else if (n == 15 && !strncasecmp ((char *) p, "accept-encoding", 15))
+	{
+#define _(sym, token, ext)						\
+	  if (http_header_has_token (value, line_end - value, token))	\
+	    req->accept_encodings |= 1 << HTTP_STATIC_ENCODING_##sym;
+	  foreach_http_static_encoding
+#undef _
+	}
+      else if (n == 14 && !strncasecmp ((char *) p, "content-length", 14))
+	{
+	  while (value < line_end && (*value == ' ' || *value == '\t'))
+	    value++;
+	  if (value == line_end || *value < '0' || *value > '9')
+	    return HTTP_PARSE_BAD_REQUEST;
+	  cl = 0;
+	  while (value < line_end && *value >= '0' && *value <= '9')
+	    {
+	      cl = cl * 10 + (*value++ - '0');
+	      /* Too large for us, and stops the overflow */
+	      if (cl > max_body)
+		return HTTP_PARSE_BAD_REQUEST;
+	    }
+	  while (value < line_end && (*value == ' ' || *value == '\t'))
+	    value++;
+	  if (value != line_end)
+	    return HTTP_PARSE_BAD_REQUEST;
+	  /* Repeated headers must agree, RFC7230 3.3.2 */
+	  if (have_content_length && cl != content_length)
+	    return HTTP_PARSE_BAD_REQUEST;
+	  content_length = cl;
+	  have_content_length = 1;
+	}
+      p = eol + 1;
+    }
+  p = eol + 1;
+  req->header_length = p - buf;
+
+  if (end - p < content_length)
+    return HTTP_PARSE_INCOMPLETE;
+
+  req->length = (p - buf) + content_length;
+  return HTTP_PARSE_OK;
+}
+
+/** \brief Pick the file to serve, a precompressed variant if the client
+    accepts one and it exists
+    @param path - c-string path of the requested file
+    @param accept_encodings - bitmap of encodings accepted by the client
+    @param encoding - encoding of the returned file
+    @param has_variants - set if any encoded variant of the file exists
+    @return path of the file to read, path itself if not encoded
+*/
+static u8 *
+http_static_server_select_variant (u8 * path, u8 accept_encodings,
+				   u8 * encoding, u8 * has_variants)
+{
+  static char *exts[] = {
+#define _(sym, token, ext) ext,
+    foreach_http_static_encoding
+#undef _
+  };
+  struct stat _sb, *sb = &_sb;
+  u8 *variant, *selected = path;
+  int i;
+
+  *encoding = HTTP_STATIC_N_ENCODINGS;
+  *has_variants = 0;
+  /* Variants the client does not accept are looked for too, caches must
+   * be told the response depends on Accept-Encoding */
+  for (i = 0; i < HTTP_STATIC_N_ENCODINGS; i++)
+    {
+      variant = format (0, "%s.%s%c", path, exts[i], 0);
+      if (stat ((char *) variant, sb) == 0
+	  && (sb->st_mode & S_IFMT) == S_IFREG)
+	{
+	  *has_variants = 1;
+	  if (selected == path && (accept_encodings & (1 << i)))
+	    {
+	      *encoding = i;
+	      selected = variant;
+	      continue;
+	    }
+	}
+      vec_free (variant);
+    }
+  return selected;
+}
+
+/** \brief Find file data in the cache, or read it and add it
+    @param hs - http session, data and cache_pool_index are set on success
+    @param file_path - c-string path of the file to read
+    @return 0 on success, -1 if the file could not be read
+*/
+static int
+http_static_server_cache_lookup (http_session_t * hs, u8 * file_path)
+{
+  http_static_server_main_t *hsm = &http_static_server_main;
+  BVT (clib_bihash_kv) kv;
+  file_data_cache_t *dp;
+  clib_error_t *error;
+
+  /* First, try the cache */
+  kv.key = (u64) file_path;
+  if (BV (clib_bihash_search) (&hsm->name_to_data, &kv, &kv) == 0)
+    {
+      if (hsm->debug_level > 1)
+	clib_warning ("lookup '%s' returned %lld", kv.key, kv.value);
+
+      /* found the data.. */
+      dp = pool_elt_at_index (hsm->cache_pool, kv.value);
+      hs->data = dp->data;
+      /* Update the cache entry, mark it in-use */
+      lru_update (hsm, dp, vlib_time_now (hsm->vlib_main));
+      hs->cache_pool_index = dp - hsm->cache_pool;
+      dp->inuse++;
+      if (hsm->debug_level > 1)
+	clib_warning ("index %d refcnt now %d", hs->cache_pool_index,
+		      dp->inuse);
+      return 0;
+    }
+
+  if (hsm->debug_level > 1)
+    clib_warning ("lookup '%s' failed", kv.key, kv.value);
+  /* Need to recycle one (or more cache) entries? */
+  if (hsm->cache_size > hsm->cache_limit)
+    {
+      int free_index = hsm->last_index;
+
+      while (free_index != ~0)
+	{
+	  /* pick the LRU */
+	  dp = pool_elt_at_index (hsm->cache_pool, free_index);
+	  free_index = dp->prev_index;
+	  /* Which could be in use, by more than one session... */
+	  if (dp->inuse)
+	    {
+	      if (hsm->debug_level > 1)
+		clib_warning ("index %d in use refcnt %d",
+			      dp - hsm->cache_pool, dp->inuse);
+	      continue;
+	    }
+	  kv.key = (u64) (dp->filename);
+	  kv.value = ~0ULL;
+	  if (BV (clib_bihash_add_del) (&hsm->name_to_data, &kv,
+					0 /* is_add */ ) < 0)
+	    {
+	      clib_warning ("LRU delete '%s' FAILED!", dp->filename);
+	    }
+	  else if (hsm->debug_level > 1)
+	    clib_warning ("LRU delete '%s' ok", dp->filename);
+
+	  lru_remove (hsm, dp);
+	  hsm->cache_size -= vec_len (dp->data);
+	  hsm->cache_evictions++;
+	  vec_free (dp->filename);
+	  vec_free (dp->data);
+	  if (hsm->debug_level > 1)
+	    clib_warning ("pool put index %d", dp - hsm->cache_pool);
+	  pool_put (hsm->cache_pool, dp);
+	  if (hsm->cache_size < hsm->cache_limit)
+	    break;
+	}
+    }
+
+  /* Read the file */
+  error = clib_file_contents ((char *) file_path, &hs->data);
+  if (error)
+    {
+      clib_warning ("Error reading '%s'", file_path);
+      clib_error_report (error);
+      return -1;
+    }
+  /* Create a cache entry for it */
+  pool_get (hsm->cache_pool, dp);
+  memset (dp, 0, sizeof (*dp));
+  dp->filename = vec_dup (file_path);
+  dp->data = hs->data;
+  hs->cache_pool_index = dp - hsm->cache_pool;
+  dp->inuse++;
+  if (hsm->debug_level > 1)
+    clib_warning ("index %d refcnt now %d", hs->cache_pool_index,
+		  dp->inuse);
+  lru_add (hsm, dp, vlib_time_now (hsm->vlib_main));
+  kv.key = (u64) vec_dup (file_path);
+  kv.value = dp - hsm->cache_pool;
+  /* Add to the lookup table */
+  if (hsm->debug_level > 1)
+    clib_warning ("add '%s' value %lld", kv.key, kv.value);
+
+  if (BV (clib_bihash_add_del) (&hsm->name_to_data, &kv, 1 /* is_add */ ) <
+      0)
+    {
+      clib_warning ("BUG: add failed!");
+    }
+  hsm->cache_size += vec_len (dp->data);
+  return 0;
 }
 
 /** \brief established state - waiting for GET, POST, etc.
@@ -595,14 +904,12 @@ state_established (session_t * s, http_session_t * hs,
 		   http_state_machine_called_from_t cf)
 {
   http_static_server_main_t *hsm = &http_static_server_main;
-  u8 *request = 0;
-  u8 *path;
-  int i, rv;
+  http_static_request_t _req, *req = &_req;
+  u8 *request = 0, *target = 0, *path, *data_path;
   struct stat _sb, *sb = &_sb;
-  clib_error_t *error;
-  u8 request_type = HTTP_BUILTIN_METHOD_GET;
-  u8 save_byte = 0;
+  u8 request_type, *query;
   uword *p, *builtin_table;
+  int rv;
 
   /* Read data from the sessison layer */
   rv = session_rx_request (hs);
@@ -611,54 +918,48 @@ state_established (session_t * s, http_session_t * hs,
   if (rv)
     return 0;
 
-  /* Process the client request */
-  request = hs->rx_buf;
-  if (vec_len (request) < 8)
+  /* Process the client request, possibly the first of several pipelined.
+   * Bodies are bounded by what fits in the rx fifo */
+  rv = http_static_parse_request (hs->rx_buf, vec_len (hs->rx_buf),
+				  hs->rx_fifo->size, req);
+  if (rv == HTTP_PARSE_INCOMPLETE)
     {
-      send_error (hs, "400 Bad Request");
+      /* Wait for the rest of the headers, or of the body */
+      if (req->header_length
+	  || vec_len (hs->rx_buf) < HTTP_STATIC_MAX_REQUEST_HDR_SIZE)
+	return 0;
+      rv = HTTP_PARSE_BAD_REQUEST;
+    }
+  if (rv == HTTP_PARSE_BAD_METHOD)
+    {
+      if (hsm->debug_level > 1)
+	clib_warning ("Unknown http method");
+
+      send_error (hs, "405 Method Not Allowed");
       close_session (hs);
       return -1;
     }
-
-  if ((i = v_find_index (request, "GET ")) >= 0)
-    goto find_end;
-  else if ((i = v_find_index (request, "POST ")) >= 0)
+  if (rv < 0)
     {
-      request_type = HTTP_BUILTIN_METHOD_POST;
-      goto find_end;
+      send_error (hs, "400 Bad Request");
+      close_session (hs);
+      return -1;
     }
 
-  if (hsm->debug_level > 1)
-    clib_warning ("Unknown http method");
-
-  send_error (hs, "405 Method Not Allowed");
-  close_session (hs);
-  return -1;
+  request_type = req->method;
+  hs->keep_alive = req->keep_alive;
+  hs->encoding = HTTP_STATIC_N_ENCODINGS;
+  hs->has_variants = 0;
 
-find_end:
+  /* NULL terminated target, without the query, for lookup purposes */
+  vec_add (target, hs->rx_buf + req->target_offset, req->target_length);
+  query = memchr (target, '?', vec_len (target));
+  if (query)
+    _vec_len (target) = query - target;
+  vec_add1 (target, 0);
 
-  /* Lose "GET " or "POST " */
-  vec_delete (request, i + 5 + request_type, 0);
-
-  /* Temporarily drop in a NULL byte for lookup purposes */
-  for (i = 0; i < vec_len (request); i++)
-    {
-      if (request[i] == ' ' || request[i] == '?')
-	{
-	  save_byte = request[i];
-	  request[i] = 0;
-	  break;
-	}
-    }
-
-  /*
-   * Now we can construct the file to open
-   * Browsers are capable of sporadically including a leading '/'
-   */
-  if (request[0] == '/')
-    path = format (0, "%s%s%c", hsm->www_root, request, 0);
-  else
-    path = format (0, "%s/%s%c", hsm->www_root, request, 0);
+  /* Now we can construct the file to open */
+  path = format (0, "%s/%s%c", hsm->www_root, target, 0);
 
   if (hsm->debug_level > 0)
     clib_warning ("%s '%s'", (request_type) == HTTP_BUILTIN_METHOD_GET ?
@@ -668,36 +969,40 @@ find_end:
   builtin_table = (request_type == HTTP_BUILTIN_METHOD_GET) ?
     hsm->get_url_handlers : hsm->post_url_handlers;
 
-  p = hash_get_mem (builtin_table, request);
-
-  if (save_byte != 0)
-    request[i] = save_byte;
+  p = hash_get_mem (builtin_table, target);
 
   if (p)
     {
-      int rv;
       int (*fp) (http_builtin_method_type_t, u8 *, http_session_t *);
       fp = (void *) p[0];
       hs->path = path;
+      /* Handlers get the request from the target on, body included */
+      vec_add (request, hs->rx_buf + req->target_offset,
+	       req->length - req->target_offset);
+      vec_delete (hs->rx_buf, req->length, 0);
       rv = (*fp) (request_type, request, hs);
       if (rv)
 	{
 	  clib_warning ("builtin handler %llx hit on %s '%s' but failed!",
 			p[0], (request_type == HTTP_BUILTIN_METHOD_GET) ?
-			"GET" : "POST", request);
+			"GET" : "POST", target);
+	  vec_free (request);
+	  vec_free (target);
 	  send_error (hs, "404 Not Found");
 	  close_session (hs);
 	  return -1;
 	}
-      vec_reset_length (hs->rx_buf);
+      vec_free (request);
+      vec_free (target);
       goto send_ok;
     }
-  vec_reset_length (hs->rx_buf);
-  /* poison request, it's not valid anymore */
-  request = 0;
+  vec_free (target);
+  /* Request is consumed, what's left is the next pipelined request */
+  vec_delete (hs->rx_buf, req->length, 0);
   /* The static server itself doesn't do POSTs */
   if (request_type == HTTP_BUILTIN_METHOD_POST)
     {
+      vec_free (path);
       send_error (hs, "404 Not Found");
       close_session (hs);
       return -1;
@@ -783,107 +1088,22 @@ find_end:
   /* find or read the file if we haven't done so yet. */
   if (hs->data == 0)
     {
-      BVT (clib_bihash_kv) kv;
-      file_data_cache_t *dp;
-
       hs->path = path;
 
-      /* First, try the cache */
-      kv.key = (u64) hs->path;
-      if (BV (clib_bihash_search) (&hsm->name_to_data, &kv, &kv) == 0)
-	{
-	  if (hsm->debug_level > 1)
-	    clib_warning ("lookup '%s' returned %lld", kv.key, kv.value);
-
-	  /* found the data.. */
-	  dp = pool_elt_at_index (hsm->cache_pool, kv.value);
-	  hs->data = dp->data;
-	  /* Update the cache entry, mark it in-use */
-	  lru_update (hsm, dp, vlib_time_now (hsm->vlib_main));
-	  hs->cache_pool_index = dp - hsm->cache_pool;
-	  dp->inuse++;
-	  if (hsm->debug_level > 1)
-	    clib_warning ("index %d refcnt now %d", hs->cache_pool_index,
-			  dp->inuse);
-	}
-      else
+      /* Precompressed variants are cached under their own file names, so
+       * each is read once and shared by all sessions that accept it */
+      data_path = http_static_server_select_variant (path,
+						     req->accept_encodings,
+						     &hs->encoding,
+						     &hs->has_variants);
+      rv = http_static_server_cache_lookup (hs, data_path);
+      if (data_path != path)
+	vec_free (data_path);
+      if (rv)
 	{
-	  if (hsm->debug_level > 1)
-	    clib_warning ("lookup '%s' failed", kv.key, kv.value);
-	  /* Need to recycle one (or more cache) entries? */
-	  if (hsm->cache_size > hsm->cache_limit)
-	    {
-	      int free_index = hsm->last_index;
-
-	      while (free_index != ~0)
-		{
-		  /* pick the LRU */
-		  dp = pool_elt_at_index (hsm->cache_pool, free_index);
-		  free_index = dp->prev_index;
-		  /* Which could be in use... */
-		  if (dp->inuse)
-		    {
-		      if (hsm->debug_level > 1)
-			clib_warning ("index %d in use refcnt %d",
-				      dp - hsm->cache_pool, dp->inuse);
-
-		    }
-		  kv.key = (u64) (dp->filename);
-		  kv.value = ~0ULL;
-		  if (BV (clib_bihash_add_del) (&hsm->name_to_data, &kv,
-						0 /* is_add */ ) < 0)
-		    {
-		      clib_warning ("LRU delete '%s' FAILED!", dp->filename);
-		    }
-		  else if (hsm->debug_level > 1)
-		    clib_warning ("LRU delete '%s' ok", dp->filename);
-
-		  lru_remove (hsm, dp);
-		  hsm->cache_size -= vec_len (dp->data);
-		  hsm->cache_evictions++;
-		  vec_free (dp->filename);
-		  vec_free (dp->data);
-		  if (hsm->debug_level > 1)
-		    clib_warning ("pool put index %d", dp - hsm->cache_pool);
-		  pool_put (hsm->cache_pool, dp);
-		  if (hsm->cache_size < hsm->cache_limit)
-		    break;
-		}
-	    }
-
-	  /* Read the file */
-	  error = clib_file_contents ((char *) (hs->path), &hs->data);
-	  if (error)
-	    {
-	      clib_warning ("Error reading '%s'", hs->path);
-	      clib_error_report (error);
-	      vec_free (hs->path);
-	      close_session (hs);
-	      return -1;
-	    }
-	  /* Create a cache entry for it */
-	  pool_get (hsm->cache_pool, dp);
-	  memset (dp, 0, sizeof (*dp));
-	  dp->filename = vec_dup (hs->path);
-	  dp->data = hs->data;
-	  hs->cache_pool_index = dp - hsm->cache_pool;
-	  dp->inuse++;
-	  if (hsm->debug_level > 1)
-	    clib_warning ("index %d refcnt now %d", hs->cache_pool_index,
-			  dp->inuse);
-	  lru_add (hsm, dp, vlib_time_now (hsm->vlib_main));
-	  kv.key = (u64) vec_dup (hs->path);
-	  kv.value = dp - hsm->cache_pool;
-	  /* Add to the lookup table */
-	  if (hsm->debug_level > 1)
-	    clib_warning ("add '%s' value %lld", kv.key, kv.value);
-
-	  if (BV (clib_bihash_add_del) (&hsm->name_to_data, &kv,
-					1 /* is_add */ ) < 0)
-	    {
-	      clib_warning ("BUG: add failed!");
-	    }
-	  hsm->cache_size += vec_len (dp->data);
+	  vec_free (hs->path);
+	  close_session (hs);
+	  return -1;
 	}
       hs->data_offset = 0;
     }
@@ -917,7 +1137,15 @@ state_send_more_data (session_t * s, http_session_t * hs,
   /* Let go of the file cache entry */
   http_static_server_detach_cache_entry (hs);
   hs->session_state = HTTP_STATE_ESTABLISHED;
-  return 0;
+
+  if (!hs->keep_alive)
+    {
+      close_session (hs);
+      return -1;
+    }
+
+  /* Serve pipelined requests that arrived while we were sending */
+  return vec_len (hs->rx_buf) || svm_fifo_max_dequeue_cons (hs->rx_fifo);
 }
 
 static int
@@ -925,6 +1153,14 @@ state_sent_ok (session_t * s, http_session_t * hs,
 	       http_state_machine_called_from_t cf)
 {
   http_static_server_main_t *hsm = &http_static_server_main;
+  static char *encoding_hdrs[] = {
+#define _(sym, token, ext) "Content-Encoding: " token "\r\n"		\
+    "Vary: Accept-Encoding\r\n",
+    foreach_http_static_encoding
+#undef _
+    "",
+  };
+  char *encoding_hdr;
   char *suffix;
   char *http_type;
   u8 *http_response;
@@ -949,26 +1185,33 @@ state_sent_ok (session_t * s, http_session_t * hs,
       clib_warning ("BUG: hs->data not set for session %d",
 		    hs->session_index);
       close_session (hs);
-      return 0;
+      return -1;
     }
 
   /*
    * Send an http response, which needs the current time,
    * the expiration time, and the data length
    */
+  encoding_hdr = encoding_hdrs[hs->encoding];
+  /* Not encoded, but other clients get an encoded variant */
+  if (hs->encoding == HTTP_STATIC_N_ENCODINGS && hs->has_variants)
+    encoding_hdr = "Vary: Accept-Encoding\r\n";
   now = clib_timebase_now (&hsm->timebase);
   http_response = format (0, http_response_template,
 			  /* Date */
 			  format_clib_timebase_time, now,
 			  /* Expires */
 			  format_clib_timebase_time, now + 600.0,
-			  http_type, vec_len (hs->data));
+			  hs->keep_alive ? "keep-alive" : "close",
+			  http_type, encoding_hdr,
+			  vec_len (hs->data));
   offset = static_send_data (hs, http_response, vec_len (http_response), 0);
   if (offset != vec_len (http_response))
     {
       clib_warning ("BUG: couldn't send response header!");
+      vec_free (http_response);
       close_session (hs);
-      return 0;
+      return -1;
     }
   vec_free (http_response);
 
@@ -1731,6 +1974,155 @@ VLIB_CLI_COMMAND (clear_http_static_cache_command, static) =
 };
 /* *INDENT-ON* */
 
+#define HTTP_TEST(_cond, _comment, _args...)			\
+{								\
+    if (!(_cond)) {						\
+	vlib_cli_output (vm, "FAIL:%d: " _comment "\n",		\
+			 __LINE__, ##_args);			\
+	return -1;						\
+    }								\
+}
+
+static int
+http_static_parse_string (char *str, u32 max_body,
+			  http_static_request_t * req)
+{
+  return http_static_parse_request ((u8 *) str, strlen (str), max_body, req);
+}
+
+static int
+http_static_test_parser (vlib_main_t * vm)
+{
+  http_static_request_t _req, *req = &_req;
+  char *get = "GET /index.html HTTP/1.1\r\nHost: vpp\r\n\r\n";
+  char *pipelined = "GET /a.html HTTP/1.1\r\n\r\n"
+    "GET //b.html?x=1 HTTP/1.1\r\nConnection: close\r\n\r\n";
+  u8 *buf = 0;
+  int rv;
+
+  /* Complete request */
+  rv = http_static_parse_string (get, 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK), "get should parse, rv %d", rv);
+  HTTP_TEST ((req->method == HTTP_BUILTIN_METHOD_GET), "method get");
+  HTTP_TEST ((req->length == strlen (get)), "length %u", req->length);
+  HTTP_TEST ((req->header_length == strlen (get)), "header length %u",
+	     req->header_length);
+  HTTP_TEST ((req->target_length == 10
+	      && !memcmp (get + req->target_offset, "index.html", 10)),
+	     "target should be index.html");
+  HTTP_TEST ((req->keep_alive), "http/1.1 should be kept alive");
+
+  /* Pipelined requests are parsed one at a time */
+  rv = http_static_parse_string (pipelined, 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK), "first should parse, rv %d", rv);
+  HTTP_TEST ((req->length == 24), "first length %u", req->length);
+  HTTP_TEST ((req->keep_alive), "first should be kept alive");
+  rv = http_static_parse_string (pipelined + req->length, 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK), "second should parse, rv %d", rv);
+  HTTP_TEST ((req->target_length == 10
+	      && !memcmp (pipelined + 24 + req->target_offset, "b.html?x=1",
+			  10)), "second target should be b.html?x=1");
+  HTTP_TEST ((!req->keep_alive), "second asks for close");
+
+  /* Incomplete headers */
+  rv = http_static_parse_string ("GET /index.html HTTP/1.1\r\nHost:", 1024,
+				 req);
+  HTTP_TEST ((rv == HTTP_PARSE_INCOMPLETE && req->header_length == 0),
+	     "partial headers should be incomplete, rv %d", rv);
+
+  /* Body larger than the header limit, headers complete */
+  buf = format (0, "POST /form HTTP/1.1\r\nContent-Length: %u\r\n\r\n",
+		2 * HTTP_STATIC_MAX_REQUEST_HDR_SIZE);
+  vec_validate_init_empty (buf, 2 * HTTP_STATIC_MAX_REQUEST_HDR_SIZE, 'x');
+  rv = http_static_parse_request (buf, vec_len (buf), 64 << 10, req);
+  HTTP_TEST ((rv == HTTP_PARSE_INCOMPLETE && req->header_length != 0),
+	     "partial body should be incomplete, rv %d", rv);
+  vec_validate_init_empty (buf, req->header_length
+			   + 2 * HTTP_STATIC_MAX_REQUEST_HDR_SIZE - 1, 'x');
+  rv = http_static_parse_request (buf, vec_len (buf), 64 << 10, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK), "post should parse, rv %d", rv);
+  HTTP_TEST ((req->method == HTTP_BUILTIN_METHOD_POST), "method post");
+  HTTP_TEST ((req->length == vec_len (buf)), "post length %u", req->length);
+  vec_free (buf);
+
+  /* Content-Length checks */
+  rv = http_static_parse_string ("POST /f HTTP/1.1\r\n"
+				 "Content-Length: 4294967300\r\n\r\n",
+				 ~0, req);
+  HTTP_TEST ((rv == HTTP_PARSE_BAD_REQUEST), "overflow should fail");
+  rv = http_static_parse_string ("POST /f HTTP/1.1\r\n"
+				 "Content-Length: 1025\r\n\r\n", 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_BAD_REQUEST), "over max body should fail");
+  rv = http_static_parse_string ("POST /f HTTP/1.1\r\n"
+				 "Content-Length: 1x\r\n\r\n", 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_BAD_REQUEST), "garbage should fail");
+  rv = http_static_parse_string ("POST /f HTTP/1.1\r\n"
+				 "Content-Length: 2\r\n"
+				 "Content-Length: 2\r\n\r\nab", 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK), "equal duplicates should parse");
+  rv = http_static_parse_string ("POST /f HTTP/1.1\r\n"
+				 "Content-Length: 2\r\n"
+				 "Content-Length: 3\r\n\r\nabc", 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_BAD_REQUEST), "different duplicates "
+	     "should fail");
+
+  /* Methods, versions and encodings */
+  rv = http_static_parse_string ("PUT /f HTTP/1.1\r\n\r\n", 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_BAD_METHOD), "put should be refused");
+  rv = http_static_parse_string ("GET /f HTTP/1.0\r\n\r\n", 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK && !req->keep_alive),
+	     "http/1.0 should not be kept alive");
+  rv = http_static_parse_string ("GET /f HTTP/1.1\r\n"
+				 "Accept-Encoding: br, gzip;q=0\r\n\r\n",
+				 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK && req->accept_encodings
+	      == 1 << HTTP_STATIC_ENCODING_BR),
+	     "gzip with zero quality should not be accepted");
+  rv = http_static_parse_string ("GET /f HTTP/1.1\r\n"
+				 "accept-encoding: deflate, gzip\r\n\r\n",
+				 1024, req);
+  HTTP_TEST ((rv == HTTP_PARSE_OK && req->accept_encodings
+	      == 1 << HTTP_STATIC_ENCODING_GZIP), "gzip should be accepted");
+
+  vlib_cli_output (vm, "SUCCESS");
+  return 0;
+}
+
+static clib_error_t *
+http_static_test_command_fn (vlib_main_t * vm, unformat_input_t * input,
+			     vlib_cli_command_t * cmd)
+{
+  int rv = 0;
+
+  if (unformat (input, "parser"))
+    rv = http_static_test_parser (vm);
+  else
+    return clib_error_return (0, "unknown input `%U'", format_unformat_error,
+			      input);
+
+  if (rv)
+    return clib_error_return (0, "http static test failed");
+  return 0;
+}
+
+/*?
+ * Unit tests of the static http server
+ *
+ * @cliexpar
+ * @clistart
+ * test http static parser
+ * @cliend
+ * @cliexcmd{test http static parser}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (http_static_test_command, static) =
+{
+  .path = "test http static",
+  .short_help = "test http static [parser]",
+  .function = http_static_test_command_fn,
+};
+/* *INDENT-ON* */
+
 static clib_error_t *
 http_static_server_main_init (vlib_main_t * vm)
 {
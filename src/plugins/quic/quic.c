@@ -574,6 +574,7 @@ quic_send_datagram (session_t * udp_session, quicly_datagram_t * packet)
 {
   u32 max_enqueue;
   session_dgram_hdr_t hdr;
+  svm_fifo_seg_t segs[2];
   u32 len, ret;
   svm_fifo_t *f;
   transport_connection_t *tc;
@@ -612,16 +613,14 @@ quic_send_datagram (session_t * udp_session, quicly_datagram_t * packet)
       clib_memcpy (&hdr.rmt_ip.ip6, &sa6->sin6_addr, 16);
     }
 
-  ret = svm_fifo_enqueue (f, sizeof (hdr), (u8 *) & hdr);
-  if (ret != sizeof (hdr))
+  segs[0].data = (u8 *) & hdr;
+  segs[0].len = sizeof (hdr);
+  segs[1].data = packet->data.base;
+  segs[1].len = len;
+  ret = svm_fifo_enqueue_segments (f, segs, 2, 0 /* allow partial */ );
+  if (ret != sizeof (hdr) + len)
     {
-      QUIC_ERR ("Not enough space to enqueue header");
-      return QUIC_ERROR_FULL_FIFO;
-    }
-  ret = svm_fifo_enqueue (f, len, packet->data.base);
-  if (ret != len)
-    {
-      QUIC_ERR ("Not enough space to enqueue payload");
+      QUIC_ERR ("Not enough space to enqueue packet");
       return QUIC_ERROR_FULL_FIFO;
     }
 
@@ -45,6 +45,10 @@ typedef struct
   volatile u32 thread_barrier;
   volatile u32 threads_running;
   volatile u64 sequence_number;
+  volatile u32 writers_running;
+  volatile u32 n_lost;
+  u32 *n_added;
+  u32 first_thread_index;
   u64 seed;
   u32 nbuckets;
   u32 nitems;
@@ -241,6 +245,150 @@ test_bihash_threads (bihash_test_main_t * tm)
   return 0;
 }
 
+/*
+ * Resize under load: writers add their own keys, checking that one of
+ * the keys they added before is still there, readers look up keys the
+ * writers added, while the main thread keeps doubling the table.
+ */
+static void
+test_bihash_resize_check_key (bihash_test_main_t * tm, u32 thread, u32 j)
+{
+  BVT (clib_bihash_kv) kv;
+
+  kv.key = ((u64) thread << 32) | (u64) j;
+  if (BV (clib_bihash_search) (&tm->hash, &kv, &kv) || kv.value != j)
+    clib_atomic_fetch_add (&tm->n_lost, 1);
+}
+
+static void *
+test_bihash_resize_writer_fn (void *arg)
+{
+  bihash_test_main_t *tm = &bihash_test_main;
+  u32 my_thread_index = (uword) arg;
+  BVT (clib_bihash_kv) kv;
+  u32 seed = my_thread_index, j;
+
+  /* Working copies are per thread, use an index no vlib thread uses */
+  __os_thread_index = tm->first_thread_index + my_thread_index;
+  clib_mem_set_per_cpu_heap (tm->global_heap);
+
+  while (tm->thread_barrier)
+    ;
+
+  for (j = 0; j < tm->nitems; j++)
+    {
+      kv.key = ((u64) my_thread_index << 32) | (u64) j;
+      kv.value = j;
+      if (BV (clib_bihash_add_del) (&tm->hash, &kv, 1 /* is_add */ ))
+	clib_atomic_fetch_add (&tm->n_lost, 1);
+      clib_atomic_store_rel_n (&tm->n_added[my_thread_index], j + 1);
+
+      test_bihash_resize_check_key (tm, my_thread_index,
+				    random_u32 (&seed) % (j + 1));
+    }
+
+  (void) __atomic_sub_fetch (&tm->writers_running, 1, __ATOMIC_RELEASE);
+  (void) __atomic_sub_fetch (&tm->threads_running, 1, __ATOMIC_RELEASE);
+  pthread_exit (0);
+  return (0);
+}
+
+static void *
+test_bihash_resize_reader_fn (void *arg)
+{
+  bihash_test_main_t *tm = &bihash_test_main;
+  u32 seed = (uword) arg, thread, n;
+
+  while (tm->thread_barrier)
+    ;
+
+  while (clib_atomic_load_acq_n (&tm->writers_running))
+    {
+      thread = random_u32 (&seed) % tm->nthreads;
+      n = clib_atomic_load_acq_n (&tm->n_added[thread]);
+      if (n)
+	test_bihash_resize_check_key (tm, thread, random_u32 (&seed) % n);
+    }
+
+  (void) __atomic_sub_fetch (&tm->threads_running, 1, __ATOMIC_RELEASE);
+  pthread_exit (0);
+  return (0);
+}
+
+static clib_error_t *
+test_bihash_resize_threads (bihash_test_main_t * tm)
+{
+  BVT (clib_bihash_init2_args) _a, *a = &_a;
+  BVT (clib_bihash) * h = &tm->hash;
+  u32 start_nbuckets, end_nbuckets, i, j;
+  pthread_t handle;
+  int rv;
+
+  tm->first_thread_index = vlib_get_thread_main ()->n_vlib_mains;
+  if (tm->first_thread_index + tm->nthreads > CLIB_MAX_MHEAPS)
+    return clib_error_return (0, "too many threads");
+  tm->global_heap = clib_mem_get_per_cpu_heap ();
+
+  clib_memset (a, 0, sizeof (*a));
+  a->h = h;
+  a->name = "test";
+  a->nbuckets = tm->nbuckets;
+  a->memory_size = tm->hash_memory_size;
+  a->auto_grow = 1;
+  a->instantiate_immediately = 1;
+  BV (clib_bihash_init2) (a);
+  /* Grown from here, not by the resize process */
+  clib_bihash_resizable_del (h);
+  start_nbuckets = h->nbuckets;
+
+  vec_validate (tm->n_added, tm->nthreads - 1);
+  vec_zero (tm->n_added);
+  tm->n_lost = 0;
+  tm->writers_running = tm->nthreads;
+  tm->threads_running = 2 * tm->nthreads;
+  tm->thread_barrier = 1;
+
+  for (i = 0; i < 2 * tm->nthreads; i++)
+    {
+      rv = pthread_create (&handle, NULL, i < tm->nthreads ?
+			   test_bihash_resize_writer_fn :
+			   test_bihash_resize_reader_fn, (void *) (uword) i);
+      if (rv)
+	{
+	  clib_unix_warning ("pthread_create returned %d", rv);
+	  if (i < tm->nthreads)
+	    tm->writers_running--;
+	  tm->threads_running--;
+	}
+    }
+  CLIB_MEMORY_BARRIER ();
+  tm->thread_barrier = 0;
+
+  while (clib_atomic_load_acq_n (&tm->threads_running) > 0)
+    BV (clib_bihash_resize_work) (h, 16);
+  while (BV (clib_bihash_resize_work) (h, 1024))
+    ;
+
+  for (i = 0; i < tm->nthreads; i++)
+    for (j = 0; j < tm->n_added[i]; j++)
+      test_bihash_resize_check_key (tm, i, j);
+
+  end_nbuckets = h->nbuckets;
+  fformat (stdout, "%u writers, %u readers: %u to %u buckets, "
+	   "%u keys lost\n", tm->nthreads, tm->nthreads, start_nbuckets,
+	   end_nbuckets, tm->n_lost);
+
+  BV (clib_bihash_free) (h);
+
+  if (tm->n_lost)
+    return clib_error_return (0, "resize threads test failed: "
+			      "%u keys lost", tm->n_lost);
+  if (end_nbuckets == start_nbuckets)
+    return clib_error_return (0, "resize threads test failed: "
+			      "table did not grow");
+  return 0;
+}
+
 /*
  * Callback to blow up spectacularly if anything remains in the table
  */
@@ -502,6 +650,8 @@ test_bihash_command_fn (vlib_main_t * vm,
 	which = 1;
       else if (unformat (input, "threads %u", &tm->nthreads))
 	which = 2;
+      else if (unformat (input, "resize-threads %u", &tm->nthreads))
+	which = 3;
       else if (unformat (input, "verbose"))
 	tm->verbose = 1;
       else
@@ -528,6 +678,10 @@ test_bihash_command_fn (vlib_main_t * vm,
       error = test_bihash_threads (tm);
       break;
 
+    case 3:
+      error = test_bihash_resize_threads (tm);
+      break;
+
     default:
       return clib_error_return (0, "no such test?");
     }
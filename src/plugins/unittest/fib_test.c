@@ -40,6 +40,7 @@
 #include <vnet/fib/fib_walk.h>
 #include <vnet/fib/fib_node_list.h>
 #include <vnet/fib/fib_urpf_list.h>
+#include <vnet/fib/fib_internal.h>
 
 #include <vlib/unix/plugin.h>
 
@@ -2118,6 +2119,28 @@ fib_test_v4 (void)
              99);
     dpo_reset(&dpo_44);
 
+    /*
+     * a list with interfaces either side of the bitmap boundary
+     */
+    urpfi = fib_urpf_list_alloc_and_lock();
+    fib_urpf_list_append(urpfi, FIB_URPF_LIST_ITF_MASK_BITS + 6);
+    fib_urpf_list_append(urpfi, 3);
+    fib_urpf_list_append(urpfi, FIB_URPF_LIST_ITF_MASK_BITS - 1);
+    fib_urpf_list_append(urpfi, 3);
+    fib_urpf_list_bake(urpfi);
+
+    FIB_TEST(3 == fib_urpf_check_size(urpfi),
+             "uRPF list has 3 unique interfaces");
+    FIB_TEST((fib_urpf_check(urpfi, 3) &&
+              fib_urpf_check(urpfi, FIB_URPF_LIST_ITF_MASK_BITS - 1) &&
+              fib_urpf_check(urpfi, FIB_URPF_LIST_ITF_MASK_BITS + 6)),
+             "uRPF check OK for all listed interfaces");
+    FIB_TEST((!fib_urpf_check(urpfi, 2) &&
+              !fib_urpf_check(urpfi, FIB_URPF_LIST_ITF_MASK_BITS) &&
+              !fib_urpf_check(urpfi, FIB_URPF_LIST_ITF_MASK_BITS + 5)),
+             "uRPF check not-OK for unlisted interfaces");
+    fib_urpf_list_unlock(urpfi);
+
     fib_table_entry_delete(fib_index,
                            &bgp_44_s_32,
                            FIB_SOURCE_API);
@@ -3273,6 +3296,56 @@ fib_test_v4 (void)
              "LB maps's bucket 1 is %d",
              lbm->lbm_buckets[1]);
 
+    /*
+     * PIC core; an IGP change to a via-entry that does not change the
+     * interfaces through which it is reachable. The recursive entries
+     * stack on the via-entry's load-balance, which is modified in place,
+     * so none of them should be restacked.
+     */
+    fib_pic_stats_t pic_before = fib_pic_stats;
+
+    fib_table_entry_path_add(fib_index,
+                             &pfx_1_1_1_3_s_32,
+                             FIB_SOURCE_API,
+                             FIB_ENTRY_FLAG_NONE,
+                             DPO_PROTO_IP4,
+                             &nh_10_10_10_1,
+                             tm->hw[0]->sw_if_index,
+                             ~0, // invalid fib index
+                             1,
+                             NULL,
+                             FIB_ROUTE_PATH_FLAG_NONE);
+    vlib_process_suspend(vlib_get_main(), 1e-5);
+
+    FIB_TEST(!dpo_cmp(dpo1, load_balance_get_bucket(dpo->dpoi_index, 1)),
+             "PIC-core: 200.200.200.200/32 still via LB for 1.1.1.3");
+    FIB_TEST(fib_pic_stats.fps_n_walks_suppressed >
+             pic_before.fps_n_walks_suppressed,
+             "PIC-core: path-list walk suppressed");
+    FIB_TEST(fib_pic_stats.fps_n_walks_propagated ==
+             pic_before.fps_n_walks_propagated,
+             "PIC-core: no path-list walks propagated");
+    FIB_TEST(fib_pic_stats.fps_n_entry_restacks ==
+             pic_before.fps_n_entry_restacks,
+             "PIC-core: no recursive entries restacked %llu",
+             fib_pic_stats.fps_n_entry_restacks -
+             pic_before.fps_n_entry_restacks);
+
+    fib_table_entry_path_remove(fib_index,
+                                &pfx_1_1_1_3_s_32,
+                                FIB_SOURCE_API,
+                                DPO_PROTO_IP4,
+                                &nh_10_10_10_1,
+                                tm->hw[0]->sw_if_index,
+                                ~0, // invalid fib index
+                                1,
+                                FIB_ROUTE_PATH_FLAG_NONE);
+    vlib_process_suspend(vlib_get_main(), 1e-5);
+
+    FIB_TEST(fib_pic_stats.fps_n_entry_restacks ==
+             pic_before.fps_n_entry_restacks,
+             "PIC-core: no recursive entries restacked on revert");
+
     /*
      * withdraw one of the /32 via-entrys.
      * that ECMP path will be unresolved and forwarding should continue on the
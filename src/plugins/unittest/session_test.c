@@ -1206,6 +1206,30 @@ session_test_rules (vlib_main_t * vm, unformat_input_t * input)
   SESSION_TEST ((tc->c_index == listener->connection_index),
 		"lookup 1.2.3.4/32 123*5* 5.6.7.8/16 4321 should work");
 
+  /*
+   * Batched lookups should agree with the ones above
+   */
+  session_lookup_key4_t keys[2] = {
+    {.lcl = lcl_ip,.rmt = rmt_ip,.lcl_port = lcl_port,.rmt_port = rmt_port},
+    {.lcl = lcl_ip,.rmt = rmt_ip,.lcl_port = lcl_port + 1,
+     .rmt_port = rmt_port},
+  };
+  transport_connection_t *tcs[2];
+  u8 results[2];
+
+  session_lookup_connections_wt4 (keys, 2, TRANSPORT_PROTO_TCP, 0, tcs,
+				  results);
+  SESSION_TEST ((tcs[0] == 0), "batched lookup for 1.2.3.4/32 1234 "
+		"5.6.7.8/16 4321 should fail (deny rule)");
+  SESSION_TEST ((results[0] == SESSION_LOOKUP_RESULT_FILTERED),
+		"batched lookup should be filtered (deny)");
+  SESSION_TEST ((tcs[1] != 0
+		 && tcs[1]->c_index == listener->connection_index),
+		"batched lookup 1.2.3.4/32 123*5* 5.6.7.8/16 4321 should "
+		"work");
+  SESSION_TEST ((results[1] == SESSION_LOOKUP_RESULT_NONE),
+		"batched lookup should not be filtered");
+
   /*
    * "Mask" deny rule with more specific allow:
    * Add allow rule 1.2.3.4/32 1234 5.6.7.8/32 4321 action -3 (allow)
@@ -1871,6 +1895,190 @@ session_test_mq_speed (vlib_main_t * vm, unformat_input_t * input)
   return 0;
 }
 
+/*
+ * Drain the app message queue, counting per session rx events and the
+ * sessions listed by bulk rx messages.
+ */
+static void
+session_test_mq_rx_bulk_drain (svm_msg_q_t * mq, u32 * n_io, u32 * n_bulk,
+			       u32 ** listed)
+{
+  session_rx_bulk_msg_t *bm;
+  session_event_t *evt;
+  svm_msg_q_msg_t msg;
+  u32 i;
+
+  *n_io = *n_bulk = 0;
+  vec_reset_length (*listed);
+  svm_msg_q_lock (mq);
+  while (!svm_msg_q_is_empty (mq))
+    {
+      svm_msg_q_sub_w_lock (mq, &msg);
+      evt = svm_msg_q_msg_data (mq, &msg);
+      if (evt->event_type == SESSION_IO_EVT_RX
+	  && msg.ring_index == SESSION_MQ_IO_EVT_RING)
+	{
+	  *n_io += 1;
+	  vec_add1 (*listed, evt->session_index);
+	}
+      else if (evt->event_type == SESSION_IO_EVT_RX_BULK
+	       && msg.ring_index == SESSION_MQ_CTRL_EVT_RING)
+	{
+	  *n_bulk += 1;
+	  bm = (session_rx_bulk_msg_t *) evt->data;
+	  for (i = 0; i < bm->n_sessions; i++)
+	    vec_add1 (*listed, bm->session_indices[i]);
+	}
+      svm_msg_q_free_msg (mq, &msg);
+    }
+  svm_msg_q_unlock (mq);
+}
+
+static int
+session_test_mq_rx_bulk (vlib_main_t * vm, unformat_input_t * input)
+{
+  u32 i, n_io, n_bulk, n_sessions = 8, n_held, *listed = 0;
+  svm_msg_q_msg_t held[16];
+  u64 options[APP_OPTIONS_N_OPTIONS];
+  session_t *s, **sessions = 0;
+  int error, __clib_unused verbose;
+  svm_fifo_t *rx_fifo, *tx_fifo;
+  vl_api_registration_t *reg;
+  u32 app_index, api_index;
+  app_worker_t *app_wrk;
+  segment_manager_t *sm;
+  svm_msg_q_ring_t *ring;
+  application_t *app;
+  svm_msg_q_t *mq;
+  svm_queue_t *q;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  q = clib_mem_alloc (sizeof (*q));
+  api_index = vl_api_memclnt_create_internal ("session_rx_bulk_test_api", q);
+
+  clib_memset (options, 0, sizeof (options));
+  options[APP_OPTIONS_FLAGS] = APP_OPTIONS_FLAGS_USE_GLOBAL_SCOPE;
+  options[APP_OPTIONS_FLAGS] |= APP_OPTIONS_FLAGS_EVT_RX_BULK;
+  /* Smallest ctrl ring, 16 elements */
+  options[APP_OPTIONS_EVT_QUEUE_SIZE] = 256;
+
+  reg = vl_api_client_index_to_registration (api_index);
+  /* Shut up coverity */
+  if (reg == 0)
+    abort ();
+  if (!session_main.evt_qs_use_memfd_seg)
+    reg->clib_file_index = VL_API_INVALID_FI;
+
+  vnet_app_attach_args_t attach_args = {
+    .api_client_index = api_index,
+    .options = options,
+    .namespace_id = 0,
+    .session_cb_vft = &dummy_session_cbs,
+    .name = format (0, "session_rx_bulk_test"),
+  };
+  error = vnet_application_attach (&attach_args);
+  SESSION_TEST ((error == 0), "app attachment should work");
+
+  app_index = attach_args.app_index;
+  app = application_get (app_index);
+  app_wrk = application_get_worker (app, 0);
+  SESSION_TEST (app_wrk->app_rx_bulk, "app worker should use bulk rx");
+  mq = app_wrk->event_queue;
+  ring = svm_msg_q_ring (mq, SESSION_MQ_CTRL_EVT_RING);
+  SESSION_TEST (ring->nitems == ARRAY_LEN (held), "ctrl ring has %u "
+		"elements", ring->nitems);
+
+  sm = app_worker_get_or_alloc_connect_segment_manager (app_wrk);
+  for (i = 0; i < n_sessions; i++)
+    {
+      s = session_alloc (0);
+      segment_manager_alloc_session_fifos (sm, 0, &rx_fifo, &tx_fifo);
+      s->rx_fifo = rx_fifo;
+      s->tx_fifo = tx_fifo;
+      s->session_state = SESSION_STATE_READY;
+      rx_fifo->client_session_index = i;
+      vec_add1 (sessions, s);
+    }
+
+  /*
+   * All notifications of a dispatch fit in one bulk message
+   */
+  for (i = 0; i < n_sessions; i++)
+    app_worker_lock_and_send_event (app_wrk, sessions[i], SESSION_IO_EVT_RX);
+  SESSION_TEST (svm_msg_q_is_empty (mq), "nothing sent before the flush");
+  error = app_worker_flush_rx_evts (0);
+  SESSION_TEST (error == 0, "flush should work");
+
+  session_test_mq_rx_bulk_drain (mq, &n_io, &n_bulk, &listed);
+  SESSION_TEST (n_bulk == 1 && n_io == 0, "one bulk message, got %u bulk "
+		"%u io", n_bulk, n_io);
+  SESSION_TEST (vec_len (listed) == n_sessions, "%u sessions listed",
+		vec_len (listed));
+  for (i = 0; i < vec_len (listed); i++)
+    SESSION_TEST (listed[i] == i, "session %u listed as %u", i, listed[i]);
+
+  /*
+   * With half the ctrl ring in use, bulk messages are not sent and the
+   * sessions get per session events on the io ring instead
+   */
+  for (i = 0; i < n_sessions; i++)
+    svm_fifo_unset_event (sessions[i]->rx_fifo);
+
+  n_held = ring->nitems / 2;
+  svm_msg_q_lock (mq);
+  for (i = 0; i < n_held; i++)
+    held[i] = svm_msg_q_alloc_msg_w_ring (mq, SESSION_MQ_CTRL_EVT_RING);
+  svm_msg_q_unlock (mq);
+
+  for (i = 0; i < n_sessions; i++)
+    app_worker_lock_and_send_event (app_wrk, sessions[i], SESSION_IO_EVT_RX);
+  error = app_worker_flush_rx_evts (0);
+  SESSION_TEST (error == 0, "flush should fall back to io events");
+  SESSION_TEST (ring->cursize == n_held, "ctrl ring left alone, %u in use",
+		ring->cursize);
+  for (i = 0; i < n_sessions; i++)
+    SESSION_TEST (svm_fifo_has_event (sessions[i]->rx_fifo),
+		  "session %u should have an event", i);
+
+  session_test_mq_rx_bulk_drain (mq, &n_io, &n_bulk, &listed);
+  SESSION_TEST (n_bulk == 0 && n_io == n_sessions, "per session events, "
+		"got %u bulk %u io", n_bulk, n_io);
+  for (i = 0; i < vec_len (listed); i++)
+    SESSION_TEST (listed[i] == i, "event %u for session %u", i, listed[i]);
+
+  svm_msg_q_lock (mq);
+  for (i = 0; i < n_held; i++)
+    svm_msg_q_free_msg (mq, &held[i]);
+  svm_msg_q_unlock (mq);
+
+  for (i = 0; i < n_sessions; i++)
+    {
+      segment_manager_dealloc_fifos (sessions[i]->rx_fifo,
+				     sessions[i]->tx_fifo);
+      session_free (sessions[i]);
+    }
+  vec_free (sessions);
+  vec_free (listed);
+
+  vnet_app_detach_args_t detach_args = {
+    .app_index = app_index,
+    .api_client_index = ~0,
+  };
+  vnet_application_detach (&detach_args);
+  return 0;
+}
+
 static int
 session_test_mq_basic (vlib_main_t * vm, unformat_input_t * input)
 {
@@ -1898,6 +2106,7 @@ session_test_mq_basic (vlib_main_t * vm, unformat_input_t * input)
   };
   cfg->consumer_pid = ~0;
   cfg->n_rings = 2;
+  cfg->flags = 0;
   cfg->q_nitems = 16;
   cfg->ring_cfgs = rc;
 
@@ -1972,6 +2181,101 @@ session_test_mq_basic (vlib_main_t * vm, unformat_input_t * input)
   return 0;
 }
 
+static int
+session_test_mq_spsc (vlib_main_t * vm, unformat_input_t * input)
+{
+  svm_msg_q_msg_t msgs[24], out[24];
+  svm_msg_q_cfg_t _cfg, *cfg = &_cfg;
+  int __clib_unused verbose, i, fd, rv;
+  u32 n, round;
+  svm_msg_q_t *mq;
+  u64 buf;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  svm_msg_q_ring_cfg_t rc[1] = { {32, 8, 0} };
+  cfg->consumer_pid = ~0;
+  cfg->n_rings = 1;
+  cfg->flags = SVM_MSG_Q_F_SPSC;
+  cfg->q_nitems = 16;
+  cfg->ring_cfgs = rc;
+
+  mq = svm_msg_q_alloc (cfg);
+  SESSION_TEST (mq != 0, "svm_msg_q_alloc");
+  SESSION_TEST (svm_msg_q_is_spsc (mq), "queue is spsc");
+
+  /* Batches that wrap around the end of the queue */
+  for (round = 0; round < 5; round++)
+    {
+      svm_msg_q_lock (mq);
+      SESSION_TEST (svm_msg_q_free_slots (mq) == 16, "free slots %u",
+		    svm_msg_q_free_slots (mq));
+      for (i = 0; i < 11; i++)
+	{
+	  msgs[i] = svm_msg_q_alloc_msg_w_ring (mq, 0);
+	  *(u32 *) svm_msg_q_msg_data (mq, &msgs[i]) = round * 100 + i;
+	}
+      svm_msg_q_add_batch_and_unlock (mq, msgs, 11);
+      SESSION_TEST (svm_msg_q_size (mq) == 11, "batch enqueue");
+
+      n = svm_msg_q_sub_batch (mq, out, 4);
+      n += svm_msg_q_sub_batch (mq, out + n, 24);
+      SESSION_TEST (n == 11, "batch dequeue %u", n);
+      for (i = 0; i < n; i++)
+	{
+	  if (*(u32 *) svm_msg_q_msg_data (mq, &out[i]) != round * 100 + i)
+	    SESSION_TEST (0, "batch dequeue wrong data");
+	  svm_msg_q_free_msg (mq, &out[i]);
+	}
+      SESSION_TEST (svm_msg_q_is_empty (mq), "queue empty");
+    }
+
+  /* Single message apis use the lock-free path as well */
+  msgs[0] = svm_msg_q_alloc_msg (mq, 8);
+  rv = svm_msg_q_add (mq, &msgs[0], SVM_Q_NOWAIT);
+  SESSION_TEST (rv == 0, "add");
+  rv = svm_msg_q_sub (mq, &out[0], SVM_Q_NOWAIT, 0);
+  SESSION_TEST (rv == 0 && out[0].as_u64 == msgs[0].as_u64, "sub");
+  svm_msg_q_free_msg (mq, &out[0]);
+  rv = svm_msg_q_sub (mq, &out[0], SVM_Q_NOWAIT, 0);
+  SESSION_TEST (rv == -2, "sub from empty queue");
+
+  /* Eventfd is written only if the consumer may be sleeping */
+  svm_msg_q_alloc_producer_eventfd (mq);
+  fd = svm_msg_q_get_producer_eventfd (mq);
+  SESSION_TEST (fd != -1, "eventfd allocated");
+
+  svm_msg_q_consumer_wake (mq);
+  msgs[0] = svm_msg_q_alloc_msg (mq, 8);
+  svm_msg_q_add (mq, &msgs[0], SVM_Q_NOWAIT);
+  rv = read (fd, &buf, sizeof (buf));
+  SESSION_TEST (rv < 0, "no signal while consumer is busy");
+  SESSION_TEST (svm_msg_q_consumer_sleep (mq) == 1, "pending messages");
+  svm_msg_q_sub_batch (mq, out, 1);
+  svm_msg_q_free_msg (mq, &out[0]);
+
+  SESSION_TEST (svm_msg_q_consumer_sleep (mq) == 0, "consumer can sleep");
+  msgs[0] = svm_msg_q_alloc_msg (mq, 8);
+  svm_msg_q_add (mq, &msgs[0], SVM_Q_NOWAIT);
+  rv = read (fd, &buf, sizeof (buf));
+  SESSION_TEST (rv == sizeof (buf) && buf == 1, "sleeping consumer signaled");
+  svm_msg_q_sub_batch (mq, out, 1);
+  svm_msg_q_free_msg (mq, &out[0]);
+
+  close (fd);
+  return 0;
+}
+
 static clib_error_t *
 session_test (vlib_main_t * vm,
 	      unformat_input_t * input, vlib_cli_command_t * cmd_arg)
@@ -1996,8 +2300,12 @@ session_test (vlib_main_t * vm,
 	res = session_test_endpoint_cfg (vm, input);
       else if (unformat (input, "mq-speed"))
 	res = session_test_mq_speed (vm, input);
+      else if (unformat (input, "mq-rx-bulk"))
+	res = session_test_mq_rx_bulk (vm, input);
       else if (unformat (input, "mq-basic"))
 	res = session_test_mq_basic (vm, input);
+      else if (unformat (input, "mq-spsc"))
+	res = session_test_mq_spsc (vm, input);
       else if (unformat (input, "all"))
 	{
 	  if ((res = session_test_basic (vm, input)))
@@ -2014,8 +2322,12 @@ session_test (vlib_main_t * vm,
 	    goto done;
 	  if ((res = session_test_mq_speed (vm, input)))
 	    goto done;
+	  if ((res = session_test_mq_rx_bulk (vm, input)))
+	    goto done;
 	  if ((res = session_test_mq_basic (vm, input)))
 	    goto done;
+	  if ((res = session_test_mq_spsc (vm, input)))
+	    goto done;
 	}
       else
 	break;
@@ -1506,6 +1506,199 @@ cleanup:
   return 0;
 }
 
+static int
+sfifo_test_fifo_peek_segments (vlib_main_t * vm, unformat_input_t * input)
+{
+  int verbose = 0, fifo_size = 1000, i, j, rv, n_bytes, n_chunks = 4;
+  svm_fifo_seg_t segs[SVM_FIFO_CURSOR_N_SEGS];
+  u8 *test_data = 0, *data_buf = 0;
+  svm_fifo_chunk_t *c, *next;
+  u32 n_segs, offset, n_copied;
+  svm_fifo_cursor_t fc;
+  svm_fifo_t *f;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  f = fifo_prepare (fifo_size);
+  for (i = 0; i < n_chunks; i++)
+    {
+      c = clib_mem_alloc (sizeof (svm_fifo_chunk_t) + 100);
+      c->length = 100;
+      c->start_byte = ~0;
+      c->next = 0;
+      svm_fifo_add_chunk (f, c);
+    }
+  SFIFO_TEST (f->size == fifo_size + n_chunks * 100, "size expected %u is "
+	      "%u", fifo_size + n_chunks * 100, f->size);
+
+  /* Start close to the end so that data wraps over all chunks */
+  svm_fifo_init_pointers (f, f->size - 150, f->size - 150);
+
+  vec_validate (test_data, f->nitems - 1);
+  vec_validate (data_buf, f->nitems - 1);
+  for (i = 0; i < vec_len (test_data); i++)
+    test_data[i] = i;
+  svm_fifo_enqueue (f, vec_len (test_data), test_data);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == vec_len (test_data),
+	      "max deq expected %u is %u", vec_len (test_data),
+	      svm_fifo_max_dequeue (f));
+
+  /*
+   * Map at different offsets and check segments point to the data
+   */
+  for (offset = 0; offset < vec_len (test_data); offset += 73)
+    {
+      n_segs = ARRAY_LEN (segs);
+      n_bytes = svm_fifo_peek_segments (f, offset, segs, &n_segs, ~0);
+      SFIFO_TEST (n_bytes == vec_len (test_data) - offset,
+		  "offset %u mapped %d expected %u", offset, n_bytes,
+		  vec_len (test_data) - offset);
+      for (i = 0, j = offset; i < n_segs; i++)
+	{
+	  rv = memcmp (segs[i].data, test_data + j, segs[i].len);
+	  SFIFO_TEST (rv == 0, "offset %u seg %u data should match", offset,
+		      i);
+	  j += segs[i].len;
+	}
+      if (verbose)
+	vlib_cli_output (vm, "offset %u: %u bytes in %u segs", offset,
+			 n_bytes, n_segs);
+    }
+
+  /* Number of segments and bytes are capped */
+  n_segs = 2;
+  n_bytes = svm_fifo_peek_segments (f, 0, segs, &n_segs, ~0);
+  SFIFO_TEST (n_segs == 2 && n_bytes == segs[0].len + segs[1].len,
+	      "2 segs should be mapped, got %u with %d bytes", n_segs,
+	      n_bytes);
+  n_segs = ARRAY_LEN (segs);
+  n_bytes = svm_fifo_peek_segments (f, 10, segs, &n_segs, 20);
+  SFIFO_TEST (n_segs == 1 && n_bytes == 20, "20 bytes should be mapped, got"
+	      " %d in %u segs", n_bytes, n_segs);
+  n_segs = ARRAY_LEN (segs);
+  rv = svm_fifo_peek_segments (f, vec_len (test_data) + 1, segs, &n_segs,
+			       ~0);
+  SFIFO_TEST (rv == SVM_FIFO_EEMPTY, "peek past tail should fail");
+
+  /*
+   * Copy through a cursor in pieces that do not align with chunks
+   */
+  svm_fifo_cursor_init (&fc, f, 7);
+  for (i = 7; i < vec_len (test_data); i += n_copied)
+    {
+      n_copied = svm_fifo_cursor_copy (&fc, data_buf + i, 37);
+      if (!n_copied)
+	break;
+    }
+  SFIFO_TEST (i == vec_len (test_data), "copied %d expected %u", i,
+	      vec_len (test_data));
+  rv = compare_data (data_buf, test_data, 7, vec_len (test_data) - 7,
+		     (u32 *) & j);
+  SFIFO_TEST (rv == 0, "[%d] copied %u expected %u", j, data_buf[j],
+	      test_data[j]);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == vec_len (test_data),
+	      "cursor should not dequeue");
+
+  c = f->start_chunk->next;
+  while (c && c != f->start_chunk)
+    {
+      next = c->next;
+      clib_mem_free (c);
+      c = next;
+    }
+
+  svm_fifo_free (f);
+  vec_free (test_data);
+  vec_free (data_buf);
+  return 0;
+}
+
+static int
+sfifo_test_fifo_enqueue_segments (vlib_main_t * vm, unformat_input_t * input)
+{
+  int verbose = 0, fifo_size = 1000, i, rv, n_bytes;
+  u8 *test_data = 0, *data_buf = 0;
+  svm_fifo_seg_t segs[3];
+  svm_fifo_t *f;
+  u32 j;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  f = fifo_prepare (fifo_size);
+
+  /* Start close to the end so that data wraps */
+  svm_fifo_init_pointers (f, f->size - 50, f->size - 50);
+
+  vec_validate (test_data, 2 * fifo_size - 1);
+  vec_validate (data_buf, 2 * fifo_size - 1);
+  for (i = 0; i < vec_len (test_data); i++)
+    test_data[i] = i;
+
+  segs[0].data = test_data;
+  segs[0].len = 45;
+  segs[1].data = test_data + 45;
+  segs[1].len = 100;
+  segs[2].data = test_data + 145;
+  segs[2].len = 7;
+
+  n_bytes = svm_fifo_enqueue_segments (f, segs, 3, 0 /* allow partial */ );
+  SFIFO_TEST (n_bytes == 152, "enqueued %d expected 152", n_bytes);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == 152, "max deq expected 152 is %u",
+	      svm_fifo_max_dequeue (f));
+
+  /* All or nothing */
+  segs[0].data = test_data + 152;
+  segs[0].len = 500;
+  segs[1].data = test_data + 652;
+  segs[1].len = 500;
+  n_bytes = svm_fifo_enqueue_segments (f, segs, 2, 0 /* allow partial */ );
+  SFIFO_TEST (n_bytes == SVM_FIFO_EFULL, "enqueue should fail, got %d",
+	      n_bytes);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == 152, "max deq expected 152 is %u",
+	      svm_fifo_max_dequeue (f));
+
+  /* Partial enqueue fills the fifo */
+  n_bytes = svm_fifo_enqueue_segments (f, segs, 2, 1 /* allow partial */ );
+  SFIFO_TEST (n_bytes == fifo_size - 152, "enqueued %d expected %u",
+	      n_bytes, fifo_size - 152);
+  SFIFO_TEST (svm_fifo_max_enqueue (f) == 0, "fifo should be full");
+
+  n_bytes = svm_fifo_dequeue (f, fifo_size, data_buf);
+  SFIFO_TEST (n_bytes == fifo_size, "dequeued %d expected %u", n_bytes,
+	      fifo_size);
+  rv = compare_data (data_buf, test_data, 0, fifo_size, &j);
+  SFIFO_TEST (rv == 0, "[%d] dequeued %u expected %u", j, data_buf[j],
+	      test_data[j]);
+
+  if (verbose)
+    vlib_cli_output (vm, "enqueued and dequeued %u bytes", fifo_size);
+
+  svm_fifo_free (f);
+  vec_free (test_data);
+  vec_free (data_buf);
+  return 0;
+}
+
 static int
 chunk_list_len (svm_fifo_chunk_t * c)
 {
@@ -2722,6 +2915,10 @@ svm_fifo_test (vlib_main_t * vm, unformat_input_t * input,
 	res = sfifo_test_fifo_replay (vm, input);
       else if (unformat (input, "grow"))
 	res = sfifo_test_fifo_grow (vm, input);
+      else if (unformat (input, "peek-segments"))
+	res = sfifo_test_fifo_peek_segments (vm, input);
+      else if (unformat (input, "enqueue-segments"))
+	res = sfifo_test_fifo_enqueue_segments (vm, input);
       else if (unformat (input, "shrink"))
 	res = sfifo_test_fifo_shrink (vm, input);
       else if (unformat (input, "segment"))
@@ -2782,6 +2979,12 @@ svm_fifo_test (vlib_main_t * vm, unformat_input_t * input,
 	  if ((res = sfifo_test_fifo_grow (vm, input)))
 	    goto done;
 
+	  if ((res = sfifo_test_fifo_peek_segments (vm, input)))
+	    goto done;
+
+	  if ((res = sfifo_test_fifo_enqueue_segments (vm, input)))
+	    goto done;
+
 	  if ((res = sfifo_test_fifo_shrink (vm, input)))
 	    goto done;
 
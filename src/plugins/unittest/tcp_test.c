@@ -753,6 +753,151 @@ tcp_test_lookup (vlib_main_t * vm, unformat_input_t * input)
   return 0;
 }
 
+static int
+tcp_test_syn_cookies (vlib_main_t * vm, unformat_input_t * input)
+{
+  tcp_connection_t _tc, *tc = &_tc, _ack_tc, *ack_tc = &_ack_tc;
+  u32 cookie, now = 123456789, n_syn_rcvd;
+  tcp_worker_ctx_t *wrk;
+
+  /*
+   * Cookie for SYN with mss, wscale and sack permitted
+   */
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->c_lcl_ip4.as_u32 = clib_host_to_net_u32 (0x06000101);
+  tc->c_rmt_ip4.as_u32 = clib_host_to_net_u32 (0x06000103);
+  tc->c_lcl_port = 35051;
+  tc->c_rmt_port = 53764;
+  tc->c_is_ip4 = 1;
+  tc->irs = 1000;
+  tc->rcv_opts.flags = TCP_OPTS_FLAG_MSS | TCP_OPTS_FLAG_WSCALE
+    | TCP_OPTS_FLAG_SACK_PERMITTED;
+  tc->rcv_opts.mss = 1450;
+  tc->rcv_opts.wscale = 7;
+
+  cookie = tcp_syn_cookie_make (tc, now);
+
+  /* Connection built out of the ACK knows nothing about the options */
+  clib_memcpy_fast (ack_tc, tc, sizeof (*tc));
+  clib_memset (&ack_tc->rcv_opts, 0, sizeof (ack_tc->rcv_opts));
+
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) == 0),
+	    "cookie should be valid");
+  TCP_TEST ((ack_tc->rcv_opts.mss == 1440), "mss should be 1440 is %u",
+	    ack_tc->rcv_opts.mss);
+  TCP_TEST ((tcp_opts_wscale (&ack_tc->rcv_opts)
+	     && ack_tc->rcv_opts.wscale == 7), "wscale should be 7");
+  TCP_TEST ((tcp_opts_sack_permitted (&ack_tc->rcv_opts)),
+	    "sack should be permitted");
+  TCP_TEST ((!tcp_opts_tstamp (&ack_tc->rcv_opts)),
+	    "timestamps are not encoded");
+
+  /*
+   * Age and mismatches
+   */
+  clib_memset (&ack_tc->rcv_opts, 0, sizeof (ack_tc->rcv_opts));
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now + (2 << 16)) == 0),
+	    "cookie should be valid ~2 minutes later");
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now + (4 << 16)) != 0),
+	    "cookie should have expired");
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie + (1 << 12), now) != 0),
+	    "modified cookie should not be valid");
+  ack_tc->c_rmt_port += 1;
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) != 0),
+	    "cookie for other connection should not be valid");
+
+  /* Address and port bits must not cancel out */
+  clib_memcpy_fast (ack_tc, tc, sizeof (*tc));
+  ack_tc->c_rmt_ip4.as_u32 ^= 0x0101;
+  ack_tc->c_rmt_port ^= 0x0101;
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) != 0),
+	    "cookie for other address and port should not be valid");
+
+  /*
+   * Ip6 cookies are bound to the order of the addresses and halves
+   */
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->c_lcl_ip6.as_u64[0] = clib_host_to_net_u64 (0x20010db800000001);
+  tc->c_lcl_ip6.as_u64[1] = clib_host_to_net_u64 (0x1);
+  tc->c_rmt_ip6.as_u64[0] = clib_host_to_net_u64 (0x20010db800000002);
+  tc->c_rmt_ip6.as_u64[1] = clib_host_to_net_u64 (0x2);
+  tc->c_lcl_port = 35051;
+  tc->c_rmt_port = 53764;
+  tc->irs = 1000;
+  cookie = tcp_syn_cookie_make (tc, now);
+
+  clib_memcpy_fast (ack_tc, tc, sizeof (*tc));
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) == 0),
+	    "ip6 cookie should be valid");
+  ack_tc->c_lcl_ip6 = tc->c_rmt_ip6;
+  ack_tc->c_rmt_ip6 = tc->c_lcl_ip6;
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) != 0),
+	    "cookie for swapped addresses should not be valid");
+  clib_memcpy_fast (ack_tc, tc, sizeof (*tc));
+  ack_tc->c_lcl_ip6.as_u64[0] = tc->c_rmt_ip6.as_u64[0];
+  ack_tc->c_rmt_ip6.as_u64[0] = tc->c_lcl_ip6.as_u64[0];
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) != 0),
+	    "cookie for swapped address halves should not be valid");
+
+  /*
+   * SYN without options gets the minimum mss
+   */
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->c_lcl_ip4.as_u32 = clib_host_to_net_u32 (0x06000101);
+  tc->c_rmt_ip4.as_u32 = clib_host_to_net_u32 (0x06000103);
+  tc->c_lcl_port = 35051;
+  tc->c_rmt_port = 53764;
+  tc->c_is_ip4 = 1;
+  tc->irs = 1000;
+
+  cookie = tcp_syn_cookie_make (tc, now);
+  clib_memcpy_fast (ack_tc, tc, sizeof (*tc));
+  TCP_TEST ((tcp_syn_cookie_check (ack_tc, cookie, now) == 0),
+	    "cookie should be valid");
+  TCP_TEST ((ack_tc->rcv_opts.mss == 536), "mss should be 536 is %u",
+	    ack_tc->rcv_opts.mss);
+  TCP_TEST ((!tcp_opts_wscale (&ack_tc->rcv_opts)
+	     && !tcp_opts_sack_permitted (&ack_tc->rcv_opts)),
+	    "no wscale and sack");
+
+  /*
+   * Listen backlog accounting. Connections leave it when established,
+   * when the SYN_RCVD timer expires and when reset
+   */
+  wrk = tcp_get_worker (vm->thread_index);
+  n_syn_rcvd = wrk->n_syn_rcvd;
+
+  tc = tcp_connection_alloc (vm->thread_index);
+  tcp_connection_timers_init (tc);
+  tc->cc_algo = tcp_cc_algo_get (TCP_CC_NEWRENO);
+  tc->c_is_ip4 = 1;
+  tcp_connection_set_state (tc, TCP_STATE_SYN_RCVD);
+  TCP_TEST ((wrk->n_syn_rcvd == n_syn_rcvd + 1), "backlog should be %u is %u",
+	    n_syn_rcvd + 1, wrk->n_syn_rcvd);
+  tcp_connection_set_state (tc, TCP_STATE_SYN_RCVD);
+  TCP_TEST ((wrk->n_syn_rcvd == n_syn_rcvd + 1), "no change on same state");
+  tcp_connection_set_state (tc, TCP_STATE_ESTABLISHED);
+  TCP_TEST ((wrk->n_syn_rcvd == n_syn_rcvd), "established leaves backlog");
+
+  /* SYN_RCVD timer expires */
+  tcp_connection_set_state (tc, TCP_STATE_SYN_RCVD);
+  tcp_connection_set_state (tc, TCP_STATE_CLOSED);
+  TCP_TEST ((wrk->n_syn_rcvd == n_syn_rcvd), "timeout leaves backlog");
+  tcp_connection_cleanup (tc);
+  TCP_TEST ((wrk->n_syn_rcvd == n_syn_rcvd), "no change on cleanup");
+
+  /* Reset in SYN_RCVD */
+  tc = tcp_connection_alloc (vm->thread_index);
+  tcp_connection_timers_init (tc);
+  tc->cc_algo = tcp_cc_algo_get (TCP_CC_NEWRENO);
+  tc->c_is_ip4 = 1;
+  tcp_connection_set_state (tc, TCP_STATE_SYN_RCVD);
+  tcp_connection_cleanup (tc);
+  TCP_TEST ((wrk->n_syn_rcvd == n_syn_rcvd), "reset leaves backlog");
+
+  return 0;
+}
+
 static int
 tcp_test_session (vlib_main_t * vm, unformat_input_t * input)
 {
@@ -1170,6 +1315,10 @@ tcp_test (vlib_main_t * vm,
 	{
 	  res = tcp_test_delivery (vm, input);
 	}
+      else if (unformat (input, "syn-cookies"))
+	{
+	  res = tcp_test_syn_cookies (vm, input);
+	}
       else if (unformat (input, "all"))
 	{
 	  if ((res = tcp_test_sack (vm, input)))
@@ -1178,6 +1327,8 @@ tcp_test (vlib_main_t * vm,
 	    goto done;
 	  if ((res = tcp_test_delivery (vm, input)))
 	    goto done;
+	  if ((res = tcp_test_syn_cookies (vm, input)))
+	    goto done;
 	}
       else
 	break;
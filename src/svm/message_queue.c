@@ -16,6 +16,7 @@
 #include <svm/message_queue.h>
 #include <vppinfra/mem.h>
 #include <vppinfra/format.h>
+#include <vppinfra/time.h>
 #include <sys/eventfd.h>
 
 static inline svm_msg_q_ring_t *
@@ -70,6 +71,9 @@ svm_msg_q_alloc (svm_msg_q_cfg_t * cfg)
   mq->q = svm_queue_init (base + sizeof (svm_msg_q_t), cfg->q_nitems,
 			  sizeof (svm_msg_q_msg_t));
   mq->q->consumer_pid = cfg->consumer_pid;
+  mq->flags = cfg->flags;
+  mq->producer_lock = 0;
+  mq->consumer_sleeping = 1;
   vh = (vec_header_t *) ((u8 *) mq->q + q_sz);
   vh->len = cfg->n_rings;
   mq->rings = (svm_msg_q_ring_t *) (vh + 1);
@@ -206,18 +210,113 @@ svm_msq_q_msg_is_valid (svm_msg_q_t * mq, svm_msg_q_msg_t * msg)
   return (dist1 < dist2);
 }
 
+/**
+ * Add messages to a spsc queue
+ *
+ * Only the producer writes the tail and only the consumer the head, so
+ * the two sync only on the atomic update of the queue size. The eventfd
+ * is written only if the queue was empty and the consumer may be asleep.
+ */
+static void
+svm_msg_q_add_raw_spsc (svm_msg_q_t * mq, svm_msg_q_msg_t * msgs, u32 n_msgs)
+{
+  svm_msg_q_msg_t *data = (svm_msg_q_msg_t *) mq->q->data;
+  svm_queue_t *q = mq->q;
+  u32 n_first;
+
+  ASSERT (q->cursize + n_msgs <= q->maxsize);
+
+  n_first = clib_min (n_msgs, q->maxsize - q->tail);
+  clib_memcpy_fast (data + q->tail, msgs, n_first * sizeof (msgs[0]));
+  if (n_first < n_msgs)
+    clib_memcpy_fast (data, msgs + n_first,
+		      (n_msgs - n_first) * sizeof (msgs[0]));
+  q->tail = (q->tail + n_msgs) % q->maxsize;
+
+  /* Full barrier, orders the size update with the read of the flag. Pairs
+   * with the flag store and size load in svm_msg_q_consumer_sleep */
+  if (clib_atomic_fetch_add (&q->cursize, n_msgs) == 0
+      && clib_atomic_load_acq_n (&mq->consumer_sleeping)
+      && q->producer_evtfd != -1)
+    {
+      int __clib_unused rv;
+      u64 val = 1;
+      rv = write (q->producer_evtfd, &val, sizeof (val));
+    }
+}
+
+static u32
+svm_msg_q_sub_raw_spsc (svm_msg_q_t * mq, svm_msg_q_msg_t * msgs, u32 n_max)
+{
+  svm_msg_q_msg_t *data = (svm_msg_q_msg_t *) mq->q->data;
+  svm_queue_t *q = mq->q;
+  u32 n_msgs, n_first;
+
+  n_msgs = clib_min (clib_atomic_load_acq_n (&q->cursize), n_max);
+  if (!n_msgs)
+    return 0;
+
+  n_first = clib_min (n_msgs, q->maxsize - q->head);
+  clib_memcpy_fast (msgs, data + q->head, n_first * sizeof (msgs[0]));
+  if (n_first < n_msgs)
+    clib_memcpy_fast (msgs + n_first, data,
+		      (n_msgs - n_first) * sizeof (msgs[0]));
+  q->head = (q->head + n_msgs) % q->maxsize;
+
+  /* Return the slots to the producer only once they've been read */
+  clib_atomic_fetch_sub (&q->cursize, n_msgs);
+  return n_msgs;
+}
+
 int
 svm_msg_q_add (svm_msg_q_t * mq, svm_msg_q_msg_t * msg, int nowait)
 {
   ASSERT (svm_msq_q_msg_is_valid (mq, msg));
-  return svm_queue_add (mq->q, (u8 *) msg, nowait);
+
+  if (!svm_msg_q_is_spsc (mq))
+    return svm_queue_add (mq->q, (u8 *) msg, nowait);
+
+  if (nowait)
+    {
+      if (svm_msg_q_try_lock (mq))
+	return -1;
+      if (PREDICT_FALSE (svm_msg_q_is_full (mq)))
+	{
+	  svm_msg_q_unlock (mq);
+	  return -2;
+	}
+    }
+  else
+    {
+      svm_msg_q_lock (mq);
+      while (svm_msg_q_is_full (mq))
+	svm_msg_q_wait_spsc (mq);
+    }
+  svm_msg_q_add_raw_spsc (mq, msg, 1);
+  svm_msg_q_unlock (mq);
+  return 0;
 }
 
 void
 svm_msg_q_add_and_unlock (svm_msg_q_t * mq, svm_msg_q_msg_t * msg)
 {
   ASSERT (svm_msq_q_msg_is_valid (mq, msg));
-  svm_queue_add_raw (mq->q, (u8 *) msg);
+  if (svm_msg_q_is_spsc (mq))
+    svm_msg_q_add_raw_spsc (mq, msg, 1);
+  else
+    svm_queue_add_raw (mq->q, (u8 *) msg);
+  svm_msg_q_unlock (mq);
+}
+
+void
+svm_msg_q_add_batch_and_unlock (svm_msg_q_t * mq, svm_msg_q_msg_t * msgs,
+				u32 n_msgs)
+{
+  ASSERT (n_msgs <= svm_msg_q_free_slots (mq));
+  if (svm_msg_q_is_spsc (mq))
+    svm_msg_q_add_raw_spsc (mq, msgs, n_msgs);
+  else
+    svm_queue_add_raw_batch (mq->q, (u8 *) msgs, n_msgs);
   svm_msg_q_unlock (mq);
 }
 
@@ -225,15 +324,99 @@ int
 svm_msg_q_sub (svm_msg_q_t * mq, svm_msg_q_msg_t * msg,
 	       svm_q_conditional_wait_t cond, u32 time)
 {
-  return svm_queue_sub (mq->q, (u8 *) msg, cond, time);
+  f64 max_time;
+
+  if (!svm_msg_q_is_spsc (mq))
+    return svm_queue_sub (mq->q, (u8 *) msg, cond, time);
+
+  if (PREDICT_FALSE (svm_msg_q_is_empty (mq)))
+    {
+      if (cond == SVM_Q_NOWAIT)
+	return -2;
+      if (cond == SVM_Q_TIMEDWAIT)
+	{
+	  max_time = unix_time_now () + time;
+	  while (svm_msg_q_is_empty (mq) && unix_time_now () < max_time)
+	    CLIB_PAUSE ();
+	  if (svm_msg_q_is_empty (mq))
+	    return ETIMEDOUT;
+	}
+      else
+	{
+	  while (svm_msg_q_is_empty (mq))
+	    CLIB_PAUSE ();
+	}
+    }
+  svm_msg_q_sub_raw_spsc (mq, msg, 1);
+  return 0;
 }
 
 void
 svm_msg_q_sub_w_lock (svm_msg_q_t * mq, svm_msg_q_msg_t * msg)
 {
+  if (svm_msg_q_is_spsc (mq))
+    {
+      while (!svm_msg_q_sub_raw_spsc (mq, msg, 1))
+	CLIB_PAUSE ();
+      return;
+    }
   svm_queue_sub_raw (mq->q, (u8 *) msg);
 }
 
+u32
+svm_msg_q_sub_batch (svm_msg_q_t * mq, svm_msg_q_msg_t * msgs, u32 n_max)
+{
+  if (svm_msg_q_is_spsc (mq))
+    return svm_msg_q_sub_raw_spsc (mq, msgs, n_max);
+  return svm_queue_sub_raw_batch (mq->q, (u8 *) msgs, n_max);
+}
+
+void
+svm_msg_q_wait_spsc (svm_msg_q_t * mq)
+{
+  u32 cursize = mq->q->cursize;
+
+  /* Let producers in if the consumer holds the lock */
+  svm_msg_q_unlock (mq);
+  while (mq->q->cursize == cursize)
+    CLIB_PAUSE ();
+  svm_msg_q_lock (mq);
+}
+
+int
+svm_msg_q_timedwait_spsc (svm_msg_q_t * mq, double timeout)
+{
+  f64 max_time = unix_time_now () + timeout;
+  u32 cursize = mq->q->cursize;
+  int rv;
+
+  svm_msg_q_unlock (mq);
+  while (mq->q->cursize == cursize && unix_time_now () < max_time)
+    CLIB_PAUSE ();
+  rv = mq->q->cursize != cursize ? 0 : ETIMEDOUT;
+  svm_msg_q_lock (mq);
+  return rv;
+}
+
+int
+svm_msg_q_consumer_sleep (svm_msg_q_t * mq)
+{
+  if (svm_msg_q_is_spsc (mq))
+    {
+      /* Either the producer sees the flag, or we see its messages */
+      __atomic_store_n (&mq->consumer_sleeping, 1, __ATOMIC_SEQ_CST);
+      return __atomic_load_n (&mq->q->cursize, __ATOMIC_SEQ_CST) != 0;
+    }
+  return !svm_msg_q_is_empty (mq);
+}
+
+void
+svm_msg_q_consumer_wake (svm_msg_q_t * mq)
+{
+  if (svm_msg_q_is_spsc (mq))
+    clib_atomic_store_rel_n (&mq->consumer_sleeping, 0);
+}
+
 void
 svm_msg_q_set_consumer_eventfd (svm_msg_q_t * mq, int fd)
 {
@@ -270,7 +453,8 @@ u8 *
 format_svm_msg_q (u8 * s, va_list * args)
 {
   svm_msg_q_t *mq = va_arg (*args, svm_msg_q_t *);
-  s = format (s, " [Q:%d/%d]", mq->q->cursize, mq->q->maxsize);
+  s = format (s, " [Q:%d/%d%s]", mq->q->cursize, mq->q->maxsize,
+	      svm_msg_q_is_spsc (mq) ? " spsc" : "");
   for (u32 i = 0; i < vec_len (mq->rings); i++)
     {
       s = format (s, " [R%d:%d/%d]", i, mq->rings[i].cursize,
@@ -22,6 +22,7 @@
 
 #include <vppinfra/clib.h>
 #include <vppinfra/error.h>
+#include <vppinfra/lock.h>
 #include <svm/queue.h>
 
 typedef struct svm_msg_q_ring_
@@ -34,10 +35,18 @@ typedef struct svm_msg_q_ring_
   u8 *data;				/**< chunk of memory for msg data */
 } __clib_packed svm_msg_q_ring_t;
 
+typedef enum svm_msg_q_flags_
+{
+  SVM_MSG_Q_F_SPSC = 1 << 0,		/**< lock-free, single consumer */
+} svm_msg_q_flags_t;
+
 typedef struct svm_msg_q_
 {
   svm_queue_t *q;			/**< queue for exchanging messages */
   svm_msg_q_ring_t *rings;		/**< rings with message data*/
+  u32 flags;				/**< queue flags */
+  volatile u32 producer_lock;		/**< producer lock in spsc mode */
+  volatile u32 consumer_sleeping;	/**< consumer may block on eventfd */
 } __clib_packed svm_msg_q_t;
 
 typedef struct svm_msg_q_ring_cfg_
@@ -52,6 +61,7 @@ typedef struct svm_msg_q_cfg_
   int consumer_pid;			/**< pid of msg consumer */
   u32 q_nitems;				/**< msg queue size (not rings) */
   u32 n_rings;				/**< number of msg rings */
+  u32 flags;				/**< queue flags, e.g., spsc */
   svm_msg_q_ring_cfg_t *ring_cfgs;	/**< array of ring cfgs */
 } svm_msg_q_cfg_t;
 
@@ -73,6 +83,11 @@ typedef union
  * apart from the message queue this also allocates (one or multiple)
  * shared-memory rings for the messages.
  *
+ * With @ref SVM_MSG_Q_F_SPSC the queue is used without the mutex and
+ * condvar. The consumer never locks and producers, if more than one,
+ * serialize on a spinlock. Blocking waits spin, so consumers are expected
+ * to sleep on the eventfd, see @ref svm_msg_q_consumer_sleep.
+ *
  * @param cfg 		configuration options: queue len, consumer pid,
  * 			ring configs
  * @return		message queue
@@ -165,6 +180,20 @@ int svm_msg_q_add (svm_msg_q_t * mq, svm_msg_q_msg_t * msg, int nowait);
  */
 void svm_msg_q_add_and_unlock (svm_msg_q_t * mq, svm_msg_q_msg_t * msg);
 
+/**
+ * Producer enqueue multiple messages to queue with mutex held
+ *
+ * Messages are made visible to the consumer at once and the consumer is
+ * signaled at most once. The caller MUST check that the queue has room
+ * for all messages, see @ref svm_msg_q_free_slots.
+ *
+ * @param mq		message queue
+ * @param msgs		messages to be enqueued
+ * @param n_msgs	number of messages
+ */
+void svm_msg_q_add_batch_and_unlock (svm_msg_q_t * mq, svm_msg_q_msg_t * msgs,
+				     u32 n_msgs);
+
 /**
  * Consumer dequeue one message from queue
  *
@@ -195,6 +224,21 @@ int svm_msg_q_sub (svm_msg_q_t * mq, svm_msg_q_msg_t * msg,
  */
 void svm_msg_q_sub_w_lock (svm_msg_q_t * mq, svm_msg_q_msg_t * msg);
 
+/**
+ * Consumer dequeue multiple messages from queue
+ *
+ * Non-blocking. Must be called with mutex held, unless the queue is in
+ * spsc mode, in which case the consumer needs no lock. Messages must be
+ * freed, in order, with @ref svm_msg_q_free_msg.
+ *
+ * @param mq		message queue
+ * @param msgs		array where messages are to be received
+ * @param n_max		max number of messages to dequeue
+ * @return		number of messages dequeued
+ */
+u32 svm_msg_q_sub_batch (svm_msg_q_t * mq, svm_msg_q_msg_t * msgs,
+			 u32 n_max);
+
 /**
  * Get data for message in queue
  *
@@ -248,6 +292,33 @@ int svm_msg_q_alloc_consumer_eventfd (svm_msg_q_t * mq);
 int svm_msg_q_alloc_producer_eventfd (svm_msg_q_t * mq);
 
 
+/**
+ * Mark consumer as about to sleep on the queue eventfd
+ *
+ * In spsc mode producers only write the eventfd if they find the queue
+ * empty and the consumer marked as sleeping. Consumers that never call
+ * @ref svm_msg_q_consumer_wake are always considered to be sleeping.
+ *
+ * @param mq		message queue
+ * @return		0 if the consumer may sleep, 1 if messages are pending
+ */
+int svm_msg_q_consumer_sleep (svm_msg_q_t * mq);
+
+/**
+ * Mark consumer as busy, producers need not signal it
+ */
+void svm_msg_q_consumer_wake (svm_msg_q_t * mq);
+
+/**
+ * Wait for message queue event in spsc mode
+ */
+void svm_msg_q_wait_spsc (svm_msg_q_t * mq);
+
+/**
+ * Timed wait for message queue event in spsc mode
+ */
+int svm_msg_q_timedwait_spsc (svm_msg_q_t * mq, double timeout);
+
 /**
  * Format message queue, shows msg count for each ring
  */
@@ -287,6 +358,24 @@ svm_msg_q_size (svm_msg_q_t * mq)
   return mq->q->cursize;
 }
 
+/**
+ * Number of messages that can still be added to the queue
+ */
+static inline u32
+svm_msg_q_free_slots (svm_msg_q_t * mq)
+{
+  return mq->q->maxsize - mq->q->cursize;
+}
+
+/**
+ * Check if message queue is in lock-free single consumer mode
+ */
+static inline u8
+svm_msg_q_is_spsc (svm_msg_q_t * mq)
+{
+  return (mq->flags & SVM_MSG_Q_F_SPSC) != 0;
+}
+
 /**
  * Check if message is invalid
  */
@@ -298,19 +387,32 @@ svm_msg_q_msg_is_invalid (svm_msg_q_msg_t * msg)
 
 /**
  * Try locking message queue
+ *
+ * In spsc mode this only excludes other producers.
  */
 static inline int
 svm_msg_q_try_lock (svm_msg_q_t * mq)
 {
+  if (svm_msg_q_is_spsc (mq))
+    return clib_atomic_test_and_set (&mq->producer_lock) ? -1 : 0;
   return pthread_mutex_trylock (&mq->q->mutex);
 }
 
 /**
  * Lock, or block trying, the message queue
+ *
+ * In spsc mode this only excludes other producers.
  */
 static inline int
 svm_msg_q_lock (svm_msg_q_t * mq)
 {
+  if (svm_msg_q_is_spsc (mq))
+    {
+      while (clib_atomic_test_and_set (&mq->producer_lock))
+	while (mq->producer_lock)
+	  CLIB_PAUSE ();
+      return 0;
+    }
   return pthread_mutex_lock (&mq->q->mutex);
 }
 
@@ -320,7 +422,10 @@ svm_msg_q_lock (svm_msg_q_t * mq)
 static inline void
 svm_msg_q_unlock (svm_msg_q_t * mq)
 {
-  pthread_mutex_unlock (&mq->q->mutex);
+  if (svm_msg_q_is_spsc (mq))
+    clib_atomic_release (&mq->producer_lock);
+  else
+    pthread_mutex_unlock (&mq->q->mutex);
 }
 
 /**
@@ -332,7 +437,10 @@ svm_msg_q_unlock (svm_msg_q_t * mq)
 static inline void
 svm_msg_q_wait (svm_msg_q_t * mq)
 {
-  svm_queue_wait (mq->q);
+  if (svm_msg_q_is_spsc (mq))
+    svm_msg_q_wait_spsc (mq);
+  else
+    svm_queue_wait (mq->q);
 }
 
 /**
@@ -346,6 +454,8 @@ svm_msg_q_wait (svm_msg_q_t * mq)
 static inline int
 svm_msg_q_timedwait (svm_msg_q_t * mq, double timeout)
 {
+  if (svm_msg_q_is_spsc (mq))
+    return svm_msg_q_timedwait_spsc (mq, timeout);
   return svm_queue_timedwait (mq->q, timeout);
 }
 
@@ -231,6 +231,27 @@ svm_queue_add_raw (svm_queue_t * q, u8 * elem)
     svm_queue_send_signal (q, 1);
 }
 
+void
+svm_queue_add_raw_batch (svm_queue_t * q, u8 * elems, u32 n_elts)
+{
+  u32 n_first;
+
+  ASSERT (q->cursize + n_elts <= q->maxsize);
+
+  n_first = clib_min (n_elts, q->maxsize - q->tail);
+  clib_memcpy_fast (&q->data[0] + q->elsize * q->tail, elems,
+		    n_first * q->elsize);
+  if (n_first < n_elts)
+    clib_memcpy_fast (&q->data[0], elems + n_first * q->elsize,
+		      (n_elts - n_first) * q->elsize);
+
+  q->tail = (q->tail + n_elts) % q->maxsize;
+  q->cursize += n_elts;
+
+  if (q->cursize == n_elts)
+    svm_queue_send_signal (q, 1);
+}
+
 
 /*
  * svm_queue_add
@@ -459,6 +480,28 @@ svm_queue_sub_raw (svm_queue_t * q, u8 * elem)
   return 0;
 }
 
+u32
+svm_queue_sub_raw_batch (svm_queue_t * q, u8 * elems, u32 n_max)
+{
+  u32 n_elts, n_first;
+
+  n_elts = clib_min (q->cursize, n_max);
+  if (!n_elts)
+    return 0;
+
+  n_first = clib_min (n_elts, q->maxsize - q->head);
+  clib_memcpy_fast (elems, &q->data[0] + q->elsize * q->head,
+		    n_first * q->elsize);
+  if (n_first < n_elts)
+    clib_memcpy_fast (elems + n_first * q->elsize, &q->data[0],
+		      (n_elts - n_first) * q->elsize);
+
+  q->head = (q->head + n_elts) % q->maxsize;
+  q->cursize -= n_elts;
+
+  return n_elts;
+}
+
 void
 svm_queue_set_producer_event_fd (svm_queue_t * q, int fd)
 {
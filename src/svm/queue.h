@@ -107,6 +107,30 @@ int svm_queue_timedwait (svm_queue_t * q, double timeout);
  */
 void svm_queue_add_raw (svm_queue_t * q, u8 * elem);
 
+/**
+ * Add multiple elements to queue with mutex held
+ *
+ * Consumer is signaled at most once. Caller must ensure the queue has
+ * room for all elements.
+ *
+ * @param q		queue
+ * @param elems		pointer to elements to add
+ * @param n_elts	number of elements
+ */
+void svm_queue_add_raw_batch (svm_queue_t * q, u8 * elems, u32 n_elts);
+
+/**
+ * Remove up to n_max elements from queue with mutex held
+ *
+ * Does not block if the queue is empty.
+ *
+ * @param q		queue
+ * @param elems		pointer to where elements are to be copied
+ * @param n_max		max number of elements to remove
+ * @return		number of elements removed
+ */
+u32 svm_queue_sub_raw_batch (svm_queue_t * q, u8 * elems, u32 n_max);
+
 /**
  * Set producer's event fd
  *
@@ -920,6 +920,58 @@ svm_fifo_enqueue (svm_fifo_t * f, u32 len, const u8 * src)
   return len;
 }
 
+int
+svm_fifo_enqueue_segments (svm_fifo_t * f, const svm_fifo_seg_t segs[],
+			   u32 n_segs, u8 allow_partial)
+{
+  u32 tail, head, free_count, len = 0, i;
+
+  f_load_head_tail_prod (f, &head, &tail);
+
+  /* free space in fifo can only increase during enqueue: SPSC */
+  free_count = f_free_count (f, head, tail);
+
+  f->ooos_newest = OOO_SEGMENT_INVALID_INDEX;
+
+  if (PREDICT_FALSE (free_count == 0))
+    return SVM_FIFO_EFULL;
+
+  if (!allow_partial)
+    {
+      for (i = 0; i < n_segs; i++)
+	len += segs[i].len;
+      if (len > free_count)
+	return SVM_FIFO_EFULL;
+      len = 0;
+    }
+
+  for (i = 0; i < n_segs; i++)
+    {
+      u32 to_copy = clib_min (segs[i].len, free_count - len);
+      svm_fifo_copy_to_chunk (f, f->tail_chunk, tail, segs[i].data,
+			      to_copy, &f->tail_chunk);
+      tail = (tail + to_copy) % f->size;
+      len += to_copy;
+      if (to_copy < segs[i].len)
+	break;
+    }
+
+  svm_fifo_trace_add (f, head, len, 2);
+
+  /* collect out-of-order segments */
+  if (PREDICT_FALSE (f->ooos_list_head != OOO_SEGMENT_INVALID_INDEX))
+    {
+      len += ooo_segment_try_collect (f, len, &tail);
+      if (!svm_fifo_chunk_includes_pos (f->tail_chunk, tail))
+	f->tail_chunk = svm_fifo_find_chunk (f, tail);
+    }
+
+  /* store-rel: producer owned index (paired with load-acq in consumer) */
+  clib_atomic_store_rel_n (&f->tail, tail);
+
+  return len;
+}
+
 /**
  * Enqueue a future segment.
  *
@@ -1025,6 +1077,49 @@ svm_fifo_peek (svm_fifo_t * f, u32 offset, u32 len, u8 * dst)
   return len;
 }
 
+int
+svm_fifo_peek_segments (svm_fifo_t * f, u32 offset, svm_fifo_seg_t * fs,
+			u32 * n_segs, u32 max_bytes)
+{
+  u32 tail, head, cursize, head_idx, to_read, n_bytes = 0, len, i = 0;
+  svm_fifo_chunk_t *c;
+
+  f_load_head_tail_cons (f, &head, &tail);
+
+  /* current size of fifo can only increase during peek: SPSC */
+  cursize = f_cursize (f, head, tail);
+
+  if (PREDICT_FALSE (cursize < offset))
+    return SVM_FIFO_EEMPTY;
+
+  to_read = clib_min (cursize - offset, max_bytes);
+  head_idx = (head + offset) % f->size;
+  if (!svm_fifo_chunk_includes_pos (f->ooo_deq, head_idx))
+    f->ooo_deq = svm_fifo_find_chunk (f, head_idx);
+
+  c = f->ooo_deq;
+  head_idx -= c->start_byte;
+  while (n_bytes < to_read && i < *n_segs)
+    {
+      len = clib_min (c->length - head_idx, to_read - n_bytes);
+      fs[i].data = &c->data[head_idx];
+      fs[i].len = len;
+      n_bytes += len;
+      i += 1;
+      head_idx += len;
+      if (head_idx == c->length)
+	{
+	  /* chunks are in a circular list */
+	  c = c->next;
+	  head_idx = 0;
+	}
+    }
+
+  f->ooo_deq = c;
+  *n_segs = i;
+  return n_bytes;
+}
+
 int
 svm_fifo_dequeue_drop (svm_fifo_t * f, u32 len)
 {
@@ -362,6 +362,22 @@ void svm_fifo_clone (svm_fifo_t * df, svm_fifo_t * sf);
  * @return	number of contiguous bytes that can be consumed or error
  */
 int svm_fifo_enqueue (svm_fifo_t * f, u32 len, const u8 * src);
+/**
+ * Enqueue array of segments into fifo
+ *
+ * All segments are copied back to back and the tail is updated once, so
+ * the consumer sees either none or all of the data, e.g., a dgram header
+ * and its payload.
+ *
+ * @param f		fifo
+ * @param segs		array of segments to enqueue
+ * @param n_segs	number of segments
+ * @param allow_partial	if set, enqueue as much as fits, otherwise
+ * 			enqueue all or nothing
+ * @return		number of bytes enqueued or error
+ */
+int svm_fifo_enqueue_segments (svm_fifo_t * f, const svm_fifo_seg_t segs[],
+			       u32 n_segs, u8 allow_partial);
 /**
  * Enqueue data to fifo with offset
  *
@@ -424,6 +440,25 @@ int svm_fifo_dequeue (svm_fifo_t * f, u32 len, u8 * dst);
  * @return		number of bytes peeked
  */
 int svm_fifo_peek (svm_fifo_t * f, u32 offset, u32 len, u8 * dst);
+/**
+ * Peek fifo data without copying
+ *
+ * Fills segments with pointers to, and lengths of, the contiguous ranges
+ * of chunk memory that hold up to max_bytes of data starting at offset
+ * from head. Head is not moved, so the data is only valid until the
+ * consumer dequeues or drops it.
+ *
+ * @param f		fifo
+ * @param offset	offset from head where to start
+ * @param fs		array of segments to be filled
+ * @param n_segs	in: number of segments in fs, out: number of
+ * 			segments filled
+ * @param max_bytes	max bytes to be mapped
+ * @return		number of bytes mapped or SVM_FIFO_EEMPTY if
+ * 			offset is past the tail
+ */
+int svm_fifo_peek_segments (svm_fifo_t * f, u32 offset, svm_fifo_seg_t * fs,
+			    u32 * n_segs, u32 max_bytes);
 /**
  * Dequeue and drop bytes from fifo
  *
@@ -861,6 +896,74 @@ svm_fifo_needs_deq_ntf (svm_fifo_t * f, u32 n_last_deq)
   return 0;
 }
 
+#define SVM_FIFO_CURSOR_N_SEGS 16
+
+/**
+ * Consumer side read cursor
+ *
+ * Copies data out of the fifo, starting at an offset from head, without
+ * moving head. Chunk memory is mapped with svm_fifo_peek_segments a batch
+ * of contiguous ranges at a time, so copying into many small destinations,
+ * e.g., a chain of buffers, looks up the fifo once per batch instead of
+ * once per copy.
+ */
+typedef struct svm_fifo_cursor_
+{
+  svm_fifo_t *f;		/**< fifo being read */
+  u32 offset;			/**< offset from head of next byte */
+  u16 n_segs;			/**< number of mapped segments */
+  u16 seg_index;		/**< segment to copy from next */
+  svm_fifo_seg_t segs[SVM_FIFO_CURSOR_N_SEGS];
+} svm_fifo_cursor_t;
+
+static inline void
+svm_fifo_cursor_init (svm_fifo_cursor_t * fc, svm_fifo_t * f, u32 offset)
+{
+  fc->f = f;
+  fc->offset = offset;
+  fc->n_segs = 0;
+  fc->seg_index = 0;
+}
+
+/**
+ * Copy data at cursor and advance it
+ *
+ * @param fc		cursor
+ * @param dst		destination buffer
+ * @param len		number of bytes to copy
+ * @return		number of bytes copied, less than len only if the
+ * 			fifo holds less data
+ */
+static inline u32
+svm_fifo_cursor_copy (svm_fifo_cursor_t * fc, u8 * dst, u32 len)
+{
+  u32 n_copied = 0, n_segs, n_bytes;
+  svm_fifo_seg_t *seg;
+
+  while (n_copied < len)
+    {
+      if (fc->seg_index == fc->n_segs)
+	{
+	  n_segs = SVM_FIFO_CURSOR_N_SEGS;
+	  if (svm_fifo_peek_segments (fc->f, fc->offset, fc->segs, &n_segs,
+				      ~0) <= 0)
+	    break;
+	  fc->n_segs = n_segs;
+	  fc->seg_index = 0;
+	}
+      seg = &fc->segs[fc->seg_index];
+      n_bytes = clib_min (seg->len, len - n_copied);
+      clib_memcpy_fast (dst + n_copied, seg->data, n_bytes);
+      seg->data += n_bytes;
+      seg->len -= n_bytes;
+      if (!seg->len)
+	fc->seg_index += 1;
+      n_copied += n_bytes;
+      fc->offset += n_bytes;
+    }
+  return n_copied;
+}
+
 #endif /* __included_ssvm_fifo_h__ */
 
 /*
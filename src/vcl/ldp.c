@@ -1861,6 +1861,9 @@ getsockopt (int fd, int level, int optname,
 	    case SO_REUSEADDR:
 	      rv = vls_attr (vlsh, VPPCOM_ATTR_GET_REUSEADDR, optval, optlen);
 	      break;
+	    case SO_REUSEPORT:
+	      rv = vls_attr (vlsh, VPPCOM_ATTR_GET_REUSEPORT, optval, optlen);
+	      break;
 	    case SO_BROADCAST:
 	      rv = vls_attr (vlsh, VPPCOM_ATTR_GET_BROADCAST, optval, optlen);
 	      break;
@@ -1962,6 +1965,10 @@ setsockopt (int fd, int level, int optname,
 	      rv = vls_attr (vlsh, VPPCOM_ATTR_SET_REUSEADDR,
 			     (void *) optval, &optlen);
 	      break;
+	    case SO_REUSEPORT:
+	      rv = vls_attr (vlsh, VPPCOM_ATTR_SET_REUSEPORT,
+			     (void *) optval, &optlen);
+	      break;
 	    case SO_BROADCAST:
 	      rv = vls_attr (vlsh, VPPCOM_ATTR_SET_BROADCAST,
 			     (void *) optval, &optlen);
@@ -492,6 +492,18 @@ vppcom_cfg_read_file (char *conf_fname)
 	      VCFG_DBG (0, "VCL<%d>: configured with mq with eventfd",
 			getpid ());
 	    }
+	  else if (unformat (line_input, "use-mq-spsc"))
+	    {
+	      vcl_cfg->use_mq_spsc = 1;
+	      VCFG_DBG (0, "VCL<%d>: configured with lock-free mq",
+			getpid ());
+	    }
+	  else if (unformat (line_input, "use-rx-bulk-evts"))
+	    {
+	      vcl_cfg->use_rx_bulk_evts = 1;
+	      VCFG_DBG (0, "VCL<%d>: configured with bulk rx events",
+			getpid ());
+	    }
 	  else if (unformat (line_input, "tls-engine %u",
 			     &vcl_cfg->tls_engine))
 	    {
@@ -204,6 +204,8 @@ typedef struct vppcom_cfg_t_
   u8 *namespace_id;
   u64 namespace_secret;
   u8 use_mq_eventfd;
+  u8 use_mq_spsc;
+  u8 use_rx_bulk_evts;
   f64 app_timeout;
   f64 session_timeout;
   f64 accept_timeout;
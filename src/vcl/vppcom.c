@@ -40,16 +40,17 @@ vcl_segment_is_not_mounted (vcl_worker_t * wrk, u64 segment_handle)
 static inline int
 vcl_mq_dequeue_batch (vcl_worker_t * wrk, svm_msg_q_t * mq, u32 n_max_msg)
 {
-  svm_msg_q_msg_t *msg;
-  u32 n_msgs;
-  int i;
+  svm_msg_q_msg_t *msgs;
+  u32 n_msgs, len;
 
   n_msgs = clib_min (svm_msg_q_size (mq), n_max_msg);
-  for (i = 0; i < n_msgs; i++)
-    {
-      vec_add2 (wrk->mq_msg_vector, msg, 1);
-      svm_msg_q_sub_w_lock (mq, msg);
-    }
+  if (!n_msgs)
+    return 0;
+
+  len = vec_len (wrk->mq_msg_vector);
+  vec_add2 (wrk->mq_msg_vector, msgs, n_msgs);
+  n_msgs = svm_msg_q_sub_batch (mq, msgs, n_msgs);
+  _vec_len (wrk->mq_msg_vector) = len + n_msgs;
   return n_msgs;
 }
 
@@ -209,6 +210,8 @@ vcl_send_session_listen (vcl_worker_t * wrk, vcl_session_t * s)
   clib_memcpy_fast (&mp->ip, &s->transport.lcl_ip, sizeof (mp->ip));
   mp->port = s->transport.lcl_port;
   mp->proto = s->session_type;
+  if (VCL_SESS_ATTR_TEST (s->attr, VCL_SESS_ATTR_REUSEPORT))
+    mp->flags = SESSION_LISTEN_F_REUSEPORT;
   app_send_ctrl_evt_to_vpp (mq, app_evt);
 }
 
@@ -777,7 +780,10 @@ static int
 vcl_handle_mq_event (vcl_worker_t * wrk, session_event_t * e)
 {
   session_disconnected_msg_t *disconnected_msg;
+  session_rx_bulk_msg_t *bulk_msg;
+  session_event_t *evt;
   vcl_session_t *session;
+  u32 i;
 
   switch (e->event_type)
     {
@@ -788,6 +794,18 @@ vcl_handle_mq_event (vcl_worker_t * wrk, session_event_t * e)
 	break;
       vec_add1 (wrk->unhandled_evts_vector, *e);
       break;
+    case SESSION_IO_EVT_RX_BULK:
+      bulk_msg = (session_rx_bulk_msg_t *) e->data;
+      for (i = 0; i < bulk_msg->n_sessions; i++)
+	{
+	  session = vcl_session_get (wrk, bulk_msg->session_indices[i]);
+	  if (!session || !(session->session_state & STATE_OPEN))
+	    continue;
+	  vec_add2 (wrk->unhandled_evts_vector, evt, 1);
+	  evt->event_type = SESSION_IO_EVT_RX;
+	  evt->session_index = bulk_msg->session_indices[i];
+	}
+      break;
     case SESSION_CTRL_EVT_ACCEPTED:
       vcl_session_accepted (wrk, (session_accepted_msg_t *) e->data);
       break;
@@ -2070,6 +2088,20 @@ vcl_select_handle_mq_event (vcl_worker_t * wrk, session_event_t * e,
 	  *bits_set += 1;
 	}
       break;
+    case SESSION_IO_EVT_RX_BULK:
+      {
+	session_rx_bulk_msg_t *bulk_msg = (session_rx_bulk_msg_t *) e->data;
+	session_event_t rx_evt = {.event_type = SESSION_IO_EVT_RX };
+	u32 i;
+
+	for (i = 0; i < bulk_msg->n_sessions; i++)
+	  {
+	    rx_evt.session_index = bulk_msg->session_indices[i];
+	    vcl_select_handle_mq_event (wrk, &rx_evt, n_bits, read_map,
+					write_map, except_map, bits_set);
+	  }
+      }
+      break;
     case SESSION_IO_EVT_TX:
       sid = e->session_index;
       session = vcl_session_get (wrk, sid);
@@ -2155,6 +2187,12 @@ vcl_select_handle_mq (vcl_worker_t * wrk, svm_msg_q_t * mq,
   session_event_t *e;
   u32 i;
 
+  if (svm_msg_q_is_spsc (mq) && !time_to_wait)
+    {
+      vcl_mq_dequeue_batch (wrk, mq, ~0);
+      goto handle_dequeued;
+    }
+
   svm_msg_q_lock (mq);
   if (svm_msg_q_is_empty (mq))
     {
@@ -2185,6 +2223,7 @@ vcl_select_handle_mq (vcl_worker_t * wrk, svm_msg_q_t * mq,
   vcl_mq_dequeue_batch (wrk, mq, ~0);
   svm_msg_q_unlock (mq);
 
+handle_dequeued:
   for (i = 0; i < vec_len (wrk->mq_msg_vector); i++)
     {
       msg = vec_elt_at_index (wrk->mq_msg_vector, i);
@@ -2246,8 +2285,11 @@ vppcom_select_eventfd (vcl_worker_t * wrk, int n_bits,
     {
       mqc = vcl_mq_evt_conn_get (wrk, wrk->mq_events[i].data.u32);
       n_read = read (mqc->mq_fd, &buf, sizeof (buf));
-      vcl_select_handle_mq (wrk, mqc->mq, n_bits, read_map, write_map,
-			    except_map, 0, bits_set);
+      svm_msg_q_consumer_wake (mqc->mq);
+      do
+	vcl_select_handle_mq (wrk, mqc->mq, n_bits, read_map, write_map,
+			      except_map, 0, bits_set);
+      while (svm_msg_q_consumer_sleep (mqc->mq));
     }
 
   return (n_mq_evts > 0 ? (int) *bits_set : 0);
@@ -2740,18 +2782,52 @@ vcl_epoll_wait_handle_mq_event (vcl_worker_t * wrk, session_event_t * e,
     }
 }
 
+/**
+ * Handle bulk rx notification. Sessions for which there's no room left in
+ * the events array are handled on the next epoll_wait
+ */
+static void
+vcl_epoll_wait_handle_rx_bulk (vcl_worker_t * wrk, session_event_t * e,
+			       struct epoll_event *events, u32 maxevents,
+			       u32 * num_ev)
+{
+  session_rx_bulk_msg_t *bulk_msg = (session_rx_bulk_msg_t *) e->data;
+  session_event_t rx_evt = {.event_type = SESSION_IO_EVT_RX }, *evt;
+  u32 i;
+
+  for (i = 0; i < bulk_msg->n_sessions; i++)
+    {
+      if (*num_ev >= maxevents)
+	{
+	  vec_add2 (wrk->unhandled_evts_vector, evt, 1);
+	  evt->event_type = SESSION_IO_EVT_RX;
+	  evt->session_index = bulk_msg->session_indices[i];
+	  continue;
+	}
+      rx_evt.session_index = bulk_msg->session_indices[i];
+      vcl_epoll_wait_handle_mq_event (wrk, &rx_evt, events, num_ev);
+    }
+}
+
 static int
 vcl_epoll_wait_handle_mq (vcl_worker_t * wrk, svm_msg_q_t * mq,
 			  struct epoll_event *events, u32 maxevents,
 			  double wait_for_time, u32 * num_ev)
 {
+  u32 i, n_msgs, n_left;
   svm_msg_q_msg_t *msg;
   session_event_t *e;
-  int i;
 
   if (vec_len (wrk->mq_msg_vector) && svm_msg_q_is_empty (mq))
     goto handle_dequeued;
 
+  /* Sole consumer of a lock-free queue, no need to contend with vpp */
+  if (svm_msg_q_is_spsc (mq) && !wait_for_time)
+    {
+      vcl_mq_dequeue_batch (wrk, mq, maxevents - *num_ev);
+      goto handle_dequeued;
+    }
+
   svm_msg_q_lock (mq);
   if (svm_msg_q_is_empty (mq))
     {
@@ -2778,11 +2854,21 @@ vcl_epoll_wait_handle_mq (vcl_worker_t * wrk, svm_msg_q_t * mq,
   svm_msg_q_unlock (mq);
 
 handle_dequeued:
-  for (i = 0; i < vec_len (wrk->mq_msg_vector); i++)
+  n_msgs = vec_len (wrk->mq_msg_vector);
+  for (i = 0; i < n_msgs; i++)
     {
       msg = vec_elt_at_index (wrk->mq_msg_vector, i);
       e = svm_msg_q_msg_data (mq, msg);
-      vcl_epoll_wait_handle_mq_event (wrk, e, events, num_ev);
+      /* Leave room for one event per remaining message */
+      if (e->event_type == SESSION_IO_EVT_RX_BULK)
+	{
+	  n_left = n_msgs - i - 1;
+	  vcl_epoll_wait_handle_rx_bulk (wrk, e, events,
+					 maxevents > n_left ?
+					 maxevents - n_left : 0, num_ev);
+	}
+      else
+	vcl_epoll_wait_handle_mq_event (wrk, e, events, num_ev);
       svm_msg_q_free_msg (mq, msg);
     }
   vec_reset_length (wrk->mq_msg_vector);
@@ -2837,7 +2923,12 @@ again:
     {
       mqc = vcl_mq_evt_conn_get (wrk, wrk->mq_events[i].data.u32);
       n_read = read (mqc->mq_fd, &buf, sizeof (buf));
-      vcl_epoll_wait_handle_mq (wrk, mqc->mq, events, maxevents, 0, &n_evts);
+      /* Producers need not write the eventfd while we drain the queue */
+      svm_msg_q_consumer_wake (mqc->mq);
+      do
+	vcl_epoll_wait_handle_mq (wrk, mqc->mq, events, maxevents, 0,
+				  &n_evts);
+      while (svm_msg_q_consumer_sleep (mqc->mq) && n_evts < maxevents);
     }
   if (!n_evts && n_mq_evts > 0)
     goto again;
@@ -3173,12 +3264,11 @@ vppcom_session_attr (uint32_t session_handle, uint32_t op,
     case VPPCOM_ATTR_GET_REUSEPORT:
       if (buffer && buflen && (*buflen >= sizeof (int)))
 	{
-	  /* VPP-TBD */
 	  *(int *) buffer = VCL_SESS_ATTR_TEST (session->attr,
 						VCL_SESS_ATTR_REUSEPORT);
 	  *buflen = sizeof (int);
 
-	  VDBG (2, "VPPCOM_ATTR_GET_REUSEPORT: %d, buflen %d, #VPP-TBD#",
+	  VDBG (2, "VPPCOM_ATTR_GET_REUSEPORT: %d, buflen %d",
 		*(int *) buffer, *buflen);
 	}
       else
@@ -3189,13 +3279,13 @@ vppcom_session_attr (uint32_t session_handle, uint32_t op,
       if (buffer && buflen && (*buflen == sizeof (int)) &&
 	  !VCL_SESS_ATTR_TEST (session->attr, VCL_SESS_ATTR_LISTEN))
 	{
-	  /* VPP-TBD */
+	  /* Sent to vpp with the listen request */
 	  if (*(int *) buffer)
 	    VCL_SESS_ATTR_SET (session->attr, VCL_SESS_ATTR_REUSEPORT);
 	  else
 	    VCL_SESS_ATTR_CLR (session->attr, VCL_SESS_ATTR_REUSEPORT);
 
-	  VDBG (2, "VPPCOM_ATTR_SET_REUSEPORT: %d, buflen %d, #VPP-TBD#",
+	  VDBG (2, "VPPCOM_ATTR_SET_REUSEPORT: %d, buflen %d",
 		VCL_SESS_ATTR_TEST (session->attr, VCL_SESS_ATTR_REUSEPORT),
 		*buflen);
 	}
@@ -109,6 +109,14 @@ vlib_buffer_copy_indices (u32 * dst, u32 * src, u32 n_indices)
       src += 16;
       n_indices -= 16;
     }
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  if (n_indices)
+    {
+      u16 mask = pow2_mask (n_indices);
+      u32x16_mask_store (u32x16_mask_load_zero (src, mask), dst, mask);
+    }
+  return;
+#endif
 #endif
 
 #if defined(CLIB_HAVE_VEC256)
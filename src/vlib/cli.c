@@ -842,6 +842,9 @@ show_memory_usage (vlib_main_t * vm,
           vlib_cli_output (vm, "  %U\n", format_mheap,
                            clib_per_cpu_mheaps[index],
                            verbose);
+          if (clib_mem_tcaches[index])
+            vlib_cli_output (vm, "  %U\n", format_clib_mem_tcache,
+                             clib_mem_tcaches[index]);
           index++;
         }));
         /* *INDENT-ON* */
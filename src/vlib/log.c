@@ -82,6 +82,48 @@ format_vlib_log_class (u8 * s, va_list * args)
     return format (s, "%v", c->name, 0);
 }
 
+static clib_format_program_t *
+vlib_log_get_program (char *fmt)
+{
+  vlib_log_main_t *lm = &log_main;
+  clib_format_program_t *p;
+  uword *pp;
+
+  if (PREDICT_FALSE (lm->program_by_fmt == 0))
+    lm->program_by_fmt = hash_create (0, sizeof (uword));
+
+  pp = hash_get (lm->program_by_fmt, pointer_to_uword (fmt));
+  if (PREDICT_TRUE (pp != 0))
+    {
+      p = uword_to_pointer (pp[0], clib_format_program_t *);
+      if (PREDICT_TRUE (p == 0 || strcmp (p->fmt, fmt) == 0))
+	return p;
+
+      /*
+       * Different text at a known address, fmt is a buffer and not a
+       * constant. Log it as text from now on. Entries may still use the
+       * old program, it keeps its own copy of the format string.
+       */
+      hash_set (lm->program_by_fmt, pointer_to_uword (fmt), 0);
+      return 0;
+    }
+
+  /* formats which do not compile are logged as text */
+  p = clib_format_compile (fmt);
+  hash_set (lm->program_by_fmt, pointer_to_uword (fmt),
+	    pointer_to_uword (p));
+  return p;
+}
+
+u8 *
+format_vlib_log_entry_message (u8 * s, va_list * args)
+{
+  vlib_log_entry_t *e = va_arg (*args, vlib_log_entry_t *);
+
+  if (e->program)
+    return clib_format_replay (s, e->program, e->args);
+  return format (s, "%v", e->string);
+}
 
 void
 vlib_log (vlib_log_level_t level, vlib_log_class_t class, char *fmt, ...)
@@ -94,6 +136,8 @@ vlib_log (vlib_log_level_t level, vlib_log_class_t class, char *fmt, ...)
   f64 t = vlib_time_now (vm);
   f64 delta = t - sc->last_event_timestamp;
   u8 *s = 0;
+  clib_format_program_t *p = 0;
+  u8 *args = 0;
   bool use_formatted_log_entry = true;
 
   vec_validate (lm->entries, lm->size);
@@ -127,7 +171,14 @@ vlib_log (vlib_log_level_t level, vlib_log_class_t class, char *fmt, ...)
 	}
     }
 
-  if (s == 0)
+  if (s == 0 && lm->binary && (p = vlib_log_get_program (fmt)))
+    {
+      /* binary mode, formatting is left to whoever reads the entry */
+      va_start (va, fmt);
+      args = clib_format_capture (0, p, &va);
+      va_end (va);
+    }
+  else if (s == 0)
     {
       va_start (va, fmt);
       s = va_format (s, fmt, &va);
@@ -136,9 +187,12 @@ vlib_log (vlib_log_level_t level, vlib_log_class_t class, char *fmt, ...)
 
   e = vec_elt_at_index (lm->entries, lm->next);
   vec_free (e->string);
+  vec_free (e->args);
   e->level = level;
   e->class = class;
   e->string = s;
+  e->program = p;
+  e->args = args;
   e->timestamp = t;
 
   lm->next = (lm->next + 1) % lm->size;
@@ -152,10 +206,13 @@ syslog:
       u8 *tmp = format (NULL, "%U", format_vlib_log_class, class);
       if (use_formatted_log_entry)
 	{
+	  u8 *msg = s ? s : clib_format_replay (0, p, args);
 	  syslog (vlib_log_level_to_syslog_priority (level), "%.*s: %.*s",
 		  (int) vec_len (tmp), tmp,
-		  (int) (vec_len (s) -
-			 (vec_c_string_is_terminated (s) ? 1 : 0)), s);
+		  (int) (vec_len (msg) -
+			 (vec_c_string_is_terminated (msg) ? 1 : 0)), msg);
+	  if (msg != s)
+	    vec_free (msg);
 	}
       else
 	{
@@ -265,10 +322,11 @@ show_log (vlib_main_t * vm,
   while (count--)
     {
       e = vec_elt_at_index (lm->entries, i);
-      vlib_cli_output (vm, "%U %-10U %-14U %v",
+      vlib_cli_output (vm, "%U %-10U %-14U %U",
 		       format_time_float, 0, e->timestamp + time_offset,
 		       format_vlib_log_level, e->level,
-		       format_vlib_log_class, e->class, e->string);
+		       format_vlib_log_class, e->class,
+		       format_vlib_log_entry_message, e);
       i = (i + 1) % lm->size;
     }
 
@@ -293,6 +351,7 @@ show_log_config (vlib_main_t * vm,
   vlib_log_subclass_data_t *sc;
 
   vlib_cli_output (vm, "%-20s %u entries", "Buffer Size:", lm->size);
+  vlib_cli_output (vm, "%-20s %s", "Mode:", lm->binary ? "binary" : "text");
   vlib_cli_output (vm, "Defaults:\n");
   vlib_cli_output (vm, "%-20s %U", "  Log Level:",
 		   format_vlib_log_level, lm->default_log_level);
@@ -345,6 +404,8 @@ clear_log (vlib_main_t * vm,
     {
       e = vec_elt_at_index (lm->entries, i);
       vec_free (e->string);
+      vec_free (e->args);
+      e->program = 0;
       i = (i + 1) % lm->size;
     }
 
@@ -566,6 +627,44 @@ VLIB_CLI_COMMAND (cli_set_log_size, static) = {
 };
 /* *INDENT-ON* */
 
+static uword
+unformat_vlib_log_mode (unformat_input_t * input, va_list * args)
+{
+  u8 *binary = va_arg (*args, u8 *);
+
+  if (unformat (input, "binary"))
+    *binary = 1;
+  else if (unformat (input, "text"))
+    *binary = 0;
+  else
+    return 0;
+  return 1;
+}
+
+/* In text mode messages are formatted when logged. In binary mode only
+   the arguments are copied and formatting is done when the log is shown.
+   Programs are cached by format address and checked against the format
+   text, so a format built in a buffer is logged as text once it changes. */
+static clib_error_t *
+set_log_mode (vlib_main_t * vm,
+	      unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  vlib_log_main_t *lm = &log_main;
+
+  if (!unformat (input, "%U", unformat_vlib_log_mode, &lm->binary))
+    return clib_error_return (0, "unknown input `%U'",
+			      format_unformat_error, input);
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (cli_set_log_mode, static) = {
+  .path = "set logging mode",
+  .short_help = "set logging mode <text|binary>",
+  .function = set_log_mode,
+};
+/* *INDENT-ON* */
+
 static uword
 unformat_vlib_log_subclass (unformat_input_t * input, va_list * args)
 {
@@ -656,6 +755,9 @@ log_config (vlib_main_t * vm, unformat_input_t * input)
 	vec_validate (lm->entries, lm->size);
       else if (unformat (input, "unthrottle-time %d", &lm->unthrottle_time))
 	;
+      else if (unformat (input, "mode %U", unformat_vlib_log_mode,
+			 &lm->binary))
+	;
       else if (unformat (input, "default-log-level %U",
 			 unformat_vlib_log_level, &lm->default_log_level))
 	;
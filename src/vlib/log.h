@@ -17,6 +17,7 @@
 #define included_vlib_log_h
 
 #include <vppinfra/types.h>
+#include <vppinfra/format.h>
 
 #define foreach_vlib_log_level \
   _(0, EMERG, emerg) \
@@ -42,6 +43,10 @@ typedef struct
   vlib_log_class_t class;
   f64 timestamp;
   u8 *string;
+  /* binary mode: compiled format and captured arguments, formatted
+     when the entry is shown */
+  clib_format_program_t *program;
+  u8 *args;
 } vlib_log_entry_t;
 
 typedef struct
@@ -81,6 +86,13 @@ typedef struct
   int unthrottle_time;
   u32 indent;
 
+  /* keep arguments instead of formatted strings */
+  u8 binary;
+
+  /* compiled format programs by format string address, 0 for formats
+     logged as text */
+  uword *program_by_fmt;
+
   /* time zero */
   struct timeval time_zero_timeval;
   f64 time_zero;
@@ -95,6 +107,7 @@ void vlib_log (vlib_log_level_t level, vlib_log_class_t class, char *fmt,
 	       ...);
 int last_log_entry ();
 u8 *format_vlib_log_class (u8 * s, va_list * args);
+u8 *format_vlib_log_entry_message (u8 * s, va_list * args);
 
 #define vlib_log_emerg(...) vlib_log(VLIB_LOG_LEVEL_EMERG, __VA_ARGS__)
 #define vlib_log_alert(...) vlib_log(VLIB_LOG_LEVEL_ALERT, __VA_ARGS__)
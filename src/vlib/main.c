@@ -45,6 +45,7 @@
 
 #include <vlib/unix/unix.h>
 #include <vlib/unix/cj.h>
+#include <fcntl.h>
 
 CJ_GLOBAL_LOG_PROTOTYPE;
 
@@ -824,8 +825,11 @@ elog_resize (vlib_main_t * vm,
 
   if (unformat (input, "%d", &tmp))
     {
+      /* Workers log into the rings being replaced */
+      vlib_worker_thread_barrier_sync (vm);
       elog_alloc (em, tmp);
       em->n_total_events_disable_limit = ~0;
+      vlib_worker_thread_barrier_release (vm);
     }
   else
     return clib_error_return (0, "Must specify how many events in the ring");
@@ -842,6 +846,182 @@ VLIB_CLI_COMMAND (elog_resize_cli, static) = {
 };
 /* *INDENT-ON* */
 
+typedef struct
+{
+  /* Exporter state, see elog_export_chunk */
+  elog_export_t export;
+  u8 *chunk;
+
+  /* Export file, -1 when not exporting */
+  int fd;
+  char *file;
+
+  /* Seconds between drains */
+  f64 interval;
+} elog_exporter_t;
+
+static elog_exporter_t elog_exporter = {.fd = -1 };
+
+/* Unwritten export data kept for retries before the export is stopped */
+#define ELOG_EXPORT_MAX_TAIL (64 << 20)
+
+static void
+elog_exporter_close (elog_exporter_t * ee)
+{
+  close (ee->fd);
+  ee->fd = -1;
+  vec_free (ee->file);
+  vec_free (ee->chunk);
+  elog_export_free (&ee->export);
+}
+
+static void
+elog_exporter_drain (vlib_main_t * vm, elog_exporter_t * ee)
+{
+  ssize_t n;
+  u32 done = 0;
+  int fatal = 0;
+
+  ee->chunk = elog_export_chunk (&vm->elog_main, &ee->export, ee->chunk);
+
+  while (done < vec_len (ee->chunk))
+    {
+      n = write (ee->fd, ee->chunk + done, vec_len (ee->chunk) - done);
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	{
+	  clib_unix_warning ("elog export to %s", ee->file);
+	  /* Only a full disk or a non-blocking fd is worth retrying */
+	  fatal = n < 0 && errno != EAGAIN && errno != ENOSPC;
+	  break;
+	}
+      done += n;
+    }
+
+  /*
+   * Keep the unwritten tail, the next drain appends to it. Dropping
+   * part of it would corrupt the file, so give up on the export when
+   * the fd is dead or the tail keeps growing.
+   */
+  if (fatal || vec_len (ee->chunk) - done > ELOG_EXPORT_MAX_TAIL)
+    {
+      clib_warning ("elog export to %s stopped, %u bytes not written",
+		    ee->file, vec_len (ee->chunk) - done);
+      elog_exporter_close (ee);
+      return;
+    }
+  if (done)
+    vec_delete (ee->chunk, done, 0);
+}
+
+static void
+elog_exporter_stop (vlib_main_t * vm, elog_exporter_t * ee)
+{
+  if (ee->fd < 0)
+    return;
+
+  elog_exporter_drain (vm, ee);
+  if (ee->fd >= 0)
+    elog_exporter_close (ee);
+}
+
+/*
+ * Drain the event log rings to a file, so captures are not limited
+ * by the ring size. The file is read back with elog_read_export_file.
+ */
+static uword
+elog_export_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
+		     vlib_frame_t * f)
+{
+  elog_exporter_t *ee = &elog_exporter;
+
+  while (1)
+    {
+      if (ee->fd < 0)
+	vlib_process_wait_for_event (vm);
+      else
+	vlib_process_wait_for_event_or_clock (vm, ee->interval);
+      vlib_process_get_events (vm, 0);
+
+      if (ee->fd >= 0)
+	elog_exporter_drain (vm, ee);
+    }
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (elog_export_node, static) = {
+  .function = elog_export_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "elog-export-process",
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+elog_export (vlib_main_t * vm,
+	     unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  elog_exporter_t *ee = &elog_exporter;
+  char *file = 0, *chroot_file;
+  f64 interval = 0.1;
+  int fd;
+
+  if (unformat (input, "stop"))
+    {
+      elog_exporter_stop (vm, ee);
+      return 0;
+    }
+
+  if (!unformat (input, "%s", &file))
+    return clib_error_return (0, "expected file name, got `%U'",
+			      format_unformat_error, input);
+  if (unformat (input, "interval %f", &interval) && interval <= 0)
+    {
+      vec_free (file);
+      return clib_error_return (0, "interval must be positive");
+    }
+
+  /* Same rules as event-logger save */
+  if (strstr (file, "..") || index (file, '/'))
+    {
+      vlib_cli_output (vm, "illegal characters in filename '%s'", file);
+      vec_free (file);
+      return 0;
+    }
+
+  chroot_file = (char *) format (0, "/tmp/%s%c", file, 0);
+  vec_free (file);
+
+  fd = open (chroot_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      clib_error_t *error = clib_error_return_unix (0, "open `%s'",
+						     chroot_file);
+      vec_free (chroot_file);
+      return error;
+    }
+
+  elog_exporter_stop (vm, ee);
+  ee->fd = fd;
+  ee->file = chroot_file;
+  ee->interval = interval;
+
+  vlib_process_signal_event (vm, elog_export_node.index, 0, 0);
+  vlib_cli_output (vm, "Exporting events to %s every %.3f seconds",
+		   ee->file, ee->interval);
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (elog_export_cli, static) = {
+  .path = "event-logger export",
+  .short_help = "event-logger export <filename> [interval <sec>] | stop "
+    "(streams events to /tmp/<filename>)",
+  .function = elog_export,
+};
+/* *INDENT-ON* */
+
 #endif /* CLIB_UNIX */
 
 static void
@@ -856,10 +1036,18 @@ elog_show_buffer_internal (vlib_main_t * vm, u32 n_events_to_show)
     * vm->clib_time.seconds_per_clock;
 
   es = elog_peek_events (em);
-  vlib_cli_output (vm, "%d of %d events in buffer, logger %s", vec_len (es),
-		   em->event_ring_size,
+  vlib_cli_output (vm, "%d of %d events in buffer%s, logger %s",
+		   vec_len (es), elog_buffer_capacity (em),
+		   em->thread_rings ? " (per-thread rings)" : "",
 		   em->n_total_events < em->n_total_events_disable_limit ?
 		   "running" : "stopped");
+#ifdef CLIB_UNIX
+  if (elog_exporter.fd >= 0)
+    vlib_cli_output (vm, "exporting to %s, %lu events exported, "
+		     "%lu dropped", elog_exporter.file,
+		     elog_exporter.export.n_events,
+		     elog_exporter.export.n_dropped);
+#endif
   vec_foreach (e, es)
   {
     vlib_cli_output (vm, "%18.9f: %U",
@@ -1957,6 +2145,8 @@ vlib_main_configure (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "elog-post-mortem-dump"))
 	vm->elog_post_mortem_dump = 1;
+      else if (unformat (input, "elog-per-thread-rings"))
+	vm->elog_per_thread_rings = 1;
       else
 	return unformat_parse_error (input);
     }
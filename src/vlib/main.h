@@ -245,6 +245,9 @@ typedef struct vlib_main_t
   /* Attempt to do a post-mortem elog dump */
   int elog_post_mortem_dump;
 
+  /* Give each thread its own event log ring */
+  int elog_per_thread_rings;
+
   /*
    * Need to call vlib_worker_thread_node_runtime_update before
    * releasing worker thread barrier. Only valid in vlib_global_main.
@@ -539,6 +539,11 @@ vlib_worker_thread_init (vlib_worker_thread_t * w)
 
   clib_mem_set_heap (w->thread_mheap);
 
+#if USE_DLMALLOC != 0
+  if (tm->mem_thread_cache)
+    clib_mem_tcache_enable ();
+#endif
+
   if (vec_len (tm->thread_prefix) && w->registration->short_name)
     {
       w->name = format (0, "%v_%s_%d%c", tm->thread_prefix,
@@ -655,6 +660,9 @@ start_workers (vlib_main_t * vm)
     clib_mem_alloc_aligned (CLIB_CACHE_LINE_BYTES, CLIB_CACHE_LINE_BYTES);
   vm->elog_main.lock[0] = 0;
 
+  if (vm->elog_per_thread_rings)
+    elog_alloc_thread_rings (&vm->elog_main, n_vlib_mains);
+
   if (n_vlib_mains > 1)
     {
       /* Replace hand-crafted length-1 vector with a real vector */
@@ -1268,6 +1276,8 @@ cpu_config (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "scheduler-priority %u", &tm->sched_priority))
 	;
+      else if (unformat (input, "mem-thread-cache"))
+	tm->mem_thread_cache = 1;
       else if (unformat (input, "%s %u", &name, &count))
 	{
 	  p = hash_get_mem (tm->thread_registrations_by_name, name);
@@ -335,6 +335,9 @@ typedef struct
   /* scheduling policy priority */
   u32 sched_priority;
 
+  /* workers cache small heap objects, see clib_mem_tcache_enable */
+  u8 mem_thread_cache;
+
   /* callbacks */
   vlib_thread_callbacks_t cb;
   int extern_thread_mgmt;
@@ -197,6 +197,32 @@ _vnet_rewrite_two_headers (const vnet_rewrite_header_t * h0,
     }
 }
 
+/*
+ * Copy a rewrite onto a packet with a fixed-size move for the common
+ * Ethernet, 802.1q and QinQ header lengths, so the copy does not depend
+ * on a guess of the most likely size.
+ */
+always_inline void
+_vnet_rewrite_one_header_sized (const vnet_rewrite_header_t * h0,
+				void *packet0)
+{
+  /* 0xfefe => poisoned adjacency => crash */
+  ASSERT (h0->data_bytes != 0xfefe);
+  switch (h0->data_bytes)
+    {
+#define _(n)								\
+    case n:								\
+      clib_memcpy_fast ((u8 *) packet0 - n, h0->data, n);		\
+      break;
+      _(14) _(18) _(22)
+#undef _
+    default:
+      clib_memcpy_fast ((u8 *) packet0 - h0->data_bytes,
+			h0->data, h0->data_bytes);
+      break;
+    }
+}
+
 #define vnet_rewrite_one_header(rw0,p0,most_likely_size)	\
   _vnet_rewrite_one_header (&((rw0).rewrite_header), (p0),	\
 			    (most_likely_size))
@@ -206,6 +232,21 @@ _vnet_rewrite_two_headers (const vnet_rewrite_header_t * h0,
 			     (p0), (p1),				\
 			     (most_likely_size))
 
+#define vnet_rewrite_one_header_sized(rw0,p0)				\
+  _vnet_rewrite_one_header_sized (&((rw0).rewrite_header), (p0))
+
+/*
+ * Number of packets the ip4/ip6 rewrite nodes handle per vector batch
+ * when TTL, checksum and MTU are processed in wide registers.
+ */
+#if CLIB_ARCH_IS_LITTLE_ENDIAN && defined (CLIB_HAVE_VEC512)
+#define VNET_REWRITE_VEC_SIZE 16
+typedef u32x16 vnet_rewrite_vec_t;
+#elif CLIB_ARCH_IS_LITTLE_ENDIAN && defined (CLIB_HAVE_VEC256)
+#define VNET_REWRITE_VEC_SIZE 8
+typedef u32x8 vnet_rewrite_vec_t;
+#endif
+
 always_inline void
 vnet_ip_mcast_fixup_header (u32 dst_mcast_mask,
 			    u32 dst_mcast_offset, u32 * addr, u8 * packet0)
@@ -56,7 +56,7 @@ VLIB_NODE_FN (ip4_cop_whitelist_node) (vlib_main_t * vm,
   u32 n_left_from, * from, * to_next;
   cop_feature_type_t next_index;
   cop_main_t *cm = &cop_main;
-  vlib_combined_counter_main_t * vcm = &load_balance_main.lbm_via_counters;
+  load_balance_main_t * lbm = &load_balance_main;
   u32 thread_index = vm->thread_index;
 
   from = vlib_frame_vector_args (frame);
@@ -173,13 +173,17 @@ VLIB_NODE_FN (ip4_cop_whitelist_node) (vlib_main_t * vm,
 	  lb1 = load_balance_get (lb_index1);
           dpo1 = load_balance_get_bucket_i(lb1, 0);
 
-          vlib_increment_combined_counter
-              (vcm, thread_index, lb_index0, 1,
+          load_balance_counter_increment_i
+              (&lbm->lbm_via_counters,
+               &lbm->lbm_per_thread[thread_index].lbpt_via_countdown,
+               thread_index, lb_index0,
                vlib_buffer_length_in_chain (vm, b0)
                + sizeof(ethernet_header_t));
 
-          vlib_increment_combined_counter
-              (vcm, thread_index, lb_index1, 1,
+          load_balance_counter_increment_i
+              (&lbm->lbm_via_counters,
+               &lbm->lbm_per_thread[thread_index].lbpt_via_countdown,
+               thread_index, lb_index1,
                vlib_buffer_length_in_chain (vm, b1)
                + sizeof(ethernet_header_t));
 
@@ -269,9 +273,11 @@ VLIB_NODE_FN (ip4_cop_whitelist_node) (vlib_main_t * vm,
 	  lb0 = load_balance_get (lb_index0);
           dpo0 = load_balance_get_bucket_i(lb0, 0);
 
-          vlib_increment_combined_counter 
-              (vcm, thread_index, lb_index0, 1,
-               vlib_buffer_length_in_chain (vm, b0) 
+          load_balance_counter_increment_i
+              (&lbm->lbm_via_counters,
+               &lbm->lbm_per_thread[thread_index].lbpt_via_countdown,
+               thread_index, lb_index0,
+               vlib_buffer_length_in_chain (vm, b0)
                + sizeof(ethernet_header_t));
 
           if (PREDICT_FALSE(dpo0->dpoi_type != DPO_RECEIVE))
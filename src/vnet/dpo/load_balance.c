@@ -61,9 +61,13 @@ load_balance_main_t load_balance_main = {
     .lbm_via_counters = {
         .name = "route-via",
         .stat_segment_name = "/net/route/via",
-    }
+    },
+    .lbm_counter_mode = LOAD_BALANCE_COUNTER_MODE_FULL,
+    .lbm_sample_interval = 1,
 };
 
+static const char *load_balance_counter_mode_names[] = LOAD_BALANCE_COUNTER_MODES;
+
 f64
 load_balance_get_multipath_tolerance (void)
 {
@@ -951,6 +955,47 @@ const static char* const * const load_balance_nodes[DPO_PROTO_NUM] =
     [DPO_PROTO_BIER] = load_balance_bier_nodes,
 };
 
+u8*
+format_load_balance_counter_mode (u8 * s, va_list * args)
+{
+    load_balance_counter_mode_t mode = va_arg(*args, int);
+
+    return (format(s, "%s", load_balance_counter_mode_names[mode]));
+}
+
+/**
+ * Set how packets are accounted to the per-route counters.
+ * The counters are cleared so the values from one mode are not mixed
+ * with those of another.
+ */
+void
+load_balance_set_counter_mode (load_balance_counter_mode_t mode,
+                               u32 sample_interval)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+    load_balance_per_thread_t *lbpt;
+
+    ASSERT(LOAD_BALANCE_COUNTER_MODE_SAMPLED != mode || sample_interval);
+
+    vec_validate_aligned(lbm->lbm_per_thread,
+                         vlib_get_thread_main()->n_vlib_mains - 1,
+                         CLIB_CACHE_LINE_BYTES);
+
+    lbm->lbm_counter_mode = mode;
+    lbm->lbm_sample_interval = (LOAD_BALANCE_COUNTER_MODE_SAMPLED == mode ?
+                                sample_interval :
+                                1);
+
+    vec_foreach(lbpt, lbm->lbm_per_thread)
+    {
+        lbpt->lbpt_to_countdown = lbm->lbm_sample_interval;
+        lbpt->lbpt_via_countdown = lbm->lbm_sample_interval;
+    }
+
+    vlib_clear_combined_counters(&lbm->lbm_to_counters);
+    vlib_clear_combined_counters(&lbm->lbm_via_counters);
+}
+
 void
 load_balance_module_init (void)
 {
@@ -970,6 +1015,10 @@ load_balance_module_init (void)
     load_balance_logger =
         vlib_log_register_class("dpo", "load-balance");
 
+    vec_validate_aligned(load_balance_main.lbm_per_thread,
+                         vlib_get_thread_main()->n_vlib_mains - 1,
+                         CLIB_CACHE_LINE_BYTES);
+
     load_balance_map_module_init();
 }
 
@@ -1002,8 +1051,19 @@ load_balance_show (vlib_main_t * vm,
     }
     else
     {
+        load_balance_main_t *lbm = &load_balance_main;
         load_balance_t *lb;
 
+        if (LOAD_BALANCE_COUNTER_MODE_SAMPLED == lbm->lbm_counter_mode)
+            vlib_cli_output (vm, "counters: %U, 1 in %d packets",
+                             format_load_balance_counter_mode,
+                             lbm->lbm_counter_mode,
+                             lbm->lbm_sample_interval);
+        else
+            vlib_cli_output (vm, "counters: %U",
+                             format_load_balance_counter_mode,
+                             lbm->lbm_counter_mode);
+
         pool_foreach(lb, load_balance_pool,
         ({
             vlib_cli_output (vm, "%U", format_load_balance,
@@ -38,6 +38,45 @@
 #include <vnet/fib/fib_types.h>
 #include <vnet/fib/fib_entry.h>
 
+/**
+ * The modes in which the per-route (i.e. per load-balance) counters
+ * account the packets that are forwarded via the load-balance.
+ */
+typedef enum load_balance_counter_mode_t_ {
+    /**
+     * No accounting
+     */
+    LOAD_BALANCE_COUNTER_MODE_OFF,
+    /**
+     * Account 1 in every N packets and scale the counts by N
+     */
+    LOAD_BALANCE_COUNTER_MODE_SAMPLED,
+    /**
+     * Account every packet
+     */
+    LOAD_BALANCE_COUNTER_MODE_FULL,
+} load_balance_counter_mode_t;
+
+#define LOAD_BALANCE_COUNTER_MODES {                    \
+    [LOAD_BALANCE_COUNTER_MODE_OFF] = "off",            \
+    [LOAD_BALANCE_COUNTER_MODE_SAMPLED] = "sampled",    \
+    [LOAD_BALANCE_COUNTER_MODE_FULL] = "full",          \
+}
+
+/**
+ * Per-thread state for the sampled counter mode
+ */
+typedef struct load_balance_per_thread_t_
+{
+    CLIB_CACHE_LINE_ALIGN_MARK(cacheline0);
+
+    /**
+     * Number of packets until the next sample of the to/via counters
+     */
+    u32 lbpt_to_countdown;
+    u32 lbpt_via_countdown;
+} load_balance_per_thread_t;
+
 /**
  * Load-balance main
  */
@@ -45,6 +84,21 @@ typedef struct load_balance_main_t_
 {
     vlib_combined_counter_main_t lbm_to_counters;
     vlib_combined_counter_main_t lbm_via_counters;
+
+    /**
+     * How the counters are maintained
+     */
+    load_balance_counter_mode_t lbm_counter_mode;
+
+    /**
+     * In sampled mode, the 1 in N packets that are counted
+     */
+    u32 lbm_sample_interval;
+
+    /**
+     * per-thread sampling state
+     */
+    load_balance_per_thread_t *lbm_per_thread;
 } load_balance_main_t;
 
 extern load_balance_main_t load_balance_main;
@@ -241,6 +295,75 @@ load_balance_get_bucket_i (const load_balance_t *lb,
     }
 }
 
+/**
+ * Account a packet to a load-balance counter in the configured mode
+ */
+static inline void
+load_balance_counter_increment_i (vlib_combined_counter_main_t *cm,
+                                  u32 *countdown,
+                                  u32 thread_index,
+                                  index_t lbi,
+                                  u32 n_bytes)
+{
+    const load_balance_main_t *lbm = &load_balance_main;
+
+    if (PREDICT_TRUE(LOAD_BALANCE_COUNTER_MODE_FULL == lbm->lbm_counter_mode))
+    {
+        vlib_increment_combined_counter(cm, thread_index, lbi, 1, n_bytes);
+    }
+    else if (LOAD_BALANCE_COUNTER_MODE_SAMPLED == lbm->lbm_counter_mode)
+    {
+        if (PREDICT_FALSE(0 == --(*countdown)))
+        {
+            *countdown = lbm->lbm_sample_interval;
+            vlib_increment_combined_counter(cm, thread_index, lbi,
+                                            lbm->lbm_sample_interval,
+                                            (u64) n_bytes *
+                                            lbm->lbm_sample_interval);
+        }
+    }
+}
+
+/**
+ * Account a packet that was looked up and found the load-balance
+ */
+static inline void
+load_balance_to_counter_increment (vlib_main_t *vm,
+                                   u32 thread_index,
+                                   index_t lbi,
+                                   vlib_buffer_t *b)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+
+    load_balance_counter_increment_i(
+        &lbm->lbm_to_counters,
+        &lbm->lbm_per_thread[thread_index].lbpt_to_countdown,
+        thread_index, lbi,
+        vlib_buffer_length_in_chain(vm, b));
+}
+
+/**
+ * Account a packet that was forwarded via the load-balance
+ */
+static inline void
+load_balance_via_counter_increment (vlib_main_t *vm,
+                                    u32 thread_index,
+                                    index_t lbi,
+                                    vlib_buffer_t *b)
+{
+    load_balance_main_t *lbm = &load_balance_main;
+
+    load_balance_counter_increment_i(
+        &lbm->lbm_via_counters,
+        &lbm->lbm_per_thread[thread_index].lbpt_via_countdown,
+        thread_index, lbi,
+        vlib_buffer_length_in_chain(vm, b));
+}
+
+extern void load_balance_set_counter_mode(load_balance_counter_mode_t mode,
+                                          u32 sample_interval);
+extern u8* format_load_balance_counter_mode(u8 * s, va_list * args);
+
 extern void load_balance_module_init(void);
 
 #endif
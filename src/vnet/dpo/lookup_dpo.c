@@ -331,7 +331,6 @@ lookup_dpo_ip4_inline (vlib_main_t * vm,
 {
     u32 n_left_from, next_index, * from, * to_next;
     u32 thread_index = vlib_get_thread_index();
-    vlib_combined_counter_main_t * cm = &load_balance_main.lbm_to_counters;
 
     from = vlib_frame_vector_args (from_frame);
     n_left_from = from_frame->n_vectors;
@@ -470,12 +469,8 @@ lookup_dpo_ip4_inline (vlib_main_t * vm,
 	    vnet_buffer(b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 	    vnet_buffer(b1)->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-	    vlib_increment_combined_counter
-		(cm, thread_index, lbi0, 1,
-		 vlib_buffer_length_in_chain (vm, b0));
-	    vlib_increment_combined_counter
-		(cm, thread_index, lbi1, 1,
-		 vlib_buffer_length_in_chain (vm, b1));
+	    load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
+	    load_balance_to_counter_increment (vm, thread_index, lbi1, b1);
 
             if (!(b0->flags & VNET_BUFFER_F_LOOP_COUNTER_VALID)) {
                 vnet_buffer2(b0)->loop_counter = 0;
@@ -591,9 +586,7 @@ lookup_dpo_ip4_inline (vlib_main_t * vm,
 	    next0 = dpo0->dpoi_next_node;
 	    vnet_buffer(b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-	    vlib_increment_combined_counter
-		(cm, thread_index, lbi0, 1,
-		 vlib_buffer_length_in_chain (vm, b0));
+	    load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
 
             if (!(b0->flags & VNET_BUFFER_F_LOOP_COUNTER_VALID)) {
                 vnet_buffer2(b0)->loop_counter = 0;
@@ -686,7 +679,6 @@ lookup_dpo_ip6_inline (vlib_main_t * vm,
                        int input_src_addr,
                        int table_from_interface)
 {
-    vlib_combined_counter_main_t * cm = &load_balance_main.lbm_to_counters;
     u32 n_left_from, next_index, * from, * to_next;
     u32 thread_index = vlib_get_thread_index();
 
@@ -847,12 +839,8 @@ lookup_dpo_ip6_inline (vlib_main_t * vm,
 	    vnet_buffer(b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 	    vnet_buffer(b1)->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-	    vlib_increment_combined_counter
-		(cm, thread_index, lbi0, 1,
-		 vlib_buffer_length_in_chain (vm, b0));
-	    vlib_increment_combined_counter
-		(cm, thread_index, lbi1, 1,
-		 vlib_buffer_length_in_chain (vm, b1));
+	    load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
+	    load_balance_to_counter_increment (vm, thread_index, lbi1, b1);
 
 	    if (PREDICT_FALSE(b0->flags & VLIB_BUFFER_IS_TRACED))
 	    {
@@ -961,9 +949,7 @@ lookup_dpo_ip6_inline (vlib_main_t * vm,
             if (PREDICT_FALSE(vnet_buffer2(b0)->loop_counter > MAX_LUKPS_PER_PACKET))
                 next0 = IP_LOOKUP_NEXT_DROP;
 
-	    vlib_increment_combined_counter
-		(cm, thread_index, lbi0, 1,
-		 vlib_buffer_length_in_chain (vm, b0));
+	    load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
 
 	    if (PREDICT_FALSE(b0->flags & VLIB_BUFFER_IS_TRACED))
 	    {
@@ -1031,7 +1017,6 @@ lookup_dpo_mpls_inline (vlib_main_t * vm,
 {
     u32 n_left_from, next_index, * from, * to_next;
     u32 thread_index = vlib_get_thread_index();
-    vlib_combined_counter_main_t * cm = &load_balance_main.lbm_to_counters;
 
     from = vlib_frame_vector_args (from_frame);
     n_left_from = from_frame->n_vectors;
@@ -1122,9 +1107,7 @@ lookup_dpo_mpls_inline (vlib_main_t * vm,
 
                 vnet_buffer (b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-                vlib_increment_combined_counter
-                    (cm, thread_index, lbi0, 1,
-                     vlib_buffer_length_in_chain (vm, b0));
+                load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
             }
 
             vnet_buffer (b0)->mpls.ttl = ((char*)hdr0)[3];
@@ -31,6 +31,8 @@
 #include <vnet/fib/fib_entry_delegate.h>
 #include <vnet/fib/fib_entry_track.h>
 
+#include <vpp/stats/stat_segment.h>
+
 /*
  * Array of strings/names for the FIB sources
  */
@@ -316,6 +318,7 @@ fib_entry_back_walk_notify (fib_node_t *node,
 	fib_entry_src_action_reactivate(fib_entry,
                                         fib_entry_get_best_source(
                                             fib_entry_get_index(fib_entry)));
+        fib_pic_stats.fps_n_entry_restacks++;
     }
 
     /*
@@ -1736,6 +1739,117 @@ fib_table_assert_empty (const fib_table_t *fib_table)
 }
 #endif
 
+/**
+ * Export the name of each route, i.e. its table-id and prefix, to the
+ * stats segment, indexed by the route's load-balance. This allows the
+ * collectors to read the per-route counters without an API dump.
+ */
+static int fib_entry_stats_export;
+
+void
+fib_entry_stats_name_update (const fib_entry_t *fib_entry,
+                             int is_add)
+{
+    u8 *s;
+
+    if (!fib_entry_stats_export ||
+        DPO_LOAD_BALANCE != fib_entry->fe_lb.dpoi_type)
+        return;
+
+    s = NULL;
+
+    if (is_add)
+        s = format(s, "%d:%U",
+                   fib_table_get_table_id(fib_entry->fe_fib_index,
+                                          fib_entry->fe_prefix.fp_proto),
+                   format_fib_prefix, &fib_entry->fe_prefix);
+
+    stat_segment_set_route_name(fib_entry->fe_lb.dpoi_index, s);
+    vec_free(s);
+}
+
+static void
+fib_entry_stats_export_set (int enable)
+{
+    fib_entry_t *fib_entry;
+
+    if (enable == fib_entry_stats_export)
+        return;
+
+    /*
+     * when disabling, remove the names whilst the export is still on
+     */
+    fib_entry_stats_export = 1;
+
+    pool_foreach(fib_entry, fib_entry_pool,
+    ({
+        if (dpo_id_is_valid(&fib_entry->fe_lb))
+            fib_entry_stats_name_update(fib_entry, enable);
+    }));
+
+    fib_entry_stats_export = enable;
+}
+
+static clib_error_t *
+set_fib_counters_command (vlib_main_t * vm,
+                          unformat_input_t * input,
+                          vlib_cli_command_t * cmd)
+{
+    load_balance_counter_mode_t mode;
+    u32 interval;
+    int export;
+
+    mode = load_balance_main.lbm_counter_mode;
+    interval = load_balance_main.lbm_sample_interval;
+    export = fib_entry_stats_export;
+
+    while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+        if (unformat (input, "off"))
+            mode = LOAD_BALANCE_COUNTER_MODE_OFF;
+        else if (unformat (input, "full"))
+            mode = LOAD_BALANCE_COUNTER_MODE_FULL;
+        else if (unformat (input, "sampled %d", &interval))
+            mode = LOAD_BALANCE_COUNTER_MODE_SAMPLED;
+        else if (unformat (input, "export"))
+            export = 1;
+        else if (unformat (input, "no-export"))
+            export = 0;
+        else
+            return (clib_error_return (0, "unknown input '%U'",
+                                       format_unformat_error, input));
+    }
+
+    if (LOAD_BALANCE_COUNTER_MODE_SAMPLED == mode && 0 == interval)
+        return (clib_error_return (0, "sample interval must be non-zero"));
+
+    if (mode != load_balance_main.lbm_counter_mode ||
+        interval != load_balance_main.lbm_sample_interval)
+        load_balance_set_counter_mode(mode, interval);
+
+    fib_entry_stats_export_set(LOAD_BALANCE_COUNTER_MODE_OFF != mode &&
+                               export);
+
+    return (NULL);
+}
+
+/*?
+ * The '<em>set fib counters</em>' command selects how packets are
+ * accounted to the per-route counters; not at all, 1 in every N packets
+ * with the counts scaled by N, or every packet (the default).
+ * With 'export', the name of each route is published in the stats
+ * segment at /net/route/names, with the same index as the route's
+ * counters in /net/route/to and /net/route/via.
+ *
+ * @cliexpar
+ * @cliexcmd{set fib counters sampled 64 export}
+?*/
+VLIB_CLI_COMMAND (set_fib_counters, static) = {
+  .path = "set fib counters",
+  .function = set_fib_counters_command,
+  .short_help = "set fib counters [off|full|sampled <N>] [export|no-export]",
+};
+
 static clib_error_t *
 show_fib_entry_command (vlib_main_t * vm,
 			unformat_input_t * input,
@@ -715,6 +715,7 @@ fib_entry_src_action_install (fib_entry_t *fib_entry,
        fib_table_fwding_dpo_update(fib_entry->fe_fib_index,
                                    &fib_entry->fe_prefix,
                                    &fib_entry->fe_lb);
+       fib_entry_stats_name_update(fib_entry, 1);
     }
 
     /*
@@ -746,6 +747,7 @@ fib_entry_src_action_uninstall (fib_entry_t *fib_entry)
 	    fib_entry->fe_fib_index,
 	    &fib_entry->fe_prefix,
 	    &fib_entry->fe_lb);
+        fib_entry_stats_name_update(fib_entry, 0);
 
 	dpo_reset(&fib_entry->fe_lb);
     }
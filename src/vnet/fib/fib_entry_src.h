@@ -329,6 +329,8 @@ extern fib_path_list_flags_t fib_entry_src_flags_2_path_list_flags(
 extern fib_forward_chain_type_t fib_entry_chain_type_fixup(const fib_entry_t *entry,
                                                            fib_forward_chain_type_t fct);
 
+extern void fib_entry_stats_name_update(const fib_entry_t *fib_entry,
+                                        int is_add);
 extern void fib_entry_src_mk_lb (fib_entry_t *fib_entry,
 				 const fib_entry_src_t *esrc,
 				 fib_forward_chain_type_t fct,
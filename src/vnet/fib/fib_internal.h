@@ -61,5 +61,43 @@ extern void fib_table_fwding_dpo_remove(u32 fib_index,
 					const fib_prefix_t *prefix,
 					const dpo_id_t *dpo);
 
+/**
+ * @brief
+ *  Prefix Independent Convergence (PIC) core statistics.
+ * Counts the work done by the back-walks that result from a change in the
+ * forwarding of a recursive path's via-entry, i.e. an IGP change beneath
+ * a set of BGP next-hops.
+ */
+typedef struct fib_pic_stats_t_
+{
+    /**
+     * Number of recursive paths re-evaluated
+     */
+    u64 fps_n_path_evals;
+
+    /**
+     * Number of path-list walks suppressed because the path-list's
+     * forwarding was unchanged
+     */
+    u64 fps_n_walks_suppressed;
+
+    /**
+     * Number of path-list children not visited as a result
+     */
+    u64 fps_n_children_spared;
+
+    /**
+     * Number of path-list walks propagated to the children
+     */
+    u64 fps_n_walks_propagated;
+
+    /**
+     * Number of entries whose forwarding was restacked by a back-walk
+     */
+    u64 fps_n_entry_restacks;
+} fib_pic_stats_t;
+
+extern fib_pic_stats_t fib_pic_stats;
+
 
 #endif
@@ -1005,6 +1005,12 @@ fib_path_back_walk_notify (fib_node_t *node,
     case FIB_PATH_TYPE_RECURSIVE:
 	if (FIB_NODE_BW_REASON_FLAG_EVALUATE & ctx->fnbw_reason)
 	{
+            fib_path_oper_flags_t old_flags;
+            dpo_id_t old_dpo = DPO_INVALID;
+
+            old_flags = path->fp_oper_flags;
+            dpo_copy(&old_dpo, &path->fp_dpo);
+
 	    /*
 	     * modify the recursive adjacency to use the new forwarding
 	     * of the via-fib.
@@ -1014,6 +1020,24 @@ fib_path_back_walk_notify (fib_node_t *node,
 		path,
 		fib_path_to_chain_type(path),
 		&path->fp_dpo);
+
+            fib_pic_stats.fps_n_path_evals++;
+
+            if ((FIB_NODE_BW_REASON_FLAG_EVALUATE == ctx->fnbw_reason) &&
+                (old_flags == path->fp_oper_flags) &&
+                (0 == dpo_cmp(&old_dpo, &path->fp_dpo)))
+            {
+                /*
+                 * the path still contributes the via-entry's load-balance,
+                 * which has been updated in place. PIC core; the
+                 * path-list's children need not restack.
+                 */
+                dpo_reset(&old_dpo);
+                fib_path_list_back_walk_pic(path->fp_pl_index, ctx);
+
+                return (FIB_NODE_BACK_WALK_CONTINUE);
+            }
+            dpo_reset(&old_dpo);
 	}
 	if ((FIB_NODE_BW_REASON_FLAG_ADJ_UPDATE & ctx->fnbw_reason) ||
             (FIB_NODE_BW_REASON_FLAG_ADJ_DOWN   & ctx->fnbw_reason))
@@ -144,6 +144,7 @@ void
 fib_urpf_list_bake (index_t ui)
 {
     fib_urpf_list_t *urpf;
+    u32 i, j;
 
     urpf = fib_urpf_list_get(ui);
 
@@ -151,7 +152,6 @@ fib_urpf_list_bake (index_t ui)
 
     if (vec_len(urpf->furpf_itfs) > 1)
       {
-        u32 i, j;
         /*
          * cat list | sort | uniq > rpf_list
          */
@@ -166,9 +166,42 @@ fib_urpf_list_bake (index_t ui)
         _vec_len(urpf->furpf_itfs) = i+1;
       }
 
+    urpf->furpf_itf_mask = 0;
+    for (i = 0; i < vec_len(urpf->furpf_itfs); i++)
+    {
+        if (urpf->furpf_itfs[i] < FIB_URPF_LIST_ITF_MASK_BITS)
+            urpf->furpf_itf_mask |= ((uword) 1 << urpf->furpf_itfs[i]);
+    }
+
     urpf->furpf_flags |= FIB_URPF_LIST_BAKED;
 }
 
+/**
+ * @brief Compare the interface sets of two baked uRPF lists.
+ */
+int
+fib_urpf_list_is_equal (index_t ui1,
+                        index_t ui2)
+{
+    fib_urpf_list_t *urpf1, *urpf2;
+
+    if (ui1 == ui2)
+        return (1);
+    if (INDEX_INVALID == ui1 || INDEX_INVALID == ui2)
+        return (0);
+
+    urpf1 = fib_urpf_list_get(ui1);
+    urpf2 = fib_urpf_list_get(ui2);
+
+    ASSERT(urpf1->furpf_flags & FIB_URPF_LIST_BAKED);
+    ASSERT(urpf2->furpf_flags & FIB_URPF_LIST_BAKED);
+
+    return (vec_len(urpf1->furpf_itfs) == vec_len(urpf2->furpf_itfs) &&
+            (0 == vec_len(urpf1->furpf_itfs) ||
+             0 == memcmp(urpf1->furpf_itfs, urpf2->furpf_itfs,
+                         vec_bytes(urpf1->furpf_itfs))));
+}
+
 void
 fib_urpf_list_show_mem (void)
 {
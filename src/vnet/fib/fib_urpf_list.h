@@ -34,6 +34,10 @@
  * non-adjacency objects (i.e. load-balances, mpls-labels, etc) and potentially
  * the same adjacency many times (esp. when UCMP is used).
  * To that end the uRPF list is a collapsed, unique interface only list.
+ *
+ * Interfaces with a small index are also recorded in a one word bitmap,
+ * so the common strict check is a single shift and mask; only interfaces
+ * beyond the bitmap need the list to be searched.
  */
 
 #ifndef __FIB_URPF_LIST_H__
@@ -62,6 +66,12 @@ typedef struct fib_urpf_list_t_
      */
     adj_index_t *furpf_itfs;
 
+    /**
+     * Bitmap of the interfaces in the list whose index is less than
+     * FIB_URPF_LIST_ITF_MASK_BITS
+     */
+    uword furpf_itf_mask;
+
     /**
      * flags
      */
@@ -74,6 +84,11 @@ typedef struct fib_urpf_list_t_
     u32 furpf_locks;
 } fib_urpf_list_t;
 
+/**
+ * @brief The number of interfaces covered by the list's bitmap
+ */
+#define FIB_URPF_LIST_ITF_MASK_BITS BITS(uword)
+
 extern index_t fib_urpf_list_alloc_and_lock(void);
 extern void fib_urpf_list_unlock(index_t urpf);
 extern void fib_urpf_list_lock(index_t urpf);
@@ -82,6 +97,7 @@ extern void fib_urpf_list_append(index_t urpf, adj_index_t adj);
 extern void fib_urpf_list_combine(index_t urpf1, index_t urpf2);
 
 extern void fib_urpf_list_bake(index_t urpf);
+extern int fib_urpf_list_is_equal(index_t urpf1, index_t urpf2);
 
 extern u8 *format_fib_urpf_list(u8 *s, va_list *ap);
 
@@ -115,6 +131,9 @@ fib_urpf_check (index_t ui, u32 sw_if_index)
 
     urpf = fib_urpf_list_get(ui);
 
+    if (PREDICT_TRUE(sw_if_index < FIB_URPF_LIST_ITF_MASK_BITS))
+	return ((urpf->furpf_itf_mask >> sw_if_index) & 1);
+
     vec_foreach(swi, urpf->furpf_itfs)
     {
 	if (*swi == sw_if_index)
@@ -109,21 +109,22 @@ vnet_flow_enable (vnet_main_t * vnm, u32 flow_index, u32 hw_if_index)
   hi = vnet_get_hw_interface (vnm, hw_if_index);
   dev_class = vnet_get_device_class (vnm, hi->dev_class_index);
 
+  /* devices that cannot offload get the software emulation */
   if (dev_class->flow_ops_function == 0)
-    return VNET_FLOW_ERROR_NOT_SUPPORTED;
-
-  if (f->actions & VNET_FLOW_ACTION_REDIRECT_TO_NODE)
+    rv = vnet_flow_sw_ops (vnm, VNET_FLOW_DEV_OP_ADD_FLOW,
+			   hw_if_index, flow_index, &private_data);
+  else
     {
-      vnet_hw_interface_t *hw = vnet_get_hw_interface (vnm, hw_if_index);
-      f->redirect_device_input_next_index =
-	vlib_node_add_next (vnm->vlib_main, hw->input_node_index,
-			    f->redirect_node_index);
+      if (f->actions & VNET_FLOW_ACTION_REDIRECT_TO_NODE)
+	f->redirect_device_input_next_index =
+	  vlib_node_add_next (vnm->vlib_main, hi->input_node_index,
+			      f->redirect_node_index);
+
+      rv = dev_class->flow_ops_function (vnm, VNET_FLOW_DEV_OP_ADD_FLOW,
+					 hi->dev_instance, flow_index,
+					 &private_data);
     }
 
-  rv = dev_class->flow_ops_function (vnm, VNET_FLOW_DEV_OP_ADD_FLOW,
-				     hi->dev_instance, flow_index,
-				     &private_data);
-
   if (rv)
     return rv;
 
@@ -153,8 +154,12 @@ vnet_flow_disable (vnet_main_t * vnm, u32 flow_index, u32 hw_if_index)
   hi = vnet_get_hw_interface (vnm, hw_if_index);
   dev_class = vnet_get_device_class (vnm, hi->dev_class_index);
 
-  rv = dev_class->flow_ops_function (vnm, VNET_FLOW_DEV_OP_DEL_FLOW,
-				     hi->dev_instance, flow_index, p);
+  if (dev_class->flow_ops_function == 0)
+    rv = vnet_flow_sw_ops (vnm, VNET_FLOW_DEV_OP_DEL_FLOW,
+			   hw_if_index, flow_index, p);
+  else
+    rv = dev_class->flow_ops_function (vnm, VNET_FLOW_DEV_OP_DEL_FLOW,
+				       hi->dev_instance, flow_index, p);
 
   if (rv)
     return rv;
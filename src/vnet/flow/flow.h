@@ -62,13 +62,13 @@
   _fe(ip4_address_t, src_addr) \
   _fe(ip4_address_t, dst_addr) \
   _fe(u16, dst_port) \
-  _fe(u16, vni)
+  _fe(u32, vni)
 
 #define foreach_flow_entry_ip6_vxlan \
   _fe(ip6_address_t, src_addr) \
   _fe(ip6_address_t, dst_addr) \
   _fe(u16, dst_port) \
-  _fe(u16, vni)
+  _fe(u32, vni)
 
 #define foreach_flow_entry_ip4_gtpc \
   foreach_flow_entry_ip4_n_tuple \
@@ -210,6 +210,11 @@ int vnet_flow_disable (vnet_main_t * vnm, u32 flow_index, u32 hw_if_index);
 int vnet_flow_del (vnet_main_t * vnm, u32 flow_index);
 vnet_flow_t *vnet_get_flow (u32 flow_index);
 
+/* software flow backend, used by interfaces without flow offload */
+int vnet_flow_sw_ops (vnet_main_t * vnm, vnet_flow_dev_op_t op,
+		      u32 hw_if_index, u32 flow_index, uword * private_data);
+u64 vnet_flow_sw_get_hits (u32 flow_index);
+
 typedef struct
 {
   u32 start;
@@ -165,6 +165,9 @@ show_flow_entry (vlib_main_t * vm, unformat_input_t * input,
 	  if (dev_class->format_flow)
 	    vlib_cli_output (vm,  "  %U\n", dev_class->format_flow,
 			     hi->dev_instance, f->index, private_data);
+	  else if (dev_class->flow_ops_function == 0)
+	    vlib_cli_output (vm, "  software, %llu hits\n",
+			     vnet_flow_sw_get_hits (f->index));
          }));
       /* *INDENT-ON* */
       return 0;
@@ -370,6 +373,8 @@ test_flow (vlib_main_t * vm, unformat_input_t * input,
 	flow.actions |= VNET_FLOW_ACTION_REDIRECT_TO_QUEUE;
       else if (unformat (line_input, "drop"))
 	flow.actions |= VNET_FLOW_ACTION_DROP;
+      else if (unformat (line_input, "count"))
+	flow.actions |= VNET_FLOW_ACTION_COUNT;
       else if (unformat (line_input, "%U", unformat_vnet_hw_interface, vnm,
 			 &hw_if_index))
 	;
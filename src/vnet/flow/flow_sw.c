@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Software flow offload.
+ *
+ * An emulation of a NIC's flow classifier for interfaces whose device
+ * class has no flow_ops_function. Enabled flows are matched, in the order
+ * they were enabled, by the flow-sw-offload node on the device-input
+ * feature arc and their actions (mark, buffer-advance, redirect-to-node,
+ * drop, count) applied exactly as a NIC would before the packet reaches
+ * the input node's next. This lets flow consumers such as the vxlan
+ * flow-input path be used and tested without offload capable hardware.
+ *
+ * vxlan is the only consumer of marks for now. NAT and ACL sessions do
+ * not request flows: their fast paths would need to map a mark back to
+ * a session and revalidate it on every hit, since sessions, unlike
+ * tunnels, come and go in the data plane and flow rules can't be
+ * programmed from the workers.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/ip/ip.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/udp/udp_packet.h>
+#include <vnet/vxlan/vxlan_packet.h>
+#include <vnet/feature/feature.h>
+#include <vnet/flow/flow.h>
+
+typedef struct
+{
+  /* flow indices enabled on each interface, in match order */
+  u32 **flows_by_sw_if_index;
+
+  /* flow-sw-offload node's next index, per flow, for redirect-to-node */
+  u32 *redirect_next_by_flow_index;
+
+  /* per-flow hit counters, for VNET_FLOW_ACTION_COUNT */
+  vlib_simple_counter_main_t hits;
+} vnet_flow_sw_main_t;
+
+static vnet_flow_sw_main_t flow_sw_main;
+
+#define foreach_flow_sw_error			\
+  _(MATCHED, "flow matched")			\
+  _(DROP, "flow drop action")
+
+typedef enum
+{
+#define _(sym,str) FLOW_SW_ERROR_##sym,
+  foreach_flow_sw_error
+#undef _
+    FLOW_SW_N_ERROR,
+} flow_sw_error_t;
+
+static char *flow_sw_error_strings[] = {
+#define _(sym,string) string,
+  foreach_flow_sw_error
+#undef _
+};
+
+typedef enum
+{
+  FLOW_SW_NEXT_DROP,
+  FLOW_SW_N_NEXT,
+} flow_sw_next_t;
+
+typedef struct
+{
+  u32 flow_index;
+  u32 next_index;
+} flow_sw_trace_t;
+
+static u8 *
+format_flow_sw_trace (u8 * s, va_list * args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  flow_sw_trace_t *t = va_arg (*args, flow_sw_trace_t *);
+
+  if (~0 == t->flow_index)
+    s = format (s, "flow-sw: no match, next %d", t->next_index);
+  else
+    s = format (s, "flow-sw: flow %d, next %d", t->flow_index,
+		t->next_index);
+  return s;
+}
+
+extern vlib_node_registration_t flow_sw_offload_node;
+
+static_always_inline int
+flow_sw_ports_match (vnet_flow_t * f, u8 protocol, void *l4,
+		     ip_port_and_mask_t * src, ip_port_and_mask_t * dst)
+{
+  udp_header_t *udp = l4;
+
+  if (IP_PROTOCOL_UDP != protocol && IP_PROTOCOL_TCP != protocol)
+    return (0 == src->mask && 0 == dst->mask);
+
+  /* tcp and udp ports are at the same offsets */
+  return (((clib_net_to_host_u16 (udp->src_port) ^ src->port) &
+	   src->mask) == 0 &&
+	  ((clib_net_to_host_u16 (udp->dst_port) ^ dst->port) &
+	   dst->mask) == 0);
+}
+
+static_always_inline int
+flow_sw_vxlan_match (udp_header_t * udp, u16 dst_port, u32 vni)
+{
+  vxlan_header_t *vxlan = (vxlan_header_t *) (udp + 1);
+
+  return (clib_net_to_host_u16 (udp->dst_port) == dst_port &&
+	  (vxlan->flags & VXLAN_FLAGS_I) && vnet_get_vni (vxlan) == vni);
+}
+
+static int
+flow_sw_match (vnet_flow_t * f, vlib_buffer_t * b)
+{
+  ethernet_header_t *eth = vlib_buffer_get_current (b);
+  u16 type = clib_net_to_host_u16 (eth->type);
+  ip4_header_t *ip4 = (ip4_header_t *) (eth + 1);
+  ip6_header_t *ip6 = (ip6_header_t *) (eth + 1);
+  u32 len = b->current_length;
+  /* ports, or the udp and vxlan headers, beyond the ip header */
+  u32 l4_len = sizeof (*eth) + 2 * sizeof (u16);
+  u32 vxlan_len = sizeof (*eth) + sizeof (udp_header_t) +
+    sizeof (vxlan_header_t);
+
+  if (len < sizeof (*eth))
+    return 0;
+
+  switch (f->type)
+    {
+    case VNET_FLOW_TYPE_ETHERNET:
+      return (type == f->ethernet.eth_hdr.type);
+
+    case VNET_FLOW_TYPE_IP4_N_TUPLE:
+      {
+	vnet_flow_ip4_n_tuple_t *t = &f->ip4_n_tuple;
+
+	if (ETHERNET_TYPE_IP4 != type || len < l4_len + sizeof (*ip4)
+	    || len < l4_len + ip4_header_bytes (ip4))
+	  return 0;
+	return (((ip4->src_address.as_u32 ^ t->src_addr.addr.as_u32) &
+		 t->src_addr.mask.as_u32) == 0 &&
+		((ip4->dst_address.as_u32 ^ t->dst_addr.addr.as_u32) &
+		 t->dst_addr.mask.as_u32) == 0 &&
+		ip4->protocol == t->protocol &&
+		flow_sw_ports_match (f, ip4->protocol,
+				     ip4_next_header (ip4),
+				     &t->src_port, &t->dst_port));
+      }
+
+    case VNET_FLOW_TYPE_IP6_N_TUPLE:
+      {
+	vnet_flow_ip6_n_tuple_t *t = &f->ip6_n_tuple;
+	int i;
+
+	if (ETHERNET_TYPE_IP6 != type || len < l4_len + sizeof (*ip6))
+	  return 0;
+	for (i = 0; i < 2; i++)
+	  if (((ip6->src_address.as_u64[i] ^ t->src_addr.addr.as_u64[i]) &
+	       t->src_addr.mask.as_u64[i]) ||
+	      ((ip6->dst_address.as_u64[i] ^ t->dst_addr.addr.as_u64[i]) &
+	       t->dst_addr.mask.as_u64[i]))
+	    return 0;
+	return (ip6->protocol == t->protocol &&
+		flow_sw_ports_match (f, ip6->protocol, ip6 + 1,
+				     &t->src_port, &t->dst_port));
+      }
+
+    case VNET_FLOW_TYPE_IP4_VXLAN:
+      {
+	vnet_flow_ip4_vxlan_t *v = &f->ip4_vxlan;
+
+	if (ETHERNET_TYPE_IP4 != type || len < vxlan_len + sizeof (*ip4)
+	    || len < vxlan_len + ip4_header_bytes (ip4))
+	  return 0;
+	return (ip4->src_address.as_u32 == v->src_addr.as_u32 &&
+		ip4->dst_address.as_u32 == v->dst_addr.as_u32 &&
+		ip4->protocol == IP_PROTOCOL_UDP &&
+		flow_sw_vxlan_match (ip4_next_header (ip4), v->dst_port,
+				     v->vni));
+      }
+
+    case VNET_FLOW_TYPE_IP6_VXLAN:
+      {
+	vnet_flow_ip6_vxlan_t *v = &f->ip6_vxlan;
+
+	if (ETHERNET_TYPE_IP6 != type || len < vxlan_len + sizeof (*ip6))
+	  return 0;
+	return (ip6_address_is_equal (&ip6->src_address, &v->src_addr) &&
+		ip6_address_is_equal (&ip6->dst_address, &v->dst_addr) &&
+		ip6->protocol == IP_PROTOCOL_UDP &&
+		flow_sw_vxlan_match ((udp_header_t *) (ip6 + 1),
+				     v->dst_port, v->vni));
+      }
+
+    default:
+      break;
+    }
+
+  return 0;
+}
+
+static_always_inline u32
+flow_sw_offload_one (vlib_main_t * vm, vlib_node_runtime_t * node,
+		     vlib_buffer_t * b, u32 * n_matched)
+{
+  vnet_flow_sw_main_t *fsm = &flow_sw_main;
+  u32 *flow_index, sw_if_index, next;
+  vnet_flow_t *f;
+
+  sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
+
+  vec_foreach (flow_index, fsm->flows_by_sw_if_index[sw_if_index])
+  {
+    f = vnet_get_flow (*flow_index);
+
+    if (!flow_sw_match (f, b))
+      continue;
+
+    *n_matched += 1;
+
+    if (f->actions & VNET_FLOW_ACTION_COUNT)
+      vlib_increment_simple_counter (&fsm->hits, vm->thread_index,
+				     f->index, 1);
+    if (f->actions & VNET_FLOW_ACTION_MARK)
+      b->flow_id = f->mark_flow_id;
+    if (f->actions & VNET_FLOW_ACTION_BUFFER_ADVANCE)
+      vlib_buffer_advance (b, f->buffer_advance);
+
+    if (f->actions & VNET_FLOW_ACTION_DROP)
+      {
+	b->error = node->errors[FLOW_SW_ERROR_DROP];
+	next = FLOW_SW_NEXT_DROP;
+      }
+    else if (f->actions & VNET_FLOW_ACTION_REDIRECT_TO_NODE)
+      next = fsm->redirect_next_by_flow_index[f->index];
+    else
+      vnet_feature_next (&next, b);
+
+    if (PREDICT_FALSE (b->flags & VLIB_BUFFER_IS_TRACED))
+      {
+	flow_sw_trace_t *t = vlib_add_trace (vm, node, b, sizeof (*t));
+	t->flow_index = f->index;
+	t->next_index = next;
+      }
+    return next;
+  }
+
+  vnet_feature_next (&next, b);
+
+  if (PREDICT_FALSE (b->flags & VLIB_BUFFER_IS_TRACED))
+    {
+      flow_sw_trace_t *t = vlib_add_trace (vm, node, b, sizeof (*t));
+      t->flow_index = ~0;
+      t->next_index = next;
+    }
+  return next;
+}
+
+VLIB_NODE_FN (flow_sw_offload_node) (vlib_main_t * vm,
+				     vlib_node_runtime_t * node,
+				     vlib_frame_t * frame)
+{
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  u16 nexts[VLIB_FRAME_SIZE], *next;
+  u32 n_left, *from, n_matched = 0;
+
+  from = vlib_frame_vector_args (frame);
+  n_left = frame->n_vectors;
+  b = bufs;
+  next = nexts;
+
+  vlib_get_buffers (vm, from, bufs, n_left);
+
+  while (n_left > 0)
+    {
+      if (n_left > 2)
+	{
+	  vlib_prefetch_buffer_header (b[2], LOAD);
+	  vlib_prefetch_buffer_data (b[1], LOAD);
+	}
+
+      next[0] = flow_sw_offload_one (vm, node, b[0], &n_matched);
+
+      b += 1;
+      next += 1;
+      n_left -= 1;
+    }
+
+  vlib_node_increment_counter (vm, node->node_index, FLOW_SW_ERROR_MATCHED,
+			       n_matched);
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
+
+  return frame->n_vectors;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (flow_sw_offload_node) = {
+  .name = "flow-sw-offload",
+  .vector_size = sizeof (u32),
+  .format_trace = format_flow_sw_trace,
+  .type = VLIB_NODE_TYPE_INTERNAL,
+  .n_errors = FLOW_SW_N_ERROR,
+  .error_strings = flow_sw_error_strings,
+  .n_next_nodes = FLOW_SW_N_NEXT,
+  .next_nodes = {
+    [FLOW_SW_NEXT_DROP] = "error-drop",
+  },
+};
+
+VNET_FEATURE_INIT (flow_sw_offload, static) = {
+  .arc_name = "device-input",
+  .node_name = "flow-sw-offload",
+  .runs_before = VNET_FEATURES ("ethernet-input"),
+};
+/* *INDENT-ON* */
+
+static int
+flow_sw_add (vnet_main_t * vnm, vnet_hw_interface_t * hi, vnet_flow_t * f)
+{
+  vnet_flow_sw_main_t *fsm = &flow_sw_main;
+  u32 sw_if_index = hi->sw_if_index;
+
+  switch (f->type)
+    {
+    case VNET_FLOW_TYPE_ETHERNET:
+    case VNET_FLOW_TYPE_IP4_N_TUPLE:
+    case VNET_FLOW_TYPE_IP6_N_TUPLE:
+    case VNET_FLOW_TYPE_IP4_VXLAN:
+    case VNET_FLOW_TYPE_IP6_VXLAN:
+      break;
+    default:
+      return VNET_FLOW_ERROR_NOT_SUPPORTED;
+    }
+
+  if (f->actions & VNET_FLOW_ACTION_REDIRECT_TO_QUEUE)
+    return VNET_FLOW_ERROR_NOT_SUPPORTED;
+
+  if (f->actions & VNET_FLOW_ACTION_REDIRECT_TO_NODE)
+    {
+      vec_validate (fsm->redirect_next_by_flow_index, f->index);
+      fsm->redirect_next_by_flow_index[f->index] =
+	vlib_node_add_next (vnm->vlib_main, flow_sw_offload_node.index,
+			    f->redirect_node_index);
+    }
+
+  vlib_validate_simple_counter (&fsm->hits, f->index);
+  vlib_zero_simple_counter (&fsm->hits, f->index);
+
+  vec_validate (fsm->flows_by_sw_if_index, sw_if_index);
+  vec_add1 (fsm->flows_by_sw_if_index[sw_if_index], f->index);
+
+  if (1 == vec_len (fsm->flows_by_sw_if_index[sw_if_index]))
+    vnet_feature_enable_disable ("device-input", "flow-sw-offload",
+				 sw_if_index, 1, 0, 0);
+  return 0;
+}
+
+static int
+flow_sw_del (vnet_main_t * vnm, vnet_hw_interface_t * hi, u32 flow_index)
+{
+  vnet_flow_sw_main_t *fsm = &flow_sw_main;
+  u32 sw_if_index = hi->sw_if_index, pos;
+
+  if (sw_if_index >= vec_len (fsm->flows_by_sw_if_index))
+    return VNET_FLOW_ERROR_NO_SUCH_ENTRY;
+
+  pos = vec_search (fsm->flows_by_sw_if_index[sw_if_index], flow_index);
+  if (~0 == pos)
+    return VNET_FLOW_ERROR_NO_SUCH_ENTRY;
+
+  vec_delete (fsm->flows_by_sw_if_index[sw_if_index], 1, pos);
+
+  if (0 == vec_len (fsm->flows_by_sw_if_index[sw_if_index]))
+    vnet_feature_enable_disable ("device-input", "flow-sw-offload",
+				 sw_if_index, 0, 0, 0);
+  return 0;
+}
+
+int
+vnet_flow_sw_ops (vnet_main_t * vnm, vnet_flow_dev_op_t op,
+		  u32 hw_if_index, u32 flow_index, uword * private_data)
+{
+  vnet_flow_sw_main_t *fsm = &flow_sw_main;
+  vnet_hw_interface_t *hi = vnet_get_hw_interface (vnm, hw_if_index);
+  vnet_flow_t *f = vnet_get_flow (flow_index);
+
+  switch (op)
+    {
+    case VNET_FLOW_DEV_OP_ADD_FLOW:
+      *private_data = flow_index;
+      return flow_sw_add (vnm, hi, f);
+    case VNET_FLOW_DEV_OP_DEL_FLOW:
+      return flow_sw_del (vnm, hi, flow_index);
+    case VNET_FLOW_DEV_OP_GET_COUNTER:
+      *private_data = vlib_get_simple_counter (&fsm->hits, flow_index);
+      return 0;
+    case VNET_FLOW_DEV_OP_RESET_COUNTER:
+      vlib_zero_simple_counter (&fsm->hits, flow_index);
+      return 0;
+    }
+
+  return VNET_FLOW_ERROR_NOT_SUPPORTED;
+}
+
+u64
+vnet_flow_sw_get_hits (u32 flow_index)
+{
+  vnet_flow_sw_main_t *fsm = &flow_sw_main;
+
+  if (flow_index >= vlib_simple_counter_n_counters (&fsm->hits))
+    return 0;
+  return vlib_get_simple_counter (&fsm->hits, flow_index);
+}
+
+static clib_error_t *
+flow_sw_init (vlib_main_t * vm)
+{
+  vnet_flow_sw_main_t *fsm = &flow_sw_main;
+
+  fsm->hits.name = "flow-sw-hits";
+  fsm->hits.stat_segment_name = "/net/flow/sw-hits";
+
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (flow_sw_init);
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -61,6 +61,9 @@ vnet_sw_interface_gso_enable_disable (u32 sw_if_index, u8 enable)
   vnet_l2_feature_enable_disable ("l2-output-ip6", "gso-l2-ip6",
 				  sw_if_index, enable, 0, 0);
 
+  gso_main.sw_if_gso_enabled = clib_bitmap_set (gso_main.sw_if_gso_enabled,
+						sw_if_index, enable);
+
   return (0);
 }
 
@@ -38,12 +38,36 @@ typedef struct
   vlib_main_t *vlib_main;
   vnet_main_t *vnet_main;
   u16 msg_id_base;
+  /** sw interfaces with the gso feature enabled */
+  uword *sw_if_gso_enabled;
 } gso_main_t;
 
 extern gso_main_t gso_main;
 
 int vnet_sw_interface_gso_enable_disable (u32 sw_if_index, u8 enable);
 
+/**
+ * Check if packets sent on interface go through the gso node, i.e., if
+ * super segments are segmented in software whenever the interface can't.
+ */
+static_always_inline int
+vnet_sw_interface_gso_is_enabled (u32 sw_if_index)
+{
+  return clib_bitmap_get (gso_main.sw_if_gso_enabled, sw_if_index);
+}
+
+/**
+ * Udp super segments are always segmented by the gso node because
+ * interfaces only advertise tcp segmentation offload. Tcp headers are
+ * at least 20 bytes so the l4 header size identifies them.
+ */
+static_always_inline int
+vnet_buffer_is_udp_gso (vlib_buffer_t * b)
+{
+  return ((b->flags & VNET_BUFFER_F_GSO)
+	  && vnet_buffer2 (b)->gso_l4_hdr_sz == sizeof (udp_header_t));
+}
+
 static_always_inline gso_header_offset_t
 vnet_gso_header_offset_parser (vlib_buffer_t * b0, int is_ip6)
 {
@@ -95,7 +95,7 @@ tso_init_buf_from_template (vlib_main_t * vm, vlib_buffer_t * nb0,
 			    vlib_buffer_t * b0, u16 template_data_sz,
 			    u16 gso_size, u8 ** p_dst_ptr, u16 * p_dst_left,
 			    u32 next_tcp_seq, u32 flags,
-			    gso_header_offset_t * gho)
+			    gso_header_offset_t * gho, int is_udp)
 {
   tso_init_buf_from_template_base (nb0, b0, flags, template_data_sz);
 
@@ -105,6 +105,9 @@ tso_init_buf_from_template (vlib_main_t * vm, vlib_buffer_t * nb0,
 							nb0->current_data));
   *p_dst_ptr = vlib_buffer_get_current (nb0) + template_data_sz;
 
+  if (is_udp)
+    return;
+
   tcp_header_t *tcp =
     (tcp_header_t *) (vlib_buffer_get_current (nb0) + gho->l4_hdr_offset);
   tcp->seq_number = clib_host_to_net_u32 (next_tcp_seq);
@@ -112,16 +115,27 @@ tso_init_buf_from_template (vlib_main_t * vm, vlib_buffer_t * nb0,
 
 static_always_inline void
 tso_fixup_segmented_buf (vlib_buffer_t * b0, u8 tcp_flags, int is_ip6,
-			 gso_header_offset_t * gho)
+			 gso_header_offset_t * gho, int is_udp)
 {
   ip4_header_t *ip4 =
     (ip4_header_t *) (vlib_buffer_get_current (b0) + gho->l3_hdr_offset);
   ip6_header_t *ip6 =
     (ip6_header_t *) (vlib_buffer_get_current (b0) + gho->l3_hdr_offset);
-  tcp_header_t *tcp =
-    (tcp_header_t *) (vlib_buffer_get_current (b0) + gho->l4_hdr_offset);
 
-  tcp->flags = tcp_flags;
+  if (is_udp)
+    {
+      udp_header_t *udp =
+	(udp_header_t *) (vlib_buffer_get_current (b0) + gho->l4_hdr_offset);
+      udp->length =
+	clib_host_to_net_u16 (b0->current_length -
+			      (gho->l4_hdr_offset - gho->l2_hdr_offset));
+    }
+  else
+    {
+      tcp_header_t *tcp =
+	(tcp_header_t *) (vlib_buffer_get_current (b0) + gho->l4_hdr_offset);
+      tcp->flags = tcp_flags;
+    }
 
   if (is_ip6)
     ip6->payload_length =
@@ -154,14 +168,18 @@ tso_segment_buffer (vlib_main_t * vm, vnet_interface_per_thread_data_t * ptd,
   u8 save_tcp_flags = 0;
   u8 tcp_flags_no_fin_psh = 0;
   u32 next_tcp_seq = 0;
+  int is_udp = vnet_buffer_is_udp_gso (sb0);
 
-  tcp_header_t *tcp =
-    (tcp_header_t *) (vlib_buffer_get_current (sb0) + gho->l4_hdr_offset);
-  next_tcp_seq = clib_net_to_host_u32 (tcp->seq_number);
-  /* store original flags for last packet and reset FIN and PSH */
-  save_tcp_flags = tcp->flags;
-  tcp_flags_no_fin_psh = tcp->flags & ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
-  tcp->checksum = 0;
+  if (!is_udp)
+    {
+      tcp_header_t *tcp = (tcp_header_t *) (vlib_buffer_get_current (sb0) +
+					    gho->l4_hdr_offset);
+      next_tcp_seq = clib_net_to_host_u32 (tcp->seq_number);
+      /* store original flags for last packet and reset FIN and PSH */
+      save_tcp_flags = tcp->flags;
+      tcp_flags_no_fin_psh = tcp->flags & ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+      tcp->checksum = 0;
+    }
 
   u32 default_bflags =
     sb0->flags & ~(VNET_BUFFER_F_GSO | VLIB_BUFFER_NEXT_PRESENT);
@@ -193,14 +211,15 @@ tso_segment_buffer (vlib_main_t * vm, vnet_interface_per_thread_data_t * ptd,
       src_ptr = vlib_buffer_get_current (sb0) + l234_sz + first_data_size;
       src_left = sb0->current_length - l234_sz - first_data_size;
 
-      tso_fixup_segmented_buf (b0, tcp_flags_no_fin_psh, is_ip6, gho);
+      tso_fixup_segmented_buf (b0, tcp_flags_no_fin_psh, is_ip6, gho,
+			       is_udp);
 
       /* grab a second buffer and prepare the loop */
       ASSERT (dbi < vec_len (ptd->split_buffers));
       cdb0 = vlib_get_buffer (vm, ptd->split_buffers[dbi++]);
       tso_init_buf_from_template (vm, cdb0, b0, l234_sz, gso_size, &dst_ptr,
 				  &dst_left, next_tcp_seq, default_bflags,
-				  gho);
+				  gho, is_udp);
 
       /* an arbitrary large number to catch the runaway loops */
       int nloops = 2000;
@@ -243,16 +262,17 @@ tso_segment_buffer (vlib_main_t * vm, vnet_interface_per_thread_data_t * ptd,
 	    {
 	      n_tx_bytes += cdb0->current_length;
 	      tso_fixup_segmented_buf (cdb0, tcp_flags_no_fin_psh, is_ip6,
-				       gho);
+				       gho, is_udp);
 	      ASSERT (dbi < vec_len (ptd->split_buffers));
 	      cdb0 = vlib_get_buffer (vm, ptd->split_buffers[dbi++]);
 	      tso_init_buf_from_template (vm, cdb0, b0, l234_sz,
 					  gso_size, &dst_ptr, &dst_left,
-					  next_tcp_seq, default_bflags, gho);
+					  next_tcp_seq, default_bflags, gho,
+					  is_udp);
 	    }
 	}
 
-      tso_fixup_segmented_buf (cdb0, save_tcp_flags, is_ip6, gho);
+      tso_fixup_segmented_buf (cdb0, save_tcp_flags, is_ip6, gho, is_udp);
 
       n_tx_bytes += cdb0->current_length;
     }
@@ -336,6 +356,13 @@ vnet_gso_node_inline (vlib_main_t * vm,
 	    swif2 = vnet_buffer (b[2])->sw_if_index[VLIB_TX];
 	    swif3 = vnet_buffer (b[3])->sw_if_index[VLIB_TX];
 
+	    /* udp super segments are segmented even if the hw does gso */
+	    if (PREDICT_FALSE (vnet_buffer_is_udp_gso (b[0])
+			       || vnet_buffer_is_udp_gso (b[1])
+			       || vnet_buffer_is_udp_gso (b[2])
+			       || vnet_buffer_is_udp_gso (b[3])))
+	      break;
+
 	    if (PREDICT_FALSE (hi->sw_if_index != swif0))
 	      {
 		hi0 = vnet_get_sup_hw_interface (vnm, swif0);
@@ -429,6 +456,8 @@ vnet_gso_node_inline (vlib_main_t * vm,
 	    }
 	  else
 	    do_segmentation0 = do_segmentation;
+	  if (PREDICT_FALSE (vnet_buffer_is_udp_gso (b[0])))
+	    do_segmentation0 = 1;
 
 	  /* speculatively enqueue b0 to the current next frame */
 	  to_next[0] = bi0 = from[0];
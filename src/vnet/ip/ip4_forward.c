@@ -112,7 +112,6 @@ VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
 				      vlib_node_runtime_t * node,
 				      vlib_frame_t * frame)
 {
-  vlib_combined_counter_main_t *cm = &load_balance_main.lbm_via_counters;
   u32 n_left, *from;
   u32 thread_index = vm->thread_index;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
@@ -201,10 +200,8 @@ VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
       vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
       vnet_buffer (b[1])->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-      vlib_increment_combined_counter
-	(cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, b[0]));
-      vlib_increment_combined_counter
-	(cm, thread_index, lbi1, 1, vlib_buffer_length_in_chain (vm, b[1]));
+      load_balance_via_counter_increment (vm, thread_index, lbi0, b[0]);
+      load_balance_via_counter_increment (vm, thread_index, lbi1, b[1]);
 
       b += 2;
       next += 2;
@@ -247,8 +244,7 @@ VLIB_NODE_FN (ip4_load_balance_node) (vlib_main_t * vm,
       next[0] = dpo0->dpoi_next_node;
       vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-      vlib_increment_combined_counter
-	(cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, b[0]));
+      load_balance_via_counter_increment (vm, thread_index, lbi0, b[0]);
 
       b += 1;
       next += 1;
@@ -2047,6 +2043,192 @@ ip4_ttl_and_checksum_check (vlib_buffer_t * b, ip4_header_t * ip, u16 * next,
 }
 
 
+/*
+ * Rewrite a single packet. Used for the packets that do not fit a full
+ * batch and for those a batch has flagged as needing the slow path.
+ */
+static_always_inline void
+ip4_rewrite_one (vlib_main_t * vm, vlib_buffer_t * b0, u16 * next0,
+		 vlib_node_runtime_t * error_node, u32 thread_index,
+		 int do_counters, int is_midchain, int is_mcast)
+{
+  ip_lookup_main_t *lm = &ip4_main.lookup_main;
+  ip_adjacency_t *adj0;
+  ip4_header_t *ip0;
+  u32 rw_len0, adj_index0, error0;
+  u32 tx_sw_if_index0;
+
+  adj_index0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
+
+  adj0 = adj_get (adj_index0);
+
+  if (do_counters)
+    vlib_prefetch_combined_counter (&adjacency_counters,
+				    thread_index, adj_index0);
+
+  ip0 = vlib_buffer_get_current (b0);
+
+  error0 = IP4_ERROR_NONE;
+
+  ip4_ttl_and_checksum_check (b0, ip0, next0, &error0);
+
+  /* Update packet buffer attributes/set output interface. */
+  rw_len0 = adj0[0].rewrite_header.data_bytes;
+  vnet_buffer (b0)->ip.save_rewrite_length = rw_len0;
+
+  /* Check MTU of outgoing interface. */
+  u16 ip0_len = clib_net_to_host_u16 (ip0->length);
+  if (b0->flags & VNET_BUFFER_F_GSO)
+    ip0_len = gso_mtu_sz (b0);
+
+  ip4_mtu_check (b0, ip0_len,
+		 adj0[0].rewrite_header.max_l3_packet_bytes,
+		 ip0->flags_and_fragment_offset &
+		 clib_host_to_net_u16 (IP4_HEADER_FLAG_DONT_FRAGMENT),
+		 next0, is_midchain, &error0);
+
+  if (is_mcast)
+    {
+      error0 = ((adj0[0].rewrite_header.sw_if_index ==
+		 vnet_buffer (b0)->sw_if_index[VLIB_RX]) ?
+		IP4_ERROR_SAME_INTERFACE : error0);
+    }
+
+  /* Don't adjust the buffer for ttl issue; icmp-error node wants
+   * to see the IP header */
+  if (PREDICT_TRUE (error0 == IP4_ERROR_NONE))
+    {
+      u32 next_index = adj0[0].rewrite_header.next_index;
+      vlib_buffer_advance (b0, -(word) rw_len0);
+      tx_sw_if_index0 = adj0[0].rewrite_header.sw_if_index;
+      vnet_buffer (b0)->sw_if_index[VLIB_TX] = tx_sw_if_index0;
+
+      if (PREDICT_FALSE
+	  (adj0[0].rewrite_header.flags & VNET_REWRITE_HAS_FEATURES))
+	vnet_feature_arc_start (lm->output_feature_arc_index,
+				tx_sw_if_index0, &next_index, b0);
+      *next0 = next_index;
+
+      if (is_midchain)
+	/* this acts on the packet that is about to be encapped */
+	calc_checksums (vm, b0);
+
+      /* Guess we are only writing on simple Ethernet header. */
+      vnet_rewrite_one_header (adj0[0], ip0, sizeof (ethernet_header_t));
+
+      if (do_counters)
+	vlib_increment_combined_counter
+	  (&adjacency_counters,
+	   thread_index, adj_index0, 1,
+	   vlib_buffer_length_in_chain (vm, b0) + rw_len0);
+
+      if (is_midchain && adj0->sub_type.midchain.fixup_func)
+	adj0->sub_type.midchain.fixup_func
+	  (vm, adj0, b0, adj0->sub_type.midchain.fixup_data);
+
+      if (is_mcast)
+	/* copy bytes from the IP address into the MAC rewrite */
+	vnet_ip_mcast_fixup_header (IP4_MCAST_ADDR_MASK,
+				    adj0->rewrite_header.dst_mcast_offset,
+				    &ip0->dst_address.as_u32, (u8 *) ip0);
+    }
+  else
+    {
+      b0->error = error_node->errors[error0];
+      /* undo the TTL decrement - we'll be back to do it again */
+      if (error0 == IP4_ERROR_MTU_EXCEEDED)
+	ip4_ttl_inc (b0, ip0);
+    }
+}
+
+#ifdef VNET_REWRITE_VEC_SIZE
+/*
+ * Rewrite a batch of VNET_REWRITE_VEC_SIZE unicast packets. The TTL,
+ * checksum and MTU checks for the whole batch are done in vector
+ * registers; any packet that would expire, needs fragmenting, is GSO or
+ * locally originated is handed to ip4_rewrite_one() untouched.
+ */
+static_always_inline void
+ip4_rewrite_vec (vlib_main_t * vm, vlib_buffer_t ** b, u16 * next,
+		 vlib_node_runtime_t * error_node, u32 thread_index,
+		 int do_counters)
+{
+  ip_lookup_main_t *lm = &ip4_main.lookup_main;
+  const ip_adjacency_t *adj[VNET_REWRITE_VEC_SIZE];
+  ip4_header_t *ip[VNET_REWRITE_VEC_SIZE];
+  vnet_rewrite_vec_t ttl_csum, len, mtu, flags, ttl, csum, slow;
+  u32 adj_index, rw_len, tx_sw_if_index, next_index;
+  int i;
+
+  for (i = 0; i < VNET_REWRITE_VEC_SIZE; i++)
+    {
+      adj_index = vnet_buffer (b[i])->ip.adj_index[VLIB_TX];
+      adj[i] = adj_get (adj_index);
+      ip[i] = vlib_buffer_get_current (b[i]);
+
+      if (do_counters)
+	vlib_prefetch_combined_counter (&adjacency_counters,
+					thread_index, adj_index);
+
+      /* ttl, protocol and checksum share the third header word */
+      ttl_csum[i] = clib_mem_unaligned (&ip[i]->ttl, u32);
+      len[i] = ip[i]->length;
+      mtu[i] = adj[i]->rewrite_header.max_l3_packet_bytes;
+      flags[i] = b[i]->flags;
+    }
+
+  len = ((len & 0xff) << 8) | (len >> 8);
+  ttl = ttl_csum & 0xff;
+
+  slow = (vnet_rewrite_vec_t) (ttl < 2);
+  slow |= (vnet_rewrite_vec_t) (len > mtu);
+  slow |= (vnet_rewrite_vec_t) ((flags & (VNET_BUFFER_F_GSO |
+					   VNET_BUFFER_F_LOCALLY_ORIGINATED))
+				!= 0);
+
+  /* Decrement TTL & update checksum, as ip4_ttl_and_checksum_check () */
+  csum = (ttl_csum >> 16) + clib_host_to_net_u16 (0x0100);
+  csum -= (vnet_rewrite_vec_t) (csum >= 0xffff);
+  ttl_csum = (ttl_csum & 0xff00) | (ttl - 1) | (csum << 16);
+
+  for (i = 0; i < VNET_REWRITE_VEC_SIZE; i++)
+    {
+      if (PREDICT_FALSE (slow[i]))
+	{
+	  ip4_rewrite_one (vm, b[i], next + i, error_node, thread_index,
+			   do_counters, 0, 0);
+	  continue;
+	}
+
+      clib_mem_unaligned (&ip[i]->ttl, u32) = ttl_csum[i];
+      ASSERT ((ip[i]->checksum == ip4_header_checksum (ip[i])) ||
+	      (b[i]->flags & VNET_BUFFER_F_OFFLOAD_IP_CKSUM));
+
+      rw_len = adj[i]->rewrite_header.data_bytes;
+      vnet_buffer (b[i])->ip.save_rewrite_length = rw_len;
+      vlib_buffer_advance (b[i], -(word) rw_len);
+
+      tx_sw_if_index = adj[i]->rewrite_header.sw_if_index;
+      vnet_buffer (b[i])->sw_if_index[VLIB_TX] = tx_sw_if_index;
+      next_index = adj[i]->rewrite_header.next_index;
+
+      if (PREDICT_FALSE
+	  (adj[i]->rewrite_header.flags & VNET_REWRITE_HAS_FEATURES))
+	vnet_feature_arc_start (lm->output_feature_arc_index,
+				tx_sw_if_index, &next_index, b[i]);
+      next[i] = next_index;
+
+      vnet_rewrite_one_header_sized (adj[i][0], ip[i]);
+
+      if (do_counters)
+	vlib_increment_combined_counter
+	  (&adjacency_counters, thread_index,
+	   vnet_buffer (b[i])->ip.adj_index[VLIB_TX], 1,
+	   vlib_buffer_length_in_chain (vm, b[i]) + rw_len);
+    }
+}
+#endif
+
 always_inline uword
 ip4_rewrite_inline_with_gso (vlib_main_t * vm,
 			     vlib_node_runtime_t * node,
@@ -2067,16 +2249,54 @@ ip4_rewrite_inline_with_gso (vlib_main_t * vm,
   vlib_get_buffers (vm, from, bufs, n_left_from);
   clib_memset_u16 (nexts, IP4_REWRITE_NEXT_DROP, n_left_from);
 
+  next = nexts;
+  b = bufs;
+
+#ifdef VNET_REWRITE_VEC_SIZE
+  if (!is_midchain && !is_mcast)
+    {
+      int i;
+
+      for (i = 0; i < clib_min (n_left_from, 2 * VNET_REWRITE_VEC_SIZE); i++)
+	vlib_prefetch_buffer_header (b[i], LOAD);
+
+      while (n_left_from >= VNET_REWRITE_VEC_SIZE)
+	{
+	  u8 *p;
+
+	  /* headers two batches ahead, data for the next batch */
+	  for (i = 0; i < VNET_REWRITE_VEC_SIZE; i++)
+	    {
+	      if (n_left_from >= 3 * VNET_REWRITE_VEC_SIZE)
+		vlib_prefetch_buffer_header
+		  (b[2 * VNET_REWRITE_VEC_SIZE + i], LOAD);
+	      if (n_left_from >= 2 * VNET_REWRITE_VEC_SIZE)
+		{
+		  p = vlib_buffer_get_current (b[VNET_REWRITE_VEC_SIZE + i]);
+		  CLIB_PREFETCH (p - CLIB_CACHE_LINE_BYTES,
+				 CLIB_CACHE_LINE_BYTES, STORE);
+		  CLIB_PREFETCH (p, CLIB_CACHE_LINE_BYTES, LOAD);
+		}
+	    }
+
+	  ip4_rewrite_vec (vm, b, next, error_node, thread_index,
+			   do_counters);
+
+	  next += VNET_REWRITE_VEC_SIZE;
+	  b += VNET_REWRITE_VEC_SIZE;
+	  n_left_from -= VNET_REWRITE_VEC_SIZE;
+	}
+    }
+#endif
+
 #if (CLIB_N_PREFETCHES >= 8)
   if (n_left_from >= 6)
     {
       int i;
       for (i = 2; i < 6; i++)
-	vlib_prefetch_buffer_header (bufs[i], LOAD);
+	vlib_prefetch_buffer_header (b[i], LOAD);
     }
 
-  next = nexts;
-  b = bufs;
   while (n_left_from >= 8)
     {
       const ip_adjacency_t *adj0, *adj1;
@@ -2255,8 +2475,6 @@ ip4_rewrite_inline_with_gso (vlib_main_t * vm,
       n_left_from -= 2;
     }
 #elif (CLIB_N_PREFETCHES >= 4)
-  next = nexts;
-  b = bufs;
   while (n_left_from >= 1)
     {
       ip_adjacency_t *adj0;
@@ -2381,93 +2599,8 @@ ip4_rewrite_inline_with_gso (vlib_main_t * vm,
 
   while (n_left_from > 0)
     {
-      ip_adjacency_t *adj0;
-      ip4_header_t *ip0;
-      u32 rw_len0, adj_index0, error0;
-      u32 tx_sw_if_index0;
-
-      adj_index0 = vnet_buffer (b[0])->ip.adj_index[VLIB_TX];
-
-      adj0 = adj_get (adj_index0);
-
-      if (do_counters)
-	vlib_prefetch_combined_counter (&adjacency_counters,
-					thread_index, adj_index0);
-
-      ip0 = vlib_buffer_get_current (b[0]);
-
-      error0 = IP4_ERROR_NONE;
-
-      ip4_ttl_and_checksum_check (b[0], ip0, next + 0, &error0);
-
-
-      /* Update packet buffer attributes/set output interface. */
-      rw_len0 = adj0[0].rewrite_header.data_bytes;
-      vnet_buffer (b[0])->ip.save_rewrite_length = rw_len0;
-
-      /* Check MTU of outgoing interface. */
-      u16 ip0_len = clib_net_to_host_u16 (ip0->length);
-      if (b[0]->flags & VNET_BUFFER_F_GSO)
-	ip0_len = gso_mtu_sz (b[0]);
-
-      ip4_mtu_check (b[0], ip0_len,
-		     adj0[0].rewrite_header.max_l3_packet_bytes,
-		     ip0->flags_and_fragment_offset &
-		     clib_host_to_net_u16 (IP4_HEADER_FLAG_DONT_FRAGMENT),
-		     next + 0, is_midchain, &error0);
-
-      if (is_mcast)
-	{
-	  error0 = ((adj0[0].rewrite_header.sw_if_index ==
-		     vnet_buffer (b[0])->sw_if_index[VLIB_RX]) ?
-		    IP4_ERROR_SAME_INTERFACE : error0);
-	}
-
-      /* Don't adjust the buffer for ttl issue; icmp-error node wants
-       * to see the IP header */
-      if (PREDICT_TRUE (error0 == IP4_ERROR_NONE))
-	{
-	  u32 next_index = adj0[0].rewrite_header.next_index;
-	  vlib_buffer_advance (b[0], -(word) rw_len0);
-	  tx_sw_if_index0 = adj0[0].rewrite_header.sw_if_index;
-	  vnet_buffer (b[0])->sw_if_index[VLIB_TX] = tx_sw_if_index0;
-
-	  if (PREDICT_FALSE
-	      (adj0[0].rewrite_header.flags & VNET_REWRITE_HAS_FEATURES))
-	    vnet_feature_arc_start (lm->output_feature_arc_index,
-				    tx_sw_if_index0, &next_index, b[0]);
-	  next[0] = next_index;
-
-	  if (is_midchain)
-	    /* this acts on the packet that is about to be encapped */
-	    calc_checksums (vm, b[0]);
-
-	  /* Guess we are only writing on simple Ethernet header. */
-	  vnet_rewrite_one_header (adj0[0], ip0, sizeof (ethernet_header_t));
-
-	  if (do_counters)
-	    vlib_increment_combined_counter
-	      (&adjacency_counters,
-	       thread_index, adj_index0, 1,
-	       vlib_buffer_length_in_chain (vm, b[0]) + rw_len0);
-
-	  if (is_midchain && adj0->sub_type.midchain.fixup_func)
-	    adj0->sub_type.midchain.fixup_func
-	      (vm, adj0, b[0], adj0->sub_type.midchain.fixup_data);
-
-	  if (is_mcast)
-	    /* copy bytes from the IP address into the MAC rewrite */
-	    vnet_ip_mcast_fixup_header (IP4_MCAST_ADDR_MASK,
-					adj0->rewrite_header.dst_mcast_offset,
-					&ip0->dst_address.as_u32, (u8 *) ip0);
-	}
-      else
-	{
-	  b[0]->error = error_node->errors[error0];
-	  /* undo the TTL decrement - we'll be back to do it again */
-	  if (error0 == IP4_ERROR_MTU_EXCEEDED)
-	    ip4_ttl_inc (b[0], ip0);
-	}
+      ip4_rewrite_one (vm, b[0], next, error_node, thread_index,
+		       do_counters, is_midchain, is_mcast);
 
       next += 1;
       b += 1;
@@ -56,7 +56,6 @@ ip4_lookup_inline (vlib_main_t * vm,
 		   vlib_node_runtime_t * node, vlib_frame_t * frame)
 {
   ip4_main_t *im = &ip4_main;
-  vlib_combined_counter_main_t *cm = &load_balance_main.lbm_to_counters;
   u32 n_left, *from;
   u32 thread_index = vm->thread_index;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
@@ -222,18 +221,10 @@ ip4_lookup_inline (vlib_main_t * vm,
       next[3] = dpo3->dpoi_next_node;
       vnet_buffer (b[3])->ip.adj_index[VLIB_TX] = dpo3->dpoi_index;
 
-      vlib_increment_combined_counter
-	(cm, thread_index, lb_index0, 1,
-	 vlib_buffer_length_in_chain (vm, b[0]));
-      vlib_increment_combined_counter
-	(cm, thread_index, lb_index1, 1,
-	 vlib_buffer_length_in_chain (vm, b[1]));
-      vlib_increment_combined_counter
-	(cm, thread_index, lb_index2, 1,
-	 vlib_buffer_length_in_chain (vm, b[2]));
-      vlib_increment_combined_counter
-	(cm, thread_index, lb_index3, 1,
-	 vlib_buffer_length_in_chain (vm, b[3]));
+      load_balance_to_counter_increment (vm, thread_index, lb_index0, b[0]);
+      load_balance_to_counter_increment (vm, thread_index, lb_index1, b[1]);
+      load_balance_to_counter_increment (vm, thread_index, lb_index2, b[2]);
+      load_balance_to_counter_increment (vm, thread_index, lb_index3, b[3]);
 
       b += 4;
       next += 4;
@@ -331,12 +322,8 @@ ip4_lookup_inline (vlib_main_t * vm,
       next[1] = dpo1->dpoi_next_node;
       vnet_buffer (b[1])->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-      vlib_increment_combined_counter
-	(cm, thread_index, lb_index0, 1,
-	 vlib_buffer_length_in_chain (vm, b[0]));
-      vlib_increment_combined_counter
-	(cm, thread_index, lb_index1, 1,
-	 vlib_buffer_length_in_chain (vm, b[1]));
+      load_balance_to_counter_increment (vm, thread_index, lb_index0, b[0]);
+      load_balance_to_counter_increment (vm, thread_index, lb_index1, b[1]);
 
       b += 2;
       next += 2;
@@ -392,9 +379,7 @@ ip4_lookup_inline (vlib_main_t * vm,
       next[0] = dpo0->dpoi_next_node;
       vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-      vlib_increment_combined_counter (cm, thread_index, lbi0, 1,
-				       vlib_buffer_length_in_chain (vm,
-								    b[0]));
+      load_balance_to_counter_increment (vm, thread_index, lbi0, b[0]);
 
       b += 1;
       next += 1;
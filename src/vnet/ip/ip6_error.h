@@ -57,6 +57,9 @@
   _ (DROP, "ip6 drop")                                                  \
   _ (PUNT, "ip6 punt")                                                  \
                                                                         \
+  /* Errors signalled by ip6-source-check-via-{rx,any} */               \
+  _ (UNICAST_SOURCE_CHECK_FAILS, "ip6 unicast source check fails")      \
+                                                                        \
   /* Errors signalled by ip6-local. */                                  \
   _ (UNKNOWN_PROTOCOL, "unknown ip protocol")                           \
   _ (UDP_CHECKSUM, "bad udp checksum")                                  \
@@ -507,6 +507,20 @@ VNET_FEATURE_INIT (ip6_inacl, static) =
 {
   .arc_name = "ip6-unicast",
   .node_name = "ip6-inacl",
+  .runs_before = VNET_FEATURES ("ip6-source-check-via-rx"),
+};
+
+VNET_FEATURE_INIT (ip6_source_check_1, static) =
+{
+  .arc_name = "ip6-unicast",
+  .node_name = "ip6-source-check-via-rx",
+  .runs_before = VNET_FEATURES ("ip6-source-check-via-any"),
+};
+
+VNET_FEATURE_INIT (ip6_source_check_2, static) =
+{
+  .arc_name = "ip6-unicast",
+  .node_name = "ip6-source-check-via-any",
   .runs_before = VNET_FEATURES ("ip6-policer-classify"),
 };
 
@@ -677,7 +691,6 @@ VLIB_NODE_FN (ip6_load_balance_node) (vlib_main_t * vm,
 				      vlib_node_runtime_t * node,
 				      vlib_frame_t * frame)
 {
-  vlib_combined_counter_main_t *cm = &load_balance_main.lbm_via_counters;
   u32 n_left, *from;
   u32 thread_index = vm->thread_index;
   ip6_main_t *im = &ip6_main;
@@ -780,10 +793,8 @@ VLIB_NODE_FN (ip6_load_balance_node) (vlib_main_t * vm,
       vnet_buffer (b[0])->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
       vnet_buffer (b[1])->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-      vlib_increment_combined_counter
-	(cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, b[0]));
-      vlib_increment_combined_counter
-	(cm, thread_index, lbi1, 1, vlib_buffer_length_in_chain (vm, b[1]));
+      load_balance_via_counter_increment (vm, thread_index, lbi0, b[0]);
+      load_balance_via_counter_increment (vm, thread_index, lbi1, b[1]);
 
       b += 2;
       next += 2;
@@ -833,8 +844,7 @@ VLIB_NODE_FN (ip6_load_balance_node) (vlib_main_t * vm,
 	    (ip_lookup_next_t) IP6_LOOKUP_NEXT_HOP_BY_HOP : next[0];
 	}
 
-      vlib_increment_combined_counter
-	(cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, b[0]));
+      load_balance_via_counter_increment (vm, thread_index, lbi0, b[0]);
 
       b += 1;
       next += 1;
@@ -1639,6 +1649,221 @@ ip6_mtu_check (vlib_buffer_t * b, u16 packet_bytes,
     }
 }
 
+/*
+ * Rewrite a single packet, returning its next node. Used for the packets
+ * that do not fit a full batch and for those a batch has flagged as
+ * needing the slow path.
+ */
+static_always_inline u32
+ip6_rewrite_one (vlib_main_t * vm, vlib_buffer_t * p0,
+		 vlib_node_runtime_t * error_node, u32 thread_index,
+		 int do_counters, int is_midchain, int is_mcast)
+{
+  ip_lookup_main_t *lm = &ip6_main.lookup_main;
+  ip_adjacency_t *adj0;
+  ip6_header_t *ip0;
+  u32 rw_len0;
+  u32 adj_index0, next0, error0;
+  u32 tx_sw_if_index0;
+  bool is_locally_originated0;
+
+  adj_index0 = vnet_buffer (p0)->ip.adj_index[VLIB_TX];
+
+  adj0 = adj_get (adj_index0);
+
+  ip0 = vlib_buffer_get_current (p0);
+
+  error0 = IP6_ERROR_NONE;
+  next0 = IP6_REWRITE_NEXT_DROP;
+
+  /* Check hop limit */
+  is_locally_originated0 =
+    p0->flags & VNET_BUFFER_F_LOCALLY_ORIGINATED;
+  if (PREDICT_TRUE (!is_locally_originated0))
+    {
+      i32 hop_limit0 = ip0->hop_limit;
+
+      ASSERT (ip0->hop_limit > 0);
+
+      hop_limit0 -= 1;
+
+      ip0->hop_limit = hop_limit0;
+
+      if (PREDICT_FALSE (hop_limit0 <= 0))
+	{
+	  /*
+	   * If the hop count drops below 1 when forwarding, generate
+	   * an ICMP response.
+	   */
+	  error0 = IP6_ERROR_TIME_EXPIRED;
+	  next0 = IP6_REWRITE_NEXT_ICMP_ERROR;
+	  vnet_buffer (p0)->sw_if_index[VLIB_TX] = (u32) ~ 0;
+	  icmp6_error_set_vnet_buffer (p0, ICMP6_time_exceeded,
+				       ICMP6_time_exceeded_ttl_exceeded_in_transit,
+				       0);
+	}
+    }
+  else
+    {
+      p0->flags &= ~VNET_BUFFER_F_LOCALLY_ORIGINATED;
+    }
+
+  if (is_midchain)
+    {
+      calc_checksums (vm, p0);
+    }
+
+  /* Guess we are only writing on simple Ethernet header. */
+  vnet_rewrite_one_header (adj0[0], ip0, sizeof (ethernet_header_t));
+
+  /* Update packet buffer attributes/set output interface. */
+  rw_len0 = adj0[0].rewrite_header.data_bytes;
+  vnet_buffer (p0)->ip.save_rewrite_length = rw_len0;
+
+  if (do_counters)
+    {
+      vlib_increment_combined_counter
+	(&adjacency_counters,
+	 thread_index, adj_index0, 1,
+	 vlib_buffer_length_in_chain (vm, p0) + rw_len0);
+    }
+
+  /* Check MTU of outgoing interface. */
+  u16 ip0_len =
+    clib_net_to_host_u16 (ip0->payload_length) +
+    sizeof (ip6_header_t);
+  if (p0->flags & VNET_BUFFER_F_GSO)
+    ip0_len = gso_mtu_sz (p0);
+
+  ip6_mtu_check (p0, ip0_len,
+		 adj0[0].rewrite_header.max_l3_packet_bytes,
+		 is_locally_originated0, &next0, is_midchain,
+		 &error0);
+
+  /* Don't adjust the buffer for hop count issue; icmp-error node
+   * wants to see the IP header */
+  if (PREDICT_TRUE (error0 == IP6_ERROR_NONE))
+    {
+      p0->current_data -= rw_len0;
+      p0->current_length += rw_len0;
+
+      tx_sw_if_index0 = adj0[0].rewrite_header.sw_if_index;
+
+      vnet_buffer (p0)->sw_if_index[VLIB_TX] = tx_sw_if_index0;
+      next0 = adj0[0].rewrite_header.next_index;
+
+      if (PREDICT_FALSE
+	  (adj0[0].rewrite_header.flags & VNET_REWRITE_HAS_FEATURES))
+	vnet_feature_arc_start (lm->output_feature_arc_index,
+				tx_sw_if_index0, &next0, p0);
+    }
+  else
+    {
+      p0->error = error_node->errors[error0];
+    }
+
+  if (is_midchain)
+    {
+      if (adj0->sub_type.midchain.fixup_func)
+	adj0->sub_type.midchain.fixup_func
+	  (vm, adj0, p0, adj0->sub_type.midchain.fixup_data);
+    }
+  if (is_mcast)
+    {
+      vnet_ip_mcast_fixup_header (IP6_MCAST_ADDR_MASK,
+				  adj0->
+				  rewrite_header.dst_mcast_offset,
+				  &ip0->dst_address.as_u32[3],
+				  (u8 *) ip0);
+    }
+
+  return next0;
+}
+
+#ifdef VNET_REWRITE_VEC_SIZE
+/*
+ * Rewrite a batch of VNET_REWRITE_VEC_SIZE unicast packets. The hop-limit
+ * and MTU checks for the whole batch are done in vector registers; any
+ * packet that would expire, is too big, is GSO or locally originated is
+ * handed to ip6_rewrite_one() untouched.
+ */
+static_always_inline void
+ip6_rewrite_vec (vlib_main_t * vm, vlib_buffer_t ** b, u16 * next,
+		 vlib_node_runtime_t * error_node, u32 thread_index,
+		 int do_counters)
+{
+  ip_lookup_main_t *lm = &ip6_main.lookup_main;
+  const ip_adjacency_t *adj[VNET_REWRITE_VEC_SIZE];
+  ip6_header_t *ip[VNET_REWRITE_VEC_SIZE];
+  vnet_rewrite_vec_t plen_hop, len, mtu, flags, slow;
+  u32 adj_index, rw_len, tx_sw_if_index, next_index;
+  int i;
+
+  for (i = 0; i < VNET_REWRITE_VEC_SIZE; i++)
+    {
+      adj_index = vnet_buffer (b[i])->ip.adj_index[VLIB_TX];
+      adj[i] = adj_get (adj_index);
+      ip[i] = vlib_buffer_get_current (b[i]);
+
+      if (do_counters)
+	vlib_prefetch_combined_counter (&adjacency_counters,
+					thread_index, adj_index);
+
+      /* payload length, next header and hop limit share a header word */
+      plen_hop[i] = clib_mem_unaligned (&ip[i]->payload_length, u32);
+      mtu[i] = adj[i]->rewrite_header.max_l3_packet_bytes;
+      flags[i] = b[i]->flags;
+    }
+
+  len = (((plen_hop & 0xff) << 8) | ((plen_hop >> 8) & 0xff)) +
+    sizeof (ip6_header_t);
+
+  slow = (vnet_rewrite_vec_t) ((plen_hop >> 24) < 2);
+  slow |= (vnet_rewrite_vec_t) (len > mtu);
+  slow |= (vnet_rewrite_vec_t) ((flags & (VNET_BUFFER_F_GSO |
+					   VNET_BUFFER_F_LOCALLY_ORIGINATED))
+				!= 0);
+
+  plen_hop -= 1 << 24;
+
+  for (i = 0; i < VNET_REWRITE_VEC_SIZE; i++)
+    {
+      if (PREDICT_FALSE (slow[i]))
+	{
+	  next[i] = ip6_rewrite_one (vm, b[i], error_node, thread_index,
+				     do_counters, 0, 0);
+	  continue;
+	}
+
+      clib_mem_unaligned (&ip[i]->payload_length, u32) = plen_hop[i];
+
+      vnet_rewrite_one_header_sized (adj[i][0], ip[i]);
+
+      rw_len = adj[i]->rewrite_header.data_bytes;
+      vnet_buffer (b[i])->ip.save_rewrite_length = rw_len;
+
+      if (do_counters)
+	vlib_increment_combined_counter
+	  (&adjacency_counters, thread_index,
+	   vnet_buffer (b[i])->ip.adj_index[VLIB_TX], 1,
+	   vlib_buffer_length_in_chain (vm, b[i]) + rw_len);
+
+      b[i]->current_data -= rw_len;
+      b[i]->current_length += rw_len;
+
+      tx_sw_if_index = adj[i]->rewrite_header.sw_if_index;
+      vnet_buffer (b[i])->sw_if_index[VLIB_TX] = tx_sw_if_index;
+      next_index = adj[i]->rewrite_header.next_index;
+
+      if (PREDICT_FALSE
+	  (adj[i]->rewrite_header.flags & VNET_REWRITE_HAS_FEATURES))
+	vnet_feature_arc_start (lm->output_feature_arc_index,
+				tx_sw_if_index, &next_index, b[i]);
+      next[i] = next_index;
+    }
+}
+#endif
+
 always_inline uword
 ip6_rewrite_inline_with_gso (vlib_main_t * vm,
 			     vlib_node_runtime_t * node,
@@ -1655,6 +1880,52 @@ ip6_rewrite_inline_with_gso (vlib_main_t * vm,
   next_index = node->cached_next_index;
   u32 thread_index = vm->thread_index;
 
+#ifdef VNET_REWRITE_VEC_SIZE
+  if (!is_midchain && !is_mcast && n_left_from >= VNET_REWRITE_VEC_SIZE)
+    {
+      vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
+      u16 nexts[VLIB_FRAME_SIZE], *next = nexts;
+      u32 n_batched, n_left;
+      u8 *p;
+      int i;
+
+      n_batched = n_left = n_left_from - n_left_from % VNET_REWRITE_VEC_SIZE;
+      vlib_get_buffers (vm, from, bufs, n_batched);
+
+      for (i = 0; i < clib_min (n_batched, 2 * VNET_REWRITE_VEC_SIZE); i++)
+	vlib_prefetch_buffer_header (b[i], LOAD);
+
+      while (n_left > 0)
+	{
+	  /* headers two batches ahead, data for the next batch */
+	  for (i = 0; i < VNET_REWRITE_VEC_SIZE; i++)
+	    {
+	      if (n_left >= 3 * VNET_REWRITE_VEC_SIZE)
+		vlib_prefetch_buffer_header
+		  (b[2 * VNET_REWRITE_VEC_SIZE + i], LOAD);
+	      if (n_left >= 2 * VNET_REWRITE_VEC_SIZE)
+		{
+		  p = vlib_buffer_get_current (b[VNET_REWRITE_VEC_SIZE + i]);
+		  CLIB_PREFETCH (p - CLIB_CACHE_LINE_BYTES,
+				 CLIB_CACHE_LINE_BYTES, STORE);
+		  CLIB_PREFETCH (p, CLIB_CACHE_LINE_BYTES, LOAD);
+		}
+	    }
+
+	  ip6_rewrite_vec (vm, b, next, error_node, thread_index,
+			   do_counters);
+
+	  next += VNET_REWRITE_VEC_SIZE;
+	  b += VNET_REWRITE_VEC_SIZE;
+	  n_left -= VNET_REWRITE_VEC_SIZE;
+	}
+
+      vlib_buffer_enqueue_to_next (vm, node, from, nexts, n_batched);
+      from += n_batched;
+      n_left_from -= n_batched;
+    }
+#endif
+
   while (n_left_from > 0)
     {
       vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
@@ -1895,127 +2166,15 @@ ip6_rewrite_inline_with_gso (vlib_main_t * vm,
 
       while (n_left_from > 0 && n_left_to_next > 0)
 	{
-	  ip_adjacency_t *adj0;
 	  vlib_buffer_t *p0;
-	  ip6_header_t *ip0;
-	  u32 pi0, rw_len0;
-	  u32 adj_index0, next0, error0;
-	  u32 tx_sw_if_index0;
-	  bool is_locally_originated0;
+	  u32 pi0, next0;
 
 	  pi0 = to_next[0] = from[0];
 
 	  p0 = vlib_get_buffer (vm, pi0);
 
-	  adj_index0 = vnet_buffer (p0)->ip.adj_index[VLIB_TX];
-
-	  adj0 = adj_get (adj_index0);
-
-	  ip0 = vlib_buffer_get_current (p0);
-
-	  error0 = IP6_ERROR_NONE;
-	  next0 = IP6_REWRITE_NEXT_DROP;
-
-	  /* Check hop limit */
-	  is_locally_originated0 =
-	    p0->flags & VNET_BUFFER_F_LOCALLY_ORIGINATED;
-	  if (PREDICT_TRUE (!is_locally_originated0))
-	    {
-	      i32 hop_limit0 = ip0->hop_limit;
-
-	      ASSERT (ip0->hop_limit > 0);
-
-	      hop_limit0 -= 1;
-
-	      ip0->hop_limit = hop_limit0;
-
-	      if (PREDICT_FALSE (hop_limit0 <= 0))
-		{
-		  /*
-		   * If the hop count drops below 1 when forwarding, generate
-		   * an ICMP response.
-		   */
-		  error0 = IP6_ERROR_TIME_EXPIRED;
-		  next0 = IP6_REWRITE_NEXT_ICMP_ERROR;
-		  vnet_buffer (p0)->sw_if_index[VLIB_TX] = (u32) ~ 0;
-		  icmp6_error_set_vnet_buffer (p0, ICMP6_time_exceeded,
-					       ICMP6_time_exceeded_ttl_exceeded_in_transit,
-					       0);
-		}
-	    }
-	  else
-	    {
-	      p0->flags &= ~VNET_BUFFER_F_LOCALLY_ORIGINATED;
-	    }
-
-	  if (is_midchain)
-	    {
-	      calc_checksums (vm, p0);
-	    }
-
-	  /* Guess we are only writing on simple Ethernet header. */
-	  vnet_rewrite_one_header (adj0[0], ip0, sizeof (ethernet_header_t));
-
-	  /* Update packet buffer attributes/set output interface. */
-	  rw_len0 = adj0[0].rewrite_header.data_bytes;
-	  vnet_buffer (p0)->ip.save_rewrite_length = rw_len0;
-
-	  if (do_counters)
-	    {
-	      vlib_increment_combined_counter
-		(&adjacency_counters,
-		 thread_index, adj_index0, 1,
-		 vlib_buffer_length_in_chain (vm, p0) + rw_len0);
-	    }
-
-	  /* Check MTU of outgoing interface. */
-	  u16 ip0_len =
-	    clib_net_to_host_u16 (ip0->payload_length) +
-	    sizeof (ip6_header_t);
-	  if (p0->flags & VNET_BUFFER_F_GSO)
-	    ip0_len = gso_mtu_sz (p0);
-
-	  ip6_mtu_check (p0, ip0_len,
-			 adj0[0].rewrite_header.max_l3_packet_bytes,
-			 is_locally_originated0, &next0, is_midchain,
-			 &error0);
-
-	  /* Don't adjust the buffer for hop count issue; icmp-error node
-	   * wants to see the IP header */
-	  if (PREDICT_TRUE (error0 == IP6_ERROR_NONE))
-	    {
-	      p0->current_data -= rw_len0;
-	      p0->current_length += rw_len0;
-
-	      tx_sw_if_index0 = adj0[0].rewrite_header.sw_if_index;
-
-	      vnet_buffer (p0)->sw_if_index[VLIB_TX] = tx_sw_if_index0;
-	      next0 = adj0[0].rewrite_header.next_index;
-
-	      if (PREDICT_FALSE
-		  (adj0[0].rewrite_header.flags & VNET_REWRITE_HAS_FEATURES))
-		vnet_feature_arc_start (lm->output_feature_arc_index,
-					tx_sw_if_index0, &next0, p0);
-	    }
-	  else
-	    {
-	      p0->error = error_node->errors[error0];
-	    }
-
-	  if (is_midchain)
-	    {
-	      if (adj0->sub_type.midchain.fixup_func)
-		adj0->sub_type.midchain.fixup_func
-		  (vm, adj0, p0, adj0->sub_type.midchain.fixup_data);
-	    }
-	  if (is_mcast)
-	    {
-	      vnet_ip_mcast_fixup_header (IP6_MCAST_ADDR_MASK,
-					  adj0->
-					  rewrite_header.dst_mcast_offset,
-					  &ip0->dst_address.as_u32[3],
-					  (u8 *) ip0);
-	    }
+	  next0 = ip6_rewrite_one (vm, p0, error_node, thread_index,
+				   do_counters, is_midchain, is_mcast);
 
 	  from += 1;
 	  n_left_from -= 1;
@@ -2727,12 +2886,22 @@ ip6_lookup_init (vlib_main_t * vm)
   if (im->lookup_table_size == 0)
     im->lookup_table_size = IP6_FIB_DEFAULT_HASH_MEMORY_SIZE;
 
-  clib_bihash_init_24_8 (&(im->ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash),
-			 "ip6 FIB fwding table",
-			 im->lookup_table_nbuckets, im->lookup_table_size);
-  clib_bihash_init_24_8 (&im->ip6_table[IP6_FIB_TABLE_NON_FWDING].ip6_hash,
-			 "ip6 FIB non-fwding table",
-			 im->lookup_table_nbuckets, im->lookup_table_size);
+  /* The prefix tables double their bucket array as routes are added */
+  {
+    clib_bihash_init2_args_24_8_t _a, *a = &_a;
+
+    clib_memset (a, 0, sizeof (*a));
+    a->h = &im->ip6_table[IP6_FIB_TABLE_FWDING].ip6_hash;
+    a->name = "ip6 FIB fwding table";
+    a->nbuckets = im->lookup_table_nbuckets;
+    a->memory_size = im->lookup_table_size;
+    a->auto_grow = 1;
+    clib_bihash_init2_24_8 (a);
+
+    a->h = &im->ip6_table[IP6_FIB_TABLE_NON_FWDING].ip6_hash;
+    a->name = "ip6 FIB non-fwding table";
+    clib_bihash_init2_24_8 (a);
+  }
   clib_bihash_init_40_8 (&im->ip6_mtable.ip6_mhash,
 			 "ip6 mFIB table",
 			 im->lookup_table_nbuckets, im->lookup_table_size);
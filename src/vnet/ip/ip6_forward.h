@@ -56,7 +56,6 @@ ip6_lookup_inline (vlib_main_t * vm,
 		   vlib_node_runtime_t * node, vlib_frame_t * frame)
 {
   ip6_main_t *im = &ip6_main;
-  vlib_combined_counter_main_t *cm = &load_balance_main.lbm_to_counters;
   u32 n_left_from, n_left_to_next, *from, *to_next;
   ip_lookup_next_t next;
   u32 thread_index = vm->thread_index;
@@ -169,10 +168,8 @@ ip6_lookup_inline (vlib_main_t * vm,
 	  vnet_buffer (p0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 	  vnet_buffer (p1)->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-	  vlib_increment_combined_counter
-	    (cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, p0));
-	  vlib_increment_combined_counter
-	    (cm, thread_index, lbi1, 1, vlib_buffer_length_in_chain (vm, p1));
+	  load_balance_to_counter_increment (vm, thread_index, lbi0, p0);
+	  load_balance_to_counter_increment (vm, thread_index, lbi1, p1);
 
 	  from += 2;
 	  to_next += 2;
@@ -274,8 +271,7 @@ ip6_lookup_inline (vlib_main_t * vm,
 	    }
 	  vnet_buffer (p0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-	  vlib_increment_combined_counter
-	    (cm, thread_index, lbi0, 1, vlib_buffer_length_in_chain (vm, p0));
+	  load_balance_to_counter_increment (vm, thread_index, lbi0, p0);
 
 	  from += 1;
 	  to_next += 1;
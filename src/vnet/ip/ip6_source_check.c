@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vnet/ip/ip.h>
+#include <vnet/fib/ip6_fib.h>
+#include <vnet/fib/fib_urpf_list.h>
+#include <vnet/dpo/load_balance.h>
+
+/**
+ * @file
+ * @brief IPv6 Unicast Source Check.
+ *
+ * This file contains the IPv6 interface unicast source check, the
+ * counterpart of ip4_source_check.c. The source address is looked up in
+ * the interface's FIB and the input interface checked against the uRPF
+ * list of the resulting load-balance.
+ */
+
+typedef struct
+{
+  u8 packet_data[64];
+} ip6_source_check_trace_t;
+
+static u8 *
+format_ip6_source_check_trace (u8 * s, va_list * va)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*va, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*va, vlib_node_t *);
+  ip6_source_check_trace_t *t = va_arg (*va, ip6_source_check_trace_t *);
+
+  s = format (s, "%U",
+	      format_ip6_header, t->packet_data, sizeof (t->packet_data));
+
+  return s;
+}
+
+typedef enum
+{
+  IP6_SOURCE_CHECK_NEXT_DROP,
+  IP6_SOURCE_CHECK_N_NEXT,
+} ip6_source_check_next_t;
+
+typedef enum
+{
+  IP6_SOURCE_CHECK_REACHABLE_VIA_RX,
+  IP6_SOURCE_CHECK_REACHABLE_VIA_ANY,
+} ip6_source_check_type_t;
+
+typedef union
+{
+  u32 fib_index;
+} ip6_source_check_config_t;
+
+static_always_inline u32
+ip6_source_check_one (vlib_buffer_t * b, vlib_node_runtime_t * error_node,
+		      ip6_source_check_type_t source_check_type)
+{
+  ip6_source_check_config_t *c;
+  const load_balance_t *lb;
+  ip6_header_t *ip;
+  u32 next, pass;
+
+  ip = vlib_buffer_get_current (b);
+  c = vnet_feature_next_with_data (&next, b, sizeof (c[0]));
+
+  /* Pass link-local and unspecified sources, used by ND and DAD. */
+  pass = (ip6_address_is_link_local_unicast (&ip->src_address) ||
+	  ip6_address_is_unspecified (&ip->src_address));
+
+  lb = load_balance_get (ip6_fib_table_fwding_lookup (c->fib_index,
+						      &ip->src_address));
+
+  if (IP6_SOURCE_CHECK_REACHABLE_VIA_RX == source_check_type)
+    pass |= fib_urpf_check (lb->lb_urpf, vnet_buffer (b)->sw_if_index
+			    [VLIB_RX]);
+  else
+    pass |= fib_urpf_check_size (lb->lb_urpf);
+
+  b->error = error_node->errors[IP6_ERROR_UNICAST_SOURCE_CHECK_FAILS];
+
+  return (pass ? next : IP6_SOURCE_CHECK_NEXT_DROP);
+}
+
+always_inline uword
+ip6_source_check_inline (vlib_main_t * vm,
+			 vlib_node_runtime_t * node,
+			 vlib_frame_t * frame,
+			 ip6_source_check_type_t source_check_type)
+{
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  u16 nexts[VLIB_FRAME_SIZE], *next;
+  u32 n_left_from, *from;
+  vlib_node_runtime_t *error_node =
+    vlib_node_get_runtime (vm, ip6_input_node.index);
+
+  from = vlib_frame_vector_args (frame);
+  n_left_from = frame->n_vectors;
+  b = bufs;
+  next = nexts;
+
+  if (node->flags & VLIB_NODE_FLAG_TRACE)
+    vlib_trace_frame_buffers_only (vm, node, from, frame->n_vectors,
+				   /* stride */ 1,
+				   sizeof (ip6_source_check_trace_t));
+
+  vlib_get_buffers (vm, from, bufs, n_left_from);
+
+  while (n_left_from >= 4)
+    {
+      /* Prefetch next iteration. */
+      vlib_prefetch_buffer_header (b[2], LOAD);
+      vlib_prefetch_buffer_header (b[3], LOAD);
+      CLIB_PREFETCH (b[2]->data, sizeof (ip6_header_t), LOAD);
+      CLIB_PREFETCH (b[3]->data, sizeof (ip6_header_t), LOAD);
+
+      next[0] = ip6_source_check_one (b[0], error_node, source_check_type);
+      next[1] = ip6_source_check_one (b[1], error_node, source_check_type);
+
+      b += 2;
+      next += 2;
+      n_left_from -= 2;
+    }
+
+  while (n_left_from > 0)
+    {
+      next[0] = ip6_source_check_one (b[0], error_node, source_check_type);
+
+      b += 1;
+      next += 1;
+      n_left_from -= 1;
+    }
+
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
+
+  return frame->n_vectors;
+}
+
+VLIB_NODE_FN (ip6_check_source_reachable_via_any) (vlib_main_t * vm,
+						   vlib_node_runtime_t * node,
+						   vlib_frame_t * frame)
+{
+  return ip6_source_check_inline (vm, node, frame,
+				  IP6_SOURCE_CHECK_REACHABLE_VIA_ANY);
+}
+
+VLIB_NODE_FN (ip6_check_source_reachable_via_rx) (vlib_main_t * vm,
+						  vlib_node_runtime_t * node,
+						  vlib_frame_t * frame)
+{
+  return ip6_source_check_inline (vm, node, frame,
+				  IP6_SOURCE_CHECK_REACHABLE_VIA_RX);
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (ip6_check_source_reachable_via_any) = {
+  .name = "ip6-source-check-via-any",
+  .vector_size = sizeof (u32),
+
+  .n_next_nodes = IP6_SOURCE_CHECK_N_NEXT,
+  .next_nodes = {
+    [IP6_SOURCE_CHECK_NEXT_DROP] = "ip6-drop",
+  },
+
+  .format_buffer = format_ip6_header,
+  .format_trace = format_ip6_source_check_trace,
+};
+
+VLIB_REGISTER_NODE (ip6_check_source_reachable_via_rx) = {
+  .name = "ip6-source-check-via-rx",
+  .vector_size = sizeof (u32),
+
+  .n_next_nodes = IP6_SOURCE_CHECK_N_NEXT,
+  .next_nodes = {
+    [IP6_SOURCE_CHECK_NEXT_DROP] = "ip6-drop",
+  },
+
+  .format_buffer = format_ip6_header,
+  .format_trace = format_ip6_source_check_trace,
+};
+/* *INDENT-ON* */
+
+#ifndef CLIB_MARCH_VARIANT
+static clib_error_t *
+set_ip6_source_check (vlib_main_t * vm,
+		      unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vnet_main_t *vnm = vnet_get_main ();
+  ip6_main_t *im = &ip6_main;
+  clib_error_t *error = 0;
+  u32 sw_if_index, is_del;
+  ip6_source_check_config_t config;
+  char *feature_name = "ip6-source-check-via-rx";
+
+  sw_if_index = ~0;
+  is_del = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat_user
+	  (line_input, unformat_vnet_sw_interface, vnm, &sw_if_index))
+	;
+      else if (unformat (line_input, "del"))
+	is_del = 1;
+      else if (unformat (line_input, "strict"))
+	feature_name = "ip6-source-check-via-rx";
+      else if (unformat (line_input, "loose"))
+	feature_name = "ip6-source-check-via-any";
+      else
+	{
+	  error = unformat_parse_error (line_input);
+	  goto done;
+	}
+    }
+
+  if (~0 == sw_if_index)
+    {
+      error = clib_error_return (0, "unknown interface `%U'",
+				 format_unformat_error, line_input);
+      goto done;
+    }
+
+  vec_validate (im->fib_index_by_sw_if_index, sw_if_index);
+  config.fib_index = im->fib_index_by_sw_if_index[sw_if_index];
+  vnet_feature_enable_disable ("ip6-unicast", feature_name, sw_if_index,
+			       is_del == 0, &config, sizeof (config));
+done:
+  unformat_free (line_input);
+
+  return error;
+}
+
+/*?
+ * This command adds the 'ip6-source-check-via-rx' graph node for
+ * a given interface. The source address of incoming unicast packets is
+ * then verified to be reachable over the incoming interface. As for IPv4
+ * two flavours are supported (the default is strict):
+ * - loose: accept ingress packet if there is a route to reach the source
+ * - strict: accept ingress packet if it arrived on an interface which
+ *          the route to the source uses.
+ * Link-local and unspecified source addresses are always accepted.
+ *
+ * @cliexpar
+ * Example of how to enable unicast source checking on an interface:
+ * @cliexcmd{set interface ip6 source-check GigabitEthernet2/0/0 loose}
+ * Example of how to disable unicast source checking on an interface:
+ * @cliexcmd{set interface ip6 source-check GigabitEthernet2/0/0 del}
+?*/
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_interface_ip6_source_check_command, static) = {
+  .path = "set interface ip6 source-check",
+  .function = set_ip6_source_check,
+  .short_help = "set interface ip6 source-check <interface> [strict|loose] [del]",
+};
+/* *INDENT-ON* */
+#endif /* CLIB_MARCH_VARIANT */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
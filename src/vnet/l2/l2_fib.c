@@ -309,6 +309,11 @@ show_l2fib (vlib_main_t * vm,
     vlib_cli_output (vm, "Raw Hash Table:\n%U\n",
 		     BV (format_bihash), &msm->mac_table, 1 /* verbose */ );
 
+  if (raw && msm->mac_lookup_use_cuckoo)
+    vlib_cli_output (vm, "Cuckoo Lookup Table:\n%U\n",
+		     format_cuckoo_8_8, &msm->mac_lookup_table,
+		     0 /* verbose */ );
+
   return 0;
 }
 
@@ -342,17 +347,82 @@ VLIB_CLI_COMMAND (show_l2fib_cli, static) = {
 /* *INDENT-ON* */
 
 
+/*
+ * The cuckoo table grows by copying its buckets, the old copy may still be
+ * in use by readers on any thread and is freed by the scanner process with
+ * the workers stopped.
+ */
+static void
+l2fib_lookup_table_garbage (clib_cuckoo_8_8_t * h, void *ctx)
+{
+  vlib_process_signal_event_mt (vlib_get_main (),
+				l2fib_mac_age_scanner_process_node.index,
+				L2_MAC_AGE_PROCESS_EVENT_CUCKOO_GC, 0);
+}
+
+static void
+l2fib_lookup_table_init (l2fib_main_t * mp)
+{
+  clib_memset (&mp->mac_lookup_table, 0, sizeof (mp->mac_lookup_table));
+  clib_cuckoo_init_8_8 (&mp->mac_lookup_table, "l2fib mac lookup table",
+			L2FIB_NUM_BUCKETS, l2fib_lookup_table_garbage, mp);
+}
+
 /* Remove all entries from the l2fib */
 void
 l2fib_clear_table (void)
 {
   l2fib_main_t *mp = &l2fib_main;
 
+  clib_spinlock_lock_if_init (&mp->mac_lookup_lock);
+
   /* Remove all entries */
   BV (clib_bihash_free) (&mp->mac_table);
   BV (clib_bihash_init) (&mp->mac_table, "l2fib mac table",
 			 L2FIB_NUM_BUCKETS, L2FIB_MEMORY_SIZE);
+  if (mp->mac_lookup_use_cuckoo)
+    {
+      clib_cuckoo_free_8_8 (&mp->mac_lookup_table);
+      l2fib_lookup_table_init (mp);
+    }
   l2learn_main.global_learn_count = 0;
+
+  clib_spinlock_unlock_if_init (&mp->mac_lookup_lock);
+}
+
+/**
+ * Add or delete an entry in the mac table, and in its cuckoo copy when
+ * that is in use. Learning workers and the scanner both get here, the
+ * pair of updates is done under mac_lookup_lock so that the tables
+ * never disagree on which entries exist.
+ */
+int
+l2fib_table_add_del (BVT (clib_bihash_kv) * kv, int is_add)
+{
+  l2fib_main_t *mp = &l2fib_main;
+  clib_cuckoo_kv_8_8_t ckv;
+  int rv;
+
+  clib_spinlock_lock_if_init (&mp->mac_lookup_lock);
+
+  rv = BV (clib_bihash_add_del) (&mp->mac_table, kv, is_add);
+
+  if (rv == 0 && mp->mac_lookup_use_cuckoo)
+    {
+      ckv.key = kv->key;
+      ckv.value = kv->value;
+      /* A failed delete leaves the entry in neither table */
+      if (clib_cuckoo_add_del_8_8 (&mp->mac_lookup_table, &ckv, is_add)
+	  != CLIB_CUCKOO_ERROR_SUCCESS && is_add)
+	{
+	  BV (clib_bihash_add_del) (&mp->mac_table, kv, 0 /* is_add */ );
+	  rv = -1;
+	}
+    }
+
+  clib_spinlock_unlock_if_init (&mp->mac_lookup_lock);
+
+  return rv;
 }
 
 /** Clear all entries in L2FIB.
@@ -436,7 +506,7 @@ l2fib_add_entry (const u8 * mac, u32 bd_index,
   kv.key = key.raw;
   kv.value = result.raw;
 
-  BV (clib_bihash_add_del) (&fm->mac_table, &kv, 1 /* is_add */ );
+  l2fib_table_add_del (&kv, 1 /* is_add */ );
 }
 
 /**
@@ -710,7 +780,7 @@ l2fib_del_entry (const u8 * mac, u32 bd_index, u32 sw_if_index)
     l2learn_main.global_learn_count--;
 
   /* Remove entry from hash table */
-  BV (clib_bihash_add_del) (&mp->mac_table, &kv, 0 /* is_add */ );
+  l2fib_table_add_del (&kv, 0 /* is_add */ );
   return 0;
 }
 
@@ -1093,7 +1163,7 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 		      BVT (clib_bihash_kv) kv;
 		      kv.key = key.raw;
 		      kv.value = result.raw;
-		      BV (clib_bihash_add_del) (&fm->mac_table, &kv, 1);
+		      l2fib_table_add_del (&kv, 1);
 		      evt_idx++;
 		      continue;	/* skip aging */
 		    }
@@ -1135,7 +1205,7 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 	      /* delete mac entry */
 	      BVT (clib_bihash_kv) kv;
 	      kv.key = key.raw;
-	      BV (clib_bihash_add_del) (&fm->mac_table, &kv, 0);
+	      l2fib_table_add_del (&kv, 0);
 	      learn_count--;
 	      /*
 	       * Note: we may have just freed the bucket's backing
@@ -1225,6 +1295,12 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	case L2_MAC_AGE_PROCESS_EVENT_ONE_PASS:
 	  break;
 
+	case L2_MAC_AGE_PROCESS_EVENT_CUCKOO_GC:
+	  vlib_worker_thread_barrier_sync (vm);
+	  clib_cuckoo_garbage_collect_8_8 (&fm->mac_lookup_table);
+	  vlib_worker_thread_barrier_release (vm);
+	  continue;
+
 	default:
 	  ASSERT (0);
 	}
@@ -1285,6 +1361,31 @@ l2fib_init (vlib_main_t * vm)
 
 VLIB_INIT_FUNCTION (l2fib_init);
 
+static clib_error_t *
+l2fib_config (vlib_main_t * vm, unformat_input_t * input)
+{
+  l2fib_main_t *mp = &l2fib_main;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "cuckoo-lookup"))
+	mp->mac_lookup_use_cuckoo = 1;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (mp->mac_lookup_use_cuckoo)
+    {
+      clib_spinlock_init (&mp->mac_lookup_lock);
+      l2fib_lookup_table_init (mp);
+    }
+
+  return 0;
+}
+
+VLIB_CONFIG_FUNCTION (l2fib_config, "l2fib");
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
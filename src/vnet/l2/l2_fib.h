@@ -20,6 +20,7 @@
 
 #include <vlib/vlib.h>
 #include <vppinfra/bihash_8_8.h>
+#include <vppinfra/cuckoo_8_8.h>
 
 /*
  * The size of the hash table
@@ -45,6 +46,13 @@ typedef struct
   /* hash table */
   BVT (clib_bihash) mac_table;
 
+  /* optional cuckoo copy of the mac table, used for datapath lookups */
+  clib_cuckoo_8_8_t mac_lookup_table;
+  u8 mac_lookup_use_cuckoo;
+
+  /* keeps the mac table and its cuckoo copy in step, when in use */
+  clib_spinlock_t mac_lookup_lock;
+
   /* per swif vector of sequence number for interface based flush of MACs */
   u8 *swif_seq_num;
 
@@ -244,6 +252,28 @@ l2fib_make_key (const u8 * mac_address, u16 bd_index)
 
 
 
+/**
+ * Search the mac table for kv->key. On a hit kv->value is set, on a miss it
+ * is left untouched. When configured, the lookup is done in the cuckoo copy
+ * of the table, which bounds it to two bucket reads.
+ */
+static_always_inline void
+l2fib_search_inline (BVT (clib_bihash) * mac_table, BVT (clib_bihash_kv) * kv)
+{
+  l2fib_main_t *mp = &l2fib_main;
+
+  if (mp->mac_lookup_use_cuckoo)
+    {
+      clib_cuckoo_kv_8_8_t ckv = {.key = kv->key };
+
+      if (clib_cuckoo_search_inline_8_8 (&mp->mac_lookup_table, &ckv) ==
+	  CLIB_CUCKOO_ERROR_SUCCESS)
+	kv->value = ckv.value;
+    }
+  else
+    BV (clib_bihash_search_inline) (mac_table, kv);
+}
+
 /**
  * Lookup the entry for mac and bd_index in the mac table for 1 packet.
  * Cached_key and cached_result are used as a one-entry cache.
@@ -279,7 +309,7 @@ l2fib_lookup_1 (BVT (clib_bihash) * mac_table,
 
       kv.key = key0->raw;
       kv.value = ~0ULL;
-      BV (clib_bihash_search_inline) (mac_table, &kv);
+      l2fib_search_inline (mac_table, &kv);
       result0->raw = kv.value;
 
       /* Update one-entry cache */
@@ -336,8 +366,8 @@ l2fib_lookup_2 (BVT (clib_bihash) * mac_table,
       kv0.value = ~0ULL;
       kv1.value = ~0ULL;
 
-      BV (clib_bihash_search_inline) (mac_table, &kv0);
-      BV (clib_bihash_search_inline) (mac_table, &kv1);
+      l2fib_search_inline (mac_table, &kv0);
+      l2fib_search_inline (mac_table, &kv1);
 
       result0->raw = kv0.value;
       result1->raw = kv1.value;
@@ -401,10 +431,10 @@ l2fib_lookup_4 (BVT (clib_bihash) * mac_table,
       kv2.value = ~0ULL;
       kv3.value = ~0ULL;
 
-      BV (clib_bihash_search_inline) (mac_table, &kv0);
-      BV (clib_bihash_search_inline) (mac_table, &kv1);
-      BV (clib_bihash_search_inline) (mac_table, &kv2);
-      BV (clib_bihash_search_inline) (mac_table, &kv3);
+      l2fib_search_inline (mac_table, &kv0);
+      l2fib_search_inline (mac_table, &kv1);
+      l2fib_search_inline (mac_table, &kv2);
+      l2fib_search_inline (mac_table, &kv3);
 
       result0->raw = kv0.value;
       result1->raw = kv1.value;
@@ -419,6 +449,8 @@ l2fib_lookup_4 (BVT (clib_bihash) * mac_table,
 
 void l2fib_clear_table (void);
 
+int l2fib_table_add_del (BVT (clib_bihash_kv) * kv, int is_add);
+
 void
 l2fib_add_entry (const u8 * mac,
 		 u32 bd_index,
@@ -230,7 +230,7 @@ l2learn_process (vlib_node_runtime_t * node,
   BVT (clib_bihash_kv) kv;
   kv.key = key0->raw;
   kv.value = result0->raw;
-  BV (clib_bihash_add_del) (msm->mac_table, &kv, 1 /* is_add */ );
+  l2fib_table_add_del (&kv, 1 /* is_add */ );
 
   /* Invalidate the cache */
   cached_key->raw = ~0;
@@ -57,6 +57,7 @@ typedef enum
   L2_MAC_AGE_PROCESS_EVENT_START = 1,
   L2_MAC_AGE_PROCESS_EVENT_STOP = 2,
   L2_MAC_AGE_PROCESS_EVENT_ONE_PASS = 3,
+  L2_MAC_AGE_PROCESS_EVENT_CUCKOO_GC = 4,
 } l2_mac_age_process_event_t;
 
 #endif
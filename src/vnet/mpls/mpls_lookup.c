@@ -58,7 +58,6 @@ VLIB_NODE_FN (mpls_lookup_node) (vlib_main_t * vm,
              vlib_node_runtime_t * node,
              vlib_frame_t * from_frame)
 {
-  vlib_combined_counter_main_t * cm = &load_balance_main.lbm_to_counters;
   u32 n_left_from, next_index, * from, * to_next;
   mpls_main_t * mm = &mpls_main;
   u32 thread_index = vlib_get_thread_index();
@@ -183,9 +182,7 @@ VLIB_NODE_FN (mpls_lookup_node) (vlib_main_t * vm,
 
               vnet_buffer (b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-              vlib_increment_combined_counter
-                  (cm, thread_index, lbi0, 1,
-                   vlib_buffer_length_in_chain (vm, b0));
+              load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
           }
           if (MPLS_IS_REPLICATE & lbi1)
           {
@@ -215,9 +212,7 @@ VLIB_NODE_FN (mpls_lookup_node) (vlib_main_t * vm,
 
               vnet_buffer (b1)->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-              vlib_increment_combined_counter
-                  (cm, thread_index, lbi1, 1,
-                   vlib_buffer_length_in_chain (vm, b1));
+              load_balance_to_counter_increment (vm, thread_index, lbi1, b1);
           }
           if (MPLS_IS_REPLICATE & lbi2)
           {
@@ -247,9 +242,7 @@ VLIB_NODE_FN (mpls_lookup_node) (vlib_main_t * vm,
 
               vnet_buffer (b2)->ip.adj_index[VLIB_TX] = dpo2->dpoi_index;
 
-              vlib_increment_combined_counter
-                  (cm, thread_index, lbi2, 1,
-                   vlib_buffer_length_in_chain (vm, b2));
+              load_balance_to_counter_increment (vm, thread_index, lbi2, b2);
           }
           if (MPLS_IS_REPLICATE & lbi3)
           {
@@ -279,9 +272,7 @@ VLIB_NODE_FN (mpls_lookup_node) (vlib_main_t * vm,
 
               vnet_buffer (b3)->ip.adj_index[VLIB_TX] = dpo3->dpoi_index;
 
-              vlib_increment_combined_counter
-                  (cm, thread_index, lbi3, 1,
-                   vlib_buffer_length_in_chain (vm, b3));
+              load_balance_to_counter_increment (vm, thread_index, lbi3, b3);
           }
 
           /*
@@ -412,9 +403,7 @@ VLIB_NODE_FN (mpls_lookup_node) (vlib_main_t * vm,
               next0 = dpo0->dpoi_next_node;
               vnet_buffer (b0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-              vlib_increment_combined_counter
-                  (cm, thread_index, lbi0, 1,
-                   vlib_buffer_length_in_chain (vm, b0));
+              load_balance_to_counter_increment (vm, thread_index, lbi0, b0);
           }
 
           /*
@@ -497,7 +486,6 @@ VLIB_NODE_FN (mpls_load_balance_node) (vlib_main_t * vm,
                   vlib_node_runtime_t * node,
                   vlib_frame_t * frame)
 {
-  vlib_combined_counter_main_t * cm = &load_balance_main.lbm_via_counters;
   u32 n_left_from, n_left_to_next, * from, * to_next;
   u32 thread_index = vlib_get_thread_index();
   u32 next;
@@ -601,12 +589,8 @@ VLIB_NODE_FN (mpls_load_balance_node) (vlib_main_t * vm,
           vnet_buffer (p0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
           vnet_buffer (p1)->ip.adj_index[VLIB_TX] = dpo1->dpoi_index;
 
-          vlib_increment_combined_counter
-              (cm, thread_index, lbi0, 1,
-               vlib_buffer_length_in_chain (vm, p0));
-          vlib_increment_combined_counter
-              (cm, thread_index, lbi1, 1,
-               vlib_buffer_length_in_chain (vm, p1));
+          load_balance_via_counter_increment (vm, thread_index, lbi0, p0);
+          load_balance_via_counter_increment (vm, thread_index, lbi1, p1);
 
           if (PREDICT_FALSE(p0->flags & VLIB_BUFFER_IS_TRACED))
           {
@@ -665,9 +649,7 @@ VLIB_NODE_FN (mpls_load_balance_node) (vlib_main_t * vm,
           next0 = dpo0->dpoi_next_node;
           vnet_buffer (p0)->ip.adj_index[VLIB_TX] = dpo0->dpoi_index;
 
-          vlib_increment_combined_counter
-              (cm, thread_index, lbi0, 1,
-               vlib_buffer_length_in_chain (vm, p0));
+          load_balance_via_counter_increment (vm, thread_index, lbi0, p0);
 
           vlib_validate_buffer_enqueue_x1 (vm, node, next,
                                            to_next, n_left_to_next,
@@ -268,6 +268,74 @@ app_listener_select_worker (application_t * app, app_listener_t * al)
   return application_get_worker (app, wrk_index);
 }
 
+static u32
+app_listener_flow_hash (transport_connection_t * tc)
+{
+  u64 key;
+
+  key = tc->rmt_ip.as_u64[0] ^ tc->rmt_ip.as_u64[1];
+  key ^= tc->lcl_ip.as_u64[0] ^ tc->lcl_ip.as_u64[1];
+  key ^= (u64) tc->rmt_port << 16 | tc->lcl_port;
+  return clib_xxhash (key);
+}
+
+/**
+ * Select worker for a reuseport listener
+ *
+ * Listening workers are partitioned over the vpp workers, so that all the
+ * sessions an app worker accepts live on the same vpp thread, and the flow
+ * hash picks one worker within the partition of the session's thread. If
+ * there are fewer app workers than vpp workers, every vpp worker maps to
+ * one app worker. Nothing is written to the listener, so concurrent
+ * accepts on different threads do not share state.
+ */
+static app_worker_t *
+app_listener_select_worker_reuseport (application_t * app,
+				      app_listener_t * al, session_t * s)
+{
+  u32 n_wrks, n_threads, slot, rank, n_cand, hash;
+  transport_connection_t *tc;
+  uword wrk_index;
+
+  n_wrks = clib_bitmap_count_set_bits (al->workers);
+  n_threads = vlib_num_workers ();
+
+  if (n_wrks == 1)
+    return application_get_worker (app, clib_bitmap_first_set (al->workers));
+
+  if (n_threads && s->thread_index)
+    {
+      slot = vlib_get_worker_index (s->thread_index);
+      if (n_wrks <= n_threads)
+	{
+	  rank = slot % n_wrks;
+	  goto done;
+	}
+      n_cand = n_wrks / n_threads + (slot < n_wrks % n_threads);
+    }
+  else
+    {
+      slot = 0;
+      n_threads = 1;
+      n_cand = n_wrks;
+    }
+
+  tc = session_get_transport (s);
+  hash = tc ? app_listener_flow_hash (tc) : 0;
+  rank = slot + (hash % n_cand) * n_threads;
+
+done:
+  /* *INDENT-OFF* */
+  clib_bitmap_foreach (wrk_index, al->workers, ({
+    if (rank-- == 0)
+      return application_get_worker (app, wrk_index);
+  }));
+  /* *INDENT-ON* */
+
+  ASSERT (0);
+  return app_listener_select_worker (app, al);
+}
+
 session_t *
 app_listener_get_session (app_listener_t * al)
 {
@@ -540,6 +608,8 @@ application_alloc_and_init (app_init_args_t * a)
     props->evt_q_size = options[APP_OPTIONS_EVT_QUEUE_SIZE];
   if (options[APP_OPTIONS_FLAGS] & APP_OPTIONS_FLAGS_EVT_MQ_USE_EVENTFD)
     props->use_mq_eventfd = 1;
+  if (options[APP_OPTIONS_FLAGS] & APP_OPTIONS_FLAGS_EVT_MQ_SPSC)
+    props->use_mq_spsc = 1;
   if (options[APP_OPTIONS_TLS_ENGINE])
     app->tls_engine = options[APP_OPTIONS_TLS_ENGINE];
   props->segment_type = seg_type;
@@ -660,14 +730,19 @@ application_n_workers (application_t * app)
   return pool_elts (app->worker_maps);
 }
 
+/**
+ * Select the app worker that accepts session s on listener ls
+ */
 app_worker_t *
-application_listener_select_worker (session_t * ls)
+application_listener_select_worker (session_t * ls, session_t * s)
 {
   application_t *app;
   app_listener_t *al;
 
   app = application_get (ls->app_index);
   al = app_listener_get (app, ls->al_index);
+  if (al->flags & SESSION_LISTEN_F_REUSEPORT)
+    return app_listener_select_worker_reuseport (app, al, s);
   return app_listener_select_worker (app, al);
 }
 
@@ -705,6 +780,8 @@ application_alloc_worker_and_init (application_t * app, app_worker_t ** wrk)
   app_wrk->listeners_table = hash_create (0, sizeof (u64));
   app_wrk->event_queue = segment_manager_event_queue (sm);
   app_wrk->app_is_builtin = application_is_builtin (app);
+  app_wrk->app_rx_bulk = !app_wrk->app_is_builtin
+    && (app->flags & APP_OPTIONS_FLAGS_EVT_RX_BULK);
 
   *wrk = app_wrk;
 
@@ -975,6 +1052,7 @@ vnet_listen (vnet_listen_args_t * a)
 	return VNET_API_ERROR_ADDRESS_IN_USE;
       if (app_worker_start_listen (app_wrk, app_listener))
 	return -1;
+      app_listener->flags |= a->flags;
       a->handle = app_listener_handle (app_listener);
       return 0;
     }
@@ -985,6 +1063,8 @@ vnet_listen (vnet_listen_args_t * a)
   if ((rv = app_listener_alloc_and_init (app, &a->sep_ext, &app_listener)))
     return rv;
 
+  app_listener->flags = a->flags;
+
   if ((rv = app_worker_start_listen (app_wrk, app_listener)))
     {
       app_listener_cleanup (app_listener);
@@ -63,6 +63,9 @@ typedef struct app_worker_
   u32 api_client_index;
 
   u8 app_is_builtin;
+
+  /** App wants rx notifications coalesced in bulk messages */
+  u8 app_rx_bulk;
 } app_worker_t;
 
 typedef struct app_worker_map_
@@ -74,6 +77,7 @@ typedef struct app_listener_
 {
   clib_bitmap_t *workers;	/**< workers accepting connections */
   u32 accept_rotor;		/**< last worker to accept a connection */
+  u8 flags;			/**< @ref session_listen_flags_t */
   u32 al_index;			/**< app listener index in app pool */
   u32 app_index;		/**< owning app index */
   u32 local_index;		/**< local listening session index */
@@ -211,7 +215,8 @@ application_t *application_lookup (u32 api_client_index);
 application_t *application_lookup_name (const u8 * name);
 app_worker_t *application_get_worker (application_t * app, u32 wrk_index);
 app_worker_t *application_get_default_worker (application_t * app);
-app_worker_t *application_listener_select_worker (session_t * ls);
+app_worker_t *application_listener_select_worker (session_t * ls,
+						  session_t * s);
 int application_change_listener_owner (session_t * s, app_worker_t * app_wrk);
 int application_is_proxy (application_t * app);
 int application_is_builtin (application_t * app);
@@ -277,6 +282,7 @@ session_t *app_worker_first_listener (app_worker_t * app,
 int app_worker_send_event (app_worker_t * app, session_t * s, u8 evt);
 int app_worker_lock_and_send_event (app_worker_t * app, session_t * s,
 				    u8 evt_type);
+int app_worker_flush_rx_evts (u32 thread_index);
 session_t *app_worker_proxy_listener (app_worker_t * app, u8 fib_proto,
 				      u8 transport_proto);
 u8 *format_app_worker (u8 * s, va_list * args);
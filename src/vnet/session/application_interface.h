@@ -105,6 +105,7 @@ typedef struct _vnet_bind_args_t
 
   u32 app_index;
   u32 wrk_map_index;
+  u8 flags;			/**< @ref session_listen_flags_t */
 
   /*
    * Results
@@ -213,6 +214,8 @@ typedef enum
   _(USE_GLOBAL_SCOPE, "App can use global session scope")	\
   _(USE_LOCAL_SCOPE, "App can use local session scope")		\
   _(EVT_MQ_USE_EVENTFD, "Use eventfds for signaling")		\
+  _(EVT_MQ_SPSC, "Lock-free single consumer event mq")		\
+  _(EVT_RX_BULK, "Accepts bulk rx notifications")		\
 
 typedef enum _app_options
 {
@@ -294,6 +297,13 @@ typedef struct
 #undef _
 } app_session_t;
 
+typedef enum session_listen_flags_
+{
+  /** Accepts are spread over the listening workers by flow hash and
+   *  vpp thread instead of round-robin */
+  SESSION_LISTEN_F_REUSEPORT = 1 << 0,
+} session_listen_flags_t;
+
 typedef struct session_listen_msg_
 {
   u32 client_index;
@@ -306,6 +316,7 @@ typedef struct session_listen_msg_
   ip46_address_t ip;
   u32 ckpair_index;
   u8 crypto_engine;
+  u8 flags;
 } __clib_packed session_listen_msg_t;
 
 STATIC_ASSERT (sizeof (session_listen_msg_t) <= SESSION_CTRL_MSG_MAX_SIZE,
@@ -502,6 +513,14 @@ typedef struct app_unmap_segment_msg_
   u64 segment_handle;
 } session_app_del_segment_msg_t;
 
+/** Rx notification for all sessions of an app worker that received data
+ *  in one dispatch. Sent on the ctrl ring as @ref SESSION_IO_EVT_RX_BULK */
+typedef struct session_rx_bulk_msg_
+{
+  u32 n_sessions;
+  u32 session_indices[0];	/**< app session indices */
+} __clib_packed session_rx_bulk_msg_t;
+
 typedef struct app_session_event_
 {
   svm_msg_q_msg_t msg;
@@ -583,6 +602,7 @@ app_send_dgram_raw (svm_fifo_t * f, app_session_transport_t * at,
 {
   u32 max_enqueue, actual_write;
   session_dgram_hdr_t hdr;
+  svm_fifo_seg_t segs[2];
   int rv;
 
   max_enqueue = svm_fifo_max_enqueue_prod (f);
@@ -598,10 +618,15 @@ app_send_dgram_raw (svm_fifo_t * f, app_session_transport_t * at,
   hdr.rmt_port = at->rmt_port;
   clib_memcpy_fast (&hdr.lcl_ip, &at->lcl_ip, sizeof (ip46_address_t));
   hdr.lcl_port = at->lcl_port;
-  rv = svm_fifo_enqueue (f, sizeof (hdr), (u8 *) & hdr);
-  ASSERT (rv == sizeof (hdr));
 
-  rv = svm_fifo_enqueue (f, actual_write, data);
+  /* Header and payload become visible to vpp together */
+  segs[0].data = (u8 *) & hdr;
+  segs[0].len = sizeof (hdr);
+  segs[1].data = data;
+  segs[1].len = actual_write;
+  rv = svm_fifo_enqueue_segments (f, segs, 2, 0 /* allow partial */ );
+  ASSERT (rv == sizeof (hdr) + actual_write);
+  rv -= sizeof (hdr);
   if (do_evt)
     {
       if (rv > 0 && svm_fifo_set_event (f))
@@ -284,7 +284,7 @@ ct_connect (app_worker_t * client_wrk, session_t * ll,
   ss->listener_handle = listen_session_get_handle (ll);
   ss->session_state = SESSION_STATE_CREATED;
 
-  server_wrk = application_listener_select_worker (ll);
+  server_wrk = application_listener_select_worker (ll, ss);
   ss->app_wrk_index = server_wrk->wrk_index;
 
   sct->c_s_index = ss->session_index;
@@ -277,7 +277,7 @@ app_worker_init_accepted (session_t * s)
   session_t *listener;
 
   listener = listen_session_get_from_handle (s->listener_handle);
-  app_wrk = application_listener_select_worker (listener);
+  app_wrk = application_listener_select_worker (listener, s);
   s->app_wrk_index = app_wrk->wrk_index;
 
   sm = app_worker_get_listen_segment_manager (app_wrk, listener);
@@ -545,25 +545,17 @@ app_worker_application_is_builtin (app_worker_t * app_wrk)
   return app_wrk->app_is_builtin;
 }
 
-static inline int
-app_send_io_evt_rx (app_worker_t * app_wrk, session_t * s)
+/**
+ * Send a rx event for one session on the io ring. The fifo event flag
+ * is only set if the event is sent, so the next enqueue retries it.
+ */
+static int
+app_send_io_evt_rx_session (app_worker_t * app_wrk, session_t * s)
 {
   session_event_t *evt;
   svm_msg_q_msg_t msg;
   svm_msg_q_t *mq;
 
-  if (app_worker_application_is_builtin (app_wrk))
-    return app_worker_builtin_rx (app_wrk, s);
-
-  /* Make sure the session is in established state within external apps.
-   * Should be removed once we confirm closes to apps */
-  if (PREDICT_FALSE (s->session_state != SESSION_STATE_READY
-		     && s->session_state != SESSION_STATE_LISTENING))
-    return 0;
-
-  if (svm_fifo_has_event (s->rx_fifo))
-    return 0;
-
   mq = app_wrk->event_queue;
   svm_msg_q_lock (mq);
 
@@ -592,6 +584,157 @@ app_send_io_evt_rx (app_worker_t * app_wrk, session_t * s)
   return 0;
 }
 
+/**
+ * Queue session for a bulk rx notification, sent when the thread
+ * flushes its rx events, see @ref app_worker_flush_rx_evts
+ */
+static inline void
+app_worker_add_rx_pending (app_worker_t * app_wrk, session_t * s)
+{
+  session_worker_t *wrk = session_main_get_worker (vlib_get_thread_index ());
+  session_handle_t **pending;
+
+  (void) svm_fifo_set_event (s->rx_fifo);
+
+  vec_validate (wrk->app_wrk_rx_pending, app_wrk->wrk_index);
+  pending = &wrk->app_wrk_rx_pending[app_wrk->wrk_index];
+  if (!vec_len (*pending))
+    vec_add1 (wrk->app_wrks_w_rx_pending, app_wrk->wrk_index);
+  vec_add1 (*pending, session_handle (s));
+}
+
+/**
+ * Send rx notifications for a list of sessions in bulk messages
+ *
+ * Bulk messages share the small ctrl ring with accept, connect and
+ * disconnect notifications. They only use the first half of it, the
+ * sessions that do not fit get per session events on the io ring.
+ */
+static int
+app_send_io_evt_rx_bulk (app_worker_t * app_wrk, session_handle_t * shs)
+{
+  u32 i, j, n_msgs, max_per_msg, n_sessions = vec_len (shs);
+  svm_msg_q_msg_t msgs[32];
+  session_rx_bulk_msg_t *bm;
+  svm_msg_q_ring_t *ring;
+  session_event_t *evt;
+  svm_msg_q_t *mq;
+  session_t *s;
+  int rv = 0;
+
+  mq = app_wrk->event_queue;
+  ring = svm_msg_q_ring (mq, SESSION_MQ_CTRL_EVT_RING);
+  max_per_msg = (ring->elsize - sizeof (session_event_t)
+		 - sizeof (session_rx_bulk_msg_t)) / sizeof (u32);
+
+  for (i = 0; i < n_sessions; i += n_msgs * max_per_msg)
+    {
+      n_msgs = (n_sessions - i + max_per_msg - 1) / max_per_msg;
+      n_msgs = clib_min (n_msgs, ARRAY_LEN (msgs));
+
+      svm_msg_q_lock (mq);
+      if (PREDICT_FALSE (svm_msg_q_free_slots (mq) < n_msgs
+			 || ring->nitems - ring->cursize
+			 < n_msgs + ring->nitems / 2))
+	{
+	  svm_msg_q_unlock (mq);
+	  goto per_session;
+	}
+
+      for (j = 0; j < n_msgs; j++)
+	{
+	  msgs[j] = svm_msg_q_alloc_msg_w_ring (mq, SESSION_MQ_CTRL_EVT_RING);
+	  evt = (session_event_t *) svm_msg_q_msg_data (mq, &msgs[j]);
+	  evt->event_type = SESSION_IO_EVT_RX_BULK;
+	  bm = (session_rx_bulk_msg_t *) evt->data;
+	  bm->n_sessions = 0;
+	}
+
+      for (j = i; j < clib_min (n_sessions, i + n_msgs * max_per_msg); j++)
+	{
+	  evt = svm_msg_q_msg_data (mq, &msgs[(j - i) / max_per_msg]);
+	  bm = (session_rx_bulk_msg_t *) evt->data;
+	  s = session_get_from_handle_if_valid (shs[j]);
+	  if (!s || !s->rx_fifo)
+	    continue;
+	  bm->session_indices[bm->n_sessions++] =
+	    s->rx_fifo->client_session_index;
+	}
+
+      svm_msg_q_add_batch_and_unlock (mq, msgs, n_msgs);
+    }
+
+  return 0;
+
+per_session:
+  for (; i < n_sessions; i++)
+    {
+      if (!(s = session_get_from_handle_if_valid (shs[i])) || !s->rx_fifo)
+	continue;
+      svm_fifo_unset_event (s->rx_fifo);
+      if (app_send_io_evt_rx_session (app_wrk, s))
+	rv = -1;
+    }
+  return rv;
+}
+
+/**
+ * Send the rx notifications accumulated by a thread
+ *
+ * Each app worker gets one message that lists all of its sessions, or
+ * more if they do not fit in one ctrl ring element, or per session
+ * events when the ctrl ring is busy.
+ *
+ * @return number of app workers that could not be notified
+ */
+int
+app_worker_flush_rx_evts (u32 thread_index)
+{
+  session_worker_t *wrk = session_main_get_worker (thread_index);
+  session_handle_t *pending;
+  app_worker_t *app_wrk;
+  int i, errors = 0;
+  u32 wrk_index;
+
+  for (i = 0; i < vec_len (wrk->app_wrks_w_rx_pending); i++)
+    {
+      wrk_index = wrk->app_wrks_w_rx_pending[i];
+      pending = wrk->app_wrk_rx_pending[wrk_index];
+      app_wrk = app_worker_get_if_valid (wrk_index);
+      if (app_wrk && app_send_io_evt_rx_bulk (app_wrk, pending))
+	errors++;
+      vec_reset_length (pending);
+      wrk->app_wrk_rx_pending[wrk_index] = pending;
+    }
+  vec_reset_length (wrk->app_wrks_w_rx_pending);
+
+  return errors;
+}
+
+static inline int
+app_send_io_evt_rx (app_worker_t * app_wrk, session_t * s)
+{
+  if (app_worker_application_is_builtin (app_wrk))
+    return app_worker_builtin_rx (app_wrk, s);
+
+  /* Make sure the session is in established state within external apps.
+   * Should be removed once we confirm closes to apps */
+  if (PREDICT_FALSE (s->session_state != SESSION_STATE_READY
+		     && s->session_state != SESSION_STATE_LISTENING))
+    return 0;
+
+  if (svm_fifo_has_event (s->rx_fifo))
+    return 0;
+
+  if (app_wrk->app_rx_bulk)
+    {
+      app_worker_add_rx_pending (app_wrk, s);
+      return 0;
+    }
+
+  return app_send_io_evt_rx_session (app_wrk, s);
+}
+
 static inline int
 app_send_io_evt_tx (app_worker_t * app_wrk, session_t * s)
 {
@@ -771,6 +771,7 @@ segment_manager_alloc_queue (fifo_segment_t * segment,
   /* *INDENT-ON* */
   cfg->consumer_pid = 0;
   cfg->n_rings = 2;
+  cfg->flags = props->use_mq_spsc ? SVM_MSG_Q_F_SPSC : 0;
   cfg->q_nitems = props->evt_q_size;
   cfg->ring_cfgs = rc;
 
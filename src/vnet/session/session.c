@@ -473,15 +473,31 @@ session_enqueue_dgram_connection (session_t * s,
   ASSERT (svm_fifo_max_enqueue_prod (s->rx_fifo)
 	  >= b->current_length + sizeof (*hdr));
 
-  svm_fifo_enqueue (s->rx_fifo, sizeof (session_dgram_hdr_t), (u8 *) hdr);
-  enqueued = svm_fifo_enqueue (s->rx_fifo, b->current_length,
-			       vlib_buffer_get_current (b));
-  if (PREDICT_FALSE ((b->flags & VLIB_BUFFER_NEXT_PRESENT) && enqueued >= 0))
+  if (PREDICT_TRUE (!(b->flags & VLIB_BUFFER_NEXT_PRESENT)))
     {
-      in_order_off = enqueued > b->current_length ? enqueued : 0;
-      rv = session_enqueue_chain_tail (s, b, in_order_off, 1);
-      if (rv > 0)
-	enqueued += rv;
+      /* Header and payload become visible to the consumer together */
+      svm_fifo_seg_t segs[2] = {
+	{(u8 *) hdr, sizeof (session_dgram_hdr_t)},
+	{vlib_buffer_get_current (b), b->current_length}
+      };
+      enqueued = svm_fifo_enqueue_segments (s->rx_fifo, segs, 2,
+					    0 /* allow partial */ );
+      if (PREDICT_TRUE (enqueued > 0))
+	enqueued -= sizeof (session_dgram_hdr_t);
+    }
+  else
+    {
+      svm_fifo_enqueue (s->rx_fifo, sizeof (session_dgram_hdr_t),
+			(u8 *) hdr);
+      enqueued = svm_fifo_enqueue (s->rx_fifo, b->current_length,
+				   vlib_buffer_get_current (b));
+      if (enqueued >= 0)
+	{
+	  in_order_off = enqueued > b->current_length ? enqueued : 0;
+	  rv = session_enqueue_chain_tail (s, b, in_order_off, 1);
+	  if (rv > 0)
+	    enqueued += rv;
+	}
     }
   if (queue_event)
     {
@@ -681,6 +697,9 @@ session_main_flush_enqueue_events (u8 transport_proto, u32 thread_index)
   vec_reset_length (indices);
   wrk->session_to_enqueue[transport_proto] = indices;
 
+  /* Apps that support it get one rx message for all sessions */
+  errors += app_worker_flush_rx_evts (vlib_get_thread_index ());
+
   return errors;
 }
 
@@ -1374,6 +1393,7 @@ session_vpp_event_queues_allocate (session_main_t * smm)
       };
       cfg->consumer_pid = 0;
       cfg->n_rings = 2;
+      cfg->flags = 0;
       cfg->q_nitems = evt_q_length;
       cfg->ring_cfgs = rc;
       smm->wrk[i].vpp_event_queue = svm_msg_q_alloc (cfg);
@@ -42,6 +42,9 @@ typedef enum
     SESSION_N_ERROR,
 } session_error_t;
 
+/** Max payload of dgram super segments, so they fit an ip packet */
+#define SESSION_TX_DGRAM_GSO_MAX_SZ (65535 - TRANSPORT_MAX_HDRS_LEN)
+
 typedef struct session_tx_context_
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -58,8 +61,12 @@ typedef struct session_tx_context_
   u16 snd_mss;
   u16 n_segs_per_evt;
   u8 n_bufs_per_seg;
+  /** Dgrams sent in this burst, if batched. One per buffer */
+  u16 n_dgrams;
     CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
   session_dgram_hdr_t hdr;
+  /** Read cursor into the tx fifo for transports that peek */
+  svm_fifo_cursor_t fifo_cursor;
 } session_tx_context_t;
 
 typedef struct session_evt_elt
@@ -125,6 +132,15 @@ typedef struct session_worker_
   /** Vector of nexts for the pending tx buffers */
   u16 *pending_tx_nexts;
 
+  /** Vector of messages dequeued from the vpp event queue */
+  svm_msg_q_msg_t *mq_msgs;
+
+  /** Per app worker vectors of sessions with pending rx notifications */
+  session_handle_t **app_wrk_rx_pending;
+
+  /** App workers with pending rx notifications */
+  u32 *app_wrks_w_rx_pending;
+
 #if SESSION_DEBUG
   /** last event poll time by thread */
   clib_time_type_t last_event_poll;
@@ -838,6 +838,57 @@ session_lookup_half_open_connection (u64 handle, u8 proto, u8 is_ip4)
   return 0;
 }
 
+/**
+ * Lookup ip4 connection that is not amongst the established ones
+ *
+ * Tries half-open connections, the session rules table and listeners,
+ * in that order. Second half of @ref session_lookup_connection_wt4
+ */
+always_inline transport_connection_t *
+session_lookup_connection_wt4_miss (session_table_t * st, session_kv4_t * kv4,
+				    ip4_address_t * lcl, ip4_address_t * rmt,
+				    u16 lcl_port, u16 rmt_port, u8 proto,
+				    u8 * result)
+{
+  session_t *s;
+  u32 action_index;
+  int rv;
+
+  /*
+   * Try half-open connections
+   */
+  rv = clib_bihash_search_inline_16_8 (&st->v4_half_open_hash, kv4);
+  if (rv == 0)
+    return transport_get_half_open (proto, kv4->value & 0xFFFFFFFF);
+
+  /*
+   * Check the session rules table
+   */
+  action_index = session_rules_table_lookup4 (&st->session_rules[proto], lcl,
+					      rmt, lcl_port, rmt_port);
+  if (session_lookup_action_index_is_valid (action_index))
+    {
+      if (action_index == SESSION_RULES_TABLE_ACTION_DROP)
+	{
+	  *result = SESSION_LOOKUP_RESULT_FILTERED;
+	  return 0;
+	}
+      if ((s = session_lookup_action_to_session (action_index,
+						 FIB_PROTOCOL_IP4, proto)))
+	return transport_get_listener (proto, s->connection_index);
+      return 0;
+    }
+
+  /*
+   * If nothing is found, check if any listener is available
+   */
+  s = session_lookup_listener4_i (st, lcl, lcl_port, proto, 1);
+  if (s)
+    return transport_get_listener (proto, s->connection_index);
+
+  return 0;
+}
+
 /**
  * Lookup connection with ip4 and transport layer information
  *
@@ -873,7 +924,6 @@ session_lookup_connection_wt4 (u32 fib_index, ip4_address_t * lcl,
   session_table_t *st;
   session_kv4_t kv4;
   session_t *s;
-  u32 action_index;
   int rv;
 
   st = session_table_get_for_fib_index (FIB_PROTOCOL_IP4, fib_index);
@@ -897,39 +947,120 @@ session_lookup_connection_wt4 (u32 fib_index, ip4_address_t * lcl,
 				       thread_index);
     }
 
-  /*
-   * Try half-open connections
-   */
-  rv = clib_bihash_search_inline_16_8 (&st->v4_half_open_hash, &kv4);
-  if (rv == 0)
-    return transport_get_half_open (proto, kv4.value & 0xFFFFFFFF);
+  return session_lookup_connection_wt4_miss (st, &kv4, lcl, rmt, lcl_port,
+					     rmt_port, proto, result);
+}
+
+/**
+ * Lookup a batch of ip4 connections
+ *
+ * Lookup logic is identical to that of @ref session_lookup_connection_wt4
+ * but the work is split in two passes over the batch. The first hashes
+ * the keys and searches the established sessions in groups of pipelined,
+ * prefetched lookups. The second runs the half-open, rules table and
+ * listener lookups for the keys that missed, which are typically few.
+ *
+ * @param keys		connection endpoints, local being the receiver
+ * @param n_keys	number of keys
+ * @param proto		transport protocol (e.g., tcp, udp)
+ * @param thread_index	thread index for request
+ * @param tcs		returned connections, 0 if not found
+ * @param results	returned lookup results
+ */
+void
+session_lookup_connections_wt4 (session_lookup_key4_t * keys, u32 n_keys,
+				u8 proto, u32 thread_index,
+				transport_connection_t ** tcs, u8 * results)
+{
+  session_kv4_t kvs[BIHASH_SEARCH_MULTI_MAX], values[BIHASH_SEARCH_MULTI_MAX];
+  session_table_t *st = 0, *sts[BIHASH_SEARCH_MULTI_MAX];
+  session_t *ss[BIHASH_SEARCH_MULTI_MAX];
+  u64 hashes[BIHASH_SEARCH_MULTI_MAX];
+  u32 i, j, n, n_run, found, fib_index = ~0;
+  session_lookup_key4_t *k;
+  session_kv4_t kv4;
 
   /*
-   * Check the session rules table
+   * Lookup sessions amongst established ones
    */
-  action_index = session_rules_table_lookup4 (&st->session_rules[proto], lcl,
-					      rmt, lcl_port, rmt_port);
-  if (session_lookup_action_index_is_valid (action_index))
+  for (j = 0; j < n_keys; j += n)
     {
-      if (action_index == SESSION_RULES_TABLE_ACTION_DROP)
+      n = clib_min (n_keys - j, BIHASH_SEARCH_MULTI_MAX);
+
+      for (i = 0; i < n; i++)
 	{
-	  *result = SESSION_LOOKUP_RESULT_FILTERED;
-	  return 0;
+	  k = &keys[j + i];
+	  if (k->fib_index != fib_index)
+	    {
+	      fib_index = k->fib_index;
+	      st = session_table_get_for_fib_index (FIB_PROTOCOL_IP4,
+						    fib_index);
+	    }
+	  sts[i] = st;
+	  make_v4_ss_kv (&kvs[i], &k->lcl, &k->rmt, k->lcl_port, k->rmt_port,
+			 proto);
+	  hashes[i] = clib_bihash_hash_16_8 (&kvs[i]);
+	  tcs[j + i] = 0;
+	  results[j + i] = SESSION_LOOKUP_RESULT_NONE;
+	}
+
+      /* Keys of a frame normally share the table, search runs of them */
+      found = 0;
+      for (i = 0; i < n; i += n_run)
+	{
+	  for (n_run = 1; i + n_run < n && sts[i + n_run] == sts[i]; n_run++)
+	    ;
+	  if (PREDICT_FALSE (!sts[i]))
+	    continue;
+	  found |= clib_bihash_search_multi_16_8 (&sts[i]->v4_session_hash,
+						  &hashes[i], &kvs[i],
+						  &values[i], n_run) << i;
+	}
+
+      for (i = 0; i < n; i++)
+	{
+	  if (!(found & (1 << i)))
+	    continue;
+	  if (PREDICT_FALSE ((u32) (values[i].value >> 32) != thread_index))
+	    {
+	      results[j + i] = SESSION_LOOKUP_RESULT_WRONG_THREAD;
+	      found &= ~(1 << i);
+	      continue;
+	    }
+	  ss[i] = session_get (values[i].value & 0xFFFFFFFFULL, thread_index);
+	  CLIB_PREFETCH (ss[i], CLIB_CACHE_LINE_BYTES, LOAD);
+	}
+
+      while (found)
+	{
+	  i = count_trailing_zeros (found);
+	  found &= found - 1;
+	  tcs[j + i] = transport_get_connection (proto, ss[i]->connection_index,
+						 thread_index);
 	}
-      if ((s = session_lookup_action_to_session (action_index,
-						 FIB_PROTOCOL_IP4, proto)))
-	return transport_get_listener (proto, s->connection_index);
-      return 0;
     }
 
   /*
-   * If nothing is found, check if any listener is available
+   * Half-open connections, rules and listeners for the misses
    */
-  s = session_lookup_listener4_i (st, lcl, lcl_port, proto, 1);
-  if (s)
-    return transport_get_listener (proto, s->connection_index);
-
-  return 0;
+  for (i = 0; i < n_keys; i++)
+    {
+      if (tcs[i] || results[i] != SESSION_LOOKUP_RESULT_NONE)
+	continue;
+      k = &keys[i];
+      if (k->fib_index != fib_index)
+	{
+	  fib_index = k->fib_index;
+	  st = session_table_get_for_fib_index (FIB_PROTOCOL_IP4, fib_index);
+	}
+      if (PREDICT_FALSE (!st))
+	continue;
+      make_v4_ss_kv (&kv4, &k->lcl, &k->rmt, k->lcl_port, k->rmt_port, proto);
+      tcs[i] = session_lookup_connection_wt4_miss (st, &kv4, &k->lcl,
+						   &k->rmt, k->lcl_port,
+						   k->rmt_port, proto,
+						   &results[i]);
+    }
 }
 
 /**
@@ -1063,6 +1194,51 @@ session_lookup_safe4 (u32 fib_index, ip4_address_t * lcl, ip4_address_t * rmt,
   return 0;
 }
 
+/**
+ * Lookup ip6 connection that is not amongst the established ones
+ *
+ * Tries half-open connections, the session rules table and listeners,
+ * in that order. Second half of @ref session_lookup_connection_wt6
+ */
+always_inline transport_connection_t *
+session_lookup_connection_wt6_miss (session_table_t * st, session_kv6_t * kv6,
+				    ip6_address_t * lcl, ip6_address_t * rmt,
+				    u16 lcl_port, u16 rmt_port, u8 proto,
+				    u8 * result)
+{
+  session_t *s;
+  u32 action_index;
+  int rv;
+
+  /* Try half-open connections */
+  rv = clib_bihash_search_inline_48_8 (&st->v6_half_open_hash, kv6);
+  if (rv == 0)
+    return transport_get_half_open (proto, kv6->value & 0xFFFFFFFF);
+
+  /* Check the session rules table */
+  action_index = session_rules_table_lookup6 (&st->session_rules[proto], lcl,
+					      rmt, lcl_port, rmt_port);
+  if (session_lookup_action_index_is_valid (action_index))
+    {
+      if (action_index == SESSION_RULES_TABLE_ACTION_DROP)
+	{
+	  *result = SESSION_LOOKUP_RESULT_FILTERED;
+	  return 0;
+	}
+      if ((s = session_lookup_action_to_session (action_index,
+						 FIB_PROTOCOL_IP6, proto)))
+	return transport_get_listener (proto, s->connection_index);
+      return 0;
+    }
+
+  /* If nothing is found, check if any listener is available */
+  s = session_lookup_listener6_i (st, lcl, lcl_port, proto, 1);
+  if (s)
+    return transport_get_listener (proto, s->connection_index);
+
+  return 0;
+}
+
 /**
  * Lookup connection with ip6 and transport layer information
  *
@@ -1097,7 +1273,6 @@ session_lookup_connection_wt6 (u32 fib_index, ip6_address_t * lcl,
   session_table_t *st;
   session_t *s;
   session_kv6_t kv6;
-  u32 action_index;
   int rv;
 
   st = session_table_get_for_fib_index (FIB_PROTOCOL_IP6, fib_index);
@@ -1119,33 +1294,111 @@ session_lookup_connection_wt6 (u32 fib_index, ip6_address_t * lcl,
 				       thread_index);
     }
 
-  /* Try half-open connections */
-  rv = clib_bihash_search_inline_48_8 (&st->v6_half_open_hash, &kv6);
-  if (rv == 0)
-    return transport_get_half_open (proto, kv6.value & 0xFFFFFFFF);
+  return session_lookup_connection_wt6_miss (st, &kv6, lcl, rmt, lcl_port,
+					     rmt_port, proto, result);
+}
 
-  /* Check the session rules table */
-  action_index = session_rules_table_lookup6 (&st->session_rules[proto], lcl,
-					      rmt, lcl_port, rmt_port);
-  if (session_lookup_action_index_is_valid (action_index))
+/**
+ * Lookup a batch of ip6 connections
+ *
+ * Lookup logic is identical to that of @ref session_lookup_connection_wt6
+ * and batching to that of @ref session_lookup_connections_wt4
+ *
+ * @param keys		connection endpoints, local being the receiver
+ * @param n_keys	number of keys
+ * @param proto		transport protocol (e.g., tcp, udp)
+ * @param thread_index	thread index for request
+ * @param tcs		returned connections, 0 if not found
+ * @param results	returned lookup results
+ */
+void
+session_lookup_connections_wt6 (session_lookup_key6_t * keys, u32 n_keys,
+				u8 proto, u32 thread_index,
+				transport_connection_t ** tcs, u8 * results)
+{
+  session_kv6_t kvs[BIHASH_SEARCH_MULTI_MAX], values[BIHASH_SEARCH_MULTI_MAX];
+  session_table_t *st = 0, *sts[BIHASH_SEARCH_MULTI_MAX];
+  session_t *ss[BIHASH_SEARCH_MULTI_MAX];
+  u64 hashes[BIHASH_SEARCH_MULTI_MAX];
+  u32 i, j, n, n_run, found, fib_index = ~0;
+  session_lookup_key6_t *k;
+  session_kv6_t kv6;
+
+  for (j = 0; j < n_keys; j += n)
     {
-      if (action_index == SESSION_RULES_TABLE_ACTION_DROP)
+      n = clib_min (n_keys - j, BIHASH_SEARCH_MULTI_MAX);
+
+      for (i = 0; i < n; i++)
 	{
-	  *result = SESSION_LOOKUP_RESULT_FILTERED;
-	  return 0;
+	  k = &keys[j + i];
+	  if (k->fib_index != fib_index)
+	    {
+	      fib_index = k->fib_index;
+	      st = session_table_get_for_fib_index (FIB_PROTOCOL_IP6,
+						    fib_index);
+	    }
+	  sts[i] = st;
+	  make_v6_ss_kv (&kvs[i], &k->lcl, &k->rmt, k->lcl_port, k->rmt_port,
+			 proto);
+	  hashes[i] = clib_bihash_hash_48_8 (&kvs[i]);
+	  tcs[j + i] = 0;
+	  results[j + i] = SESSION_LOOKUP_RESULT_NONE;
 	}
-      if ((s = session_lookup_action_to_session (action_index,
-						 FIB_PROTOCOL_IP6, proto)))
-	return transport_get_listener (proto, s->connection_index);
-      return 0;
-    }
 
-  /* If nothing is found, check if any listener is available */
-  s = session_lookup_listener6_i (st, lcl, lcl_port, proto, 1);
-  if (s)
-    return transport_get_listener (proto, s->connection_index);
+      found = 0;
+      for (i = 0; i < n; i += n_run)
+	{
+	  for (n_run = 1; i + n_run < n && sts[i + n_run] == sts[i]; n_run++)
+	    ;
+	  if (PREDICT_FALSE (!sts[i]))
+	    continue;
+	  found |= clib_bihash_search_multi_48_8 (&sts[i]->v6_session_hash,
+						  &hashes[i], &kvs[i],
+						  &values[i], n_run) << i;
+	}
 
-  return 0;
+      for (i = 0; i < n; i++)
+	{
+	  if (!(found & (1 << i)))
+	    continue;
+	  ASSERT ((u32) (values[i].value >> 32) == thread_index);
+	  if (PREDICT_FALSE ((u32) (values[i].value >> 32) != thread_index))
+	    {
+	      results[j + i] = SESSION_LOOKUP_RESULT_WRONG_THREAD;
+	      found &= ~(1 << i);
+	      continue;
+	    }
+	  ss[i] = session_get (values[i].value & 0xFFFFFFFFULL, thread_index);
+	  CLIB_PREFETCH (ss[i], CLIB_CACHE_LINE_BYTES, LOAD);
+	}
+
+      while (found)
+	{
+	  i = count_trailing_zeros (found);
+	  found &= found - 1;
+	  tcs[j + i] = transport_get_connection (proto, ss[i]->connection_index,
+						 thread_index);
+	}
+    }
+
+  for (i = 0; i < n_keys; i++)
+    {
+      if (tcs[i] || results[i] != SESSION_LOOKUP_RESULT_NONE)
+	continue;
+      k = &keys[i];
+      if (k->fib_index != fib_index)
+	{
+	  fib_index = k->fib_index;
+	  st = session_table_get_for_fib_index (FIB_PROTOCOL_IP6, fib_index);
+	}
+      if (PREDICT_FALSE (!st))
+	continue;
+      make_v6_ss_kv (&kv6, &k->lcl, &k->rmt, k->lcl_port, k->rmt_port, proto);
+      tcs[i] = session_lookup_connection_wt6_miss (st, &kv6, &k->lcl,
+						   &k->rmt, k->lcl_port,
+						   k->rmt_port, proto,
+						   &results[i]);
+    }
 }
 
 /**
@@ -29,6 +29,25 @@ typedef enum session_lookup_result_
   SESSION_LOOKUP_RESULT_FILTERED
 } session_lookup_result_t;
 
+/** Endpoints of a connection to be looked up, local being the receiver */
+typedef struct session_lookup_key4_
+{
+  u32 fib_index;
+  ip4_address_t lcl;
+  ip4_address_t rmt;
+  u16 lcl_port;
+  u16 rmt_port;
+} session_lookup_key4_t;
+
+typedef struct session_lookup_key6_
+{
+  u32 fib_index;
+  ip6_address_t lcl;
+  ip6_address_t rmt;
+  u16 lcl_port;
+  u16 rmt_port;
+} session_lookup_key6_t;
+
 session_t *session_lookup_safe4 (u32 fib_index, ip4_address_t * lcl,
 				 ip4_address_t * rmt, u16 lcl_port,
 				 u16 rmt_port, u8 proto);
@@ -42,6 +61,10 @@ transport_connection_t *session_lookup_connection_wt4 (u32 fib_index,
 						       u16 rmt_port, u8 proto,
 						       u32 thread_index,
 						       u8 * is_filtered);
+void session_lookup_connections_wt4 (session_lookup_key4_t * keys,
+				     u32 n_keys, u8 proto, u32 thread_index,
+				     transport_connection_t ** tcs,
+				     u8 * results);
 transport_connection_t *session_lookup_connection4 (u32 fib_index,
 						    ip4_address_t * lcl,
 						    ip4_address_t * rmt,
@@ -54,6 +77,10 @@ transport_connection_t *session_lookup_connection_wt6 (u32 fib_index,
 						       u16 rmt_port, u8 proto,
 						       u32 thread_index,
 						       u8 * is_filtered);
+void session_lookup_connections_wt6 (session_lookup_key6_t * keys,
+				     u32 n_keys, u8 proto, u32 thread_index,
+				     transport_connection_t ** tcs,
+				     u8 * results);
 transport_connection_t *session_lookup_connection6 (u32 fib_index,
 						    ip6_address_t * lcl,
 						    ip6_address_t * rmt,
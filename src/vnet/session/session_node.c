@@ -58,6 +58,7 @@ session_mq_listen_handler (void *data)
   a->sep_ext.crypto_engine = mp->crypto_engine;
   a->app_index = app->app_index;
   a->wrk_map_index = mp->wrk_index;
+  a->flags = mp->flags;
 
   if ((rv = vnet_listen (a)))
     clib_warning ("listen returned: %d", rv);
@@ -582,8 +583,8 @@ session_tx_fifo_chain_tail (vlib_main_t * vm, session_tx_context_t * ctx,
       data = vlib_buffer_get_current (chain_b);
       if (peek_data)
 	{
-	  n_bytes_read = svm_fifo_peek (ctx->s->tx_fifo,
-					ctx->tx_offset, len_to_deq, data);
+	  n_bytes_read = svm_fifo_cursor_copy (&ctx->fifo_cursor, data,
+					       len_to_deq);
 	  ctx->tx_offset += n_bytes_read;
 	}
       else
@@ -651,8 +652,8 @@ session_tx_fill_buffer (vlib_main_t * vm, session_tx_context_t * ctx,
 
   if (peek_data)
     {
-      n_bytes_read = svm_fifo_peek (ctx->s->tx_fifo, ctx->tx_offset,
-				    len_to_deq, data0);
+      n_bytes_read = svm_fifo_cursor_copy (&ctx->fifo_cursor, data0,
+					   len_to_deq);
       ASSERT (n_bytes_read > 0);
       /* Keep track of progress locally, transport is also supposed to
        * increment it independently when pushing the header */
@@ -684,6 +685,9 @@ session_tx_fill_buffer (vlib_main_t * vm, session_tx_context_t * ctx,
 	    {
 	      offset = hdr->data_length + SESSION_CONN_HDR_LEN;
 	      svm_fifo_dequeue_drop (f, offset);
+	      /* Batched dgrams, load header of the next one */
+	      if (ctx->n_dgrams && ctx->left_to_snd > n_bytes_read)
+		svm_fifo_peek (f, 0, sizeof (ctx->hdr), (u8 *) & ctx->hdr);
 	    }
 	}
       else
@@ -747,11 +751,64 @@ session_tx_get_transport (session_tx_context_t * ctx, u8 peek_data)
     }
 }
 
+/**
+ * Try to send multiple dgrams of a connected session in one burst
+ *
+ * Dgrams that fit one buffer and are not fragmented into multiple
+ * segments are sent one per buffer, until the first one that does not
+ * fit, the snd space is exhausted or the node's burst size is reached.
+ * Listeners are excluded because the remote endpoint may differ from one
+ * dgram to the next. First dgram header is expected in ctx->hdr.
+ *
+ * @return 1 if dgrams are batched, 0 otherwise
+ */
+always_inline int
+session_tx_set_dgram_batch_params (vlib_main_t * vm,
+				   session_tx_context_t * ctx, u32 max_segs)
+{
+  u32 max_len, offset = 0, n_bytes = 0;
+  session_dgram_pre_hdr_t phdr;
+
+  max_len = clib_min (ctx->snd_mss, vlib_buffer_get_default_data_size (vm)
+		      - TRANSPORT_MAX_HDRS_LEN);
+  if (ctx->s->session_state == SESSION_STATE_LISTENING
+      || ctx->hdr.data_offset || ctx->hdr.data_length > max_len)
+    return 0;
+
+  phdr.data_length = ctx->hdr.data_length;
+  phdr.data_offset = 0;
+  while (1)
+    {
+      if (phdr.data_length > max_len || phdr.data_offset
+	  || n_bytes + phdr.data_length > ctx->snd_space
+	  || offset + SESSION_CONN_HDR_LEN + phdr.data_length
+	  > ctx->max_dequeue)
+	break;
+      n_bytes += phdr.data_length;
+      offset += SESSION_CONN_HDR_LEN + phdr.data_length;
+      ctx->n_dgrams += 1;
+      if (ctx->n_dgrams == max_segs
+	  || ctx->max_dequeue - offset <= SESSION_CONN_HDR_LEN)
+	break;
+      svm_fifo_peek (ctx->s->tx_fifo, offset, sizeof (phdr), (u8 *) & phdr);
+    }
+
+  if (!ctx->n_dgrams)
+    return 0;
+
+  ctx->max_dequeue = ctx->max_len_to_snd = n_bytes;
+  ctx->n_segs_per_evt = ctx->n_dgrams;
+  ctx->n_bufs_per_seg = 1;
+  ctx->deq_per_buf = ctx->deq_per_first_buf = max_len;
+  return 1;
+}
+
 always_inline void
 session_tx_set_dequeue_params (vlib_main_t * vm, session_tx_context_t * ctx,
 			       u32 max_segs, u8 peek_data)
 {
   u32 n_bytes_per_buf, n_bytes_per_seg;
+  ctx->n_dgrams = 0;
   ctx->max_dequeue = svm_fifo_max_dequeue_cons (ctx->s->tx_fifo);
   if (peek_data)
     {
@@ -763,6 +820,8 @@ session_tx_set_dequeue_params (vlib_main_t * vm, session_tx_context_t * ctx,
 	  return;
 	}
       ctx->max_dequeue -= ctx->tx_offset;
+      svm_fifo_cursor_init (&ctx->fifo_cursor, ctx->s->tx_fifo,
+			    ctx->tx_offset);
     }
   else
     {
@@ -776,6 +835,8 @@ session_tx_set_dequeue_params (vlib_main_t * vm, session_tx_context_t * ctx,
 	  svm_fifo_peek (ctx->s->tx_fifo, 0, sizeof (ctx->hdr),
 			 (u8 *) & ctx->hdr);
 	  ASSERT (ctx->hdr.data_length > ctx->hdr.data_offset);
+	  if (session_tx_set_dgram_batch_params (vm, ctx, max_segs))
+	    return;
 	  ctx->max_dequeue = ctx->hdr.data_length - ctx->hdr.data_offset;
 	}
     }
@@ -814,6 +875,77 @@ session_tx_set_dequeue_params (vlib_main_t * vm, session_tx_context_t * ctx,
 				     TRANSPORT_MAX_HDRS_LEN);
 }
 
+/**
+ * Send batched dgrams, chaining consecutive dgrams of equal size into
+ * gso super segments that are split late, by the gso node.
+ *
+ * @return number of packets sent
+ */
+always_inline u16
+session_tx_fill_dgrams_gso (session_worker_t * wrk,
+			    session_tx_context_t * ctx, u16 * n_bufs,
+			    u32 next_index)
+{
+  svm_fifo_t *f = ctx->s->tx_fifo;
+  u16 n_left = ctx->n_dgrams, n_pkts = 0;
+  vlib_main_t *vm = wrk->vm;
+
+  while (n_left)
+    {
+      vlib_buffer_t *b0, *prev_b, *chain_b;
+      u32 bi0, chain_bi, gso_size, n_read;
+
+      bi0 = wrk->tx_buffers[--(*n_bufs)];
+      b0 = vlib_get_buffer (vm, bi0);
+      session_tx_fill_buffer (vm, ctx, b0, n_bufs, 0 /* peek_data */ );
+      b0->total_length_not_including_first_buffer = 0;
+      gso_size = b0->current_length;
+      prev_b = b0;
+      n_left -= 1;
+
+      while (n_left && ctx->hdr.data_length == gso_size
+	     && b0->current_length + b0->total_length_not_including_first_buffer
+	     + gso_size <= SESSION_TX_DGRAM_GSO_MAX_SZ)
+	{
+	  chain_bi = wrk->tx_buffers[--(*n_bufs)];
+	  chain_b = vlib_get_buffer (vm, chain_bi);
+	  chain_b->current_data = 0;
+	  chain_b->next_buffer = 0;
+	  n_read = svm_fifo_peek (f, SESSION_CONN_HDR_LEN, gso_size,
+				  vlib_buffer_get_current (chain_b));
+	  ASSERT (n_read == gso_size);
+	  svm_fifo_dequeue_drop (f, SESSION_CONN_HDR_LEN + gso_size);
+	  chain_b->current_length = n_read;
+
+	  prev_b->next_buffer = chain_bi;
+	  prev_b->flags |= VLIB_BUFFER_NEXT_PRESENT;
+	  b0->total_length_not_including_first_buffer += n_read;
+	  ctx->left_to_snd -= n_read;
+	  prev_b = chain_b;
+
+	  n_left -= 1;
+	  if (n_left)
+	    svm_fifo_peek (f, 0, sizeof (ctx->hdr), (u8 *) & ctx->hdr);
+	}
+
+      if (prev_b != b0)
+	{
+	  b0->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID | VNET_BUFFER_F_GSO;
+	  vnet_buffer2 (b0)->gso_size = gso_size;
+	}
+
+      ctx->transport_vft->push_header (ctx->tc, b0);
+
+      VLIB_BUFFER_TRACE_TRAJECTORY_INIT (b0);
+
+      vec_add1 (wrk->pending_tx_buffers, bi0);
+      vec_add1 (wrk->pending_tx_nexts, next_index);
+      n_pkts += 1;
+    }
+
+  return n_pkts;
+}
+
 always_inline int
 session_tx_fifo_read_and_snd_i (session_worker_t * wrk,
 				vlib_node_runtime_t * node,
@@ -927,6 +1059,15 @@ session_tx_fifo_read_and_snd_i (session_worker_t * wrk,
   ctx->left_to_snd = ctx->max_len_to_snd;
   n_left = ctx->n_segs_per_evt;
 
+  /* Egress may change, e.g., route or gso feature updates, check per burst */
+  if (ctx->n_dgrams > 1 && (ctx->tc->flags & TRANSPORT_CONNECTION_F_GSO)
+      && transport_connection_egress_gso (ctx->tc))
+    {
+      ctx->n_segs_per_evt = session_tx_fill_dgrams_gso (wrk, ctx, &n_bufs,
+							next_index);
+      n_left = 0;
+    }
+
   while (n_left >= 4)
     {
       vlib_buffer_t *b0, *b1;
@@ -1260,7 +1401,6 @@ session_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 thread_index = vm->thread_index, n_to_dequeue;
   session_worker_t *wrk = &smm->wrk[thread_index];
   session_evt_elt_t *elt, *ctrl_he, *new_he, *old_he;
-  svm_msg_q_msg_t _msg, *msg = &_msg;
   clib_llist_index_t old_ti;
   int i, n_tx_packets = 0;
   session_event_t *evt;
@@ -1280,20 +1420,23 @@ session_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
    *  Dequeue and handle new events
    */
 
-  /* Try to dequeue what is available. Don't wait for lock.
+  /* Try to dequeue what is available. Don't wait for lock and only
+   * hold it for as long as it takes to grab the messages.
    * XXX: we may need priorities here */
   mq = wrk->vpp_event_queue;
   n_to_dequeue = svm_msg_q_size (mq);
   if (n_to_dequeue && svm_msg_q_try_lock (mq) == 0)
     {
+      vec_validate (wrk->mq_msgs, n_to_dequeue - 1);
+      n_to_dequeue = svm_msg_q_sub_batch (mq, wrk->mq_msgs, n_to_dequeue);
+      svm_msg_q_unlock (mq);
+
       for (i = 0; i < n_to_dequeue; i++)
 	{
-	  svm_msg_q_sub_w_lock (mq, msg);
-	  evt = svm_msg_q_msg_data (mq, msg);
+	  evt = svm_msg_q_msg_data (mq, &wrk->mq_msgs[i]);
 	  session_evt_add_to_list (wrk, evt);
-	  svm_msg_q_free_msg (mq, msg);
+	  svm_msg_q_free_msg (mq, &wrk->mq_msgs[i]);
 	}
-      svm_msg_q_unlock (mq);
     }
 
   /*
@@ -1366,6 +1509,10 @@ session_queue_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
   if (vec_len (wrk->pending_tx_buffers))
     session_flush_pending_tx_buffers (wrk, node);
 
+  /* Rx notifications generated while handling events */
+  if (vec_len (wrk->app_wrks_w_rx_pending))
+    app_worker_flush_rx_evts (thread_index);
+
   vlib_node_increment_counter (vm, session_queue_node.index,
 			       SESSION_QUEUE_ERROR_TX, n_tx_packets);
 
@@ -16,6 +16,11 @@
 #include <vnet/session/transport.h>
 #include <vnet/session/session.h>
 #include <vnet/fib/fib.h>
+#include <vnet/fib/ip4_fib.h>
+#include <vnet/fib/ip6_fib.h>
+#include <vnet/dpo/load_balance.h>
+#include <vnet/adj/adj.h>
+#include <vnet/gso/gso.h>
 
 /**
  * Per-type vector of transport protocol virtual function tables
@@ -719,6 +724,40 @@ transport_connection_tx_pacer_update_bytes (transport_connection_t * tc,
   spacer_update_bucket (&tc->pacer, bytes);
 }
 
+/**
+ * Check if all paths towards the connection's remote end leave through
+ * interfaces with the gso feature enabled, i.e., interfaces that send
+ * gso packets through the gso node. Routes and interface features can
+ * change, so this is meant to be checked per burst.
+ */
+int
+transport_connection_egress_gso (transport_connection_t * tc)
+{
+  const load_balance_t *lb;
+  const dpo_id_t *dpo;
+  ip_adjacency_t *adj;
+  u32 lb_index;
+  int i;
+
+  if (tc->is_ip4)
+    lb_index = ip4_fib_forwarding_lookup (tc->fib_index, &tc->rmt_ip.ip4);
+  else
+    lb_index = ip6_fib_table_fwding_lookup (tc->fib_index, &tc->rmt_ip.ip6);
+
+  lb = load_balance_get (lb_index);
+  for (i = 0; i < lb->lb_n_buckets; i++)
+    {
+      dpo = load_balance_get_bucket_i (lb, i);
+      if (dpo->dpoi_type != DPO_ADJACENCY)
+	return 0;
+      adj = adj_get (dpo->dpoi_index);
+      if (!vnet_sw_interface_gso_is_enabled (adj->rewrite_header.sw_if_index))
+	return 0;
+    }
+
+  return 1;
+}
+
 void
 transport_update_time (clib_time_type_t time_now, u8 thread_index)
 {
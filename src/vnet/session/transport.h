@@ -266,6 +266,8 @@ void
 transport_connection_tx_pacer_update_bytes (transport_connection_t * tc,
 					    u32 bytes);
 
+int transport_connection_egress_gso (transport_connection_t * tc);
+
 #endif /* SRC_VNET_SESSION_TRANSPORT_H_ */
 
 /*
@@ -46,6 +46,10 @@ typedef enum transport_connection_flags_
   TRANSPORT_CONNECTION_F_NO_LOOKUP = 1 << 1, /**< Don't register connection in lookup
 						  Does not apply to local apps and
 						  transports using the network layer (udp/tcp) */
+  TRANSPORT_CONNECTION_F_GSO = 1 << 2, /**< Transport takes consecutive
+					    dgrams of equal size as one gso
+					    packet, when the egress interface
+					    segments them */
 } transport_connection_flags_t;
 
 typedef struct _spacer
@@ -245,6 +245,10 @@ tcp_connection_cleanup (tcp_connection_t * tc)
   transport_endpoint_cleanup (TRANSPORT_PROTO_TCP, &tc->c_lcl_ip,
 			      tc->c_lcl_port);
 
+  /* Leave the listen backlog if handshake did not complete */
+  if (tc->state == TCP_STATE_SYN_RCVD)
+    tcp_get_worker (tc->c_thread_index)->n_syn_rcvd -= 1;
+
   /* Check if connection is not yet fully established */
   if (tc->state == TCP_STATE_SYN_SENT)
     {
@@ -643,6 +647,127 @@ tcp_generate_random_iss (tcp_connection_t * tc)
   return ((tmp >> 32) ^ (tmp & 0xffffffff));
 }
 
+/**
+ * MSS values that can be encoded in a syn cookie, in increasing order
+ */
+static const u16 tcp_syn_cookie_mss[] = {
+  536, 1220, 1360, 1440, 1460, 4312, 8960
+};
+
+/*
+ * Syn cookie layout, as in rfc4987 and Linux. The iss is
+ *   hash1 + irs + (count << 24) + ((hash2 (count) + data) & 0xffffff)
+ * where count is a coarse clock, ~65s per tick, and data carries the
+ * options of the SYN that are needed later: mss index (3 bits), sack
+ * permitted (1), wscale present (1) and wscale (4). Timestamps are not
+ * encoded, the ACK carries them if they were negotiated.
+ */
+#define TCP_SYN_COOKIE_SACK		(1 << 3)
+#define TCP_SYN_COOKIE_WSCALE		(1 << 4)
+#define TCP_SYN_COOKIE_WSCALE_SHIFT	5
+#define TCP_SYN_COOKIE_DATA_BITS	9
+
+static u32
+tcp_syn_cookie_hash (tcp_connection_t * tc, u64 seed, u32 count)
+{
+  u64 h;
+
+  /*
+   * Chain each field through the hash instead of folding them together,
+   * a fold lets different tuples share a cookie. Every step is a
+   * bijection, so distinct tuples give distinct states
+   */
+  h = clib_xxhash (seed ^ count);
+  if (tc->c_is_ip4)
+    h = clib_xxhash (h ^ ((u64) tc->c_lcl_ip.ip4.as_u32 << 32
+			  | tc->c_rmt_ip.ip4.as_u32));
+  else
+    {
+      h = clib_xxhash (h ^ tc->c_lcl_ip.ip6.as_u64[0]);
+      h = clib_xxhash (h ^ tc->c_lcl_ip.ip6.as_u64[1]);
+      h = clib_xxhash (h ^ tc->c_rmt_ip.ip6.as_u64[0]);
+      h = clib_xxhash (h ^ tc->c_rmt_ip.ip6.as_u64[1]);
+    }
+  h = clib_xxhash (h ^ ((u64) tc->c_lcl_port << 16 | tc->c_rmt_port));
+  return ((h >> 32) ^ (h & 0xffffffff));
+}
+
+/**
+ * Generate syn cookie, to be used as iss, for connection
+ *
+ * Connection must have the endpoints, irs and the options of the SYN
+ * filled in.
+ *
+ * @param tc	connection built out of a SYN
+ * @param now	time, in tcp ticks
+ * @return	syn cookie
+ */
+u32
+tcp_syn_cookie_make (tcp_connection_t * tc, u32 now)
+{
+  tcp_main_t *tm = &tcp_main;
+  u32 count, data, i;
+
+  for (i = ARRAY_LEN (tcp_syn_cookie_mss) - 1; i > 0; i--)
+    if (tc->rcv_opts.mss >= tcp_syn_cookie_mss[i])
+      break;
+  data = i;
+
+  if (tcp_opts_sack_permitted (&tc->rcv_opts))
+    data |= TCP_SYN_COOKIE_SACK;
+  if (tcp_opts_wscale (&tc->rcv_opts))
+    data |= TCP_SYN_COOKIE_WSCALE
+      | tc->rcv_opts.wscale << TCP_SYN_COOKIE_WSCALE_SHIFT;
+
+  count = now >> TCP_SYN_COOKIE_COUNT_SHIFT;
+  return tcp_syn_cookie_hash (tc, tm->iss_seed.first, 0) + tc->irs
+    + (count << 24)
+    + ((tcp_syn_cookie_hash (tc, tm->iss_seed.second, count) + data)
+       & 0xffffff);
+}
+
+/**
+ * Validate syn cookie acked by peer
+ *
+ * Connection must have the endpoints and irs filled in. On success, the
+ * SYN options recovered from the cookie are added to its rcv_opts.
+ *
+ * @param tc	connection built out of the ACK
+ * @param cookie	syn cookie, i.e., ack number - 1
+ * @param now	time, in tcp ticks
+ * @return	0 if cookie is valid, -1 otherwise
+ */
+int
+tcp_syn_cookie_check (tcp_connection_t * tc, u32 cookie, u32 now)
+{
+  tcp_main_t *tm = &tcp_main;
+  u32 count, data;
+
+  cookie -= tcp_syn_cookie_hash (tc, tm->iss_seed.first, 0) + tc->irs;
+  count = cookie >> 24;
+  if ((((now >> TCP_SYN_COOKIE_COUNT_SHIFT) - count) & 0xff)
+      > TCP_SYN_COOKIE_MAX_AGE)
+    return -1;
+
+  data = (cookie - tcp_syn_cookie_hash (tc, tm->iss_seed.second, count))
+    & 0xffffff;
+  if (data >> TCP_SYN_COOKIE_DATA_BITS)
+    return -1;
+  if ((data & 0x7) >= ARRAY_LEN (tcp_syn_cookie_mss))
+    return -1;
+
+  tc->rcv_opts.flags |= TCP_OPTS_FLAG_MSS;
+  tc->rcv_opts.mss = tcp_syn_cookie_mss[data & 0x7];
+  if (data & TCP_SYN_COOKIE_SACK)
+    tc->rcv_opts.flags |= TCP_OPTS_FLAG_SACK_PERMITTED;
+  if (data & TCP_SYN_COOKIE_WSCALE)
+    {
+      tc->rcv_opts.flags |= TCP_OPTS_FLAG_WSCALE;
+      tc->rcv_opts.wscale = data >> TCP_SYN_COOKIE_WSCALE_SHIFT;
+    }
+  return 0;
+}
+
 /**
  * Initialize max segment size we're able to process.
  *
@@ -650,7 +775,7 @@ tcp_generate_random_iss (tcp_connection_t * tc)
  * of the IP and TCP headers (see RFC6691). It is also what we advertise
  * to our peer.
  */
-static void
+void
 tcp_init_rcv_mss (tcp_connection_t * tc)
 {
   u8 ip_hdr_len;
@@ -1227,17 +1352,6 @@ tcp_half_open_session_get_transport (u32 conn_index)
   return &tc->connection;
 }
 
-static u16
-tcp_session_cal_goal_size (tcp_connection_t * tc)
-{
-  u16 goal_size = tc->snd_mss;
-
-  goal_size = TCP_MAX_GSO_SZ - tc->snd_mss % TCP_MAX_GSO_SZ;
-  goal_size = clib_min (goal_size, tc->snd_wnd / 2);
-
-  return goal_size > tc->snd_mss ? goal_size : tc->snd_mss;
-}
-
 /**
  * Compute maximum segment size for session layer.
  *
@@ -1255,10 +1369,7 @@ tcp_session_send_mss (transport_connection_t * trans_conn)
    * the current state of the connection. */
   tcp_update_burst_snd_vars (tc);
 
-  if (PREDICT_FALSE (tc->cfg_flags & TCP_CFG_F_TSO))
-    return tcp_session_cal_goal_size (tc);
-
-  return tc->snd_mss;
+  return tcp_tx_max_seg_size (tc);
 }
 
 always_inline u32
@@ -1688,6 +1799,7 @@ tcp_configuration_init (void)
   tcp_cfg.finwait2_time = 300;	/* 30s */
   tcp_cfg.closing_time = 300;	/* 30s */
   tcp_cfg.cleanup_time = 1;	/* 0.1s */
+  tcp_cfg.syn_cookie_threshold = 1024;
 }
 
 static clib_error_t *
@@ -1780,6 +1892,11 @@ tcp_config_fn (vlib_main_t * vm, unformat_input_t * input)
       else if (unformat (input, "preallocated-half-open-connections %d",
 			 &tcp_cfg.preallocated_half_open_connections))
 	;
+      else if (unformat (input, "syn-cookie-threshold %u",
+			 &tcp_cfg.syn_cookie_threshold))
+	;
+      else if (unformat (input, "no-syn-cookies"))
+	tcp_cfg.syn_cookie_threshold = ~0;
       else if (unformat (input, "buffer-fail-fraction %f",
 			 &tcp_cfg.buffer_fail_fraction))
 	;
@@ -2104,6 +2221,30 @@ VLIB_CLI_COMMAND (tcp_src_address_command, static) =
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+tcp_cc_algo_command_fn (vlib_main_t * vm, unformat_input_t * input,
+			vlib_cli_command_t * cmd_arg)
+{
+  tcp_cc_algorithm_type_e cc_algo;
+
+  if (!unformat (input, "%U", unformat_tcp_cc_algo, &cc_algo))
+    return clib_error_return (0, "unknown congestion control algorithm `%U'",
+			      format_unformat_error, input);
+
+  /* Existing connections keep their algorithm */
+  tcp_cfg.cc_algo = cc_algo;
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (tcp_cc_algo_command, static) =
+{
+  .path = "set tcp cc-algo",
+  .short_help = "set tcp cc-algo <newreno|cubic|bbr>",
+  .function = tcp_cc_algo_command_fn,
+};
+/* *INDENT-ON* */
+
 static u8 *
 tcp_scoreboard_dump_trace (u8 * s, sack_scoreboard_t * sb)
 {
@@ -298,7 +298,8 @@ typedef enum _tcp_cc_algorithm_type
 {
   TCP_CC_NEWRENO,
   TCP_CC_CUBIC,
-  TCP_CC_LAST = TCP_CC_CUBIC
+  TCP_CC_BBR,
+  TCP_CC_LAST = TCP_CC_BBR
 } tcp_cc_algorithm_type_e;
 
 typedef struct _tcp_cc_algorithm tcp_cc_algorithm_t;
@@ -520,6 +521,12 @@ typedef struct tcp_worker_ctx_
   /** vector of pending disconnect notifications */
   u32 *pending_disconnects;
 
+  /** connections in SYN_RCVD, i.e., the listen backlog of the worker */
+  u32 n_syn_rcvd;
+
+  /** time, in tcp ticks, the last syn cookie was sent. 0 if none */
+  u32 syn_cookie_time;
+
   /** convenience pointer to this thread's vlib main */
   vlib_main_t *vm;
 
@@ -598,6 +605,11 @@ typedef struct tcp_configuration_
   /** Number of preallocated half-open connections */
   u32 preallocated_half_open_connections;
 
+  /** Listen backlog, per worker, beyond which SYNs are answered with syn
+   *  cookies instead of allocating connections. 0 to always use cookies,
+   *  ~0 to disable */
+  u32 syn_cookie_threshold;
+
   /** Vectors of src addresses. Optional unless one needs > 63K active-opens */
   ip4_address_t *ip4_src_addrs;
   ip6_address_t *ip6_src_addrs;
@@ -740,6 +752,16 @@ tcp_get_connection_from_transport (transport_connection_t * tconn)
 always_inline void
 tcp_connection_set_state (tcp_connection_t * tc, tcp_state_t state)
 {
+  /* Account for connections entering and leaving the listen backlog */
+  if (PREDICT_FALSE ((tc->state == TCP_STATE_SYN_RCVD)
+		     != (state == TCP_STATE_SYN_RCVD)))
+    {
+      tcp_worker_ctx_t *wrk = tcp_get_worker (tc->c_thread_index);
+      if (state == TCP_STATE_SYN_RCVD)
+	wrk->n_syn_rcvd += 1;
+      else
+	wrk->n_syn_rcvd -= 1;
+    }
   tc->state = state;
   TCP_EVT (TCP_EVT_STATE_CHANGE, tc);
 }
@@ -781,11 +803,13 @@ tcp_half_open_connection_get (u32 conn_index)
 
 void tcp_make_fin (tcp_connection_t * tc, vlib_buffer_t * b);
 void tcp_make_synack (tcp_connection_t * ts, vlib_buffer_t * b);
+u32 tcp_initial_window_to_advertise (tcp_connection_t * tc);
 void tcp_send_reset_w_pkt (tcp_connection_t * tc, vlib_buffer_t * pkt,
 			   u32 thread_index, u8 is_ip4);
 void tcp_send_reset (tcp_connection_t * tc);
 void tcp_send_syn (tcp_connection_t * tc);
 void tcp_send_synack (tcp_connection_t * tc);
+void tcp_send_synack_stateless (tcp_connection_t * tc);
 void tcp_send_fin (tcp_connection_t * tc);
 void tcp_send_ack (tcp_connection_t * tc);
 void tcp_update_burst_snd_vars (tcp_connection_t * tc);
@@ -980,6 +1004,37 @@ tcp_available_cc_snd_space (const tcp_connection_t * tc)
   return available_wnd - flight_size;
 }
 
+/**
+ * Largest segment, in bytes of payload, tcp should build for a burst.
+ *
+ * Without tso this is the mss. With tso it is the largest multiple of the
+ * mss that fits a gso packet and half of the peer's window, so the
+ * interface or the gso node does the actual segmentation.
+ */
+always_inline u32
+tcp_tx_max_seg_size (const tcp_connection_t * tc)
+{
+  u32 seg_size;
+
+  if (PREDICT_TRUE (!(tc->cfg_flags & TCP_CFG_F_TSO)))
+    return tc->snd_mss;
+
+  seg_size = clib_min (TCP_MAX_GSO_SZ - TRANSPORT_MAX_HDRS_LEN,
+		       tc->snd_wnd / 2);
+  seg_size -= seg_size % tc->snd_mss;
+
+  return clib_max (seg_size, tc->snd_mss);
+}
+
+/**
+ * Number of mss sized segments a (super) segment of n_bytes counts for
+ */
+always_inline u32
+tcp_tx_n_segs (const tcp_connection_t * tc, u32 n_bytes)
+{
+  return (n_bytes + tc->snd_mss - 1) / tc->snd_mss;
+}
+
 always_inline u8
 tcp_is_lost_fin (tcp_connection_t * tc)
 {
@@ -993,6 +1048,35 @@ int tcp_fastrecovery_prr_snd_space (tcp_connection_t * tc);
 
 fib_node_index_t tcp_lookup_rmt_in_fib (tcp_connection_t * tc);
 
+void tcp_init_rcv_mss (tcp_connection_t * tc);
+u32 tcp_syn_cookie_make (tcp_connection_t * tc, u32 now);
+int tcp_syn_cookie_check (tcp_connection_t * tc, u32 cookie, u32 now);
+
+/** Syn cookie clock tick, in tcp ticks, and max age of a cookie, in
+ *  cookie clock ticks */
+#define TCP_SYN_COOKIE_COUNT_SHIFT	16
+#define TCP_SYN_COOKIE_MAX_AGE		2
+
+always_inline u8
+tcp_syn_cookies_active (tcp_worker_ctx_t * wrk)
+{
+  return tcp_cfg.syn_cookie_threshold != ~0
+    && wrk->n_syn_rcvd >= tcp_cfg.syn_cookie_threshold;
+}
+
+/**
+ * Check if the worker sent syn cookies recently enough for an ACK to a
+ * listener to be the ACK of a cookie. Avoids validating, and possibly
+ * accepting, forged ACKs when no cookies are in flight.
+ */
+always_inline u8
+tcp_syn_cookies_recent (tcp_worker_ctx_t * wrk, u32 now)
+{
+  return wrk->syn_cookie_time
+    && (now - wrk->syn_cookie_time
+	< ((TCP_SYN_COOKIE_MAX_AGE + 1) << TCP_SYN_COOKIE_COUNT_SHIFT));
+}
+
 /* Made public for unit testing only */
 void tcp_update_sack_list (tcp_connection_t * tc, u32 start, u32 end);
 u32 tcp_sack_list_bytes (tcp_connection_t * tc);
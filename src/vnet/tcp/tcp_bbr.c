@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) 2026 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * BBR congestion control. Based on draft-cardwell-iccrg-bbr-congestion-
+ * control-00 (BBR v1) with optional BBR v2 style bounds on inflight after
+ * rounds with excessive loss. Bandwidth and rtt samples come from the
+ * delivery rate estimator in tcp_bt.c, so rate sampling is enabled for all
+ * connections that use this algorithm.
+ */
+
+#include <vnet/tcp/tcp.h>
+
+#define BBR_HIGH_GAIN		2.885	/* 2/ln(2) */
+#define BBR_DRAIN_GAIN		(1 / BBR_HIGH_GAIN)
+#define BBR_CWND_GAIN		2.0
+#define BBR_BW_WIN_ROUNDS	10	/* Max bw filter window, in rounds */
+#define BBR_MIN_RTT_WIN		10.0	/* Min rtt filter window, in sec */
+#define BBR_PROBE_RTT_TIME	0.2	/* Time spent in probe rtt, in sec */
+#define BBR_MIN_CWND_SEGS	4
+#define BBR_FULL_BW_THRESH	1.25
+#define BBR_FULL_BW_ROUNDS	3
+#define BBR_CYCLE_LEN		8
+#define BBR_INFLIGHT_HI_BETA	0.7
+#define BBR_INFLIGHT_HI_HEADROOM 0.85
+
+static const f64 bbr_pacing_gain_cycle[BBR_CYCLE_LEN] = {
+  1.25, 0.75, 1, 1, 1, 1, 1, 1
+};
+
+#define foreach_bbr_mode		\
+  _(STARTUP, "startup")			\
+  _(DRAIN, "drain")			\
+  _(PROBE_BW, "probe-bw")		\
+  _(PROBE_RTT, "probe-rtt")
+
+typedef enum bbr_mode_
+{
+#define _(sym, str) BBR_MODE_##sym,
+  foreach_bbr_mode
+#undef _
+} __clib_packed bbr_mode_e;
+
+typedef struct bbr_cfg_
+{
+  /** Bound inflight after rounds with loss above loss_thresh */
+  u8 loss_bound;
+
+  /** Fraction of bytes lost in a round considered excessive */
+  f64 loss_thresh;
+} bbr_cfg_t;
+
+static bbr_cfg_t bbr_cfg = {
+  .loss_bound = 0,
+  .loss_thresh = 0.02,
+};
+
+/** Windowed max filter sample. Time is measured in rounds */
+typedef struct bbr_bw_sample_
+{
+  f64 bw;
+  u32 round;
+} bbr_bw_sample_t;
+
+typedef struct bbr_data_
+{
+  /** Best, 2nd best and 3rd best bw samples in window (bytes/s) */
+  bbr_bw_sample_t max_bw[3];
+
+  f64 min_rtt;			/**< Min rtt in window (sec) */
+  f64 min_rtt_stamp;		/**< Time when min_rtt was measured */
+  f64 probe_rtt_done_stamp;	/**< End of current probe rtt, if known */
+  f64 cycle_stamp;		/**< Start of current gain cycle phase */
+  f64 pacing_gain;
+  f64 cwnd_gain;
+  f64 full_bw;			/**< Bw when we last saw bw grow */
+
+  u64 next_round_delivered;	/**< Delivered that ends current round */
+  u32 round_count;		/**< Number of rounds seen */
+  u32 prior_cwnd;		/**< cwnd before recovery or probe rtt */
+
+  u32 inflight_hi;		/**< Max inflight that avoids high loss */
+  u32 probe_up_segs;		/**< Segments inflight_hi grows next round */
+  u32 round_lost;		/**< Bytes lost in current round */
+  u32 round_delivered;		/**< Bytes delivered in current round */
+
+  bbr_mode_e mode;
+  u8 cycle_index;
+  u8 full_bw_count;
+  u8 full_bw_reached;
+  u8 round_start;
+  u8 packet_conservation;
+  u8 probe_rtt_round_done;
+} bbr_data_t;
+
+typedef struct bbr_main_
+{
+  /** Per thread pools of connection state, too large for cc_data */
+  bbr_data_t **data;
+} bbr_main_t;
+
+static bbr_main_t bbr_main;
+
+typedef struct bbr_cc_data_
+{
+  /** Index of connection state in thread's pool, plus one */
+  u32 data_index;
+} bbr_cc_data_t;
+
+STATIC_ASSERT (sizeof (bbr_cc_data_t) <= TCP_CC_DATA_SZ, "bbr data len");
+
+static inline bbr_data_t *
+bbr_data (tcp_connection_t * tc)
+{
+  bbr_cc_data_t *cd = (bbr_cc_data_t *) tcp_cc_data (tc);
+  ASSERT (cd->data_index);
+  return pool_elt_at_index (bbr_main.data[tc->c_thread_index],
+			    cd->data_index - 1);
+}
+
+static inline f64
+bbr_time (tcp_connection_t * tc)
+{
+  return tcp_time_now_us (tc->c_thread_index);
+}
+
+static inline f64
+bbr_max_bw (bbr_data_t * bd)
+{
+  return bd->max_bw[0].bw;
+}
+
+/**
+ * Kathleen Nichols' windowed max filter, as used by the Linux
+ * implementation. Keeps the best three samples in the window, such that
+ * when the best expires, a reasonable replacement is available.
+ */
+static void
+bbr_max_bw_update (bbr_data_t * bd, f64 bw, u32 round)
+{
+  bbr_bw_sample_t *s = bd->max_bw, val = {.bw = bw,.round = round };
+  u32 dt;
+
+  if (bw >= s[0].bw || round - s[2].round > BBR_BW_WIN_ROUNDS)
+    {
+      s[2] = s[1] = s[0] = val;
+      return;
+    }
+
+  if (bw >= s[1].bw)
+    s[2] = s[1] = val;
+  else if (bw >= s[2].bw)
+    s[2] = val;
+
+  dt = round - s[0].round;
+  if (dt > BBR_BW_WIN_ROUNDS)
+    {
+      s[0] = s[1];
+      s[1] = s[2];
+      s[2] = val;
+      if (round - s[0].round > BBR_BW_WIN_ROUNDS)
+	{
+	  s[0] = s[1];
+	  s[1] = s[2];
+	  s[2] = val;
+	}
+    }
+  else if (s[1].round == s[0].round && dt > BBR_BW_WIN_ROUNDS / 4)
+    {
+      s[2] = s[1] = val;
+    }
+  else if (s[2].round == s[1].round && dt > BBR_BW_WIN_ROUNDS / 2)
+    {
+      s[2] = val;
+    }
+}
+
+/**
+ * Bandwidth-delay product scaled by gain, in bytes
+ */
+static u32
+bbr_bdp (tcp_connection_t * tc, bbr_data_t * bd, f64 gain)
+{
+  /* No rtt sample yet */
+  if (bd->min_rtt == 0 || bbr_max_bw (bd) == 0)
+    return tcp_initial_cwnd (tc);
+
+  return gain * bbr_max_bw (bd) * bd->min_rtt;
+}
+
+static u32
+bbr_target_cwnd (tcp_connection_t * tc, bbr_data_t * bd, f64 gain)
+{
+  /* Allow for tso, delayed and stretched acks */
+  return bbr_bdp (tc, bd, gain) + 3 * tc->snd_mss;
+}
+
+static inline u32
+bbr_min_cwnd (tcp_connection_t * tc)
+{
+  return BBR_MIN_CWND_SEGS * tc->snd_mss;
+}
+
+static void
+bbr_enter_startup (bbr_data_t * bd)
+{
+  bd->mode = BBR_MODE_STARTUP;
+  bd->pacing_gain = BBR_HIGH_GAIN;
+  bd->cwnd_gain = BBR_HIGH_GAIN;
+}
+
+static void
+bbr_enter_probe_bw (tcp_connection_t * tc, bbr_data_t * bd)
+{
+  bd->mode = BBR_MODE_PROBE_BW;
+  bd->cwnd_gain = BBR_CWND_GAIN;
+  /* Randomly pick any phase but the one that drains the queue */
+  bd->cycle_index = (BBR_CYCLE_LEN - clib_cpu_time_now () % 7)
+    % BBR_CYCLE_LEN;
+  bd->pacing_gain = bbr_pacing_gain_cycle[bd->cycle_index];
+  bd->cycle_stamp = bbr_time (tc);
+}
+
+static void
+bbr_reset_mode (tcp_connection_t * tc, bbr_data_t * bd)
+{
+  if (!bd->full_bw_reached)
+    bbr_enter_startup (bd);
+  else
+    bbr_enter_probe_bw (tc, bd);
+}
+
+static void
+bbr_update_round (tcp_connection_t * tc, bbr_data_t * bd,
+		  tcp_rate_sample_t * rs)
+{
+  bd->round_start = 0;
+  if (rs->prior_delivered < bd->next_round_delivered)
+    return;
+
+  bd->next_round_delivered = tc->delivered;
+  bd->round_count += 1;
+  bd->round_start = 1;
+  bd->packet_conservation = 0;
+}
+
+static void
+bbr_update_bw (tcp_connection_t * tc, bbr_data_t * bd,
+	       tcp_rate_sample_t * rs)
+{
+  f64 bw;
+
+  if (rs->interval_time <= 0 || !rs->delivered)
+    return;
+
+  bw = rs->delivered / rs->interval_time;
+
+  /* App limited samples underestimate the path, use them only if they
+   * push the estimate up */
+  if (!(rs->flags & TCP_BTS_IS_APP_LIMITED) || bw >= bbr_max_bw (bd))
+    bbr_max_bw_update (bd, bw, bd->round_count);
+}
+
+static void
+bbr_check_full_bw_reached (bbr_data_t * bd, tcp_rate_sample_t * rs)
+{
+  if (bd->full_bw_reached || !bd->round_start
+      || (rs->flags & TCP_BTS_IS_APP_LIMITED))
+    return;
+
+  if (bbr_max_bw (bd) >= bd->full_bw * BBR_FULL_BW_THRESH)
+    {
+      bd->full_bw = bbr_max_bw (bd);
+      bd->full_bw_count = 0;
+      return;
+    }
+
+  bd->full_bw_count += 1;
+  bd->full_bw_reached = bd->full_bw_count >= BBR_FULL_BW_ROUNDS;
+}
+
+static void
+bbr_check_drain (tcp_connection_t * tc, bbr_data_t * bd)
+{
+  if (bd->mode == BBR_MODE_STARTUP && bd->full_bw_reached)
+    {
+      bd->mode = BBR_MODE_DRAIN;
+      bd->pacing_gain = BBR_DRAIN_GAIN;
+      bd->cwnd_gain = BBR_HIGH_GAIN;
+      tc->ssthresh = bbr_target_cwnd (tc, bd, 1);
+    }
+  if (bd->mode == BBR_MODE_DRAIN
+      && tcp_flight_size (tc) <= bbr_target_cwnd (tc, bd, 1))
+    bbr_enter_probe_bw (tc, bd);
+}
+
+static int
+bbr_is_next_cycle_phase (tcp_connection_t * tc, bbr_data_t * bd,
+			 tcp_rate_sample_t * rs, u32 prior_inflight)
+{
+  int is_full_length = bbr_time (tc) - bd->cycle_stamp > bd->min_rtt;
+
+  /* Cruise at 1.0 for a min rtt */
+  if (bd->pacing_gain == 1)
+    return is_full_length;
+
+  /* Probe until inflight reaches the probing target or loss shows that
+   * the target cannot be reached */
+  if (bd->pacing_gain > 1)
+    return is_full_length && (rs->lost || prior_inflight >=
+			      bbr_bdp (tc, bd, bd->pacing_gain));
+
+  /* Drain until the queue created while probing is gone */
+  return is_full_length || prior_inflight <= bbr_bdp (tc, bd, 1);
+}
+
+static void
+bbr_update_cycle_phase (tcp_connection_t * tc, bbr_data_t * bd,
+			tcp_rate_sample_t * rs, u32 prior_inflight)
+{
+  if (bd->mode != BBR_MODE_PROBE_BW
+      || !bbr_is_next_cycle_phase (tc, bd, rs, prior_inflight))
+    return;
+
+  bd->cycle_index = (bd->cycle_index + 1) % BBR_CYCLE_LEN;
+  bd->cycle_stamp = bbr_time (tc);
+  bd->pacing_gain = bbr_pacing_gain_cycle[bd->cycle_index];
+}
+
+static void
+bbr_update_min_rtt (tcp_connection_t * tc, bbr_data_t * bd,
+		    tcp_rate_sample_t * rs)
+{
+  f64 now = bbr_time (tc);
+  int expired;
+
+  expired = now > bd->min_rtt_stamp + BBR_MIN_RTT_WIN;
+  if (rs->rtt_time > 0 && (rs->rtt_time <= bd->min_rtt || expired
+			   || bd->min_rtt == 0))
+    {
+      bd->min_rtt = rs->rtt_time;
+      bd->min_rtt_stamp = now;
+    }
+
+  if (expired && bd->mode != BBR_MODE_PROBE_RTT)
+    {
+      bd->mode = BBR_MODE_PROBE_RTT;
+      bd->pacing_gain = 1;
+      bd->cwnd_gain = 1;
+      bd->prior_cwnd = clib_max (bd->prior_cwnd, tc->cwnd);
+      bd->probe_rtt_done_stamp = 0;
+    }
+
+  if (bd->mode != BBR_MODE_PROBE_RTT)
+    return;
+
+  /* Wait for inflight to drain to the minimum before timing the probe */
+  if (!bd->probe_rtt_done_stamp && tcp_flight_size (tc) <= bbr_min_cwnd (tc))
+    {
+      bd->probe_rtt_done_stamp = now + BBR_PROBE_RTT_TIME;
+      bd->probe_rtt_round_done = 0;
+      bd->next_round_delivered = tc->delivered;
+    }
+  else if (bd->probe_rtt_done_stamp)
+    {
+      if (bd->round_start)
+	bd->probe_rtt_round_done = 1;
+      if (bd->probe_rtt_round_done && now > bd->probe_rtt_done_stamp)
+	{
+	  bd->min_rtt_stamp = now;
+	  tc->cwnd = clib_max (tc->cwnd, bd->prior_cwnd);
+	  bd->prior_cwnd = 0;
+	  bbr_reset_mode (tc, bd);
+	}
+    }
+}
+
+/**
+ * BBR v2 style response to loss. If a round loses more than loss_thresh
+ * of its bytes, inflight is bounded to what the path sustained. While
+ * probing for bw without excessive loss, the bound is raised by an
+ * exponentially growing number of segments per round.
+ */
+static void
+bbr_update_loss_bound (tcp_connection_t * tc, bbr_data_t * bd,
+		       tcp_rate_sample_t * rs, u32 prior_inflight)
+{
+  u32 n_bytes;
+
+  bd->round_lost += rs->lost;
+  bd->round_delivered += rs->acked_and_sacked;
+
+  if (!bd->round_start)
+    return;
+
+  n_bytes = bd->round_lost + bd->round_delivered;
+  if (n_bytes && bd->round_lost > bbr_cfg.loss_thresh * n_bytes)
+    {
+      bd->inflight_hi = clib_max (prior_inflight,
+				  BBR_INFLIGHT_HI_BETA * bbr_bdp (tc, bd, 1));
+      bd->inflight_hi = clib_max (bd->inflight_hi, bbr_min_cwnd (tc));
+      bd->probe_up_segs = 1;
+    }
+  else if (bd->inflight_hi && bd->mode == BBR_MODE_PROBE_BW
+	   && bd->pacing_gain > 1)
+    {
+      bd->inflight_hi += bd->probe_up_segs * tc->snd_mss;
+      bd->probe_up_segs = clib_min (bd->probe_up_segs * 2, 1 << 10);
+    }
+
+  bd->round_lost = 0;
+  bd->round_delivered = 0;
+}
+
+static void
+bbr_set_cwnd (tcp_connection_t * tc, bbr_data_t * bd, u32 acked)
+{
+  u32 target = bbr_target_cwnd (tc, bd, bd->cwnd_gain);
+
+  /* First round of recovery sends one segment per segment delivered */
+  if (bd->packet_conservation)
+    tc->cwnd = clib_max (tc->cwnd, tcp_flight_size (tc) + acked);
+  else if (bd->full_bw_reached)
+    tc->cwnd = clib_min (tc->cwnd + acked, target);
+  else if (tc->cwnd < target || tc->delivered < tcp_initial_cwnd (tc))
+    tc->cwnd = tc->cwnd + acked;
+
+  if (bd->inflight_hi)
+    {
+      u32 bound = bd->inflight_hi;
+      if (bd->mode != BBR_MODE_PROBE_BW || bd->pacing_gain <= 1)
+	bound *= BBR_INFLIGHT_HI_HEADROOM;
+      tc->cwnd = clib_min (tc->cwnd, bound);
+    }
+
+  tc->cwnd = clib_max (tc->cwnd, bbr_min_cwnd (tc));
+  if (bd->mode == BBR_MODE_PROBE_RTT)
+    tc->cwnd = clib_min (tc->cwnd, bbr_min_cwnd (tc));
+
+  /* Constrained by tx fifo */
+  tc->cwnd = clib_min (tc->cwnd, clib_max (tc->tx_fifo_size,
+					   bbr_min_cwnd (tc)));
+}
+
+static void
+bbr_update (tcp_connection_t * tc, tcp_rate_sample_t * rs)
+{
+  bbr_data_t *bd = bbr_data (tc);
+  u32 prior_inflight;
+
+  /* Ack carried no rate sample */
+  if (!rs || !rs->prior_time)
+    return;
+
+  prior_inflight = tcp_flight_size (tc) + rs->acked_and_sacked;
+
+  bbr_update_round (tc, bd, rs);
+  bbr_update_bw (tc, bd, rs);
+  bbr_update_cycle_phase (tc, bd, rs, prior_inflight);
+  bbr_check_full_bw_reached (bd, rs);
+  bbr_check_drain (tc, bd);
+  bbr_update_min_rtt (tc, bd, rs);
+  if (bbr_cfg.loss_bound)
+    bbr_update_loss_bound (tc, bd, rs, prior_inflight);
+
+  bbr_set_cwnd (tc, bd, rs->acked_and_sacked);
+}
+
+static void
+bbr_rcv_ack (tcp_connection_t * tc, tcp_rate_sample_t * rs)
+{
+  bbr_update (tc, rs);
+}
+
+static void
+bbr_rcv_cong_ack (tcp_connection_t * tc, tcp_cc_ack_t ack_type,
+		  tcp_rate_sample_t * rs)
+{
+  bbr_update (tc, rs);
+
+  /* Past the first round of recovery prr may send up to the model's
+   * window, not a reduced one */
+  if (!bbr_data (tc)->packet_conservation)
+    tc->ssthresh = tc->cwnd;
+}
+
+static void
+bbr_congestion (tcp_connection_t * tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  /* Loss is not a congestion signal for bbr. Conserve packets for one
+   * round and let prr pace retransmits against an unreduced window */
+  bd->prior_cwnd = tc->cwnd;
+  bd->packet_conservation = 1;
+  bd->next_round_delivered = tc->delivered;
+  tc->ssthresh = clib_max (tc->cwnd, bbr_min_cwnd (tc));
+}
+
+static void
+bbr_loss (tcp_connection_t * tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bd->prior_cwnd = clib_max (bd->prior_cwnd, tc->cwnd);
+  bd->packet_conservation = 1;
+  bd->next_round_delivered = tc->delivered;
+  bd->round_start = 1;
+  bd->full_bw = 0;
+  tc->cwnd = tcp_loss_wnd (tc);
+}
+
+static void
+bbr_recovered (tcp_connection_t * tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bd->packet_conservation = 0;
+  tc->cwnd = clib_max (tc->cwnd, bd->prior_cwnd);
+  tc->ssthresh = tc->cwnd;
+  bd->prior_cwnd = 0;
+}
+
+static void
+bbr_undo_recovery (tcp_connection_t * tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  /* Spurious recovery, restart looking for a bw plateau */
+  bd->packet_conservation = 0;
+  bd->full_bw = 0;
+  bd->full_bw_count = 0;
+  bd->prior_cwnd = 0;
+}
+
+static void
+bbr_event (tcp_connection_t * tc, tcp_cc_event_t evt)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  /* Restarting from idle, pace at the estimated bw */
+  if (evt == TCP_CC_EVT_START_TX && bd->mode == BBR_MODE_PROBE_BW)
+    {
+      bd->pacing_gain = 1;
+      bd->cycle_stamp = bbr_time (tc);
+    }
+}
+
+static u64
+bbr_get_pacing_rate (tcp_connection_t * tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+  f64 srtt;
+
+  if (bbr_max_bw (bd) != 0)
+    return bd->pacing_gain * bbr_max_bw (bd);
+
+  /* No bw sample yet, pace the initial window over the smoothed rtt */
+  srtt = clib_min ((f64) tc->srtt * TCP_TICK, tc->mrtt_us);
+  return bd->pacing_gain * tc->cwnd / srtt;
+}
+
+static void
+bbr_conn_init (tcp_connection_t * tc)
+{
+  bbr_cc_data_t *cd = (bbr_cc_data_t *) tcp_cc_data (tc);
+  bbr_data_t *bd;
+
+  pool_get_zero (bbr_main.data[tc->c_thread_index], bd);
+  cd->data_index = bd - bbr_main.data[tc->c_thread_index] + 1;
+
+  tc->cfg_flags |= TCP_CFG_F_RATE_SAMPLE;
+  tc->ssthresh = 0x7FFFFFFFU;
+  tc->cwnd = tcp_initial_cwnd (tc);
+
+  bd->min_rtt_stamp = bbr_time (tc);
+  bd->cycle_stamp = bd->min_rtt_stamp;
+  bd->next_round_delivered = tc->delivered;
+  bbr_enter_startup (bd);
+}
+
+static void
+bbr_conn_cleanup (tcp_connection_t * tc)
+{
+  bbr_cc_data_t *cd = (bbr_cc_data_t *) tcp_cc_data (tc);
+
+  /* Connection never initialized, e.g., handshake did not complete */
+  if (!cd->data_index)
+    return;
+
+  pool_put_index (bbr_main.data[tc->c_thread_index], cd->data_index - 1);
+  cd->data_index = 0;
+}
+
+static uword
+bbr_unformat_config (unformat_input_t * input)
+{
+  f64 loss_thresh;
+
+  if (!input)
+    return 0;
+
+  unformat_skip_white_space (input);
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "loss-bound"))
+	bbr_cfg.loss_bound = 1;
+      else if (unformat (input, "loss-thresh %f", &loss_thresh)
+	       && loss_thresh > 0 && loss_thresh < 1)
+	bbr_cfg.loss_thresh = loss_thresh;
+      else
+	return 0;
+    }
+  return 1;
+}
+
+const static tcp_cc_algorithm_t tcp_bbr = {
+  .name = "bbr",
+  .unformat_cfg = bbr_unformat_config,
+  .init = bbr_conn_init,
+  .cleanup = bbr_conn_cleanup,
+  .congestion = bbr_congestion,
+  .loss = bbr_loss,
+  .recovered = bbr_recovered,
+  .undo_recovery = bbr_undo_recovery,
+  .rcv_ack = bbr_rcv_ack,
+  .rcv_cong_ack = bbr_rcv_cong_ack,
+  .event = bbr_event,
+  .get_pacing_rate = bbr_get_pacing_rate,
+};
+
+clib_error_t *
+bbr_init (vlib_main_t * vm)
+{
+  vlib_thread_main_t *vtm = vlib_get_thread_main ();
+  clib_error_t *error = 0;
+
+  vec_validate (bbr_main.data, vtm->n_vlib_mains - 1);
+  tcp_cc_algo_register (TCP_CC_BBR, &tcp_bbr);
+
+  return error;
+}
+
+VLIB_INIT_FUNCTION (bbr_init);
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -63,6 +63,7 @@ typedef enum _tcp_listen_next
 #define _(s,n) TCP_LISTEN_NEXT_##s,
   foreach_tcp_state_next
 #undef _
+    TCP_LISTEN_NEXT_RCV_PROCESS,
     TCP_LISTEN_N_NEXT,
 } tcp_listen_next_t;
 
@@ -560,6 +561,13 @@ tcp_estimate_initial_rtt (tcp_connection_t * tc)
       mrtt = clib_max ((u32) (tc->mrtt_us * THZ), 1);
       tc->rtt_ts = 0;
     }
+  else if (!tcp_opts_tstamp (&tc->rcv_opts) || !tc->rcv_opts.tsecr)
+    {
+      /* Connection created out of a syn cookie without timestamps, no
+       * sample available. Keep the initial rto */
+      tcp_update_rto (tc);
+      return;
+    }
   else
     {
       mrtt = tcp_time_now_w_thread (thread_index) - tc->rcv_opts.tsecr;
@@ -2585,7 +2593,7 @@ tcp46_syn_sent_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       /* SYN: Simultaneous open. Change state to SYN-RCVD and send SYN-ACK */
       else
 	{
-	  new_tc0->state = TCP_STATE_SYN_RCVD;
+	  tcp_connection_set_state (new_tc0, TCP_STATE_SYN_RCVD);
 
 	  /* Notify app that we have connection */
 	  if (session_stream_connect_notify (&new_tc0->connection, 0))
@@ -2798,8 +2806,7 @@ tcp46_rcv_process_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  tcp_connection_tx_pacer_update (tc0);
 
 	  /* Switch state to ESTABLISHED */
-	  tc0->state = TCP_STATE_ESTABLISHED;
-	  TCP_EVT (TCP_EVT_STATE_CHANGE, tc0);
+	  tcp_connection_set_state (tc0, TCP_STATE_ESTABLISHED);
 
 	  if (!(tc0->cfg_flags & TCP_CFG_F_NO_TSO))
 	    tcp_check_tx_offload (tc0, is_ip4);
@@ -3129,17 +3136,156 @@ VLIB_REGISTER_NODE (tcp6_rcv_process_node) =
 };
 /* *INDENT-ON* */
 
+/**
+ * Initialize connection out of a SYN, or of the ACK of a syn cookie,
+ * received by a listener
+ */
+static void
+tcp_listen_init_connection (tcp_connection_t * tc, tcp_connection_t * lc,
+			    vlib_buffer_t * b, tcp_header_t * th, u32 irs,
+			    u8 is_ip4)
+{
+  tc->c_lcl_port = th->dst_port;
+  tc->c_rmt_port = th->src_port;
+  tc->c_is_ip4 = is_ip4;
+  tc->c_fib_index = lc->c_fib_index;
+  tc->cc_algo = lc->cc_algo;
+
+  if (is_ip4)
+    {
+      ip4_header_t *ip4 = vlib_buffer_get_current (b);
+      tc->c_lcl_ip4.as_u32 = ip4->dst_address.as_u32;
+      tc->c_rmt_ip4.as_u32 = ip4->src_address.as_u32;
+    }
+  else
+    {
+      ip6_header_t *ip6 = vlib_buffer_get_current (b);
+      clib_memcpy_fast (&tc->c_lcl_ip6, &ip6->dst_address,
+			sizeof (ip6_address_t));
+      clib_memcpy_fast (&tc->c_rmt_ip6, &ip6->src_address,
+			sizeof (ip6_address_t));
+    }
+
+  tc->irs = irs;
+  tc->rcv_nxt = irs + 1;
+  tc->rcv_las = tc->rcv_nxt;
+  tc->sw_if_index = vnet_buffer (b)->sw_if_index[VLIB_RX];
+}
+
+/**
+ * Answer SYN with a syn cookie. No state is kept for the connection
+ */
+static u32
+tcp_listen_send_syn_cookie (tcp_connection_t * lc, vlib_buffer_t * b,
+			    tcp_header_t * th, u32 thread_index, u8 is_ip4)
+{
+  tcp_connection_t _tc, *tc = &_tc;
+  u32 now = tcp_time_now_w_thread (thread_index);
+
+  clib_memset (tc, 0, sizeof (*tc));
+  tcp_listen_init_connection (tc, lc, b, th, vnet_buffer (b)->tcp.seq_number,
+			      is_ip4);
+  if (tcp_options_parse (th, &tc->rcv_opts, 1))
+    return TCP_ERROR_OPTIONS;
+
+  tc->c_thread_index = thread_index;
+  tc->state = TCP_STATE_SYN_RCVD;
+  if (tcp_opts_tstamp (&tc->rcv_opts))
+    tc->tsval_recent = tc->rcv_opts.tsval;
+  if (!tcp_cfg.csum_offload)
+    tc->cfg_flags |= TCP_CFG_F_NO_CSUM_OFFLOAD;
+  tcp_init_rcv_mss (tc);
+  tc->iss = tcp_syn_cookie_make (tc, now);
+
+  tcp_send_synack_stateless (tc);
+  /* 0 means no cookies were sent */
+  tcp_get_worker (thread_index)->syn_cookie_time = now ? now : 1;
+  return TCP_ERROR_NONE;
+}
+
+/**
+ * Create connection for the ACK of a valid syn cookie
+ *
+ * The connection is left in SYN_RCVD, as if it had sent the SYN-ACK, so
+ * that tcp-rcv-process handles the ACK like for any other connection.
+ */
+static u32
+tcp_listen_syn_cookie_ack (tcp_connection_t * lc, vlib_buffer_t * b,
+			   tcp_header_t * th, u32 thread_index, u8 is_ip4)
+{
+  tcp_connection_t _tc, *tc = &_tc, *child;
+  u32 now = tcp_time_now_w_thread (thread_index);
+
+  /* Validate before allocating anything */
+  clib_memset (tc, 0, sizeof (*tc));
+  tcp_listen_init_connection (tc, lc, b, th,
+			      vnet_buffer (b)->tcp.seq_number - 1, is_ip4);
+  if (tcp_syn_cookie_check (tc, vnet_buffer (b)->tcp.ack_number - 1, now))
+    return TCP_ERROR_SYN_COOKIES_INVALID;
+
+  /* Timestamps were negotiated if the ACK carries them */
+  if (tcp_options_parse (th, &tc->rcv_opts, 1))
+    return TCP_ERROR_OPTIONS;
+
+  child = tcp_connection_alloc_w_base (thread_index, tc);
+  tcp_connection_set_state (child, TCP_STATE_SYN_RCVD);
+
+  if (tcp_opts_tstamp (&child->rcv_opts))
+    {
+      child->tsval_recent = child->rcv_opts.tsval;
+      child->tsval_recent_age = now;
+    }
+  if (tcp_opts_wscale (&child->rcv_opts))
+    child->snd_wscale = child->rcv_opts.wscale;
+
+  child->snd_wnd = clib_net_to_host_u16 (th->window) << child->snd_wscale;
+  child->snd_wl1 = vnet_buffer (b)->tcp.seq_number;
+  child->snd_wl2 = vnet_buffer (b)->tcp.ack_number;
+
+  tcp_connection_init_vars (child);
+  child->rto = TCP_RTO_MIN;
+  /* No SYN-ACK send time to sample the rtt from */
+  child->rtt_ts = 0;
+
+  /* Use the cookie instead of the random iss and recompute the window,
+   * and its scale, advertised in the SYN-ACK */
+  child->iss = vnet_buffer (b)->tcp.ack_number - 1;
+  child->snd_una = child->iss;
+  child->snd_nxt = child->iss + 1;
+  child->snd_una_max = child->snd_nxt;
+  tcp_initial_window_to_advertise (child);
+
+  if (session_stream_accept (&child->connection, lc->c_s_index,
+			     lc->c_thread_index, 0 /* notify */ ))
+    {
+      tcp_connection_cleanup (child);
+      return TCP_ERROR_CREATE_SESSION_FAIL;
+    }
+
+  TCP_EVT (TCP_EVT_SYN_RCVD, child, 1);
+  child->tx_fifo_size = transport_tx_fifo_size (&child->connection);
+  vnet_buffer (b)->tcp.connection_index = child->c_c_index;
+  return TCP_ERROR_NONE;
+}
+
 /**
  * LISTEN state processing as per RFC 793 p. 65
+ *
+ * If the listen backlog of the worker grows past the configured threshold,
+ * SYNs are answered with syn cookies and connections are only created
+ * once the ACK of a valid cookie arrives.
  */
 always_inline uword
 tcp46_listen_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		     vlib_frame_t * from_frame, int is_ip4)
 {
-  u32 n_left_from, *from, n_syns = 0, *first_buffer;
+  u32 n_left_from, *from, n_syns = 0, n_free = 0, n_rcv = 0;
+  u32 n_cookies_sent = 0, n_cookies_rcvd = 0, n_cookies_invalid = 0;
   u32 my_thread_index = vm->thread_index;
+  tcp_worker_ctx_t *wrk = tcp_get_worker (my_thread_index);
+  u32 to_free[VLIB_FRAME_SIZE], to_rcv[VLIB_FRAME_SIZE];
 
-  from = first_buffer = vlib_frame_vector_args (from_frame);
+  from = vlib_frame_vector_args (from_frame);
   n_left_from = from_frame->n_vectors;
 
   while (n_left_from > 0)
@@ -3179,13 +3325,8 @@ tcp46_listen_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
          goto drop;
        */
 
-      /* 2. second check for an ACK: handled in dispatch */
-      /* if (tcp_ack (th0))
-         {
-         tcp_send_reset (b0, is_ip4);
-         goto drop;
-         }
-       */
+      /* 2. second check for an ACK: handled in dispatch, unless it may
+       * be the ACK of a syn cookie */
 
       /* 3. check for a SYN (did that already) */
 
@@ -3198,28 +3339,33 @@ tcp46_listen_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  goto drop;
 	}
 
-      /* Create child session and send SYN-ACK */
-      child0 = tcp_connection_alloc (my_thread_index);
-      child0->c_lcl_port = th0->dst_port;
-      child0->c_rmt_port = th0->src_port;
-      child0->c_is_ip4 = is_ip4;
-      child0->state = TCP_STATE_SYN_RCVD;
-      child0->c_fib_index = lc0->c_fib_index;
-      child0->cc_algo = lc0->cc_algo;
-
-      if (is_ip4)
+      if (PREDICT_FALSE (!tcp_syn (th0)))
 	{
-	  child0->c_lcl_ip4.as_u32 = ip40->dst_address.as_u32;
-	  child0->c_rmt_ip4.as_u32 = ip40->src_address.as_u32;
+	  error0 = tcp_listen_syn_cookie_ack (lc0, b0, th0, my_thread_index,
+					      is_ip4);
+	  if (error0 == TCP_ERROR_SYN_COOKIES_INVALID)
+	    {
+	      tcp_send_reset_w_pkt (lc0, b0, my_thread_index, is_ip4);
+	      n_cookies_invalid += 1;
+	    }
+	  else if (error0 == TCP_ERROR_NONE)
+	    n_cookies_rcvd += 1;
+	  goto trace;
 	}
-      else
+
+      if (PREDICT_FALSE (tcp_syn_cookies_active (wrk)))
 	{
-	  clib_memcpy_fast (&child0->c_lcl_ip6, &ip60->dst_address,
-			    sizeof (ip6_address_t));
-	  clib_memcpy_fast (&child0->c_rmt_ip6, &ip60->src_address,
-			    sizeof (ip6_address_t));
+	  error0 = tcp_listen_send_syn_cookie (lc0, b0, th0, my_thread_index,
+					       is_ip4);
+	  n_cookies_sent += (error0 == TCP_ERROR_NONE);
+	  goto drop;
 	}
 
+      /* Create child session and send SYN-ACK */
+      child0 = tcp_connection_alloc (my_thread_index);
+      tcp_listen_init_connection (child0, lc0, b0, th0,
+				  vnet_buffer (b0)->tcp.seq_number, is_ip4);
+
       if (tcp_options_parse (th0, &child0->rcv_opts, 1))
 	{
 	  error0 = TCP_ERROR_OPTIONS;
@@ -3227,10 +3373,7 @@ tcp46_listen_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  goto drop;
 	}
 
-      child0->irs = vnet_buffer (b0)->tcp.seq_number;
-      child0->rcv_nxt = vnet_buffer (b0)->tcp.seq_number + 1;
-      child0->rcv_las = child0->rcv_nxt;
-      child0->sw_if_index = vnet_buffer (b0)->sw_if_index[VLIB_RX];
+      tcp_connection_set_state (child0, TCP_STATE_SYN_RCVD);
 
       /* RFC1323: TSval timestamps sent on {SYN} and {SYN,ACK}
        * segments are used to initialize PAWS. */
@@ -3265,6 +3408,10 @@ tcp46_listen_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 
     drop:
 
+      n_syns += (error0 == TCP_ERROR_NONE);
+
+    trace:
+
       if (PREDICT_FALSE (b0->flags & VLIB_BUFFER_IS_TRACED))
 	{
 	  t0 = vlib_add_trace (vm, node, b0, sizeof (*t0));
@@ -3273,11 +3420,22 @@ tcp46_listen_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 			    sizeof (t0->tcp_connection));
 	}
 
-      n_syns += (error0 == TCP_ERROR_NONE);
+      /* ACKs of syn cookies now have a connection in SYN_RCVD */
+      if (PREDICT_FALSE (!tcp_syn (th0) && error0 == TCP_ERROR_NONE))
+	to_rcv[n_rcv++] = bi0;
+      else
+	to_free[n_free++] = bi0;
     }
 
   tcp_inc_counter (listen, TCP_ERROR_SYNS_RCVD, n_syns);
-  vlib_buffer_free (vm, first_buffer, from_frame->n_vectors);
+  tcp_inc_counter (listen, TCP_ERROR_SYN_COOKIES_SENT, n_cookies_sent);
+  tcp_inc_counter (listen, TCP_ERROR_SYN_COOKIES_RCVD, n_cookies_rcvd);
+  tcp_inc_counter (listen, TCP_ERROR_SYN_COOKIES_INVALID, n_cookies_invalid);
+
+  if (n_rcv)
+    vlib_buffer_enqueue_to_single_next (vm, node, to_rcv,
+					TCP_LISTEN_NEXT_RCV_PROCESS, n_rcv);
+  vlib_buffer_free (vm, to_free, n_free);
 
   return from_frame->n_vectors;
 }
@@ -3308,6 +3466,7 @@ VLIB_REGISTER_NODE (tcp4_listen_node) =
 #define _(s,n) [TCP_LISTEN_NEXT_##s] = n,
     foreach_tcp_state_next
 #undef _
+    [TCP_LISTEN_NEXT_RCV_PROCESS] = "tcp4-rcv-process",
   },
   .format_trace = format_tcp_rx_trace_short,
 };
@@ -3327,6 +3486,7 @@ VLIB_REGISTER_NODE (tcp6_listen_node) =
 #define _(s,n) [TCP_LISTEN_NEXT_##s] = n,
     foreach_tcp_state_next
 #undef _
+    [TCP_LISTEN_NEXT_RCV_PROCESS] = "tcp6-rcv-process",
   },
   .format_trace = format_tcp_rx_trace_short,
 };
@@ -3405,15 +3565,16 @@ tcp_input_set_error_next (tcp_main_t * tm, u16 * next, u32 * error, u8 is_ip4)
     }
 }
 
-always_inline tcp_connection_t *
-tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
-			 u8 is_ip4, u8 is_nolookup)
+/**
+ * Check the headers of a buffer and fill in its tcp metadata
+ *
+ * @return 0 if the buffer can be looked up, -1 otherwise
+ */
+always_inline int
+tcp_input_parse_buffer (vlib_buffer_t * b, u32 * error, u8 is_ip4)
 {
-  u32 fib_index = vnet_buffer (b)->ip.fib_index;
   int n_advance_bytes, n_data_bytes;
-  transport_connection_t *tc;
   tcp_header_t *tcp;
-  u8 result = 0;
 
   if (is_ip4)
     {
@@ -3422,7 +3583,7 @@ tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
       if (PREDICT_FALSE (b->current_length < ip_hdr_bytes + sizeof (*tcp)))
 	{
 	  *error = TCP_ERROR_LENGTH;
-	  return 0;
+	  return -1;
 	}
       tcp = ip4_next_header (ip4);
       vnet_buffer (b)->tcp.hdr_offset = (u8 *) tcp - (u8 *) ip4;
@@ -3433,15 +3594,8 @@ tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
       if (PREDICT_FALSE (n_data_bytes < 0))
 	{
 	  *error = TCP_ERROR_LENGTH;
-	  return 0;
+	  return -1;
 	}
-
-      if (!is_nolookup)
-	tc = session_lookup_connection_wt4 (fib_index, &ip4->dst_address,
-					    &ip4->src_address, tcp->dst_port,
-					    tcp->src_port,
-					    TRANSPORT_PROTO_TCP, thread_index,
-					    &result);
     }
   else
     {
@@ -3449,7 +3603,7 @@ tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
       if (PREDICT_FALSE (b->current_length < sizeof (*ip6) + sizeof (*tcp)))
 	{
 	  *error = TCP_ERROR_LENGTH;
-	  return 0;
+	  return -1;
 	}
       tcp = ip6_next_header (ip6);
       vnet_buffer (b)->tcp.hdr_offset = (u8 *) tcp - (u8 *) ip6;
@@ -3461,11 +3615,80 @@ tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
       if (PREDICT_FALSE (n_data_bytes < 0))
 	{
 	  *error = TCP_ERROR_LENGTH;
-	  return 0;
+	  return -1;
 	}
+    }
+
+  vnet_buffer (b)->tcp.seq_number = clib_net_to_host_u32 (tcp->seq_number);
+  vnet_buffer (b)->tcp.ack_number = clib_net_to_host_u32 (tcp->ack_number);
+  vnet_buffer (b)->tcp.data_offset = n_advance_bytes;
+  vnet_buffer (b)->tcp.data_len = n_data_bytes;
+  vnet_buffer (b)->tcp.seq_end = vnet_buffer (b)->tcp.seq_number
+    + n_data_bytes;
+  vnet_buffer (b)->tcp.flags = 0;
 
-      if (!is_nolookup)
+  return 0;
+}
+
+/**
+ * Find the connections of a frame of buffers
+ *
+ * All buffers are parsed first and the connections are then looked up
+ * in one batch, so the session table lookups can be pipelined.
+ */
+static_always_inline void
+tcp_input_lookup_frame (vlib_buffer_t ** bufs, u32 n_bufs, u32 thread_index,
+			tcp_connection_t ** tcs, u32 * errors, u8 is_ip4,
+			u8 is_nolookup)
+{
+  transport_connection_t *found[VLIB_FRAME_SIZE];
+  session_lookup_key4_t keys4[VLIB_FRAME_SIZE];
+  session_lookup_key6_t keys6[VLIB_FRAME_SIZE];
+  u8 results[VLIB_FRAME_SIZE];
+  u16 indices[VLIB_FRAME_SIZE];
+  u32 i, fib_index, n_keys = 0;
+  vlib_buffer_t *b;
+  tcp_header_t *tcp;
+
+  for (i = 0; i < n_bufs; i++)
+    {
+      if (i + 4 < n_bufs)
+	{
+	  vlib_prefetch_buffer_header (bufs[i + 4], STORE);
+	  CLIB_PREFETCH (bufs[i + 4]->data, 2 * CLIB_CACHE_LINE_BYTES, LOAD);
+	}
+
+      b = bufs[i];
+      tcs[i] = 0;
+      errors[i] = TCP_ERROR_NO_LISTENER;
+
+      /* Metadata overlaps, read fib index before it is overwritten */
+      fib_index = vnet_buffer (b)->ip.fib_index;
+      if (PREDICT_FALSE (tcp_input_parse_buffer (b, &errors[i], is_ip4)))
+	continue;
+
+      if (is_nolookup)
+	{
+	  tcs[i] = tcp_connection_get (vnet_buffer (b)->tcp.connection_index,
+				       thread_index);
+	  continue;
+	}
+
+      tcp = tcp_buffer_hdr (b);
+      if (is_ip4)
 	{
+	  ip4_header_t *ip4 = vlib_buffer_get_current (b);
+	  session_lookup_key4_t *k = &keys4[n_keys];
+	  k->fib_index = fib_index;
+	  k->lcl.as_u32 = ip4->dst_address.as_u32;
+	  k->rmt.as_u32 = ip4->src_address.as_u32;
+	  k->lcl_port = tcp->dst_port;
+	  k->rmt_port = tcp->src_port;
+	}
+      else
+	{
+	  ip6_header_t *ip6 = vlib_buffer_get_current (b);
+	  session_lookup_key6_t *k = &keys6[n_keys];
 	  if (PREDICT_FALSE
 	      (ip6_address_is_link_local_unicast (&ip6->dst_address)))
 	    {
@@ -3473,32 +3696,31 @@ tcp_input_lookup_buffer (vlib_buffer_t * b, u8 thread_index, u32 * error,
 	      fib_index = vec_elt (im->fib_index_by_sw_if_index,
 				   vnet_buffer (b)->sw_if_index[VLIB_RX]);
 	    }
-
-	  tc = session_lookup_connection_wt6 (fib_index, &ip6->dst_address,
-					      &ip6->src_address,
-					      tcp->dst_port, tcp->src_port,
-					      TRANSPORT_PROTO_TCP,
-					      thread_index, &result);
+	  k->fib_index = fib_index;
+	  ip6_address_copy (&k->lcl, &ip6->dst_address);
+	  ip6_address_copy (&k->rmt, &ip6->src_address);
+	  k->lcl_port = tcp->dst_port;
+	  k->rmt_port = tcp->src_port;
 	}
+      indices[n_keys++] = i;
     }
 
-  if (is_nolookup)
-    tc =
-      (transport_connection_t *) tcp_connection_get (vnet_buffer (b)->
-						     tcp.connection_index,
-						     thread_index);
-
-  vnet_buffer (b)->tcp.seq_number = clib_net_to_host_u32 (tcp->seq_number);
-  vnet_buffer (b)->tcp.ack_number = clib_net_to_host_u32 (tcp->ack_number);
-  vnet_buffer (b)->tcp.data_offset = n_advance_bytes;
-  vnet_buffer (b)->tcp.data_len = n_data_bytes;
-  vnet_buffer (b)->tcp.seq_end = vnet_buffer (b)->tcp.seq_number
-    + n_data_bytes;
-  vnet_buffer (b)->tcp.flags = 0;
+  if (is_nolookup || !n_keys)
+    return;
 
-  *error = result ? TCP_ERROR_NONE + result : *error;
+  if (is_ip4)
+    session_lookup_connections_wt4 (keys4, n_keys, TRANSPORT_PROTO_TCP,
+				    thread_index, found, results);
+  else
+    session_lookup_connections_wt6 (keys6, n_keys, TRANSPORT_PROTO_TCP,
+				    thread_index, found, results);
 
-  return tcp_get_connection_from_transport (tc);
+  for (i = 0; i < n_keys; i++)
+    {
+      tcs[indices[i]] = tcp_get_connection_from_transport (found[i]);
+      if (results[i])
+	errors[indices[i]] = TCP_ERROR_NONE + results[i];
+    }
 }
 
 static inline void
@@ -3517,6 +3739,21 @@ tcp_input_dispatch_buffer (tcp_main_t * tm, tcp_connection_t * tc,
   if (PREDICT_FALSE (*error == TCP_ERROR_DISPATCH
 		     || *next == TCP_INPUT_NEXT_RESET))
     {
+      /* May be the ACK of a syn cookie if cookies were sent recently,
+       * let the listener validate it */
+      if (tc->state == TCP_STATE_LISTEN && flags == TCP_FLAG_ACK)
+	{
+	  u32 thread_index = vlib_get_thread_index ();
+	  tcp_worker_ctx_t *wrk = tcp_get_worker (thread_index);
+	  if (tcp_syn_cookies_recent (wrk,
+				      tcp_time_now_w_thread (thread_index)))
+	    {
+	      *next = TCP_INPUT_NEXT_LISTEN;
+	      *error = TCP_ERROR_NONE;
+	      return;
+	    }
+	}
+
       /* Overload tcp flags to store state */
       tcp_state_t state = tc->state;
       vnet_buffer (b)->tcp.flags = tc->state;
@@ -3535,7 +3772,9 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 n_left_from, *from, thread_index = vm->thread_index;
   tcp_main_t *tm = vnet_get_tcp_main ();
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  tcp_connection_t *tcs[VLIB_FRAME_SIZE], **tc;
   u16 nexts[VLIB_FRAME_SIZE], *next;
+  u32 errors[VLIB_FRAME_SIZE], *error;
 
   tcp_set_time_now (tcp_get_worker (thread_index));
 
@@ -3543,90 +3782,81 @@ tcp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   n_left_from = frame->n_vectors;
   vlib_get_buffers (vm, from, bufs, n_left_from);
 
+  tcp_input_lookup_frame (bufs, n_left_from, thread_index, tcs, errors,
+			  is_ip4, is_nolookup);
+
   b = bufs;
+  tc = tcs;
   next = nexts;
+  error = errors;
 
   while (n_left_from >= 4)
     {
-      u32 error0 = TCP_ERROR_NO_LISTENER, error1 = TCP_ERROR_NO_LISTENER;
-      tcp_connection_t *tc0, *tc1;
-
-      {
-	vlib_prefetch_buffer_header (b[2], STORE);
-	CLIB_PREFETCH (b[2]->data, 2 * CLIB_CACHE_LINE_BYTES, LOAD);
-
-	vlib_prefetch_buffer_header (b[3], STORE);
-	CLIB_PREFETCH (b[3]->data, 2 * CLIB_CACHE_LINE_BYTES, LOAD);
-      }
+      if (tc[2])
+	CLIB_PREFETCH (tc[2], CLIB_CACHE_LINE_BYTES, STORE);
+      if (tc[3])
+	CLIB_PREFETCH (tc[3], CLIB_CACHE_LINE_BYTES, STORE);
 
       next[0] = next[1] = TCP_INPUT_NEXT_DROP;
 
-      tc0 = tcp_input_lookup_buffer (b[0], thread_index, &error0, is_ip4,
-				     is_nolookup);
-      tc1 = tcp_input_lookup_buffer (b[1], thread_index, &error1, is_ip4,
-				     is_nolookup);
-
-      if (PREDICT_TRUE (!tc0 + !tc1 == 0))
+      if (PREDICT_TRUE (!tc[0] + !tc[1] == 0))
 	{
-	  ASSERT (tcp_lookup_is_valid (tc0, b[0], tcp_buffer_hdr (b[0])));
-	  ASSERT (tcp_lookup_is_valid (tc1, b[1], tcp_buffer_hdr (b[1])));
+	  ASSERT (tcp_lookup_is_valid (tc[0], b[0], tcp_buffer_hdr (b[0])));
+	  ASSERT (tcp_lookup_is_valid (tc[1], b[1], tcp_buffer_hdr (b[1])));
 
-	  vnet_buffer (b[0])->tcp.connection_index = tc0->c_c_index;
-	  vnet_buffer (b[1])->tcp.connection_index = tc1->c_c_index;
+	  vnet_buffer (b[0])->tcp.connection_index = tc[0]->c_c_index;
+	  vnet_buffer (b[1])->tcp.connection_index = tc[1]->c_c_index;
 
-	  tcp_input_dispatch_buffer (tm, tc0, b[0], &next[0], &error0);
-	  tcp_input_dispatch_buffer (tm, tc1, b[1], &next[1], &error1);
+	  tcp_input_dispatch_buffer (tm, tc[0], b[0], &next[0], &error[0]);
+	  tcp_input_dispatch_buffer (tm, tc[1], b[1], &next[1], &error[1]);
 	}
       else
 	{
-	  if (PREDICT_TRUE (tc0 != 0))
+	  if (PREDICT_TRUE (tc[0] != 0))
 	    {
-	      ASSERT (tcp_lookup_is_valid (tc0, b[0], tcp_buffer_hdr (b[0])));
-	      vnet_buffer (b[0])->tcp.connection_index = tc0->c_c_index;
-	      tcp_input_dispatch_buffer (tm, tc0, b[0], &next[0], &error0);
+	      ASSERT (tcp_lookup_is_valid (tc[0], b[0],
+					   tcp_buffer_hdr (b[0])));
+	      vnet_buffer (b[0])->tcp.connection_index = tc[0]->c_c_index;
+	      tcp_input_dispatch_buffer (tm, tc[0], b[0], &next[0],
+					 &error[0]);
 	    }
 	  else
-	    tcp_input_set_error_next (tm, &next[0], &error0, is_ip4);
+	    tcp_input_set_error_next (tm, &next[0], &error[0], is_ip4);
 
-	  if (PREDICT_TRUE (tc1 != 0))
+	  if (PREDICT_TRUE (tc[1] != 0))
 	    {
-	      ASSERT (tcp_lookup_is_valid (tc1, b[1], tcp_buffer_hdr (b[1])));
-	      vnet_buffer (b[1])->tcp.connection_index = tc1->c_c_index;
-	      tcp_input_dispatch_buffer (tm, tc1, b[1], &next[1], &error1);
+	      ASSERT (tcp_lookup_is_valid (tc[1], b[1],
+					   tcp_buffer_hdr (b[1])));
+	      vnet_buffer (b[1])->tcp.connection_index = tc[1]->c_c_index;
+	      tcp_input_dispatch_buffer (tm, tc[1], b[1], &next[1],
+					 &error[1]);
 	    }
 	  else
-	    tcp_input_set_error_next (tm, &next[1], &error1, is_ip4);
+	    tcp_input_set_error_next (tm, &next[1], &error[1], is_ip4);
 	}
 
       b += 2;
+      tc += 2;
       next += 2;
+      error += 2;
       n_left_from -= 2;
     }
   while (n_left_from > 0)
     {
-      tcp_connection_t *tc0;
-      u32 error0 = TCP_ERROR_NO_LISTENER;
-
-      if (n_left_from > 1)
-	{
-	  vlib_prefetch_buffer_header (b[1], STORE);
-	  CLIB_PREFETCH (b[1]->data, 2 * CLIB_CACHE_LINE_BYTES, LOAD);
-	}
-
       next[0] = TCP_INPUT_NEXT_DROP;
-      tc0 = tcp_input_lookup_buffer (b[0], thread_index, &error0, is_ip4,
-				     is_nolookup);
-      if (PREDICT_TRUE (tc0 != 0))
+      if (PREDICT_TRUE (tc[0] != 0))
 	{
-	  ASSERT (tcp_lookup_is_valid (tc0, b[0], tcp_buffer_hdr (b[0])));
-	  vnet_buffer (b[0])->tcp.connection_index = tc0->c_c_index;
-	  tcp_input_dispatch_buffer (tm, tc0, b[0], &next[0], &error0);
+	  ASSERT (tcp_lookup_is_valid (tc[0], b[0], tcp_buffer_hdr (b[0])));
+	  vnet_buffer (b[0])->tcp.connection_index = tc[0]->c_c_index;
+	  tcp_input_dispatch_buffer (tm, tc[0], b[0], &next[0], &error[0]);
 	}
       else
-	tcp_input_set_error_next (tm, &next[0], &error0, is_ip4);
+	tcp_input_set_error_next (tm, &next[0], &error[0], is_ip4);
 
       b += 1;
+      tc += 1;
       next += 1;
+      error += 1;
       n_left_from -= 1;
     }
 
@@ -974,6 +974,31 @@ tcp_send_synack (tcp_connection_t * tc)
   TCP_EVT (TCP_EVT_SYNACK_SENT, tc);
 }
 
+/**
+ *  Send SYN-ACK for connection that is not allocated
+ *
+ *  Used with syn cookies, whereby tc is a temporary copy that only lives
+ *  while the SYN is processed. No timers are set and the packet goes
+ *  straight to ipx_lookup, as tcpx_output would look up the connection.
+ */
+void
+tcp_send_synack_stateless (tcp_connection_t * tc)
+{
+  tcp_worker_ctx_t *wrk = tcp_get_worker (tc->c_thread_index);
+  vlib_main_t *vm = wrk->vm;
+  vlib_buffer_t *b;
+  u32 bi;
+
+  if (PREDICT_FALSE (!vlib_buffer_alloc (vm, &bi, 1)))
+    return;
+
+  b = vlib_get_buffer (vm, bi);
+  tcp_init_buffer (vm, b);
+  tcp_make_synack (tc, b);
+  tcp_push_ip_hdr (wrk, tc, b);
+  tcp_enqueue_to_ip_lookup (wrk, b, bi, tc->c_is_ip4, tc->c_fib_index);
+}
+
 /**
  * Flush ip lookup tx frames populated by timer pops
  */
@@ -1292,6 +1317,8 @@ tcp_prepare_segment (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
       u32 chain_bi = ~0, n_bufs_per_seg, n_bufs;
       u16 n_peeked, len_to_deq;
       vlib_buffer_t *chain_b, *prev_b;
+      svm_fifo_cursor_t fc;
+      session_t *s;
       int i;
 
       /* Make sure we have enough buffers */
@@ -1306,11 +1333,15 @@ tcp_prepare_segment (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 	  return 0;
 	}
 
+      /* Copy straight out of the fifo chunks, looking them up once for
+       * the whole chain, which matters for tso super segments */
+      s = session_get (tc->c_s_index, tc->c_thread_index);
+      svm_fifo_cursor_init (&fc, s->tx_fifo, offset);
+
       *b = vlib_get_buffer (vm, wrk->tx_buffers[--n_bufs]);
       data = tcp_init_buffer (vm, *b);
-      n_bytes = session_tx_fifo_peek_bytes (&tc->connection, data, offset,
-					    bytes_per_buffer -
-					    TRANSPORT_MAX_HDRS_LEN);
+      n_bytes = svm_fifo_cursor_copy (&fc, data, bytes_per_buffer -
+				      TRANSPORT_MAX_HDRS_LEN);
       b[0]->current_length = n_bytes;
       b[0]->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
       b[0]->total_length_not_including_first_buffer = 0;
@@ -1325,9 +1356,7 @@ tcp_prepare_segment (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 	  chain_b = vlib_get_buffer (vm, chain_bi);
 	  chain_b->current_data = 0;
 	  data = vlib_buffer_get_current (chain_b);
-	  n_peeked = session_tx_fifo_peek_bytes (&tc->connection, data,
-						 offset + n_bytes,
-						 len_to_deq);
+	  n_peeked = svm_fifo_cursor_copy (&fc, data, len_to_deq);
 	  ASSERT (n_peeked == len_to_deq);
 	  n_bytes += n_peeked;
 	  chain_b->current_length = n_peeked;
@@ -1383,7 +1412,8 @@ tcp_prepare_retransmit_segment (tcp_worker_ctx_t * wrk,
   if (!available_bytes)
     return 0;
 
-  max_deq_bytes = clib_min (tc->snd_mss, max_deq_bytes);
+  /* With tso, holes are retransmitted as super segments */
+  max_deq_bytes = clib_min (tcp_tx_max_seg_size (tc), max_deq_bytes);
   max_deq_bytes = clib_min (available_bytes, max_deq_bytes);
 
   start = tc->snd_una + offset;
@@ -1399,7 +1429,7 @@ tcp_prepare_retransmit_segment (tcp_worker_ctx_t * wrk,
     tcp_bt_track_rxt (tc, start, start + n_bytes);
 
   tc->bytes_retrans += n_bytes;
-  tc->segs_retrans += 1;
+  tc->segs_retrans += tcp_tx_n_segs (tc, n_bytes);
   TCP_EVT (TCP_EVT_CC_RTX, tc, offset, n_bytes);
 
   return n_bytes;
@@ -1761,27 +1791,31 @@ static int
 tcp_transmit_unsent (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 		     u32 burst_size)
 {
-  u32 offset, n_segs = 0, n_written, bi, available_wnd;
+  u32 offset, n_segs = 0, n_written, bi, available_wnd, max_seg, seg_size;
   vlib_main_t *vm = wrk->vm;
   vlib_buffer_t *b = 0;
 
   offset = tc->snd_nxt - tc->snd_una;
   available_wnd = tc->snd_wnd - offset;
   burst_size = clib_min (burst_size, available_wnd / tc->snd_mss);
+  max_seg = tcp_tx_max_seg_size (tc);
 
   if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
     tcp_bt_check_app_limited (tc);
 
+  /* burst_size is in mss sized segments, a tso super segment counts for
+   * as many segments as it carries */
   while (n_segs < burst_size)
     {
-      n_written = tcp_prepare_segment (wrk, tc, offset, tc->snd_mss, &b);
+      seg_size = clib_min (max_seg, (burst_size - n_segs) * tc->snd_mss);
+      n_written = tcp_prepare_segment (wrk, tc, offset, seg_size, &b);
       if (!n_written)
 	goto done;
 
       bi = vlib_get_buffer_index (vm, b);
       tcp_enqueue_to_output (wrk, b, bi, tc->c_is_ip4);
       offset += n_written;
-      n_segs += 1;
+      n_segs += tcp_tx_n_segs (tc, n_written);
 
       if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
 	tcp_bt_track_tx (tc, n_written);
@@ -1968,6 +2002,7 @@ tcp_retransmit_sack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
 
       max_bytes = clib_min (hole->end - sb->high_rxt, snd_space);
       max_bytes = snd_limited ? clib_min (max_bytes, tc->snd_mss) : max_bytes;
+      max_bytes = clib_min (max_bytes, (burst_size - n_segs) * tc->snd_mss);
       if (max_bytes == 0)
 	break;
 
@@ -1987,7 +2022,7 @@ tcp_retransmit_sack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
       ASSERT (seq_leq (sb->high_rxt, tc->snd_nxt));
 
       snd_space -= n_written;
-      n_segs += 1;
+      n_segs += tcp_tx_n_segs (tc, n_written);
     }
 
   if (hole)
@@ -2034,8 +2069,9 @@ tcp_retransmit_no_sack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
    * segment. */
   while (snd_space > 0 && n_segs < burst_size)
     {
-      max_bytes = clib_min (tc->snd_mss,
+      max_bytes = clib_min (tcp_tx_max_seg_size (tc),
 			    tc->snd_congestion - tc->snd_una - offset);
+      max_bytes = clib_min (max_bytes, (burst_size - n_segs) * tc->snd_mss);
       if (!max_bytes)
 	break;
       n_written = tcp_prepare_retransmit_segment (wrk, tc, offset, max_bytes,
@@ -2049,7 +2085,7 @@ tcp_retransmit_no_sack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc,
       tcp_enqueue_to_output (wrk, b, bi, tc->c_is_ip4);
       snd_space -= n_written;
       offset += n_written;
-      n_segs += 1;
+      n_segs += tcp_tx_n_segs (tc, n_written);
     }
 
   if (n_segs == burst_size)
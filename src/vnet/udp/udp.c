@@ -161,6 +161,10 @@ udp_push_header (transport_connection_t * tc, vlib_buffer_t * b)
   vnet_buffer (b)->sw_if_index[VLIB_TX] = uc->c_fib_index;
   b->flags |= VNET_BUFFER_F_LOCALLY_ORIGINATED;
 
+  /* Session layer chained equal size dgrams, gso node splits them */
+  if (b->flags & VNET_BUFFER_F_GSO)
+    vnet_buffer2 (b)->gso_l4_hdr_sz = sizeof (udp_header_t);
+
   if (PREDICT_FALSE (uc->flags & UDP_CONN_F_CLOSING))
     {
       if (!transport_max_tx_dequeue (&uc->connection))
@@ -327,6 +331,8 @@ udp_open_connection (transport_endpoint_cfg_t * rmt)
   uc->c_proto = TRANSPORT_PROTO_UDP;
   uc->c_fib_index = rmt->fib_index;
   uc->flags |= UDP_CONN_F_OWNS_PORT;
+  /* Connected, all dgrams go to the same peer */
+  uc->c_flags |= TRANSPORT_CONNECTION_F_GSO;
 
   return uc->c_c_index;
 }
@@ -76,6 +76,23 @@ udp_input_inc_counter (vlib_main_t * vm, u8 is_ip4, u8 evt, u8 val)
     vlib_node_increment_counter (vm, udp6_input_node.index, evt, val);
 }
 
+/**
+ * Check if a datagram belongs to a connected udp connection
+ */
+always_inline int
+udp_connection_match (udp_connection_t * uc, u32 fib_index, void *lcl_addr,
+		      void *rmt_addr, udp_header_t * udp, u8 is_ip4)
+{
+  if (uc->c_lcl_port != udp->dst_port || uc->c_rmt_port != udp->src_port
+      || uc->c_fib_index != fib_index)
+    return 0;
+  if (is_ip4)
+    return (uc->c_lcl_ip4.as_u32 == ((ip4_address_t *) lcl_addr)->as_u32
+	    && uc->c_rmt_ip4.as_u32 == ((ip4_address_t *) rmt_addr)->as_u32);
+  return (ip6_address_is_equal (&uc->c_lcl_ip6, lcl_addr)
+	  && ip6_address_is_equal (&uc->c_rmt_ip6, rmt_addr));
+}
+
 always_inline uword
 udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		    vlib_frame_t * frame, u8 is_ip4)
@@ -83,6 +100,8 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 n_left_from, *from;
   u32 errors, *first_buffer;
   u32 my_thread_index = vm->thread_index;
+  udp_connection_t *last_uc = 0;
+  session_t *last_s = 0;
 
   from = first_buffer = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
@@ -120,23 +139,40 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	{
 	  /* TODO: must fix once udp_local does ip options correctly */
 	  ip40 = (ip4_header_t *) (((u8 *) udp0) - sizeof (*ip40));
-	  s0 = session_lookup_safe4 (fib_index0, &ip40->dst_address,
-				     &ip40->src_address, udp0->dst_port,
-				     udp0->src_port, TRANSPORT_PROTO_UDP);
 	  lcl_addr = &ip40->dst_address;
 	  rmt_addr = &ip40->src_address;
-
 	}
       else
 	{
 	  ip60 = (ip6_header_t *) (((u8 *) udp0) - sizeof (*ip60));
-	  s0 = session_lookup_safe6 (fib_index0, &ip60->dst_address,
-				     &ip60->src_address, udp0->dst_port,
-				     udp0->src_port, TRANSPORT_PROTO_UDP);
 	  lcl_addr = &ip60->dst_address;
 	  rmt_addr = &ip60->src_address;
 	}
 
+      /*
+       * Bursts usually carry several dgrams of the same flow. If this one
+       * belongs to the same connected session as the previous one, which
+       * is owned by this thread and can't go away while we run, skip the
+       * lookup. The cache is reset whenever connections or sessions are
+       * allocated, as that may move the pools.
+       */
+      if (last_uc && udp_connection_match (last_uc, fib_index0, lcl_addr,
+					   rmt_addr, udp0, is_ip4))
+	{
+	  s0 = last_s;
+	  uc0 = last_uc;
+	  goto enqueue0;
+	}
+
+      if (is_ip4)
+	s0 = session_lookup_safe4 (fib_index0, &ip40->dst_address,
+				   &ip40->src_address, udp0->dst_port,
+				   udp0->src_port, TRANSPORT_PROTO_UDP);
+      else
+	s0 = session_lookup_safe6 (fib_index0, &ip60->dst_address,
+				   &ip60->src_address, udp0->dst_port,
+				   udp0->src_port, TRANSPORT_PROTO_UDP);
+
       if (PREDICT_FALSE (!s0))
 	{
 	  error0 = UDP_ERROR_NO_LISTENER;
@@ -160,6 +196,7 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		   * Clone the transport. It will be cleaned up with the
 		   * session once we notify the session layer.
 		   */
+		  last_uc = 0;
 		  new_uc0 =
 		    udp_connection_clone_safe (s0->connection_index,
 					       s0->thread_index);
@@ -190,6 +227,7 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  uc0 = udp_get_connection_from_transport (tc0);
 	  if (uc0->flags & UDP_CONN_F_CONNECTED)
 	    {
+	      last_uc = 0;
 	      child0 = udp_connection_alloc (my_thread_index);
 	      if (is_ip4)
 		{
@@ -206,6 +244,7 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	      child0->c_is_ip4 = is_ip4;
 	      child0->c_fib_index = tc0->fib_index;
 	      child0->flags |= UDP_CONN_F_CONNECTED;
+	      child0->c_flags |= TRANSPORT_CONNECTION_F_GSO;
 
 	      if (session_stream_accept (&child0->connection,
 					 tc0->s_index, tc0->thread_index, 1))
@@ -226,7 +265,7 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  goto trace0;
 	}
 
-
+    enqueue0:
       if (svm_fifo_max_enqueue_prod (s0->rx_fifo)
 	  < b0->current_length + sizeof (session_dgram_hdr_t))
 	{
@@ -264,6 +303,14 @@ udp46_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
       if (s0->session_state != SESSION_STATE_LISTENING)
 	session_pool_remove_peeker (s0->thread_index);
 
+      if (s0->thread_index == my_thread_index
+	  && s0->session_state == SESSION_STATE_READY
+	  && (uc0->flags & UDP_CONN_F_CONNECTED))
+	{
+	  last_s = s0;
+	  last_uc = uc0;
+	}
+
     trace0:
 
       b0->error = node->errors[error0];
@@ -99,7 +99,7 @@ vxlan4_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache4 * cache,
       return di;
     }
 
-  int rv = clib_bihash_search_inline_16_8 (&vxm->vxlan4_tunnel_by_key, &key4);
+  int rv = vxlan4_tunnel_search_inline (vxm, &key4);
   if (PREDICT_TRUE (rv == 0))
     {
       *cache = key4;
@@ -114,14 +114,14 @@ vxlan4_find_tunnel (vxlan_main_t * vxm, last_tunnel_cache4 * cache,
 
   /* search for mcast decap info by mcast address */
   key4.key[0] = dst;
-  rv = clib_bihash_search_inline_16_8 (&vxm->vxlan4_tunnel_by_key, &key4);
+  rv = vxlan4_tunnel_search_inline (vxm, &key4);
   if (rv != 0)
     return decap_not_found;
 
   /* search for unicast tunnel using the mcast tunnel local(src) ip */
   vxlan_decap_info_t mdi = {.as_u64 = key4.value };
   key4.key[0] = ((u64) mdi.local_ip.as_u32 << 32) | src;
-  rv = clib_bihash_search_inline_16_8 (&vxm->vxlan4_tunnel_by_key, &key4);
+  rv = vxlan4_tunnel_search_inline (vxm, &key4);
   if (PREDICT_FALSE (rv != 0))
     return decap_not_found;
 
@@ -23,6 +23,8 @@
 #include <vnet/interface.h>
 #include <vnet/flow/flow.h>
 #include <vlib/vlib.h>
+#include <vppinfra/cuckoo_16_8.h>
+#include <vppinfra/cuckoo_template.c>
 
 /**
  * @file
@@ -384,8 +386,7 @@ int vnet_vxlan_add_del_tunnel
 	a->dst.ip4.as_u32 | (((u64) a->src.ip4.as_u32) << 32);
       key4.key[1] = (((u64) a->encap_fib_index) << 32)
 	| clib_host_to_net_u32 (a->vni << 8);
-      not_found =
-	clib_bihash_search_inline_16_8 (&vxm->vxlan4_tunnel_by_key, &key4);
+      not_found = vxlan4_tunnel_search_inline (vxm, &key4);
       p = (void *) &key4.value;
     }
   else
@@ -474,8 +475,7 @@ int vnet_vxlan_add_del_tunnel
 	  else
 	    di.next_index = t->decap_next_index;
 	  key4.value = di.as_u64;
-	  add_failed = clib_bihash_add_del_16_8 (&vxm->vxlan4_tunnel_by_key,
-						 &key4, 1 /*add */ );
+	  add_failed = vxlan4_tunnel_add_del (vxm, &key4, 1 /*add */ );
 	}
 
       if (add_failed)
@@ -608,8 +608,7 @@ int vnet_vxlan_add_del_tunnel
       vxm->tunnel_index_by_sw_if_index[sw_if_index] = ~0;
 
       if (!is_ip6)
-	clib_bihash_add_del_16_8 (&vxm->vxlan4_tunnel_by_key, &key4,
-				  0 /*del */ );
+	vxlan4_tunnel_add_del (vxm, &key4, 0 /*del */ );
       else
 	clib_bihash_add_del_24_8 (&vxm->vxlan6_tunnel_by_key, &key6,
 				  0 /*del */ );
@@ -902,6 +901,10 @@ show_vxlan_tunnel_command_fn (vlib_main_t * vm,
       vlib_cli_output (vm, "Raw IPv6 Hash Table:\n%U\n",
 		       format_bihash_24_8, &vxm->vxlan6_tunnel_by_key,
 		       1 /* verbose */ );
+      if (vxm->vxlan4_lookup_use_cuckoo)
+	vlib_cli_output (vm, "IPv4 Cuckoo Lookup Table:\n%U\n",
+			 format_cuckoo_16_8, &vxm->vxlan4_tunnel_lookup,
+			 0 /* verbose */ );
     }
 
   return 0;
@@ -1273,6 +1276,78 @@ vxlan_init (vlib_main_t * vm)
 
 VLIB_INIT_FUNCTION (vxlan_init);
 
+/*
+ * Tunnels are added and deleted from the main thread, stop the workers
+ * before freeing the buckets the cuckoo table grew out of.
+ */
+static void
+vxlan4_tunnel_lookup_garbage (clib_cuckoo_16_8_t * h, void *ctx)
+{
+  vlib_main_t *vm = vlib_get_main ();
+
+  ASSERT (vlib_get_thread_index () == 0);
+  vlib_worker_thread_barrier_sync (vm);
+  clib_cuckoo_garbage_collect_16_8 (h);
+  vlib_worker_thread_barrier_release (vm);
+}
+
+/**
+ * Add or delete an ip4 tunnel key, in the cuckoo copy of the table too
+ * when that is in use.
+ */
+int
+vxlan4_tunnel_add_del (vxlan_main_t * vxm, vxlan4_tunnel_key_t * key4,
+		       int is_add)
+{
+  int rv;
+
+  clib_spinlock_lock_if_init (&vxm->vxlan4_lookup_lock);
+
+  rv = clib_bihash_add_del_16_8 (&vxm->vxlan4_tunnel_by_key, key4, is_add);
+
+  /* A failed delete leaves the key in neither table */
+  if (rv == 0 && vxm->vxlan4_lookup_use_cuckoo
+      && clib_cuckoo_add_del_16_8 (&vxm->vxlan4_tunnel_lookup,
+				   (clib_cuckoo_kv_16_8_t *) key4, is_add)
+      != CLIB_CUCKOO_ERROR_SUCCESS && is_add)
+    {
+      clib_bihash_add_del_16_8 (&vxm->vxlan4_tunnel_by_key, key4,
+				0 /* is_add */ );
+      rv = -1;
+    }
+
+  clib_spinlock_unlock_if_init (&vxm->vxlan4_lookup_lock);
+
+  return rv;
+}
+
+static clib_error_t *
+vxlan_config (vlib_main_t * vm, unformat_input_t * input)
+{
+  vxlan_main_t *vxm = &vxlan_main;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "cuckoo-lookup"))
+	vxm->vxlan4_lookup_use_cuckoo = 1;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (vxm->vxlan4_lookup_use_cuckoo)
+    {
+      clib_spinlock_init (&vxm->vxlan4_lookup_lock);
+      clib_cuckoo_init_16_8 (&vxm->vxlan4_tunnel_lookup, "vxlan4 lookup",
+			     VXLAN_HASH_NUM_BUCKETS,
+			     vxlan4_tunnel_lookup_garbage, vxm);
+    }
+
+  return 0;
+}
+
+VLIB_CONFIG_FUNCTION (vxlan_config, "vxlan");
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
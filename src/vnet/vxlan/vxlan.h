@@ -19,6 +19,7 @@
 #include <vppinfra/hash.h>
 #include <vppinfra/bihash_16_8.h>
 #include <vppinfra/bihash_24_8.h>
+#include <vppinfra/cuckoo_16_8.h>
 #include <vnet/vnet.h>
 #include <vnet/ip/ip.h>
 #include <vnet/l2/l2_input.h>
@@ -161,6 +162,12 @@ typedef struct
   clib_bihash_16_8_t vxlan4_tunnel_by_key;	/* keyed on ipv4.dst + fib + vni */
   clib_bihash_24_8_t vxlan6_tunnel_by_key;	/* keyed on ipv6.dst + fib + vni */
 
+  /* optional cuckoo copy of vxlan4_tunnel_by_key, used by vxlan4-input */
+  clib_cuckoo_16_8_t vxlan4_tunnel_lookup;
+  u8 vxlan4_lookup_use_cuckoo;
+  /* keeps vxlan4_tunnel_by_key and its cuckoo copy in step */
+  clib_spinlock_t vxlan4_lookup_lock;
+
   /* local VTEP IPs ref count used by vxlan-bypass node to check if
      received VXLAN packet DIP matches any local VTEP address */
   uword *vtep4;			/* local ip4 VTEPs keyed on their ip4 addr */
@@ -187,6 +194,25 @@ typedef struct
 
 extern vxlan_main_t vxlan_main;
 
+STATIC_ASSERT_SIZEOF (vxlan4_tunnel_key_t, sizeof (clib_cuckoo_kv_16_8_t));
+
+/**
+ * Search the ip4 tunnel table, or its cuckoo copy when configured.
+ * Returns 0 and sets key4->value when found.
+ */
+always_inline int
+vxlan4_tunnel_search_inline (vxlan_main_t * vxm, vxlan4_tunnel_key_t * key4)
+{
+  if (vxm->vxlan4_lookup_use_cuckoo)
+    return clib_cuckoo_search_inline_16_8
+      (&vxm->vxlan4_tunnel_lookup, (clib_cuckoo_kv_16_8_t *) key4);
+
+  return clib_bihash_search_inline_16_8 (&vxm->vxlan4_tunnel_by_key, key4);
+}
+
+int vxlan4_tunnel_add_del (vxlan_main_t * vxm, vxlan4_tunnel_key_t * key4,
+			   int is_add);
+
 extern vlib_node_registration_t vxlan4_input_node;
 extern vlib_node_registration_t vxlan6_input_node;
 extern vlib_node_registration_t vxlan4_encap_node;
@@ -504,6 +504,7 @@ vl_api_log_dump_t_handler (vl_api_log_dump_t * mp)
   int count = lm->count;
   f64 time_offset, start_time;
   vl_api_registration_t *reg;
+  u8 *msg_class, *message;
 
   reg = vl_api_client_index_to_registration (mp->client_index);
   if (reg == 0)
@@ -518,10 +519,15 @@ vl_api_log_dump_t_handler (vl_api_log_dump_t * mp)
     {
       e = vec_elt_at_index (lm->entries, i);
       if (start_time <= e->timestamp + time_offset)
-	show_log_details (reg, mp->context, e->timestamp + time_offset,
-			  (vl_api_log_level_t *) & e->level,
-			  format (0, "%U", format_vlib_log_class, e->class),
-			  e->string);
+	{
+	  msg_class = format (0, "%U", format_vlib_log_class, e->class);
+	  message = format (0, "%U", format_vlib_log_entry_message, e);
+	  show_log_details (reg, mp->context, e->timestamp + time_offset,
+			    (vl_api_log_level_t *) & e->level,
+			    msg_class, message);
+	  vec_free (msg_class);
+	  vec_free (message);
+	}
       i = (i + 1) % lm->size;
     }
 
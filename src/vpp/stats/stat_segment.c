@@ -628,6 +628,21 @@ do_stat_segment_updates (stat_segment_main_t * sm)
   sm->directory_vector[STAT_COUNTER_MEM_STATSEG_USED].value =
     usage.bytes_used;
 
+#if USE_DLMALLOC != 0
+  /* Per thread heap object caches */
+  {
+    u64 hits = 0, misses = 0;
+    for (i = 0; i < vec_len (vlib_mains); i++)
+      if (clib_mem_tcaches[i])
+	{
+	  hits += clib_mem_tcaches[i]->hits;
+	  misses += clib_mem_tcaches[i]->misses;
+	}
+    sm->directory_vector[STAT_COUNTER_MEM_TCACHE_HITS].value = hits;
+    sm->directory_vector[STAT_COUNTER_MEM_TCACHE_MISSES].value = misses;
+  }
+#endif
+
   if (sm->node_counters_enabled)
     update_node_counters (sm);
 
@@ -968,6 +983,60 @@ statseg_sw_interface_add_del (vnet_main_t * vnm, u32 sw_if_index, u32 is_add)
 
 VNET_SW_INTERFACE_ADD_DEL_FUNCTION (statseg_sw_interface_add_del);
 
+/*
+ * Name the route, i.e. the FIB load-balance, whose counters are at 'index'
+ * in the /net/route/to and /net/route/via vectors. A NULL name removes it.
+ */
+void
+stat_segment_set_route_name (u32 index, const u8 * name)
+{
+  stat_segment_main_t *sm = &stat_segment_main;
+  stat_segment_shared_header_t *shared_header = sm->shared_header;
+
+  if (!shared_header)
+    return;
+
+  void *oldheap = vlib_stats_push_heap (sm->routes);
+  vlib_stat_segment_lock ();
+
+  vec_validate (sm->routes, index);
+  vec_free (sm->routes[index]);
+  if (name)
+    sm->routes[index] = format (0, "%v%c", name, 0);
+
+  stat_segment_directory_entry_t *ep;
+  ep = &sm->directory_vector[STAT_COUNTER_ROUTE_NAMES];
+  ep->offset = stat_segment_offset (shared_header, sm->routes);
+
+  int i;
+  u64 *offset_vector =
+    ep->offset_vector ? stat_segment_pointer (shared_header,
+					      ep->offset_vector) : 0;
+
+  vec_validate (offset_vector, vec_len (sm->routes) - 1);
+
+  if (sm->last != sm->routes)
+    {
+      /* the route vector moved, so need to recalulate the offset array */
+      for (i = 0; i < vec_len (sm->routes); i++)
+	{
+	  offset_vector[i] =
+	    sm->routes[i] ? stat_segment_offset (shared_header,
+						 sm->routes[i]) : 0;
+	}
+    }
+  else
+    {
+      offset_vector[index] =
+	sm->routes[index] ?
+	stat_segment_offset (shared_header, sm->routes[index]) : 0;
+    }
+  ep->offset_vector = stat_segment_offset (shared_header, offset_vector);
+
+  vlib_stat_segment_unlock ();
+  clib_mem_set_heap (oldheap);
+}
+
 /* *INDENT-OFF* */
 VLIB_REGISTER_NODE (stat_segment_collector, static) =
 {
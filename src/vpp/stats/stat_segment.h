@@ -35,8 +35,11 @@ typedef enum
  STAT_COUNTER_NODE_SUSPENDS,
  STAT_COUNTER_INTERFACE_NAMES,
  STAT_COUNTER_NODE_NAMES,
+ STAT_COUNTER_ROUTE_NAMES,
  STAT_COUNTER_MEM_STATSEG_TOTAL,
  STAT_COUNTER_MEM_STATSEG_USED,
+ STAT_COUNTER_MEM_TCACHE_HITS,
+ STAT_COUNTER_MEM_TCACHE_MISSES,
  STAT_COUNTERS
 } stat_segment_counter_t;
 
@@ -55,8 +58,11 @@ typedef enum
   _(NODE_SUSPENDS, COUNTER_VECTOR_SIMPLE, suspends, /sys/node)  \
   _(INTERFACE_NAMES, NAME_VECTOR, names, /if)                   \
   _(NODE_NAMES, NAME_VECTOR, names, /sys/node)                  \
+  _(ROUTE_NAMES, NAME_VECTOR, names, /net/route)                \
   _(MEM_STATSEG_TOTAL, SCALAR_INDEX, total, /mem/statseg)       \
-  _(MEM_STATSEG_USED, SCALAR_INDEX, used, /mem/statseg)
+  _(MEM_STATSEG_USED, SCALAR_INDEX, used, /mem/statseg)         \
+  _(MEM_TCACHE_HITS, SCALAR_INDEX, hits, /mem/tcache)           \
+  _(MEM_TCACHE_MISSES, SCALAR_INDEX, misses, /mem/tcache)
 
 /* Default stat segment 32m */
 #define STAT_SEGMENT_DEFAULT_SIZE	(32<<20)
@@ -89,6 +95,7 @@ typedef struct
   u64 *error_vector;
   u8 **interfaces;
   u8 **nodes;
+  u8 **routes;
 
   /* Update interval */
   f64 update_interval;
@@ -115,5 +122,6 @@ stat_segment_register_state_counter(u8 *name, u32 *index);
 clib_error_t *
 stat_segment_deregister_state_counter(u32 index);
 void stat_segment_set_state_counter (u32 index, u64 value);
+void stat_segment_set_route_name (u32 index, const u8 * name);
 
 #endif
@@ -496,6 +496,47 @@ VLIB_CLI_COMMAND (show_bihash_command, static) =
 };
 /* *INDENT-ON* */
 
+/* Buckets migrated per table per dispatch of the resize process */
+#define BIHASH_RESIZE_BUCKETS_PER_DISPATCH 1024
+
+/*
+ * Grow auto_grow bihash tables in the background: check every second,
+ * then migrate buckets in small batches until the resize completes.
+ */
+static uword
+bihash_resize_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
+		       vlib_frame_t * f)
+{
+  clib_bihash_resizable_t *r;
+  f64 timeout = 1.0;
+  int busy, i;
+
+  while (1)
+    {
+      vlib_process_suspend (vm, timeout);
+
+      /* Backwards, a table which can't grow deregisters itself */
+      busy = 0;
+      for (i = vec_len (clib_all_resizable_bihashes) - 1; i >= 0; i--)
+	{
+	  r = vec_elt_at_index (clib_all_resizable_bihashes, i);
+	  busy |= r->fn (r->h, BIHASH_RESIZE_BUCKETS_PER_DISPATCH);
+	}
+
+      timeout = busy ? 1e-3 : 1.0;
+    }
+  return 0;
+}
+
+/* *INDENT-OFF* */
+VLIB_REGISTER_NODE (bihash_resize_process_node, static) =
+{
+  .function = bihash_resize_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "bihash-resize-process",
+};
+/* *INDENT-ON* */
+
 #ifdef CLIB_SANITIZE_ADDR
 /* default options for Address Sanitizer */
 const char *
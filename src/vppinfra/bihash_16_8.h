@@ -28,6 +28,7 @@
 #include <vppinfra/pool.h>
 #include <vppinfra/xxhash.h>
 #include <vppinfra/crc32.h>
+#include <vppinfra/kv_match.h>
 
 typedef struct
 {
@@ -76,6 +77,15 @@ clib_bihash_key_compare_16_8 (u64 * a, u64 * b)
 #endif
 }
 
+/* Match a key against a page of 4 (key,value) pairs */
+static inline u32
+clib_bihash_page_match_16_8 (clib_bihash_kv_16_8_t * kvp,
+			     clib_bihash_kv_16_8_t * key)
+{
+  return clib_kv_match4_16_8 ((u64 *) kvp, key->key);
+}
+
+#define BIHASH_HAVE_PAGE_MATCH 1
 #undef __included_bihash_template_h__
 #include <vppinfra/bihash_template.h>
 
@@ -28,6 +28,7 @@
 #include <vppinfra/format.h>
 #include <vppinfra/pool.h>
 #include <vppinfra/xxhash.h>
+#include <vppinfra/kv_match.h>
 
 typedef struct
 {
@@ -80,6 +81,15 @@ clib_bihash_key_compare_24_8 (u64 * a, u64 * b)
 #endif
 }
 
+/* Match a key against a page of 4 (key,value) pairs */
+static inline u32
+clib_bihash_page_match_24_8 (clib_bihash_kv_24_8_t * kvp,
+			     clib_bihash_kv_24_8_t * key)
+{
+  return clib_kv_match4_24_8 ((u64 *) kvp, key->key);
+}
+
+#define BIHASH_HAVE_PAGE_MATCH 1
 #undef __included_bihash_template_h__
 #include <vppinfra/bihash_template.h>
 
@@ -28,6 +28,7 @@
 #include <vppinfra/pool.h>
 #include <vppinfra/xxhash.h>
 #include <vppinfra/crc32.h>
+#include <vppinfra/kv_match.h>
 
 /** 8 octet key, 8 octet key value pair */
 typedef struct
@@ -85,6 +86,19 @@ clib_bihash_key_compare_8_8 (u64 a, u64 b)
   return a == b;
 }
 
+/** Match a key against a page of clib_bihash_kv_8_8_t instances
+    @param kvp - the first (key,value) pair of the page
+    @param key - the key to look for
+    @return bitmap of the matching (key,value) pairs
+*/
+static inline u32
+clib_bihash_page_match_8_8 (clib_bihash_kv_8_8_t * kvp,
+			    clib_bihash_kv_8_8_t * key)
+{
+  return clib_kv_match4_8_8 ((u64 *) kvp, key->key);
+}
+
+#define BIHASH_HAVE_PAGE_MATCH 1
 #undef __included_bihash_template_h__
 #include <vppinfra/bihash_template.h>
 
@@ -14,11 +14,15 @@
  */
 
 #include <vppinfra/mem.h>
+#include <vppinfra/bihash_resize.h>
 
 /* Vector of all bihashes */
 void **clib_all_bihashes;
 static void **clib_all_bihash_heap;
 
+/* Vector of auto-grow bihashes */
+clib_bihash_resizable_t *clib_all_resizable_bihashes;
+
 void *
 clib_all_bihash_set_heap (void)
 {
@@ -42,10 +46,49 @@ clib_bihash_copied (void *dst, void *src)
       if (clib_all_bihashes[i] == src)
 	{
 	  clib_all_bihashes[i] = dst;
-	  return;
+	  goto resizable;
 	}
     }
   clib_warning ("Couldn't find bihash copy source %llx!", src);
+
+resizable:
+  for (i = 0; i < vec_len (clib_all_resizable_bihashes); i++)
+    if (clib_all_resizable_bihashes[i].h == src)
+      clib_all_resizable_bihashes[i].h = dst;
+}
+
+void
+clib_bihash_resizable_add (void *h, clib_bihash_resize_fn_t * fn)
+{
+  clib_bihash_resizable_t *r;
+  void *oldheap;
+
+  vec_foreach (r, clib_all_resizable_bihashes)
+  {
+    if (r->h == h)
+      return;
+  }
+
+  oldheap = clib_all_bihash_set_heap ();
+  vec_add2 (clib_all_resizable_bihashes, r, 1);
+  r->h = h;
+  r->fn = fn;
+  clib_mem_set_heap (oldheap);
+}
+
+void
+clib_bihash_resizable_del (void *h)
+{
+  int i;
+
+  for (i = 0; i < vec_len (clib_all_resizable_bihashes); i++)
+    {
+      if (clib_all_resizable_bihashes[i].h == h)
+	{
+	  vec_delete (clib_all_resizable_bihashes, 1, i);
+	  return;
+	}
+    }
 }
 
 
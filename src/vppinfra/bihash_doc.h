@@ -101,8 +101,30 @@ a power of two
 void clib_bihash_init
   (clib_bihash * h, char *name, u32 nbuckets, uword memory_size);
 
+/** Create a bounded index extensible hash table in a file, or
+    reattach to the table left in the file by a previous process
+
+    The file starts with a versioned header describing the table
+    type and size. A table which was not detached cleanly is walked
+    and checked before it is attached; a table which fails the
+    check, or does not match the requested type and size, is
+    discarded and an empty one created in its place. The file is
+    locked while the table is mapped, a second process is refused.
+
+    @param a - initialization parameters, as for clib_bihash_init2.
+    auto_grow is not supported
+    @param path - the file, on hugetlbfs for huge page backing
+    @param attached - set to 1 if an existing table was attached
+    @returns 0 on success, or an error if the file can't be mapped
+    or is in use
+*/
+
+clib_error_t *clib_bihash_init_file
+  (clib_bihash_init2_args * a, char *path, int *attached);
+
 /** Destroy a bounded index extensible hash table
     @param h - the bi-hash table to free
+    @note a file backed table is unmapped, its contents are kept
 */
 
 void clib_bihash_free (clib_bihash * h);
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __included_bihash_resize_h__
+#define __included_bihash_resize_h__
+
+#include <vppinfra/vec.h>
+
+/**
+ * Type-independent resize worker of a bihash initialized with
+ * auto_grow. Migrates up to n_buckets buckets and returns non-zero
+ * while the table still has resize work pending.
+ */
+typedef int (clib_bihash_resize_fn_t) (void *h, u32 n_buckets);
+
+typedef struct
+{
+  void *h;
+  clib_bihash_resize_fn_t *fn;
+} clib_bihash_resizable_t;
+
+/* Auto-grow tables, serviced by a background process */
+extern clib_bihash_resizable_t *clib_all_resizable_bihashes;
+
+void clib_bihash_resizable_add (void *h, clib_bihash_resize_fn_t * fn);
+void clib_bihash_resizable_del (void *h);
+
+#endif /* __included_bihash_resize_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
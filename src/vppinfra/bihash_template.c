@@ -29,9 +29,25 @@ static inline void *BV (alloc_aligned) (BVT (clib_bihash) * h, uword nbytes)
   if (alloc_arena_next (h) > alloc_arena_size (h))
     os_out_of_memory ();
 
+#if BIHASH_32_64_SVM == 0
+  if (PREDICT_FALSE (h->file_header != 0))
+    h->file_header->alloc_arena_next = alloc_arena_next (h);
+#endif
+
   return (void *) (uword) (rv + alloc_arena (h));
 }
 
+static inline void BV (freelist_sync) (BVT (clib_bihash) * h, u32 log2_pages)
+{
+#if BIHASH_32_64_SVM == 0
+  if (PREDICT_FALSE (h->file_header != 0))
+    {
+      ASSERT (log2_pages < CLIB_BIHASH_FILE_N_FREELISTS);
+      h->file_header->freelists[log2_pages] = h->freelists[log2_pages];
+    }
+#endif
+}
+
 void BV (clib_bihash_instantiate) (BVT (clib_bihash) * h)
 {
   uword bucket_size;
@@ -60,8 +76,14 @@ void BV (clib_bihash_init2) (BVT (clib_bihash_init2_args) * a)
   h->memory_size = a->memory_size;
   h->instantiated = 0;
   h->fmt_fn = a->fmt_fn;
+  h->old_buckets = 0;
+  h->auto_grow = a->auto_grow;
+  h->n_elts = 0;
 
   alloc_arena (h) = 0;
+#if BIHASH_32_64_SVM == 0
+  h->file_header = 0;
+#endif
 
   /*
    * Make sure the requested size is rational. The max table
@@ -83,6 +105,9 @@ void BV (clib_bihash_init2) (BVT (clib_bihash_init2_args) * a)
     }
 
 do_lock:
+  if (h->auto_grow)
+    clib_bihash_resizable_add (h, BV (clib_bihash_resize_work));
+
   if (h->alloc_lock)
     clib_mem_free ((void *) h->alloc_lock);
 
@@ -233,6 +258,286 @@ void BV (clib_bihash_slave_init_svm)
   h->freelists = BV (clib_bihash_get_value) (h, h->sh->freelists_as_u64);
   h->fmt_fn = NULL;
 }
+#else /* BIHASH_32_64_SVM */
+
+/* Lay out an empty table in a freshly mapped file */
+static void BV (clib_bihash_file_format) (BVT (clib_bihash) * h)
+{
+  clib_bihash_file_header_t *fh = h->file_header;
+  uword bucket_size = h->nbuckets * sizeof (h->buckets[0]);
+
+  clib_memset (fh, 0, sizeof (*fh));
+  alloc_arena_next (h) = round_pow2 (sizeof (*fh), CLIB_CACHE_LINE_BYTES);
+  h->buckets = BV (alloc_aligned) (h, bucket_size);
+  clib_memset (h->buckets, 0, bucket_size);
+  vec_reset_length (h->freelists);
+  h->n_elts = 0;
+
+  fh->version = CLIB_BIHASH_FILE_VERSION;
+  fh->kvp_size = sizeof (BVT (clib_bihash_kv));
+  fh->kvp_per_page = BIHASH_KVP_PER_PAGE;
+  fh->nbuckets = h->nbuckets;
+  fh->memory_size = h->memory_size;
+  strncpy (fh->type, __bvstr (BIHASH_TYPE), sizeof (fh->type) - 1);
+  fh->buckets_offset = BV (clib_bihash_get_offset) (h, h->buckets);
+
+  /* Magic last, a file formatted halfway is never attached */
+  CLIB_MEMORY_BARRIER ();
+  fh->magic = CLIB_BIHASH_FILE_MAGIC;
+}
+
+/* Mark the cache lines of an arena allocation, fail on overlap */
+static int BV (clib_bihash_file_claim) (BVT (clib_bihash) * h,
+					uword ** used, u64 offset,
+					uword n_bytes)
+{
+  clib_bihash_file_header_t *fh = h->file_header;
+  uword i, first, last;
+
+  if (offset < fh->buckets_offset + h->nbuckets * sizeof (h->buckets[0]) ||
+      offset + n_bytes > fh->alloc_arena_next ||
+      (offset & (CLIB_CACHE_LINE_BYTES - 1)))
+    return -1;
+
+  first = offset / CLIB_CACHE_LINE_BYTES;
+  last = (offset + n_bytes - 1) / CLIB_CACHE_LINE_BYTES;
+  for (i = first; i <= last; i++)
+    {
+      if (clib_bitmap_get (*used, i))
+	return -1;
+      *used = clib_bitmap_set (*used, i, 1);
+    }
+  return 0;
+}
+
+/*
+ * Walk a table left behind by a process which did not detach cleanly.
+ * Every page must be inside the arena, owned by one bucket or one
+ * freelist, and hold the entries its bucket expects. A bucket still
+ * locked means a writer was interrupted.
+ */
+static char *BV (clib_bihash_file_check) (BVT (clib_bihash) * h)
+{
+  clib_bihash_file_header_t *fh = h->file_header;
+  BVT (clib_bihash_value) * v;
+  BVT (clib_bihash_bucket) * b;
+  BVT (clib_bihash_kv) * kv;
+  uword *used = 0, page_size = sizeof (BVT (clib_bihash_value));
+  char *why = 0;
+  u64 hash, offset, n_elts = 0;
+  u32 i, j, n;
+
+  for (i = 0; i < h->nbuckets; i++)
+    {
+      b = h->buckets + i;
+      if (b->as_u64 == 0)
+	continue;
+
+      if (b->lock)
+	{
+	  why = "bucket left locked";
+	  goto done;
+	}
+      if (b->log2_pages >= CLIB_BIHASH_FILE_N_FREELISTS ||
+	  BV (clib_bihash_file_claim) (h, &used, b->offset,
+				       page_size << b->log2_pages))
+	{
+	  why = "bad bucket page offset";
+	  goto done;
+	}
+
+      v = BV (clib_bihash_get_value) (h, b->offset);
+      for (n = 0, j = 0; j < (BIHASH_KVP_PER_PAGE << b->log2_pages); j++)
+	{
+	  kv = &v[j / BIHASH_KVP_PER_PAGE].kvp[j % BIHASH_KVP_PER_PAGE];
+	  if (BV (clib_bihash_is_free) (kv))
+	    continue;
+
+	  hash = BV (clib_bihash_hash) (kv);
+	  if ((hash & (h->nbuckets - 1)) != i ||
+	      (b->linear_search == 0 &&
+	       ((hash >> h->log2_nbuckets) & ((1 << b->log2_pages) - 1)) !=
+	       j / BIHASH_KVP_PER_PAGE))
+	    {
+	      why = "entry in the wrong bucket";
+	      goto done;
+	    }
+	  n++;
+	}
+      if (n != b->refcnt)
+	{
+	  why = "bucket refcnt mismatch";
+	  goto done;
+	}
+      n_elts += n;
+    }
+
+  /* A loop revisits a claimed page, so these walks terminate */
+  for (i = 0; i < vec_len (h->freelists); i++)
+    for (offset = h->freelists[i]; offset; offset = v->next_free_as_u64)
+      {
+	if (BV (clib_bihash_file_claim) (h, &used, offset, page_size << i))
+	  {
+	    why = "bad freelist";
+	    goto done;
+	  }
+	v = BV (clib_bihash_get_value) (h, offset);
+      }
+
+  for (i = 0; i < CLIB_BIHASH_FILE_N_WORKING_COPIES; i++)
+    if (fh->working_copies[i] &&
+	(fh->working_copy_lengths[i] >= CLIB_BIHASH_FILE_N_FREELISTS ||
+	 BV (clib_bihash_file_claim) (h, &used, fh->working_copies[i],
+				      page_size <<
+				      fh->working_copy_lengths[i])))
+      {
+	why = "bad working copy";
+	goto done;
+      }
+
+  h->n_elts = n_elts;
+
+done:
+  clib_bitmap_free (used);
+  return why;
+}
+
+/* Returns 0 when the file holds a usable table of the right type */
+static int BV (clib_bihash_file_attach) (BVT (clib_bihash) * h)
+{
+  clib_bihash_file_header_t *fh = h->file_header;
+  uword bucket_size = h->nbuckets * sizeof (h->buckets[0]);
+  char *why = 0;
+  int i;
+
+  if (fh->magic != CLIB_BIHASH_FILE_MAGIC)
+    return -1;
+
+  if (fh->version != CLIB_BIHASH_FILE_VERSION ||
+      fh->kvp_size != sizeof (BVT (clib_bihash_kv)) ||
+      fh->kvp_per_page != BIHASH_KVP_PER_PAGE ||
+      strncmp (fh->type, __bvstr (BIHASH_TYPE), sizeof (fh->type)))
+    why = "different table type or version";
+  else if (fh->nbuckets != h->nbuckets || fh->memory_size != h->memory_size)
+    why = "different size";
+  else if (fh->buckets_offset !=
+	   round_pow2 (sizeof (*fh), CLIB_CACHE_LINE_BYTES) ||
+	   fh->alloc_arena_next < fh->buckets_offset + bucket_size ||
+	   fh->alloc_arena_next > h->memory_size)
+    why = "corrupt header";
+
+  if (why)
+    goto fail;
+
+  h->buckets = BV (clib_bihash_get_value) (h, fh->buckets_offset);
+  alloc_arena_next (h) = fh->alloc_arena_next;
+  /* Pages of any size may be freed from now on */
+  vec_validate (h->freelists, CLIB_BIHASH_FILE_N_FREELISTS - 1);
+  for (i = 0; i < CLIB_BIHASH_FILE_N_FREELISTS; i++)
+    h->freelists[i] = fh->freelists[i];
+  h->n_elts = fh->n_elts;
+
+  /* Unless detached cleanly, check the contents */
+  if (fh->in_use && (why = BV (clib_bihash_file_check) (h)))
+    goto fail;
+
+  /* Reuse the working copies of the last owner, they'd leak otherwise */
+  for (i = 0; i < CLIB_BIHASH_FILE_N_WORKING_COPIES; i++)
+    if (fh->working_copies[i])
+      {
+	vec_validate (h->working_copies, i);
+	vec_validate_init_empty (h->working_copy_lengths, i, ~0);
+	h->working_copies[i] =
+	  BV (clib_bihash_get_value) (h, fh->working_copies[i]);
+	h->working_copy_lengths[i] = fh->working_copy_lengths[i];
+      }
+  return 0;
+
+fail:
+  clib_warning ("%s: not attaching to existing table, %s", h->name, why);
+  return -1;
+}
+
+/**
+ * Create a table in a file, or reattach to the table a previous
+ * process left there. Use a file on hugetlbfs to back the table with
+ * huge pages. The table is kept across clib_bihash_free, remove the
+ * file to discard it. File backed tables can't grow.
+ */
+clib_error_t *BV (clib_bihash_init_file) (BVT (clib_bihash_init2_args) * a,
+					  char *path, int *attached)
+{
+  BVT (clib_bihash) * h = a->h;
+  clib_bihash_file_header_t *fh;
+  clib_error_t *error = 0;
+  struct stat st;
+  uword size;
+  void *base;
+  int fd;
+
+  *attached = 0;
+
+  if (a->auto_grow)
+    return clib_error_return (0, "%s: file backed tables can't grow",
+			      a->name);
+
+  if ((fd = open (path, O_RDWR | O_CREAT, 0600)) < 0)
+    return clib_error_return_unix (0, "open '%s'", path);
+
+  /* One process per table, the lock goes away with the process */
+  if (flock (fd, LOCK_EX | LOCK_NB) < 0)
+    {
+      error = clib_error_return_unix (0, "'%s' is in use", path);
+      goto done;
+    }
+
+  /* hugetlbfs wants whole pages */
+  size = round_pow2 (a->memory_size, clib_mem_get_fd_page_size (fd));
+
+  if (fstat (fd, &st) < 0)
+    {
+      error = clib_error_return_unix (0, "fstat '%s'", path);
+      goto done;
+    }
+
+  if (st.st_size != size && ftruncate (fd, size) < 0)
+    {
+      error = clib_error_return_unix (0, "ftruncate '%s'", path);
+      goto done;
+    }
+
+  base = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED)
+    {
+      error = clib_error_return_unix (0, "mmap '%s'", path);
+      goto done;
+    }
+
+  a->memory_size = size;
+  a->instantiate_immediately = 0;
+  BV (clib_bihash_init2) (a);
+
+  alloc_arena (h) = pointer_to_u64 (base);
+  alloc_arena_size (h) = size;
+  h->file_header = fh = base;
+  h->file_fd = fd;
+
+  if (BV (clib_bihash_file_attach) (h) == 0)
+    *attached = 1;
+  else
+    BV (clib_bihash_file_format) (h);
+
+  fh->in_use = 1;
+  fh->n_attach++;
+  CLIB_MEMORY_BARRIER ();
+  h->instantiated = 1;
+
+done:
+  /* Keep the fd, and the lock, while mapped */
+  if (error)
+    close (fd);
+  return error;
+}
 #endif /* BIHASH_32_64_SVM */
 
 void BV (clib_bihash_set_kvp_format_fn) (BVT (clib_bihash) * h,
@@ -241,6 +546,9 @@ void BV (clib_bihash_set_kvp_format_fn) (BVT (clib_bihash) * h,
   h->fmt_fn = fmt_fn;
 }
 
+static void BV (value_free) (BVT (clib_bihash) * h,
+			     BVT (clib_bihash_value) * v, u32 log2_pages);
+
 void BV (clib_bihash_free) (BVT (clib_bihash) * h)
 {
   int i;
@@ -249,16 +557,45 @@ void BV (clib_bihash_free) (BVT (clib_bihash) * h)
     goto never_initialized;
 
   h->instantiated = 0;
+#if BIHASH_32_64_SVM == 0
+  if (h->file_header)
+    {
+      /* Working copies not recorded in the header go back to the
+       * freelists, the next owner reuses the others */
+      BV (clib_bihash_alloc_lock) (h);
+      for (i = CLIB_BIHASH_FILE_N_WORKING_COPIES;
+	   i < vec_len (h->working_copies); i++)
+	if (h->working_copies[i])
+	  BV (value_free) (h, h->working_copies[i],
+			   h->working_copy_lengths[i]);
+      BV (clib_bihash_alloc_unlock) (h);
+    }
+#endif
   vec_free (h->working_copies);
   vec_free (h->working_copy_lengths);
 #if BIHASH_32_64_SVM == 0
   vec_free (h->freelists);
+  if (h->file_header)
+    {
+      /* Keep the contents, the next clib_bihash_init_file reattaches */
+      h->file_header->n_elts = h->n_elts;
+      CLIB_MEMORY_BARRIER ();
+      h->file_header->in_use = 0;
+      if (msync ((void *) (uword) alloc_arena (h), alloc_arena_size (h),
+		 MS_SYNC) < 0)
+	clib_unix_warning ("msync");
+      munmap ((void *) (uword) alloc_arena (h), alloc_arena_size (h));
+      close (h->file_fd);
+      goto never_initialized;
+    }
 #else
   if (h->memfd > 0)
     (void) close (h->memfd);
 #endif
   clib_mem_vm_free ((void *) (uword) (alloc_arena (h)), alloc_arena_size (h));
 never_initialized:
+  /* auto_grow is cleared when growing fails, deregister regardless */
+  clib_bihash_resizable_del (h);
   clib_memset (h, 0, sizeof (*h));
   for (i = 0; i < vec_len (clib_all_bihashes); i++)
     {
@@ -292,6 +629,7 @@ BV (value_alloc) (BVT (clib_bihash) * h, u32 log2_pages)
     }
   rv = BV (clib_bihash_get_value) (h, (uword) h->freelists[log2_pages]);
   h->freelists[log2_pages] = rv->next_free_as_u64;
+  BV (freelist_sync) (h, log2_pages);
 
 initialize:
   ASSERT (rv);
@@ -317,6 +655,7 @@ BV (value_free) (BVT (clib_bihash) * h, BVT (clib_bihash_value) * v,
 
   v->next_free_as_u64 = (u64) h->freelists[log2_pages];
   h->freelists[log2_pages] = (u64) BV (clib_bihash_get_offset) (h, v);
+  BV (freelist_sync) (h, log2_pages);
 }
 
 static inline void
@@ -353,11 +692,30 @@ BV (make_working_copy) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b)
        *   if (working_copy)
        *     clib_mem_free (working_copy);
        */
+      BVT (clib_bihash_value) * old_copy = working_copy;
+
       working_copy = BV (alloc_aligned)
 	(h, sizeof (working_copy[0]) * (1 << b->log2_pages));
       h->working_copy_lengths[thread_index] = b->log2_pages;
       h->working_copies[thread_index] = working_copy;
 
+#if BIHASH_32_64_SVM == 0
+      /* The arena of a file backed table outlives the process, record
+       * the copy for the next owner and recycle the one it replaces */
+      if (PREDICT_FALSE (h->file_header != 0))
+	{
+	  if (thread_index < CLIB_BIHASH_FILE_N_WORKING_COPIES)
+	    {
+	      h->file_header->working_copies[thread_index] =
+		BV (clib_bihash_get_offset) (h, working_copy);
+	      h->file_header->working_copy_lengths[thread_index] =
+		b->log2_pages;
+	    }
+	  if (old_copy)
+	    BV (value_free) (h, old_copy, log2_working_copy_length);
+	}
+#endif
+
       BV (clib_bihash_increment_stat) (h, BIHASH_STAT_working_copy_lost,
 				       1ULL << b->log2_pages);
     }
@@ -372,12 +730,17 @@ BV (make_working_copy) (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b)
   h->working_copies[thread_index] = working_copy;
 }
 
+/*
+ * Rehash the entries of old_values onto new_log2_pages pages. Only the
+ * entries whose hash matches select_value under select_mask are moved,
+ * which lets a resize split a bucket across two new buckets.
+ */
 static
 BVT (clib_bihash_value) *
 BV (split_and_rehash)
   (BVT (clib_bihash) * h,
    BVT (clib_bihash_value) * old_values, u32 old_log2_pages,
-   u32 new_log2_pages)
+   u32 new_log2_pages, u32 log2_nbuckets, u64 select_mask, u64 select_value)
 {
   BVT (clib_bihash_value) * new_values, *new_v;
   int i, j, length_in_kvs;
@@ -397,7 +760,9 @@ BV (split_and_rehash)
 
       /* rehash the item onto its new home-page */
       new_hash = BV (clib_bihash_hash) (&(old_values->kvp[i]));
-      new_hash >>= h->log2_nbuckets;
+      if ((new_hash & select_mask) != select_value)
+	continue;
+      new_hash >>= log2_nbuckets;
       new_hash &= (1 << new_log2_pages) - 1;
       new_v = &new_values[new_hash];
 
@@ -426,7 +791,7 @@ BVT (clib_bihash_value) *
 BV (split_and_rehash_linear)
   (BVT (clib_bihash) * h,
    BVT (clib_bihash_value) * old_values, u32 old_log2_pages,
-   u32 new_log2_pages)
+   u32 new_log2_pages, u64 select_mask, u64 select_value)
 {
   BVT (clib_bihash_value) * new_values;
   int i, j, new_length, old_length;
@@ -448,6 +813,11 @@ BV (split_and_rehash_linear)
 	  if (BV (clib_bihash_is_free) (&(old_values->kvp[i])))
 	    goto doublebreak;
 
+	  /* Or destined for another bucket */
+	  if ((BV (clib_bihash_hash) (&(old_values->kvp[i])) & select_mask)
+	      != select_value)
+	    goto doublebreak;
+
 	  /* New value should never be in use */
 	  if (BV (clib_bihash_is_free) (&(new_values->kvp[j])))
 	    {
@@ -468,17 +838,288 @@ BV (split_and_rehash_linear)
   return new_values;
 }
 
+/*
+ * Move the entries of an old bucket into the two new buckets they
+ * hash to. The new buckets are necessarily empty: writers always
+ * migrate the old bucket before touching its new buckets. The empty
+ * test is done under the bucket lock, a writer which started before
+ * the resize may be adding the first entry to the old bucket. A
+ * non-empty old bucket also keeps the resize, started at resize_seq,
+ * from completing while we look at its parameters.
+ */
+static void
+BV (clib_bihash_migrate_bucket) (BVT (clib_bihash) * h,
+				 BVT (clib_bihash_bucket) * old_buckets,
+				 u32 old_index, u32 resize_seq)
+{
+  BVT (clib_bihash_bucket) * ob, *nb, tmp_b;
+  BVT (clib_bihash_value) * old_v, *new_v;
+  u32 old_log2_pages, new_log2_pages, log2_nbuckets;
+  u64 select_mask, select_value;
+  int half, i, n_kvs, mark_bucket_linear;
+
+  ob = &old_buckets[old_index];
+
+  BV (clib_bihash_lock_bucket) (ob);
+
+  /* Nothing to move, somebody beat us to it, or another resize? */
+  if (BV (clib_bihash_bucket_is_empty) (ob) ||
+      clib_atomic_load_acq_n (&h->resize_seq) != resize_seq)
+    {
+      BV (clib_bihash_unlock_bucket) (ob);
+      return;
+    }
+
+  old_v = BV (clib_bihash_get_value) (h, ob->offset);
+  old_log2_pages = ob->log2_pages;
+  log2_nbuckets = h->old_log2_nbuckets + 1;
+  select_mask = h->old_nbuckets;
+
+  BV (clib_bihash_alloc_lock) (h);
+
+  for (half = 0; half < 2; half++)
+    {
+      nb = &h->buckets[old_index + half * h->old_nbuckets];
+      select_value = half ? select_mask : 0;
+
+      ASSERT (BV (clib_bihash_bucket_is_empty) (nb));
+
+      n_kvs = 0;
+      for (i = 0; i < (BIHASH_KVP_PER_PAGE << old_log2_pages); i++)
+	if (!BV (clib_bihash_is_free) (&old_v->kvp[i]) &&
+	    (BV (clib_bihash_hash) (&old_v->kvp[i]) & select_mask) ==
+	    select_value)
+	  n_kvs++;
+
+      if (n_kvs == 0)
+	continue;
+
+      /*
+       * Each new bucket gets about half of the entries, try with
+       * half of the pages first
+       */
+      mark_bucket_linear = 0;
+      new_log2_pages = old_log2_pages ? old_log2_pages - 1 : 0;
+      while (1)
+	{
+	  new_v = BV (split_and_rehash) (h, old_v, old_log2_pages,
+					 new_log2_pages, log2_nbuckets,
+					 select_mask, select_value);
+	  if (new_v)
+	    break;
+	  if (new_log2_pages > old_log2_pages)
+	    {
+	      /* pinned collisions, the old bucket size always fits */
+	      new_log2_pages = old_log2_pages;
+	      new_v = BV (split_and_rehash_linear) (h, old_v, old_log2_pages,
+						    new_log2_pages,
+						    select_mask,
+						    select_value);
+	      mark_bucket_linear = 1;
+	      BV (clib_bihash_increment_stat) (h, BIHASH_STAT_linear, 1);
+	      break;
+	    }
+	  new_log2_pages++;
+	}
+
+      tmp_b.as_u64 = 0;
+      tmp_b.offset = BV (clib_bihash_get_offset) (h, new_v);
+      tmp_b.log2_pages = new_log2_pages;
+      tmp_b.linear_search = mark_bucket_linear;
+      tmp_b.refcnt = n_kvs;
+      CLIB_MEMORY_BARRIER ();
+      nb->as_u64 = tmp_b.as_u64;
+    }
+
+  /*
+   * Readers search the old bucket before the new ones, so once it is
+   * empty the entries are guaranteed to be visible in the new array
+   */
+  CLIB_MEMORY_BARRIER ();
+  ob->as_u64 = 0;		/* empties and unlocks the bucket */
+
+  BV (value_free) (h, old_v, old_log2_pages);
+  BV (clib_bihash_alloc_unlock) (h);
+}
+
+/**
+ * Start doubling the bucket array. Buckets are moved to the new array
+ * by clib_bihash_resize_step and by writers as they touch them.
+ * Returns 0 on success, -1 if a resize is already in progress or the
+ * arena cannot hold the new array.
+ */
+int BV (clib_bihash_resize_start) (BVT (clib_bihash) * h)
+{
+#if BIHASH_32_64_SVM
+  /* The bucket array location is part of the shared header */
+  return -1;
+#else
+  BVT (clib_bihash_bucket) * new_buckets;
+  uword bucket_size;
+
+  /* The bucket array of a file backed table is located by its header */
+  if (h->instantiated == 0 || h->log2_nbuckets >= 31 || h->file_header)
+    return -1;
+
+  BV (clib_bihash_alloc_lock) (h);
+
+  if (h->old_buckets)
+    {
+      BV (clib_bihash_alloc_unlock) (h);
+      return -1;
+    }
+
+  bucket_size = 2ULL * h->nbuckets * sizeof (h->buckets[0]);
+  if (alloc_arena_next (h) + bucket_size + CLIB_CACHE_LINE_BYTES >
+      alloc_arena_size (h))
+    {
+      BV (clib_bihash_alloc_unlock) (h);
+      return -1;
+    }
+
+  new_buckets = BV (alloc_aligned) (h, bucket_size);
+  clib_memset (new_buckets, 0, bucket_size);
+
+  /*
+   * Release stores, who reads the parameters of this resize also sees
+   * the end of the previous one, see clib_bihash_search_resizing
+   */
+  clib_atomic_store_rel_n (&h->old_nbuckets, h->nbuckets);
+  clib_atomic_store_rel_n (&h->old_log2_nbuckets, h->log2_nbuckets);
+  h->resize_cursor = 0;
+  h->resize_n_done = 0;
+  clib_atomic_store_rel_n (&h->resize_seq, h->resize_seq + 1);
+  clib_atomic_store_rel_n (&h->old_buckets, h->buckets);
+
+  /* Array before size, see clib_bihash_get_bucket */
+  clib_atomic_store_rel_n (&h->buckets, new_buckets);
+  h->nbuckets = 2 * h->old_nbuckets;
+  clib_atomic_store_rel_n (&h->log2_nbuckets, h->old_log2_nbuckets + 1);
+
+  BV (clib_bihash_alloc_unlock) (h);
+  return 0;
+#endif
+}
+
+/**
+ * Migrate up to n_buckets old buckets. Returns non-zero while the
+ * resize is still in progress.
+ */
+int BV (clib_bihash_resize_step) (BVT (clib_bihash) * h, u32 n_buckets)
+{
+  BVT (clib_bihash_bucket) * old_buckets;
+  u32 i, resize_seq;
+
+  resize_seq = clib_atomic_load_acq_n (&h->resize_seq);
+  old_buckets = clib_atomic_load_acq_n (&h->old_buckets);
+  if (old_buckets == 0 || !(resize_seq & 1))
+    return 0;
+
+  while (n_buckets--)
+    {
+      i = clib_atomic_fetch_add (&h->resize_cursor, 1);
+      if (i >= h->old_nbuckets)
+	break;
+
+      BV (clib_bihash_migrate_bucket) (h, old_buckets, i, resize_seq);
+
+      if (clib_atomic_add_fetch (&h->resize_n_done, 1) == h->old_nbuckets)
+	{
+	  /*
+	   * Every old bucket is now empty and stays empty. The old array
+	   * is not reused, a reader or a writer may still be looking at it.
+	   */
+	  clib_atomic_store_rel_n (&h->old_buckets, 0);
+	  clib_atomic_store_rel_n (&h->resize_seq, h->resize_seq + 1);
+	  return 0;
+	}
+    }
+  return 1;
+}
+
+int BV (clib_bihash_resize_needed) (BVT (clib_bihash) * h)
+{
+  return (h->auto_grow && h->instantiated && h->old_buckets == 0 &&
+	  h->n_elts > (u64) h->nbuckets * BIHASH_KVP_PER_PAGE);
+}
+
+/**
+ * Background resize worker, see clib_all_resizable_bihashes
+ */
+int BV (clib_bihash_resize_work) (void *arg, u32 n_buckets)
+{
+  BVT (clib_bihash) * h = arg;
+
+  if (h->old_buckets)
+    return BV (clib_bihash_resize_step) (h, n_buckets);
+
+  if (BV (clib_bihash_resize_needed) (h))
+    {
+      if (BV (clib_bihash_resize_start) (h) == 0)
+	return 1;
+
+      clib_warning ("%s: can't grow beyond %u buckets", h->name,
+		    h->nbuckets);
+      h->auto_grow = 0;
+      clib_bihash_resizable_del (h);
+    }
+  return 0;
+}
+
+/*
+ * Writer side of a resize: migrate the old bucket hash maps to, so the
+ * new bucket can be written. The resize parameters are read as a
+ * seqlock. Returns non-zero if the caller must look again: the resize
+ * it saw is over, or its bucket array is not published yet.
+ */
+static int
+BV (clib_bihash_migrate_hash) (BVT (clib_bihash) * h, u64 hash,
+			       u32 log2_nbuckets, u32 resize_seq)
+{
+  BVT (clib_bihash_bucket) * old_buckets;
+  u32 old_nbuckets, old_log2_nbuckets;
+
+  old_buckets = clib_atomic_load_acq_n (&h->old_buckets);
+  old_nbuckets = clib_atomic_load_acq_n (&h->old_nbuckets);
+  old_log2_nbuckets = clib_atomic_load_acq_n (&h->old_log2_nbuckets);
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  if (clib_atomic_load_acq_n (&h->resize_seq) != resize_seq)
+    return -1;
+
+  /* The bucket we got may be in the old array, or in the new one but
+     indexed with the old size */
+  if (log2_nbuckets != old_log2_nbuckets + 1)
+    return -1;
+
+  /* Not set when the resize is completing, everything was migrated */
+  if (old_buckets)
+    BV (clib_bihash_migrate_bucket) (h, old_buckets,
+				     hash & (old_nbuckets - 1), resize_seq);
+  return 0;
+}
+
+static inline void BV (clib_bihash_count_elts) (BVT (clib_bihash) * h,
+						int is_add)
+{
+  if (PREDICT_TRUE (h->auto_grow == 0))
+    return;
+  if (is_add)
+    clib_atomic_fetch_add (&h->n_elts, 1);
+  else
+    clib_atomic_fetch_sub (&h->n_elts, 1);
+}
+
 static inline int BV (clib_bihash_add_del_inline)
   (BVT (clib_bihash) * h, BVT (clib_bihash_kv) * add_v, int is_add,
    int (*is_stale_cb) (BVT (clib_bihash_kv) *, void *), void *arg)
 {
-  u32 bucket_index;
   BVT (clib_bihash_bucket) * b, tmp_b;
   BVT (clib_bihash_value) * v, *new_v, *save_new_v, *working_copy;
   int i, limit;
   u64 hash, new_hash;
-  u32 new_log2_pages, old_log2_pages;
+  u32 new_log2_pages, old_log2_pages, log2_nbuckets;
   u32 thread_index = os_get_thread_index ();
+  u32 resize_seq;
   int mark_bucket_linear;
   int resplit_once;
 
@@ -499,13 +1140,33 @@ static inline int BV (clib_bihash_add_del_inline)
 
   hash = BV (clib_bihash_hash) (add_v);
 
-  bucket_index = hash & (h->nbuckets - 1);
-  b = &h->buckets[bucket_index];
+retry:
+  resize_seq = clib_atomic_load_acq_n (&h->resize_seq);
+  b = BV (clib_bihash_get_bucket) (h, hash, &log2_nbuckets);
 
-  hash >>= h->log2_nbuckets;
+  /* Resizing? Move the old bucket's entries to the new array first */
+  if (PREDICT_FALSE (resize_seq & 1) &&
+      BV (clib_bihash_migrate_hash) (h, hash, log2_nbuckets, resize_seq))
+    {
+      CLIB_PAUSE ();
+      goto retry;
+    }
 
   BV (clib_bihash_lock_bucket) (b);
 
+  /*
+   * A resize started or completed under our feet? The bucket may be
+   * (being) migrated, look again. Once we hold the lock, migration of
+   * this bucket waits for us.
+   */
+  if (PREDICT_FALSE (clib_atomic_load_acq_n (&h->resize_seq) != resize_seq))
+    {
+      BV (clib_bihash_unlock_bucket) (b);
+      goto retry;
+    }
+
+  hash >>= log2_nbuckets;
+
   /* First elt in the bucket? */
   if (BV (clib_bihash_bucket_is_empty) (b))
     {
@@ -527,6 +1188,7 @@ static inline int BV (clib_bihash_add_del_inline)
 
       b->as_u64 = tmp_b.as_u64;	/* unlocks the bucket */
       BV (clib_bihash_increment_stat) (h, BIHASH_STAT_alloc_add, 1);
+      BV (clib_bihash_count_elts) (h, 1 /* is_add */ );
 
       return (0);
     }
@@ -590,6 +1252,7 @@ static inline int BV (clib_bihash_add_del_inline)
 	      ASSERT (b->refcnt > 0);
 	      BV (clib_bihash_unlock_bucket) (b);
 	      BV (clib_bihash_increment_stat) (h, BIHASH_STAT_add, 1);
+	      BV (clib_bihash_count_elts) (h, 1 /* is_add */ );
 	      return (0);
 	    }
 	}
@@ -624,6 +1287,7 @@ static inline int BV (clib_bihash_add_del_inline)
 		  b->refcnt--;
 		  BV (clib_bihash_unlock_bucket) (b);
 		  BV (clib_bihash_increment_stat) (h, BIHASH_STAT_del, 1);
+		  BV (clib_bihash_count_elts) (h, 0 /* is_add */ );
 		  return (0);
 		}
 	      else		/* yes, free it */
@@ -643,6 +1307,7 @@ static inline int BV (clib_bihash_add_del_inline)
 		  BV (clib_bihash_alloc_unlock) (h);
 		  BV (clib_bihash_increment_stat) (h, BIHASH_STAT_del_free,
 						   1);
+		  BV (clib_bihash_count_elts) (h, 0 /* is_add */ );
 		  return (0);
 		}
 	    }
@@ -669,7 +1334,7 @@ static inline int BV (clib_bihash_add_del_inline)
   BV (clib_bihash_increment_stat) (h, BIHASH_STAT_splits, 1);
 
   new_v = BV (split_and_rehash) (h, working_copy, old_log2_pages,
-				 new_log2_pages);
+				 new_log2_pages, log2_nbuckets, 0, 0);
   if (new_v == 0)
     {
     try_resplit:
@@ -677,7 +1342,7 @@ static inline int BV (clib_bihash_add_del_inline)
       new_log2_pages++;
       /* Try re-splitting. If that fails, fall back to linear search */
       new_v = BV (split_and_rehash) (h, working_copy, old_log2_pages,
-				     new_log2_pages);
+				     new_log2_pages, log2_nbuckets, 0, 0);
       if (new_v == 0)
 	{
 	mark_linear:
@@ -685,7 +1350,7 @@ static inline int BV (clib_bihash_add_del_inline)
 	  /* pinned collisions, use linear search */
 	  new_v =
 	    BV (split_and_rehash_linear) (h, working_copy, old_log2_pages,
-					  new_log2_pages);
+					  new_log2_pages, 0, 0);
 	  mark_bucket_linear = 1;
 	  BV (clib_bihash_increment_stat) (h, BIHASH_STAT_linear, 1);
 	}
@@ -700,7 +1365,7 @@ static inline int BV (clib_bihash_add_del_inline)
   limit = BIHASH_KVP_PER_PAGE;
   if (mark_bucket_linear)
     limit <<= new_log2_pages;
-  new_hash >>= h->log2_nbuckets;
+  new_hash >>= log2_nbuckets;
   new_hash &= (1 << new_log2_pages) - 1;
   new_v += mark_bucket_linear ? 0 : new_hash;
 
@@ -737,6 +1402,7 @@ expand_ok:
   v = BV (clib_bihash_get_value) (h, h->saved_bucket.offset);
   BV (value_free) (h, v, h->saved_bucket.log2_pages);
   BV (clib_bihash_alloc_unlock) (h);
+  BV (clib_bihash_count_elts) (h, 1 /* is_add */ );
   return (0);
 }
 
@@ -758,48 +1424,83 @@ int BV (clib_bihash_search)
    BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
 {
   u64 hash;
-  u32 bucket_index;
-  BVT (clib_bihash_value) * v;
-  BVT (clib_bihash_bucket) * b;
-  int i, limit;
 
   ASSERT (valuep);
 
-  if (PREDICT_FALSE (alloc_arena (h) == 0))
-    return -1;
-
   hash = BV (clib_bihash_hash) (search_key);
 
-  bucket_index = hash & (h->nbuckets - 1);
-  b = &h->buckets[bucket_index];
+  return BV (clib_bihash_search_inline_2_with_hash) (h, hash, search_key,
+						     valuep);
+}
 
-  if (BV (clib_bihash_bucket_is_empty) (b))
-    return -1;
+/*
+ * Lookup slow path while the bucket array is being doubled. The old
+ * bucket is searched before the new ones: migration fills the new
+ * buckets before emptying the old one, so an entry is always in at
+ * least one of the places we look. The resize parameters are read as
+ * a seqlock, and unless a resize started or completed meanwhile, in
+ * which case we look again: what we found, or did not, may come from
+ * recycled pages.
+ */
+int BV (clib_bihash_search_resizing)
+  (BVT (clib_bihash) * h, u64 hash,
+   BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
+{
+  BVT (clib_bihash_bucket) * old_buckets, *b;
+  u32 log2_nbuckets, old_nbuckets, old_log2_nbuckets, resize_seq;
+  int rv;
 
-  if (PREDICT_FALSE (b->lock))
+  while (1)
     {
-      volatile BVT (clib_bihash_bucket) * bv = b;
-      while (bv->lock)
-	CLIB_PAUSE ();
-    }
+      resize_seq = clib_atomic_load_acq_n (&h->resize_seq);
+      /* Size, then old array: a new size means the old array is set */
+      log2_nbuckets = clib_atomic_load_acq_n (&h->log2_nbuckets);
+      old_buckets = clib_atomic_load_acq_n (&h->old_buckets);
+      old_nbuckets = clib_atomic_load_acq_n (&h->old_nbuckets);
+      old_log2_nbuckets = clib_atomic_load_acq_n (&h->old_log2_nbuckets);
+      __atomic_thread_fence (__ATOMIC_ACQUIRE);
+      if (clib_atomic_load_acq_n (&h->resize_seq) != resize_seq)
+	continue;
 
-  hash >>= h->log2_nbuckets;
+      /*
+       * Resize starting, and neither array published yet? Nothing was
+       * migrated, but we can't tell where the old array is
+       */
+      if (old_buckets == 0 && (resize_seq & 1) &&
+	  log2_nbuckets != old_log2_nbuckets + 1)
+	{
+	  CLIB_PAUSE ();
+	  continue;
+	}
 
-  v = BV (clib_bihash_get_value) (h, b->offset);
-  limit = BIHASH_KVP_PER_PAGE;
-  v += (b->linear_search == 0) ? hash & ((1 << b->log2_pages) - 1) : 0;
-  if (PREDICT_FALSE (b->linear_search))
-    limit <<= b->log2_pages;
+      rv = -1;
+      if (old_buckets)
+	{
+	  b = old_buckets + (hash & (old_nbuckets - 1));
+	  rv = BV (clib_bihash_search_bucket)
+	    (h, b, hash >> old_log2_nbuckets, search_key, valuep);
+
+	  /*
+	   * Migration frees the pages only after emptying the bucket,
+	   * a hit is good if the bucket is still there
+	   */
+	  CLIB_MEMORY_BARRIER ();
+	  if (rv == 0 && BV (clib_bihash_bucket_is_empty) (b))
+	    rv = -1;
+	}
 
-  for (i = 0; i < limit; i++)
-    {
-      if (BV (clib_bihash_key_compare) (v->kvp[i].key, search_key->key))
+      if (rv)
 	{
-	  *valuep = v->kvp[i];
-	  return 0;
+	  b = BV (clib_bihash_get_bucket) (h, hash, &log2_nbuckets);
+	  rv = BV (clib_bihash_search_bucket) (h, b, hash >> log2_nbuckets,
+					       search_key, valuep);
 	}
+
+      /* Seqlock read, the bucket loads must not move past the check */
+      __atomic_thread_fence (__ATOMIC_ACQUIRE);
+      if (clib_atomic_load_acq_n (&h->resize_seq) == resize_seq)
+	return rv;
     }
-  return -1;
 }
 
 u8 *BV (format_bihash) (u8 * s, va_list * args)
@@ -813,15 +1514,20 @@ u8 *BV (format_bihash) (u8 * s, va_list * args)
   u64 active_buckets = 0;
   u64 linear_buckets = 0;
   u64 used_bytes;
+  u32 n_old_buckets;
 
   s = format (s, "Hash table %s\n", h->name ? h->name : (u8 *) "(unnamed)");
 
   if (PREDICT_FALSE (alloc_arena (h) == 0))
     return format (s, "[empty, uninitialized]");
 
-  for (i = 0; i < h->nbuckets; i++)
+  /* While resizing, walk the not yet migrated buckets too */
+  n_old_buckets = h->old_buckets ? h->old_nbuckets : 0;
+
+  for (i = 0; i < h->nbuckets + n_old_buckets; i++)
     {
-      b = &h->buckets[i];
+      b = (i < n_old_buckets ? &h->old_buckets[i] :
+	   &h->buckets[i - n_old_buckets]);
       if (BV (clib_bihash_bucket_is_empty) (b))
 	{
 	  if (verbose > 1)
@@ -895,6 +1601,9 @@ u8 *BV (format_bihash) (u8 * s, va_list * args)
     }
 
   s = format (s, "    %lld linear search buckets\n", linear_buckets);
+  if (n_old_buckets)
+    s = format (s, "    resizing from %u to %u buckets, %u migrated\n",
+		h->old_nbuckets, h->nbuckets, h->resize_n_done);
   used_bytes = alloc_arena_next (h);
   s = format (s,
 	      "    arena: base %llx, next %llx\n"
@@ -912,13 +1621,21 @@ void BV (clib_bihash_foreach_key_value_pair)
   int i, j, k;
   BVT (clib_bihash_bucket) * b;
   BVT (clib_bihash_value) * v;
+  u32 n_old_buckets;
 
   if (PREDICT_FALSE (alloc_arena (h) == 0))
     return;
 
-  for (i = 0; i < h->nbuckets; i++)
+  /*
+   * While resizing, walk the not yet migrated buckets first. Entries
+   * migrated during the walk may be visited twice, but not missed.
+   */
+  n_old_buckets = h->old_buckets ? h->old_nbuckets : 0;
+
+  for (i = 0; i < h->nbuckets + n_old_buckets; i++)
     {
-      b = &h->buckets[i];
+      b = (i < n_old_buckets ? &h->old_buckets[i] :
+	   &h->buckets[i - n_old_buckets]);
       if (BV (clib_bihash_bucket_is_empty) (b))
 	continue;
 
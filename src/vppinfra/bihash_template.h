@@ -28,6 +28,13 @@
 #include <vppinfra/pool.h>
 #include <vppinfra/cache.h>
 #include <vppinfra/lock.h>
+#include <vppinfra/atomics.h>
+#include <vppinfra/bihash_resize.h>
+#include <vppinfra/bitmap.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
 
 #ifndef BIHASH_TYPE
 #error BIHASH_TYPE not defined
@@ -36,7 +43,6 @@
 #ifdef BIHASH_32_64_SVM
 #undef HAVE_MEMFD_CREATE
 #include <vppinfra/linux/syscall.h>
-#include <fcntl.h>
 #define F_LINUX_SPECIFIC_BASE 1024
 #define F_ADD_SEALS (F_LINUX_SPECIFIC_BASE + 9)
 #define F_SEAL_SHRINK (2)
@@ -52,6 +58,9 @@
 #define __bvt(a,b) _bvt(a,b)
 #define BVT(a) __bvt(a,BIHASH_TYPE)
 
+#define _bvstr(a) #a
+#define __bvstr(a) _bvstr(a)
+
 #define _bvs(a,b) struct a##b
 #define __bvs(a,b) _bvs(a,b)
 #define BVS(a) __bvs(a,BIHASH_TYPE)
@@ -117,6 +126,48 @@ typedef CLIB_PACKED (struct {
 
 STATIC_ASSERT_SIZEOF (BVT (clib_bihash_shared_header), 8 * sizeof (u64));
 
+#ifndef included_clib_bihash_file_header
+#define included_clib_bihash_file_header
+
+#define CLIB_BIHASH_FILE_MAGIC 0x6873616869627076ULL	/* "vpbihash" */
+#define CLIB_BIHASH_FILE_VERSION 2
+#define CLIB_BIHASH_FILE_N_FREELISTS 32
+#define CLIB_BIHASH_FILE_N_WORKING_COPIES 64
+
+/*
+ * Header at the start of a file backed table, see clib_bihash_init_file.
+ * Everything else in the file is addressed by offset from the header,
+ * so the table can be mapped anywhere by the next process.
+ */
+typedef struct
+{
+  u64 magic;
+  u32 version;
+
+  /* Table layout, must match on attach */
+  u32 kvp_size;
+  u32 kvp_per_page;
+  u32 nbuckets;
+  u64 memory_size;
+  char type[16];
+
+  /* Arena state, kept current as pages are allocated and freed */
+  u64 buckets_offset;
+  u64 alloc_arena_next;
+  u64 freelists[CLIB_BIHASH_FILE_N_FREELISTS];
+  u64 n_elts;
+
+  /* Per-thread working copies, reused by the next process */
+  u64 working_copies[CLIB_BIHASH_FILE_N_WORKING_COPIES];
+  u8 working_copy_lengths[CLIB_BIHASH_FILE_N_WORKING_COPIES];
+
+  /* Set while mapped, cleared by clib_bihash_free */
+  volatile u32 in_use;
+  u32 n_attach;
+} clib_bihash_file_header_t;
+
+#endif /* included_clib_bihash_file_header */
+
 typedef
 BVS (clib_bihash)
 {
@@ -134,11 +185,33 @@ BVS (clib_bihash)
 
   u64 *freelists;
 
+  /*
+   * Online resize state. While old_buckets is set, the bucket array
+   * is being doubled: entries not yet migrated live in old_buckets.
+   * Readers search both arrays, writers migrate the old bucket
+   * they hash to before touching the new one.
+   */
+  BVT (clib_bihash_bucket) * old_buckets;
+  u32 old_nbuckets;
+  u32 old_log2_nbuckets;
+  u32 resize_cursor;
+  u32 resize_n_done;
+  /* Bumped when a resize starts and when it completes, odd while resizing */
+  volatile u32 resize_seq;
+
+  /* Grow automatically once the table holds more than nbuckets pages */
+  u8 auto_grow;
+  u64 n_elts;
+
 #if BIHASH_32_64_SVM
   BVT (clib_bihash_shared_header) * sh;
   int memfd;
 #else
   BVT (clib_bihash_shared_header) sh;
+
+  /* File backed tables only, see clib_bihash_init_file */
+  clib_bihash_file_header_t *file_header;
+  int file_fd;
 #endif
 
   u64 alloc_arena;		/* Base of the allocation arena */
@@ -168,6 +241,7 @@ typedef struct
   format_function_t *fmt_fn;
   u8 instantiate_immediately;
   u8 dont_add_to_all_bihash_list;
+  u8 auto_grow;
 } BVT (clib_bihash_init2_args);
 
 extern void **clib_all_bihashes;
@@ -309,6 +383,9 @@ void BV (clib_bihash_master_init_svm)
   (BVT (clib_bihash) * h, char *name, u32 nbuckets, u64 memory_size);
 void BV (clib_bihash_slave_init_svm)
   (BVT (clib_bihash) * h, char *name, int fd);
+#else
+clib_error_t *BV (clib_bihash_init_file) (BVT (clib_bihash_init2_args) * a,
+					  char *path, int *attached);
 #endif
 
 void BV (clib_bihash_set_kvp_format_fn) (BVT (clib_bihash) * h,
@@ -327,6 +404,14 @@ int BV (clib_bihash_add_or_overwrite_stale) (BVT (clib_bihash) * h,
 int BV (clib_bihash_search) (BVT (clib_bihash) * h,
 			     BVT (clib_bihash_kv) * search_v,
 			     BVT (clib_bihash_kv) * return_v);
+int BV (clib_bihash_search_resizing) (BVT (clib_bihash) * h, u64 hash,
+				      BVT (clib_bihash_kv) * search_v,
+				      BVT (clib_bihash_kv) * return_v);
+
+int BV (clib_bihash_resize_start) (BVT (clib_bihash) * h);
+int BV (clib_bihash_resize_step) (BVT (clib_bihash) * h, u32 n_buckets);
+int BV (clib_bihash_resize_needed) (BVT (clib_bihash) * h);
+int BV (clib_bihash_resize_work) (void *h, u32 n_buckets);
 
 #define BIHASH_WALK_STOP 0
 #define BIHASH_WALK_CONTINUE 1
@@ -345,19 +430,28 @@ format_function_t BV (format_bihash);
 format_function_t BV (format_bihash_kvp);
 format_function_t BV (format_bihash_lru);
 
-static inline int BV (clib_bihash_search_inline_with_hash)
-  (BVT (clib_bihash) * h, u64 hash, BVT (clib_bihash_kv) * key_result)
+/**
+ * Return the bucket for a hash, and the log2 of the size of the
+ * bucket array it belongs to. The size is loaded before the array:
+ * a resize publishes the (larger) new array before its size, so the
+ * bucket index is always within bounds.
+ */
+static inline BVT (clib_bihash_bucket) *
+BV (clib_bihash_get_bucket) (BVT (clib_bihash) * h, u64 hash,
+			     u32 * log2_nbuckets)
 {
-  u32 bucket_index;
-  BVT (clib_bihash_value) * v;
-  BVT (clib_bihash_bucket) * b;
-  int i, limit;
+  u32 log2 = clib_atomic_load_acq_n (&h->log2_nbuckets);
 
-  if (PREDICT_FALSE (alloc_arena (h) == 0))
-    return -1;
+  *log2_nbuckets = log2;
+  return h->buckets + (hash & ((1ULL << log2) - 1));
+}
 
-  bucket_index = hash & (h->nbuckets - 1);
-  b = &h->buckets[bucket_index];
+static inline int BV (clib_bihash_search_bucket)
+  (BVT (clib_bihash) * h, BVT (clib_bihash_bucket) * b, u64 hash,
+   BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
+{
+  BVT (clib_bihash_value) * v;
+  int i, limit;
 
   if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (b)))
     return -1;
@@ -369,8 +463,6 @@ static inline int BV (clib_bihash_search_inline_with_hash)
 	CLIB_PAUSE ();
     }
 
-  hash >>= h->log2_nbuckets;
-
   v = BV (clib_bihash_get_value) (h, b->offset);
 
   /* If the bucket has unresolvable collisions, use linear search */
@@ -381,15 +473,58 @@ static inline int BV (clib_bihash_search_inline_with_hash)
 
   for (i = 0; i < limit; i++)
     {
-      if (BV (clib_bihash_key_compare) (v->kvp[i].key, key_result->key))
+      if (BV (clib_bihash_key_compare) (v->kvp[i].key, search_key->key))
 	{
-	  *key_result = v->kvp[i];
+	  *valuep = v->kvp[i];
 	  return 0;
 	}
     }
   return -1;
 }
 
+static inline int BV (clib_bihash_search_inline_2_with_hash)
+  (BVT (clib_bihash) * h,
+   u64 hash, BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
+{
+  BVT (clib_bihash_bucket) * b;
+  u32 log2_nbuckets, resize_seq;
+
+  ASSERT (valuep);
+
+  if (PREDICT_FALSE (alloc_arena (h) == 0))
+    return -1;
+
+  resize_seq = clib_atomic_load_acq_n (&h->resize_seq);
+  b = BV (clib_bihash_get_bucket) (h, hash, &log2_nbuckets);
+
+  if (PREDICT_TRUE (BV (clib_bihash_search_bucket)
+		    (h, b, hash >> log2_nbuckets, search_key, valuep) == 0))
+    {
+      /*
+       * Migration recycles the pages of the buckets it moves, don't
+       * trust a hit made while a resize was in progress
+       */
+      __atomic_thread_fence (__ATOMIC_ACQUIRE);
+      if (PREDICT_TRUE (h->resize_seq == resize_seq && !(resize_seq & 1)))
+	return 0;
+      return BV (clib_bihash_search_resizing) (h, hash, search_key, valuep);
+    }
+
+  /* Not found, but it may not have been migrated yet */
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  if (PREDICT_FALSE (h->resize_seq != resize_seq || (resize_seq & 1)))
+    return BV (clib_bihash_search_resizing) (h, hash, search_key, valuep);
+
+  return -1;
+}
+
+static inline int BV (clib_bihash_search_inline_with_hash)
+  (BVT (clib_bihash) * h, u64 hash, BVT (clib_bihash_kv) * key_result)
+{
+  return BV (clib_bihash_search_inline_2_with_hash) (h, hash, key_result,
+						     key_result);
+}
+
 static inline int BV (clib_bihash_search_inline)
   (BVT (clib_bihash) * h, BVT (clib_bihash_kv) * key_result)
 {
@@ -403,11 +538,10 @@ static inline int BV (clib_bihash_search_inline)
 static inline void BV (clib_bihash_prefetch_bucket)
   (BVT (clib_bihash) * h, u64 hash)
 {
-  u32 bucket_index;
   BVT (clib_bihash_bucket) * b;
+  u32 log2_nbuckets;
 
-  bucket_index = hash & (h->nbuckets - 1);
-  b = &h->buckets[bucket_index];
+  b = BV (clib_bihash_get_bucket) (h, hash, &log2_nbuckets);
 
   CLIB_PREFETCH (b, CLIB_CACHE_LINE_BYTES, READ);
 }
@@ -415,20 +549,19 @@ static inline void BV (clib_bihash_prefetch_bucket)
 static inline void BV (clib_bihash_prefetch_data)
   (BVT (clib_bihash) * h, u64 hash)
 {
-  u32 bucket_index;
   BVT (clib_bihash_value) * v;
   BVT (clib_bihash_bucket) * b;
+  u32 log2_nbuckets;
 
   if (PREDICT_FALSE (alloc_arena (h) == 0))
     return;
 
-  bucket_index = hash & (h->nbuckets - 1);
-  b = &h->buckets[bucket_index];
+  b = BV (clib_bihash_get_bucket) (h, hash, &log2_nbuckets);
 
   if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (b)))
     return;
 
-  hash >>= h->log2_nbuckets;
+  hash >>= log2_nbuckets;
   v = BV (clib_bihash_get_value) (h, b->offset);
 
   v += (b->linear_search == 0) ? hash & ((1 << b->log2_pages) - 1) : 0;
@@ -436,65 +569,125 @@ static inline void BV (clib_bihash_prefetch_data)
   CLIB_PREFETCH (v, CLIB_CACHE_LINE_BYTES, READ);
 }
 
-static inline int BV (clib_bihash_search_inline_2_with_hash)
+static inline int BV (clib_bihash_search_inline_2)
   (BVT (clib_bihash) * h,
-   u64 hash, BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
+   BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
 {
-  u32 bucket_index;
-  BVT (clib_bihash_value) * v;
-  BVT (clib_bihash_bucket) * b;
-  int i, limit;
+  u64 hash;
 
-  ASSERT (valuep);
+  hash = BV (clib_bihash_hash) (search_key);
 
-  if (PREDICT_FALSE (alloc_arena (h) == 0))
-    return -1;
+  return BV (clib_bihash_search_inline_2_with_hash) (h, hash, search_key,
+						     valuep);
+}
 
-  bucket_index = hash & (h->nbuckets - 1);
-  b = &h->buckets[bucket_index];
 
-  if (PREDICT_FALSE (BV (clib_bihash_bucket_is_empty) (b)))
-    return -1;
+/**
+ * Match a key against the BIHASH_KVP_PER_PAGE pairs of a page,
+ * returns the bitmap of the matching pairs. Key types provide a
+ * vectorized version by defining BIHASH_HAVE_PAGE_MATCH.
+ */
+static inline u32 BV (clib_bihash_search_page)
+  (BVT (clib_bihash_value) * v, BVT (clib_bihash_kv) * search_key)
+{
+#ifdef BIHASH_HAVE_PAGE_MATCH
+  return BV (clib_bihash_page_match) (v->kvp, search_key);
+#else
+  u32 i, m = 0;
 
-  if (PREDICT_FALSE (b->lock))
+  for (i = 0; i < BIHASH_KVP_PER_PAGE; i++)
+    m |= BV (clib_bihash_key_compare) (v->kvp[i].key, search_key->key) << i;
+  return m;
+#endif
+}
+
+#define BIHASH_SEARCH_MULTI_MAX 16
+
+/**
+ * Search for up to BIHASH_SEARCH_MULTI_MAX keys at once, given their
+ * hashes. The lookups are pipelined: all the buckets are prefetched,
+ * then all the pages, before the keys are compared a page at a time.
+ * Keys whose bucket is busy, uses linear search, or which raced with
+ * a resize, are looked up one by one.
+ *
+ * @return bitmap of the keys found, for which valuep[i] is filled in
+ */
+static inline u32 BV (clib_bihash_search_multi)
+  (BVT (clib_bihash) * h, u64 * hashes, BVT (clib_bihash_kv) * search_keys,
+   BVT (clib_bihash_kv) * valuep, u32 n_keys)
+{
+  BVT (clib_bihash_bucket) * buckets, *b[BIHASH_SEARCH_MULTI_MAX], tmp_b;
+  BVT (clib_bihash_value) * v[BIHASH_SEARCH_MULTI_MAX];
+  u32 log2_nbuckets, resize_seq, i, m, found = 0, slow = 0;
+
+  ASSERT (n_keys <= BIHASH_SEARCH_MULTI_MAX);
+
+  if (PREDICT_FALSE (alloc_arena (h) == 0))
+    return 0;
+
+  resize_seq = clib_atomic_load_acq_n (&h->resize_seq);
+  /* Size before array, see clib_bihash_get_bucket */
+  log2_nbuckets = clib_atomic_load_acq_n (&h->log2_nbuckets);
+  buckets = h->buckets;
+
+  for (i = 0; i < n_keys; i++)
     {
-      volatile BVT (clib_bihash_bucket) * bv = b;
-      while (bv->lock)
-	CLIB_PAUSE ();
+      b[i] = buckets + (hashes[i] & ((1ULL << log2_nbuckets) - 1));
+      CLIB_PREFETCH (b[i], sizeof (b[i][0]), READ);
     }
 
-  hash >>= h->log2_nbuckets;
-  v = BV (clib_bihash_get_value) (h, b->offset);
+  for (i = 0; i < n_keys; i++)
+    {
+      tmp_b.as_u64 = b[i]->as_u64;
+      v[i] = 0;
 
-  /* If the bucket has unresolvable collisions, use linear search */
-  limit = BIHASH_KVP_PER_PAGE;
-  v += (b->linear_search == 0) ? hash & ((1 << b->log2_pages) - 1) : 0;
-  if (PREDICT_FALSE (b->linear_search))
-    limit <<= b->log2_pages;
+      if (PREDICT_FALSE (tmp_b.lock || tmp_b.linear_search))
+	{
+	  slow |= 1 << i;
+	  continue;
+	}
+      if (BV (clib_bihash_bucket_is_empty) (&tmp_b))
+	continue;
 
-  for (i = 0; i < limit; i++)
+      v[i] = BV (clib_bihash_get_value) (h, tmp_b.offset);
+      v[i] += (hashes[i] >> log2_nbuckets) & ((1 << tmp_b.log2_pages) - 1);
+      CLIB_PREFETCH (v[i], sizeof (v[i][0]), READ);
+    }
+
+  for (i = 0; i < n_keys; i++)
     {
-      if (BV (clib_bihash_key_compare) (v->kvp[i].key, search_key->key))
+      if (v[i] == 0)
+	continue;
+
+      m = BV (clib_bihash_search_page) (v[i], &search_keys[i]);
+      if (m)
 	{
-	  *valuep = v->kvp[i];
-	  return 0;
+	  valuep[i] = v[i]->kvp[count_trailing_zeros (m)];
+	  found |= 1 << i;
 	}
     }
-  return -1;
-}
 
-static inline int BV (clib_bihash_search_inline_2)
-  (BVT (clib_bihash) * h,
-   BVT (clib_bihash_kv) * search_key, BVT (clib_bihash_kv) * valuep)
-{
-  u64 hash;
+  /* Don't trust what was (not) found while resizing */
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  if (PREDICT_FALSE (h->resize_seq != resize_seq || (resize_seq & 1)))
+    {
+      slow = pow2_mask (n_keys);
+      found = 0;
+    }
 
-  hash = BV (clib_bihash_hash) (search_key);
+  while (PREDICT_FALSE (slow))
+    {
+      i = count_trailing_zeros (slow);
+      slow &= slow - 1;
+      if (BV (clib_bihash_search_inline_2_with_hash)
+	  (h, hashes[i], &search_keys[i], &valuep[i]) == 0)
+	found |= 1 << i;
+    }
 
-  return BV (clib_bihash_search_inline_2_with_hash) (h, hash, search_key,
-						     valuep);
+  return found;
 }
 
+#undef BIHASH_HAVE_PAGE_MATCH
 
 #endif /* __included_bihash_template_h__ */
 
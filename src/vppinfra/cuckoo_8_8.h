@@ -27,6 +27,8 @@
 #include <vppinfra/format.h>
 #include <vppinfra/pool.h>
 #include <vppinfra/xxhash.h>
+#include <vppinfra/vector.h>
+#include <vppinfra/kv_match.h>
 #include <vppinfra/cuckoo_debug.h>
 #include <vppinfra/cuckoo_common.h>
 
@@ -108,10 +110,21 @@ clib_cuckoo_key_compare_8_8 (u64 a, u64 b)
   return a == b;
 }
 
-#if 0
+/** Match a key against the elements of a bucket
+    @param elts - the first (key,value) pair of the bucket
+    @param kvp - the key to look for
+    @return bitmap of the matching (key,value) pairs
+*/
+always_inline u32
+clib_cuckoo_elts_match_8_8 (clib_cuckoo_kv_8_8_t * elts,
+			    clib_cuckoo_kv_8_8_t * kvp)
+{
+  return clib_kv_match4_8_8 ((u64 *) elts, kvp->key);
+}
+
+#define CLIB_CUCKOO_HAVE_BUCKET_MATCH 1
 #undef __included_cuckoo_template_h__
 #include <vppinfra/cuckoo_template.h>
-#endif
 
 #endif /* __included_cuckoo_8_8_h__ */
 
@@ -21,6 +21,12 @@
  */
 
 #include <vppinfra/vec.h>
+
+/* built on its own as part of vppinfra, provide the 8_8 instantiation */
+#ifndef CLIB_CUCKOO_TYPE
+#include <vppinfra/cuckoo_8_8.h>
+#endif
+
 #include <vppinfra/cuckoo_template.h>
 
 int CV (clib_cuckoo_search) (CVT (clib_cuckoo) * h,
@@ -189,6 +195,11 @@ void CV (clib_cuckoo_init) (CVT (clib_cuckoo) * h, const char *name,
 
 void CV (clib_cuckoo_free) (CVT (clib_cuckoo) * h)
 {
+  CV (clib_cuckoo_garbage_collect) (h);
+  vec_free (h->buckets);
+  pool_free (h->paths);
+  vec_free (h->bfs_search_queue);
+  clib_spinlock_free (&h->writer_lock);
   clib_memset (h, 0, sizeof (*h));
 }
 
@@ -202,6 +213,8 @@ CV (clib_cuckoo_bucket_version_bump_and_lock) (CVT (clib_cuckoo_bucket) * b)
   ASSERT (0 == writer_flag);
   aux = clib_cuckoo_bucket_aux_pack (version + 1, use_count, 1);
   b->aux = aux;
+  /* readers must see the writer flag before any of the element updates */
+  clib_atomic_fence_rel ();
   return aux;
 }
 
@@ -213,7 +226,7 @@ static void CV (clib_cuckoo_bucket_unlock) (CVT (clib_cuckoo_bucket) * b,
   u8 writer_flag = clib_cuckoo_bucket_aux_get_writer_flag (aux);
   ASSERT (1 == writer_flag);
   aux = clib_cuckoo_bucket_aux_pack (version, use_count, 0);
-  b->aux = aux;
+  clib_atomic_store_rel_n (&b->aux, aux);
 }
 
 #define CLIB_CUCKOO_DEBUG_PATH (1)
@@ -318,8 +331,8 @@ CV (clib_cuckoo_bucket_find_empty) (CVT (clib_cuckoo_bucket) * bucket)
  * the arrays must be able to contain CLIB_CUCKOO_BFS_MAX_PATH_LENGTH elements
  */
 static void
-clib_cuckoo_path_walk (CVT (clib_cuckoo) * h, uword path_idx,
-		       uword * buckets, uword * offsets)
+CV (clib_cuckoo_path_walk) (CVT (clib_cuckoo) * h, uword path_idx,
+			    uword * buckets, uword * offsets)
 {
   clib_cuckoo_path_t *path = pool_elt_at_index (h->paths, path_idx);
   ASSERT (path->length > 0);
@@ -352,7 +365,7 @@ static u8 *CV (format_cuckoo_path) (u8 * s, va_list * args)
   clib_cuckoo_path_t *p = pool_elt_at_index (h->paths, path_idx);
   uword buckets[CLIB_CUCKOO_BFS_MAX_PATH_LENGTH];
   uword offsets[CLIB_CUCKOO_BFS_MAX_PATH_LENGTH];
-  clib_cuckoo_path_walk (h, path_idx, buckets, offsets);
+  CV (clib_cuckoo_path_walk) (h, path_idx, buckets, offsets);
   s = format (s, "length %u: ", p->length);
   for (uword i = p->length - 1; i > 0; --i)
     {
@@ -592,7 +605,7 @@ static int CV (clib_cuckoo_add_slow) (CVT (clib_cuckoo) * h,
     {
       uword buckets[CLIB_CUCKOO_BFS_MAX_PATH_LENGTH];
       uword offsets[CLIB_CUCKOO_BFS_MAX_PATH_LENGTH];
-      clib_cuckoo_path_walk (h, path_idx, buckets, offsets);
+      CV (clib_cuckoo_path_walk) (h, path_idx, buckets, offsets);
       /*
        * walk back the path, moving the free element forward to one of our
        * buckets ...
@@ -790,11 +803,15 @@ static void CV (clib_cuckoo_rehash) (CVT (clib_cuckoo) * h)
 	  new_bucket->aux = aux;
 	}
     }
-  h->buckets = new;
+  clib_atomic_store_rel_n (&h->buckets, new);
 #if CLIB_CUCKOO_DEBUG_COUNTERS
   ++h->rehashes;
 #endif
-  h->garbage_callback (h, h->garbage_ctx);
+  /* without a callback the caller promised there are no concurrent readers */
+  if (h->garbage_callback)
+    h->garbage_callback (h, h->garbage_ctx);
+  else
+    CV (clib_cuckoo_garbage_collect) (h);
 }
 
 static int CV (clib_cuckoo_bucket_search_internal) (CVT (clib_cuckoo) * h,
@@ -876,9 +893,13 @@ restart:
   CLIB_CUCKOO_DEEP_SELF_CHECK (h);
   if (CLIB_CUCKOO_ERROR_SUCCESS != rv)
     {
-    CLIB_CUCKOO_DBG ("Fast insert failed, bucket 1: %wu, bucket 2: %wu\n%U%U", aux.bucket1, aux.bucket2, CV (format_cuckoo_bucket), CV (clib_cuckoo_bucindent: Standaindent: Standard input: 903: Error: Unmatched 'else' rd input: 865: Error:Unmatched 'else' ket_at_index) (h, aux.bucket1),
+      CLIB_CUCKOO_DBG ("Fast insert failed, bucket 1: %wu, "
+		       "bucket 2: %wu\n%U%U",
+		       lookup.bucket1, lookup.bucket2,
+		       CV (format_cuckoo_bucket),
+		       CV (clib_cuckoo_bucket_at_index) (h, lookup.bucket1),
 		       CV (format_cuckoo_bucket),
-		       CV (clib_cuckoo_bucket_at_index) (h, aux.bucket2));
+		       CV (clib_cuckoo_bucket_at_index) (h, lookup.bucket2));
       /* slow path */
       rv = CV (clib_cuckoo_add_slow) (h, kvp, &lookup, reduced_hash);
       CLIB_CUCKOO_DEEP_SELF_CHECK (h);
@@ -35,7 +35,7 @@
 #include <vppinfra/error.h>
 #include <vppinfra/hash.h>
 #include <vppinfra/cache.h>
-#include <vppinfra/cuckoo_8_8.h>
+#include <vppinfra/atomics.h>
 
 #ifndef CLIB_CUCKOO_TYPE
 #error CLIB_CUCKOO_TYPE not defined
@@ -61,6 +61,8 @@ STATIC_ASSERT (CLIB_CUCKOO_KVP_PER_BUCKET ==
 	       (1 << CLIB_CUCKOO_LOG2_KVP_PER_BUCKET),
 	       "CLIB_CUCKOO_KVP_PER_BUCKET != (1 << CLIB_CUCKOO_LOG2_KVP_PER_BUCKET");
 
+#undef CV
+#undef CVT
 #define _cv(a, b) a##b
 #define __cv(a, b) _cv (a, b)
 #define CV(a) __cv (a, CLIB_CUCKOO_TYPE)
@@ -69,6 +71,16 @@ STATIC_ASSERT (CLIB_CUCKOO_KVP_PER_BUCKET ==
 #define __cvt(a, b) _cvt (a, b)
 #define CVT(a) __cvt (a, CLIB_CUCKOO_TYPE)
 
+/*
+ * Everything up to the bucket type is independent of the key/value type and
+ * is shared by all instantiations in a translation unit, which must
+ * therefore agree on the bucket geometry.
+ */
+#ifndef __included_cuckoo_template_common__
+#define __included_cuckoo_template_common__
+#define CLIB_CUCKOO_COMMON_LOG2_KVP_PER_BUCKET CLIB_CUCKOO_LOG2_KVP_PER_BUCKET
+#define CLIB_CUCKOO_COMMON_BFS_MAX_PATH_LENGTH CLIB_CUCKOO_BFS_MAX_PATH_LENGTH
+
 typedef u64 clib_cuckoo_bucket_aux_t;
 
 #define CLIB_CUCKOO_USE_COUNT_BIT_WIDTH (1 + CLIB_CUCKOO_LOG2_KVP_PER_BUCKET)
@@ -152,6 +164,31 @@ typedef struct
   path_data_t data;
 } clib_cuckoo_path_t;
 
+always_inline u8
+clib_cuckoo_reduce_hash (u64 hash)
+{
+  u32 v32 = ((u32) hash) ^ ((u32) (hash >> 32));
+  u16 v16 = ((u16) v32) ^ ((u16) (v32 >> 16));
+  u8 v8 = ((u8) v16) ^ ((u8) (v16 >> 8));
+  return v8;
+}
+
+always_inline u64
+clib_cuckoo_get_other_bucket (u64 nbuckets, u64 bucket, u8 reduced_hash)
+{
+  u64 mask = (nbuckets - 1);
+  return (bucket ^ ((reduced_hash + 1) * 0xc6a4a7935bd1e995)) & mask;
+}
+
+#else /* __included_cuckoo_template_common__ */
+#if CLIB_CUCKOO_COMMON_LOG2_KVP_PER_BUCKET != CLIB_CUCKOO_LOG2_KVP_PER_BUCKET
+#error cuckoo instantiations disagree on CLIB_CUCKOO_LOG2_KVP_PER_BUCKET
+#endif
+#if CLIB_CUCKOO_COMMON_BFS_MAX_PATH_LENGTH != CLIB_CUCKOO_BFS_MAX_PATH_LENGTH
+#error cuckoo instantiations disagree on CLIB_CUCKOO_BFS_MAX_PATH_LENGTH
+#endif
+#endif /* __included_cuckoo_template_common__ */
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -314,21 +351,6 @@ float CV (clib_cuckoo_calc_load) (CVT (clib_cuckoo) * h);
 format_function_t CV (format_cuckoo);
 format_function_t CV (format_cuckoo_kvp);
 
-always_inline u8
-clib_cuckoo_reduce_hash (u64 hash)
-{
-  u32 v32 = ((u32) hash) ^ ((u32) (hash >> 32));
-  u16 v16 = ((u16) v32) ^ ((u16) (v32 >> 16));
-  u8 v8 = ((u8) v16) ^ ((u8) (v16 >> 8));
-  return v8;
-}
-
-always_inline u64
-clib_cuckoo_get_other_bucket (u64 nbuckets, u64 bucket, u8 reduced_hash)
-{
-  u64 mask = (nbuckets - 1);
-  return (bucket ^ ((reduced_hash + 1) * 0xc6a4a7935bd1e995)) & mask;
-}
 
 always_inline clib_cuckoo_lookup_info_t
 CV (clib_cuckoo_calc_lookup) (CVT (clib_cuckoo_bucket) * buckets, u64 hash)
@@ -355,98 +377,129 @@ CV (clib_cuckoo_calc_lookup) (CVT (clib_cuckoo_bucket) * buckets, u64 hash)
 }
 
 /**
- * search for key within bucket
+ * match a key against the used elements of a bucket
+ *
+ * returns a bitmap of matching elements, the per-type header may provide
+ * a vector implementation comparing the key against all elements at once
  */
-always_inline int CV (clib_cuckoo_bucket_search) (CVT (clib_cuckoo_bucket) *
-						  b,
-						  CVT (clib_cuckoo_kv) * kvp,
-						  u8 reduced_hash)
+always_inline u32 CV (clib_cuckoo_bucket_match) (CVT (clib_cuckoo_bucket) *
+						 b,
+						 CVT (clib_cuckoo_kv) * kvp,
+						 u8 reduced_hash,
+						 int use_count)
 {
-  clib_cuckoo_bucket_aux_t bucket_aux;
-  u8 writer_flag;
-  do
-    {
-      bucket_aux = b->aux;
-      writer_flag = clib_cuckoo_bucket_aux_get_writer_flag (bucket_aux);
-    }
-  while (PREDICT_FALSE (writer_flag));	/* loop while writer flag is set */
-
+  u32 match = 0;
+#ifdef CLIB_CUCKOO_HAVE_BUCKET_MATCH
+  match = CV (clib_cuckoo_elts_match) (b->elts, kvp);
+#else
   int i;
-#if CLIB_CUCKOO_OPTIMIZE_USE_COUNT_LIMITS_SEARCH
-  const int use_count = clib_cuckoo_bucket_aux_get_use_count (bucket_aux);
-#endif
   /* *INDENT-OFF* */
   clib_cuckoo_bucket_foreach_idx_unrolled (i, {
-#if CLIB_CUCKOO_OPTIMIZE_USE_COUNT_LIMITS_SEARCH
-    if (i > use_count)
-      {
-        break;
-      }
-#endif
     if (
 #if CLIB_CUCKOO_OPTIMIZE_CMP_REDUCED_HASH
         reduced_hash == b->reduced_hashes[i] &&
 #endif
         0 == memcmp (&kvp->key, &b->elts[i].key, sizeof (kvp->key)))
-      {
-        kvp->value = b->elts[i].value;
-        clib_cuckoo_bucket_aux_t bucket_aux2 = b->aux;
-        if (PREDICT_TRUE (clib_cuckoo_bucket_aux_get_version (bucket_aux) ==
-                          clib_cuckoo_bucket_aux_get_version (bucket_aux2)))
-          {
-            /* yay, fresh data */
-            return CLIB_CUCKOO_ERROR_SUCCESS;
-          }
-        else
-          {
-            /* oops, modification detected */
-            return CLIB_CUCKOO_ERROR_AGAIN;
-          }
-      }
+      match |= 1 << i;
   });
   /* *INDENT-ON* */
-  return CLIB_CUCKOO_ERROR_NOT_FOUND;
+#endif
+#if CLIB_CUCKOO_OPTIMIZE_USE_COUNT_LIMITS_SEARCH
+  match &= pow2_mask (use_count);
+#endif
+  return match;
 }
 
+/**
+ * search for key within bucket
+ *
+ * the bucket version is read before and after the element is copied out,
+ * CLIB_CUCKOO_ERROR_AGAIN is returned if a writer touched the bucket
+ * meanwhile
+ */
+always_inline int CV (clib_cuckoo_bucket_search) (CVT (clib_cuckoo_bucket) *
+						  b,
+						  CVT (clib_cuckoo_kv) * kvp,
+						  u8 reduced_hash)
+{
+  clib_cuckoo_bucket_aux_t bucket_aux;
+  u32 match;
+
+  bucket_aux = clib_atomic_load_acq_n (&b->aux);
+  if (PREDICT_FALSE (clib_cuckoo_bucket_aux_get_writer_flag (bucket_aux)))
+    return CLIB_CUCKOO_ERROR_AGAIN;
+
+  match = CV (clib_cuckoo_bucket_match)
+    (b, kvp, reduced_hash, clib_cuckoo_bucket_aux_get_use_count (bucket_aux));
+  if (match)
+    kvp->value = b->elts[count_trailing_zeros (match)].value;
+
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  if (PREDICT_FALSE (bucket_aux != b->aux))
+    return CLIB_CUCKOO_ERROR_AGAIN;
+
+  return match ? CLIB_CUCKOO_ERROR_SUCCESS : CLIB_CUCKOO_ERROR_NOT_FOUND;
+}
+
+/**
+ * search for key
+ *
+ * readers never take a lock or write to the table: both candidate buckets
+ * are read optimistically and their versions validated afterwards. A
+ * lookup costs two bucket reads unless it races with a writer on one of
+ * these buckets: while a writer flag is set the reader spins until it
+ * clears, and a version change seen afterwards makes it start over
+ */
 always_inline int CV (clib_cuckoo_search_inline) (CVT (clib_cuckoo) * h,
 						  CVT (clib_cuckoo_kv) * kvp)
 {
   clib_cuckoo_lookup_info_t lookup;
-  int rv;
+  clib_cuckoo_bucket_aux_t aux1, aux2;
+  CVT (clib_cuckoo_bucket) * buckets, *b1, *b2;
+  u32 match;
 
   u64 hash = CV (clib_cuckoo_hash) (kvp);
-  CVT (clib_cuckoo_bucket) * buckets;
 again:
-  buckets = h->buckets;
+  buckets = clib_atomic_load_acq_n (&h->buckets);
   lookup = CV (clib_cuckoo_calc_lookup) (buckets, hash);
-  do
-    {
-      rv =
-	CV (clib_cuckoo_bucket_search) (vec_elt_at_index
-					(buckets, lookup.bucket1), kvp,
-					lookup.reduced_hash);
-    }
-  while (PREDICT_FALSE (CLIB_CUCKOO_ERROR_AGAIN == rv));
-  if (CLIB_CUCKOO_ERROR_SUCCESS == rv)
+  b1 = vec_elt_at_index (buckets, lookup.bucket1);
+  b2 = vec_elt_at_index (buckets, lookup.bucket2);
+
+  aux1 = clib_atomic_load_acq_n (&b1->aux);
+  aux2 = clib_atomic_load_acq_n (&b2->aux);
+  if (PREDICT_FALSE (clib_cuckoo_bucket_aux_get_writer_flag (aux1 | aux2)))
     {
-      return CLIB_CUCKOO_ERROR_SUCCESS;
+      CLIB_PAUSE ();
+      goto again;
     }
 
-  rv =
-    CV (clib_cuckoo_bucket_search) (vec_elt_at_index
-				    (buckets, lookup.bucket2), kvp,
-				    lookup.reduced_hash);
-  if (PREDICT_FALSE (CLIB_CUCKOO_ERROR_AGAIN == rv))
+  match = CV (clib_cuckoo_bucket_match)
+    (b1, kvp, lookup.reduced_hash,
+     clib_cuckoo_bucket_aux_get_use_count (aux1));
+  if (match)
+    kvp->value = b1->elts[count_trailing_zeros (match)].value;
+  else
     {
-      /*
-       * change to 2nd bucket could bump the item to 1st bucket and the bucket
-       * indexes might not even be valid anymore - restart the search
-       */
-      goto again;
+      match = CV (clib_cuckoo_bucket_match)
+	(b2, kvp, lookup.reduced_hash,
+	 clib_cuckoo_bucket_aux_get_use_count (aux2));
+      if (match)
+	kvp->value = b2->elts[count_trailing_zeros (match)].value;
     }
-  return rv;
+
+  /*
+   * an element moved from one bucket to the other, or the value changed,
+   * while we were looking - start over
+   */
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  if (PREDICT_FALSE (aux1 != b1->aux || aux2 != b2->aux))
+    goto again;
+
+  return match ? CLIB_CUCKOO_ERROR_SUCCESS : CLIB_CUCKOO_ERROR_NOT_FOUND;
 }
 
+#undef CLIB_CUCKOO_HAVE_BUCKET_MATCH
+
 #endif /* __included_cuckoo_template_h__ */
 
 /** @endcond */
@@ -487,6 +487,32 @@ elog_alloc (elog_main_t * em, u32 n_events)
   /* Leave an empty ievent at end so we can always speculatively write
      and event there (possibly a long form event). */
   vec_resize_aligned (em->event_ring, n_events, CLIB_CACHE_LINE_BYTES);
+
+  if (em->thread_rings)
+    elog_alloc_thread_rings (em, vec_len (em->thread_rings));
+}
+
+/*
+ * Give each thread its own ring of event_ring_size events, so that
+ * logging threads share no cache lines. Rings are merged by time
+ * when events are read. Call before other threads log events.
+ */
+void
+elog_alloc_thread_rings (elog_main_t * em, u32 n_threads)
+{
+  elog_thread_ring_t *r;
+
+  vec_foreach (r, em->thread_rings) vec_free (r->event_ring);
+  vec_free (em->thread_rings);
+
+  if (n_threads == 0)
+    return;
+
+  vec_validate_aligned (em->thread_rings, n_threads - 1,
+			CLIB_CACHE_LINE_BYTES);
+  vec_foreach (r, em->thread_rings)
+    vec_resize_aligned (r->event_ring, em->event_ring_size,
+			CLIB_CACHE_LINE_BYTES);
 }
 
 void
@@ -533,12 +559,95 @@ elog_event_range (elog_main_t * em, uword * lo)
     }
 }
 
+static int elog_cmp (void *a1, void *a2);
+
+/*
+ * Copy the events of a thread ring with index >= *next to es. The
+ * newest event may still be being filled in, unless the writer is
+ * stopped it is left for the next call. Returns the number of events
+ * the writer overwrote before they could be copied.
+ */
+static u64
+elog_thread_ring_read (elog_main_t * em, elog_thread_ring_t * r,
+		       u64 * next, elog_event_t ** es, int include_newest)
+{
+  u64 size = em->event_ring_size;
+  elog_event_t *e;
+  u64 i, lo, hi, n, n_dropped = 0;
+  uword n_before = vec_len (*es);
+
+  n = clib_atomic_load_acq_n (&r->n_total_events);
+  hi = include_newest ? n : n - (n > 0);
+
+  /* The event being written may reuse the slot of n - size */
+  lo = n < *next ? 0 /* ring was reset */ : *next;
+  if (n > size && lo < n - size)
+    {
+      n_dropped = n - size - lo;
+      lo = n - size;
+    }
+
+  for (i = lo; i < hi; i++)
+    {
+      vec_add2 (*es, e, 1);
+      e[0] = r->event_ring[i & (size - 1)];
+    }
+
+  /*
+   * Drop what the writer reached while we were copying. The copies
+   * must complete before the count is re-read, pairs with the fence
+   * in elog_event_data_inline.
+   */
+  clib_atomic_fence_acq ();
+  n = clib_atomic_load_relax_n (&r->n_total_events);
+  if (n > size && lo < n - size && hi > lo)
+    {
+      i = clib_min (n - size - lo, hi - lo);
+      vec_delete (*es, i, n_before);
+      n_dropped += i;
+    }
+
+  *next = clib_max (hi, lo);
+  return n_dropped;
+}
+
+/* The shared ring, as seen by elog_thread_ring_read */
+static void
+elog_shared_ring (elog_main_t * em, elog_thread_ring_t * r)
+{
+  r->n_total_events = em->n_total_events;
+  r->event_ring = em->event_ring;
+}
+
 elog_event_t *
 elog_peek_events (elog_main_t * em)
 {
   elog_event_t *e, *f, *es = 0;
   uword i, j, n;
 
+  if (em->thread_rings)
+    {
+      elog_thread_ring_t *r, shared;
+      u64 next;
+
+      vec_foreach (r, em->thread_rings)
+      {
+	next = 0;
+	elog_thread_ring_read (em, r, &next, &es, 1 /* include_newest */ );
+      }
+
+      /* Events logged before the rings were set up */
+      next = 0;
+      elog_shared_ring (em, &shared);
+      elog_thread_ring_read (em, &shared, &next, &es, 1);
+
+      vec_foreach (e, es)
+	e->time = (e->time_cycles -
+		   em->init_time.cpu) * em->cpu_timer.seconds_per_clock;
+      vec_sort_with_function (es, elog_cmp);
+      return es;
+    }
+
   n = elog_event_range (em, &j);
   for (i = 0; i < n; i++)
     {
@@ -1158,6 +1267,187 @@ unserialize_elog_main (serialize_main_t * m, va_list * va)
   }
 }
 
+static char *elog_export_magic = "elog chunk v0";
+
+static void
+serialize_elog_export_chunk (serialize_main_t * m, va_list * va)
+{
+  elog_main_t *em = va_arg (*va, elog_main_t *);
+  elog_export_t *x = va_arg (*va, elog_export_t *);
+  u32 n_types = vec_len (em->event_types) - x->n_event_types;
+  u32 n_tracks = vec_len (em->tracks) - x->n_tracks;
+  u32 n_bytes = vec_len (em->string_table) - x->n_string_table_bytes;
+  elog_event_t *e;
+
+  serialize_magic (m, elog_export_magic, strlen (elog_export_magic));
+  serialize (m, serialize_elog_time_stamp, &em->init_time);
+
+  /* What the importer must already have, to catch lost chunks */
+  serialize_integer (m, x->n_event_types, sizeof (u32));
+  serialize_integer (m, x->n_tracks, sizeof (u32));
+  serialize_integer (m, x->n_string_table_bytes, sizeof (u32));
+
+  serialize_integer (m, n_types, sizeof (u32));
+  serialize (m, serialize_elog_event_type,
+	     em->event_types + x->n_event_types, n_types);
+  serialize_integer (m, n_tracks, sizeof (u32));
+  serialize (m, serialize_elog_track, em->tracks + x->n_tracks, n_tracks);
+  serialize_integer (m, n_bytes, sizeof (u32));
+  clib_memcpy_fast (serialize_get (m, n_bytes),
+		    em->string_table + x->n_string_table_bytes, n_bytes);
+
+  serialize_integer (m, vec_len (x->events), sizeof (u32));
+  vec_foreach (e, x->events) serialize (m, serialize_elog_event, em, e);
+}
+
+u8 *
+elog_export_chunk (elog_main_t * em, elog_export_t * x, u8 * chunk)
+{
+  serialize_main_t m;
+  elog_thread_ring_t *r, shared;
+  elog_event_t *e;
+  u32 len;
+  u8 *data;
+
+  vec_reset_length (x->events);
+
+  /*
+   * The shared ring goes last, it is in use without thread rings.
+   * Its writers do not publish events in order, so with more than one
+   * an event may be exported before it is filled in.
+   */
+  vec_validate (x->ring_positions, vec_len (em->thread_rings));
+  vec_foreach (r, em->thread_rings)
+    x->n_dropped +=
+    elog_thread_ring_read (em, r, x->ring_positions + (r - em->thread_rings),
+			   &x->events, 0 /* include_newest */ );
+  elog_shared_ring (em, &shared);
+  x->n_dropped += elog_thread_ring_read (em, &shared,
+					 vec_end (x->ring_positions) - 1,
+					 &x->events, 0);
+
+  /* Types, tracks and strings used by the events are registered by now */
+  elog_lock (em);
+
+  if (vec_len (x->events) == 0 &&
+      vec_len (em->event_types) == x->n_event_types &&
+      vec_len (em->tracks) == x->n_tracks &&
+      vec_len (em->string_table) == x->n_string_table_bytes)
+    {
+      elog_unlock (em);
+      return chunk;
+    }
+
+  vec_foreach (e, x->events)
+    e->time = (e->time_cycles -
+	       em->init_time.cpu) * em->cpu_timer.seconds_per_clock;
+  vec_sort_with_function (x->events, elog_cmp);
+
+  serialize_open_vector (&m, 0);
+  serialize (&m, serialize_elog_export_chunk, em, x);
+  data = serialize_close_vector (&m);
+
+  x->n_event_types = vec_len (em->event_types);
+  x->n_tracks = vec_len (em->tracks);
+  x->n_string_table_bytes = vec_len (em->string_table);
+  x->n_events += vec_len (x->events);
+
+  elog_unlock (em);
+
+  /* Chunks are framed by a u32 length, in network byte order */
+  len = clib_host_to_net_u32 (vec_len (data));
+  vec_add (chunk, (u8 *) & len, sizeof (len));
+  vec_append (chunk, data);
+  vec_free (data);
+  return chunk;
+}
+
+static void
+unserialize_elog_export_chunk (serialize_main_t * m, va_list * va)
+{
+  elog_main_t *em = va_arg (*va, elog_main_t *);
+  u32 base[3], n, i;
+  elog_event_t *e;
+  elog_track_t *t;
+
+  unserialize_check_magic (m, elog_export_magic,
+			   strlen (elog_export_magic));
+  unserialize (m, unserialize_elog_time_stamp, &em->init_time);
+
+  unserialize_integer (m, &base[0], sizeof (u32));
+  unserialize_integer (m, &base[1], sizeof (u32));
+  unserialize_integer (m, &base[2], sizeof (u32));
+
+  /* The first chunk brings its own default track */
+  if (base[1] == 0)
+    {
+      vec_foreach (t, em->tracks) vec_free (t->name);
+      vec_reset_length (em->tracks);
+    }
+
+  if (base[0] != vec_len (em->event_types) ||
+      base[1] != vec_len (em->tracks) ||
+      base[2] != vec_len (em->string_table))
+    serialize_error_return (m, "chunk out of sequence");
+
+  unserialize_integer (m, &n, sizeof (u32));
+  vec_resize (em->event_types, n);
+  unserialize (m, unserialize_elog_event_type,
+	       vec_end (em->event_types) - n, n);
+  for (i = base[0]; i < vec_len (em->event_types); i++)
+    new_event_type (em, i);
+
+  unserialize_integer (m, &n, sizeof (u32));
+  vec_resize (em->tracks, n);
+  unserialize (m, unserialize_elog_track, vec_end (em->tracks) - n, n);
+
+  unserialize_integer (m, &n, sizeof (u32));
+  vec_add (em->string_table, unserialize_get (m, n), n);
+
+  unserialize_integer (m, &n, sizeof (u32));
+  vec_add2 (em->events, e, n);
+  for (i = 0; i < n; i++)
+    unserialize (m, unserialize_elog_event, em, e + i);
+}
+
+clib_error_t *
+elog_import_chunks (elog_main_t * em, u8 * data, uword n_bytes)
+{
+  serialize_main_t m;
+  clib_error_t *error;
+  u32 len;
+
+  while (n_bytes >= sizeof (len))
+    {
+      len = clib_net_to_host_u32 (clib_mem_unaligned (data, u32));
+      data += sizeof (len);
+      n_bytes -= sizeof (len);
+
+      /* A partial chunk at the end of a stream still being written */
+      if (len > n_bytes)
+	break;
+
+      unserialize_open_data (&m, data, len);
+      error = unserialize (&m, unserialize_elog_export_chunk, em);
+      if (error)
+	return error;
+      data += len;
+      n_bytes -= len;
+    }
+
+  /* Events of different rings may arrive in different chunks */
+  vec_sort_with_function (em->events, elog_cmp);
+  return 0;
+}
+
+void
+elog_export_free (elog_export_t * x)
+{
+  vec_free (x->ring_positions);
+  vec_free (x->events);
+  clib_memset (x, 0, sizeof (x[0]));
+}
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -55,6 +55,8 @@
 #include <vppinfra/time.h>	/* for clib_cpu_time_now */
 #include <vppinfra/hash.h>
 #include <vppinfra/mhash.h>
+#include <vppinfra/os.h>
+#include <vppinfra/atomics.h>
 
 typedef struct
 {
@@ -129,6 +131,18 @@ typedef struct
   u64 os_nsec;
 } elog_time_stamp_t;
 
+/** Event ring written by a single thread, see elog_alloc_thread_rings */
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /** Events logged by the owning thread, the only writer */
+  u64 n_total_events;
+
+  /** Power of 2 size, same as event_ring_size */
+  elog_event_t *event_ring;
+} elog_thread_ring_t;
+
 typedef struct
 {
   /** Total number of events in buffer. */
@@ -180,8 +194,31 @@ typedef struct
 
   /** Vector of events converted to generic form after collection. */
   elog_event_t *events;
+
+  /** Per-thread rings, indexed by thread index. When set, events
+      go to the ring of the logging thread instead of event_ring. */
+  elog_thread_ring_t *thread_rings;
 } elog_main_t;
 
+/** Streaming export state, see elog_export_chunk */
+typedef struct
+{
+  /** Event types, tracks and string table bytes already exported */
+  u32 n_event_types;
+  u32 n_tracks;
+  u32 n_string_table_bytes;
+
+  /** Events exported, and overwritten in a ring before export */
+  u64 n_events;
+  u64 n_dropped;
+
+  /** Next event to export, per ring */
+  u64 *ring_positions;
+
+  /** Scratch events */
+  elog_event_t *events;
+} elog_export_t;
+
 /** @brief Return number of events in the event-log buffer
     @param em elog_main_t *
     @return number of events in the buffer
@@ -190,7 +227,12 @@ typedef struct
 always_inline uword
 elog_n_events_in_buffer (elog_main_t * em)
 {
-  return clib_min (em->n_total_events, em->event_ring_size);
+  elog_thread_ring_t *r;
+  uword n = clib_min (em->n_total_events, em->event_ring_size);
+
+  vec_foreach (r, em->thread_rings)
+    n += clib_min (r->n_total_events, em->event_ring_size);
+  return n;
 }
 
 /** @brief Return number of events which can fit in the event buffer
@@ -200,7 +242,7 @@ elog_n_events_in_buffer (elog_main_t * em)
 always_inline uword
 elog_buffer_capacity (elog_main_t * em)
 {
-  return em->event_ring_size;
+  return em->event_ring_size * (1 + vec_len (em->thread_rings));
 }
 
 /** @brief Reset the event buffer
@@ -209,8 +251,11 @@ elog_buffer_capacity (elog_main_t * em)
 always_inline void
 elog_reset_buffer (elog_main_t * em)
 {
+  elog_thread_ring_t *r;
+
   em->n_total_events = 0;
   em->n_total_events_disable_limit = ~0;
+  vec_foreach (r, em->thread_rings) r->n_total_events = 0;
 }
 
 /** @brief Enable or disable event logging
@@ -228,6 +273,8 @@ elog_enable_disable (elog_main_t * em, int is_enabled)
    This is used as a "debug trigger" when a certain event has occurred.
    Events will be logged both before and after the "event" but the
    event will not be lost as long as N < RING_SIZE.
+   Not supported with per-thread rings, which do not count events
+   globally.
 
    @param em elog_main_t *
    @param n uword number of events before disabling event logging
@@ -313,6 +360,27 @@ elog_event_data_inline (elog_main_t * em,
     }
 
   ASSERT (track_index < vec_len (em->tracks));
+
+  if (em->thread_rings)
+    {
+      elog_thread_ring_t *r;
+      u64 n;
+
+      r = vec_elt_at_index (em->thread_rings, os_get_thread_index ());
+      n = r->n_total_events;
+      e = r->event_ring + (n & (em->event_ring_size - 1));
+
+      /*
+       * The previous event is filled in by now. Publish it, readers
+       * leave the newest event of each ring alone. The new count must
+       * be visible before the slot of event n - size is overwritten,
+       * elog_thread_ring_read re-checks it to drop torn copies.
+       */
+      clib_atomic_store_rel_n (&r->n_total_events, n + 1);
+      clib_atomic_fence_rel ();
+      goto done;
+    }
+
   ASSERT (is_pow2 (vec_len (em->event_ring)));
 
   if (em->lock)
@@ -323,6 +391,7 @@ elog_event_data_inline (elog_main_t * em,
   ei &= em->event_ring_size - 1;
   e = vec_elt_at_index (em->event_ring, ei);
 
+done:
   e->time_cycles = cpu_time;
   e->type = type_index;
   e->track = track_index;
@@ -526,8 +595,40 @@ void unserialize_elog_main (serialize_main_t * m, va_list * va);
 
 void elog_init (elog_main_t * em, u32 n_events);
 void elog_alloc (elog_main_t * em, u32 n_events);
+void elog_alloc_thread_rings (elog_main_t * em, u32 n_threads);
+
+/** @brief export events logged since the previous call
+
+    Appends a chunk to a vector: event types, tracks and strings not
+    yet exported, and the new events of all rings sorted by time,
+    framed by a u32 length in network byte order. Chunks can be
+    appended to a file or handed to another process, and turned back
+    into an event log with elog_import_chunks. Call from one thread
+    at a time, while events are being logged.
+
+    @param em elog_main_t *
+    @param x elog_export_t * export state, zero initialized
+    @param chunk u8 * vector to append to
+    @return chunk, unchanged when there was nothing to export
+*/
+u8 *elog_export_chunk (elog_main_t * em, elog_export_t * x, u8 * chunk);
+
+/** @brief add the events of exported chunks to an event log
+    @param em elog_main_t * initialized with elog_init (em, 0)
+    @param data u8 * one or more chunks from elog_export_chunk, in
+    the order they were exported. A trailing partial chunk is ignored.
+    @param n_bytes uword data size
+    @return error, if a chunk is not valid
+    @note em->events can then be formatted or saved with
+    elog_write_file (em, file, 0)
+*/
+clib_error_t *elog_import_chunks (elog_main_t * em, u8 * data,
+				  uword n_bytes);
+void elog_export_free (elog_export_t * x);
 
 #ifdef CLIB_UNIX
+#include <vppinfra/unix.h>
+
 always_inline clib_error_t *
 elog_write_file (elog_main_t * em, char *clib_file, int flush_ring)
 {
@@ -558,6 +659,23 @@ elog_read_file (elog_main_t * em, char *clib_file)
   return error;
 }
 
+/** @brief read a file of chunks written by elog_export_chunk
+    @param em elog_main_t * initialized with elog_init (em, 0)
+    @param clib_file char * file name
+*/
+always_inline clib_error_t *
+elog_read_export_file (elog_main_t * em, char *clib_file)
+{
+  clib_error_t *error;
+  u8 *data = 0;
+
+  error = clib_file_contents (clib_file, &data);
+  if (!error)
+    error = elog_import_chunks (em, data, vec_len (data));
+  vec_free (data);
+  return error;
+}
+
 #endif /* CLIB_UNIX */
 
 #endif /* included_clib_elog_h */
@@ -434,6 +434,469 @@ format (u8 * s, const char *fmt, ...)
   return s;
 }
 
+/** Parse a format string once, for use with va_format_program,
+    clib_format_capture and clib_format_replay.
+    @param fmt - format string, the program keeps a copy of it
+    @return the program, or 0 if fmt uses a conversion not supported by
+            format or is too long to compile
+*/
+clib_format_program_t *
+clib_format_compile (const char *fmt)
+{
+  clib_format_program_t *p;
+  clib_format_op_t *op, *ops = 0;
+  const u8 *f = (u8 *) fmt, *g = f;
+  uword c, i, width;
+
+  if (strlen (fmt) > 0xffff)
+    return 0;
+
+  while (1)
+    {
+      c = *f;
+      if (c != 0 && c != '%')
+	{
+	  f++;
+	  continue;
+	}
+
+      vec_add2 (ops, op, 1);
+      clib_memset (op, 0, sizeof (op[0]));
+      op->literal_offset = g - (u8 *) fmt;
+      op->literal_length = f - g;
+      op->justify = '+';
+      op->pad_char = ' ';
+
+      if (c == 0)
+	break;
+
+      c = *++f;
+      if (c == '%')
+	{
+	  /* %% => literal % */
+	  op->literal_length++;
+	  g = ++f;
+	  continue;
+	}
+
+      /* Same grammar as do_percent. */
+      switch (c)
+	{
+	case '-':
+	case '+':
+	case '=':
+	  op->justify = c;
+	  c = *++f;
+	  break;
+	}
+
+      for (i = 0; i < 2; i++)
+	{
+	  if (c == '0' && i == 0)
+	    op->pad_char = '0';
+	  if (c == '*')
+	    {
+	      op->width_is_arg[i] = 1;
+	      c = *++f;
+	    }
+	  else
+	    {
+	      width = 0;
+	      while (c >= '0' && c <= '9')
+		{
+		  width = 10 * width + (c - '0');
+		  c = *++f;
+		}
+	      if (width > 0xffff)
+		goto error;
+	      op->width[i] = width;
+	    }
+	  if (c != '.')
+	    break;
+	  c = *++f;
+	}
+
+      switch (c)
+	{
+	case 'w':
+	  op->how_long = 'w';
+	  c = *++f;
+	  break;
+
+	case 'L':
+	case 'l':
+	  op->how_long = c;
+	  c = *++f;
+	  if (c == 'l')
+	    {
+	      op->how_long = 'L';
+	      c = *++f;
+	    }
+	  break;
+	}
+
+      /* A dangling % at the end of fmt prints nothing. */
+      if (c == 0)
+	break;
+
+      if (!strchr ("cpxXudsSvfgeU", c))
+	goto error;
+
+      op->conversion = c;
+      g = ++f;
+    }
+
+  p = clib_mem_alloc (sizeof (p[0]));
+  p->fmt = (char *) format (0, "%s%c", fmt, 0);
+  p->ops = ops;
+  return p;
+
+error:
+  vec_free (ops);
+  return 0;
+}
+
+void
+clib_format_program_free (clib_format_program_t * p)
+{
+  if (!p)
+    return;
+  vec_free (p->fmt);
+  vec_free (p->ops);
+  clib_mem_free (p);
+}
+
+static_always_inline void
+format_op_info (clib_format_op_t * op, format_info_t * fi)
+{
+  fi->justify = op->justify;
+  fi->pad_char = op->pad_char;
+  fi->how_long = op->how_long;
+  fi->width[0] = op->width[0];
+  fi->width[1] = op->width[1];
+}
+
+static_always_inline u64
+format_op_va_number (clib_format_op_t * op, va_list * va)
+{
+  if (op->conversion == 'p')
+    return pointer_to_uword (va_arg (*va, void *));
+  if (op->conversion == 'c')
+    return va_arg (*va, int);
+
+  switch (op->how_long)
+    {
+    case 'L':
+      return va_arg (*va, unsigned long long);
+    case 'l':
+      return va_arg (*va, long);
+    case 'w':
+      return va_arg (*va, word);
+    default:
+      return va_arg (*va, int);
+    }
+}
+
+static_always_inline const u8 *
+format_op_va_bytes (clib_format_op_t * op, format_info_t * fi,
+		    va_list * va, uword * len)
+{
+  u8 *v;
+
+  if (op->conversion == 'v')
+    {
+      v = va_arg (*va, u8 *);
+      *len = vec_len (v);
+    }
+  else
+    {
+      v = va_arg (*va, u8 *);
+      if (!v)
+	{
+	  *len = 5;
+	  return (u8 *) "(nil)";
+	}
+      *len = strlen ((char *) v);
+    }
+
+  if (fi->width[1] != 0)
+    *len = clib_min (*len, fi->width[1]);
+  return v;
+}
+
+/* Output one converted value, as do_percent would. */
+static u8 *
+format_op_emit (u8 * s, clib_format_op_t * op, format_info_t * fi,
+		u64 number, f64 x, const u8 * bytes, uword len)
+{
+  uword i, s_initial_len = vec_len (s);
+  format_integer_options_t o = {
+    .is_signed = 0,
+    .base = 10,
+    .n_bits = BITS (uword),
+    .uppercase_digits = 0,
+  };
+
+  switch (op->conversion)
+    {
+    case 'c':
+      vec_add1 (s, number);
+      break;
+
+    case 'p':
+      vec_add1 (s, '0');
+      vec_add1 (s, 'x');
+      o.n_bits = BITS (uword *);
+      o.base = 16;
+      s = format_integer (s, number, &o);
+      break;
+
+    case 'x':
+    case 'X':
+    case 'u':
+    case 'd':
+      if (op->conversion == 'x' || op->conversion == 'X')
+	o.base = 16;
+      o.is_signed = op->conversion == 'd';
+      o.uppercase_digits = op->conversion == 'X';
+      switch (op->how_long)
+	{
+	case 'L':
+	  o.n_bits = BITS (unsigned long long);
+	  break;
+	case 'l':
+	  o.n_bits = BITS (long);
+	  break;
+	case 'w':
+	  o.n_bits = BITS (uword);
+	  break;
+	default:
+	  o.n_bits = BITS (int);
+	  break;
+	}
+      s = format_integer (s, number, &o);
+      break;
+
+    case 'f':
+    case 'g':
+    case 'e':
+      s = format_float (s, x, fi->width[1], op->conversion);
+      break;
+
+    case 'S':
+      for (i = 0; i < len; i++)
+	vec_add1 (s, bytes[i] == '_' ? ' ' : bytes[i]);
+      break;
+
+    default:
+      /* %s, %v and captured %U */
+      vec_add (s, bytes, len);
+      break;
+    }
+
+  return justify (s, fi, s_initial_len);
+}
+
+/** Format with a compiled program, the equivalent of va_format for the
+    program's format string without parsing it again */
+u8 *
+va_format_program (u8 * s, clib_format_program_t * p, va_list * va)
+{
+  typedef u8 *(user_func_t) (u8 * s, va_list * args);
+  clib_format_op_t *op;
+  format_info_t fi;
+  const u8 *bytes;
+  uword len;
+
+  vec_foreach (op, p->ops)
+  {
+    if (op->literal_length)
+      vec_add (s, p->fmt + op->literal_offset, op->literal_length);
+    if (op->conversion == 0)
+      continue;
+
+    format_op_info (op, &fi);
+    if (op->width_is_arg[0])
+      fi.width[0] = va_arg (*va, int);
+    if (op->width_is_arg[1])
+      fi.width[1] = va_arg (*va, int);
+
+    switch (op->conversion)
+      {
+      case 'U':
+	{
+	  user_func_t *u = va_arg (*va, user_func_t *);
+	  len = vec_len (s);
+	  s = (*u) (s, va);
+	  s = justify (s, &fi, len);
+	}
+	break;
+
+      case 'f':
+      case 'g':
+      case 'e':
+	s = format_op_emit (s, op, &fi, 0, va_arg (*va, double), 0, 0);
+	break;
+
+      case 's':
+      case 'S':
+      case 'v':
+	bytes = format_op_va_bytes (op, &fi, va, &len);
+	s = format_op_emit (s, op, &fi, 0, 0, bytes, len);
+	break;
+
+      default:
+	s = format_op_emit (s, op, &fi, format_op_va_number (op, va), 0, 0,
+			    0);
+	break;
+      }
+  }
+
+  return s;
+}
+
+/** Copy the arguments of a compiled format into a blob, so that
+    formatting can be done later by clib_format_replay. Numbers are
+    stored as is, strings and vectors are copied. %U arguments cannot be
+    deferred, they are formatted right away (starting a new line, as far
+    as format_get_indent is concerned).
+    @param blob - vector to append the arguments to
+    @return the blob
+*/
+u8 *
+clib_format_capture (u8 * blob, clib_format_program_t * p, va_list * va)
+{
+  typedef u8 *(user_func_t) (u8 * s, va_list * args);
+  clib_format_op_t *op;
+  format_info_t fi;
+  const u8 *bytes;
+  uword len;
+  i32 width;
+  u32 n;
+  u64 number;
+  f64 x;
+
+  vec_foreach (op, p->ops)
+  {
+    if (op->conversion == 0)
+      continue;
+
+    format_op_info (op, &fi);
+    if (op->width_is_arg[0])
+      {
+	width = va_arg (*va, int);
+	fi.width[0] = width;
+	vec_add (blob, (u8 *) & width, sizeof (width));
+      }
+    if (op->width_is_arg[1])
+      {
+	width = va_arg (*va, int);
+	fi.width[1] = width;
+	vec_add (blob, (u8 *) & width, sizeof (width));
+      }
+
+    switch (op->conversion)
+      {
+      case 'U':
+	{
+	  user_func_t *u = va_arg (*va, user_func_t *);
+	  u8 *tmp = (*u) (0, va);
+	  n = vec_len (tmp);
+	  vec_add (blob, (u8 *) & n, sizeof (n));
+	  vec_add (blob, tmp, n);
+	  vec_free (tmp);
+	}
+	break;
+
+      case 'f':
+      case 'g':
+      case 'e':
+	x = va_arg (*va, double);
+	vec_add (blob, (u8 *) & x, sizeof (x));
+	break;
+
+      case 's':
+      case 'S':
+      case 'v':
+	bytes = format_op_va_bytes (op, &fi, va, &len);
+	n = len;
+	vec_add (blob, (u8 *) & n, sizeof (n));
+	vec_add (blob, bytes, n);
+	break;
+
+      default:
+	number = format_op_va_number (op, va);
+	vec_add (blob, (u8 *) & number, sizeof (number));
+	break;
+      }
+  }
+
+  return blob;
+}
+
+/** Format arguments captured by clib_format_capture with the same
+    program. Output is the same as va_format with the original
+    arguments. */
+u8 *
+clib_format_replay (u8 * s, clib_format_program_t * p, u8 * blob)
+{
+  clib_format_op_t *op;
+  format_info_t fi;
+  u8 *b = blob;
+  u32 n;
+  u64 number;
+  f64 x;
+
+  vec_foreach (op, p->ops)
+  {
+    if (op->literal_length)
+      vec_add (s, p->fmt + op->literal_offset, op->literal_length);
+    if (op->conversion == 0)
+      continue;
+
+    format_op_info (op, &fi);
+    if (op->width_is_arg[0])
+      {
+	fi.width[0] = clib_mem_unaligned (b, i32);
+	b += sizeof (i32);
+      }
+    if (op->width_is_arg[1])
+      {
+	fi.width[1] = clib_mem_unaligned (b, i32);
+	b += sizeof (i32);
+      }
+
+    switch (op->conversion)
+      {
+      case 'f':
+      case 'g':
+      case 'e':
+	x = clib_mem_unaligned (b, f64);
+	b += sizeof (x);
+	s = format_op_emit (s, op, &fi, 0, x, 0, 0);
+	break;
+
+      case 's':
+      case 'S':
+      case 'v':
+      case 'U':
+	n = clib_mem_unaligned (b, u32);
+	b += sizeof (n);
+	s = format_op_emit (s, op, &fi, 0, 0, b, n);
+	b += n;
+	break;
+
+      default:
+	number = clib_mem_unaligned (b, u64);
+	b += sizeof (number);
+	s = format_op_emit (s, op, &fi, number, 0, 0, 0);
+	break;
+      }
+  }
+
+  ASSERT (b == vec_end (blob));
+  return s;
+}
 word
 va_fformat (FILE * f, char *fmt, va_list * va)
 {
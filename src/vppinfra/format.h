@@ -50,6 +50,46 @@ typedef u8 *(format_function_t) (u8 * s, va_list * args);
 u8 *va_format (u8 * s, const char *format, va_list * args);
 u8 *format (u8 * s, const char *format, ...);
 
+/** One conversion of a precompiled format string, with the literal
+    text which precedes it. */
+typedef struct
+{
+  /** literal text before the conversion, as offset and length in fmt */
+  u16 literal_offset;
+  u16 literal_length;
+
+  /** conversion letter, 0 for literal text only */
+  u8 conversion;
+
+  /** '+', '-' or '=' */
+  u8 justify;
+  u8 pad_char;
+
+  /** 0, 'l', 'L' or 'w' */
+  u8 how_long;
+
+  /** width and precision, taken from the arguments when set */
+  u8 width_is_arg[2];
+  u16 width[2];
+} clib_format_op_t;
+
+/** A format string parsed once, so formatting does not need to
+    interpret it again. Used to format straight from a va_list, or to
+    capture the arguments into a blob which is formatted later. */
+typedef struct
+{
+  /** copy of the format string, so the caller's may go away */
+  char *fmt;
+  clib_format_op_t *ops;
+} clib_format_program_t;
+
+clib_format_program_t *clib_format_compile (const char *fmt);
+void clib_format_program_free (clib_format_program_t * p);
+u8 *va_format_program (u8 * s, clib_format_program_t * p, va_list * va);
+u8 *clib_format_capture (u8 * blob, clib_format_program_t * p,
+			 va_list * va);
+u8 *clib_format_replay (u8 * s, clib_format_program_t * p, u8 * blob);
+
 #ifdef CLIB_UNIX
 
 #include <stdio.h>
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __included_kv_match_h__
+#define __included_kv_match_h__
+
+#include <vppinfra/clib.h>
+#include <vppinfra/vector.h>
+
+/*
+ * Compare a key against 4 consecutive (key,value) pairs of u64 words, as
+ * laid out in a bihash page or a cuckoo bucket. Each returns a bitmap
+ * with bit i set when pair i holds the key.
+ */
+
+/** Match an 8 byte key against 4 (key,value) pairs, i.e. 8 u64s
+    @param kv - the first (key,value) pair
+    @param key - the key to look for
+    @return bitmap of the matching pairs
+*/
+static_always_inline u32
+clib_kv_match4_8_8 (u64 * kv, u64 key)
+{
+#if defined (CLIB_HAVE_VEC512)
+  u32 m = u64x8_is_equal_mask (u64x8_load_unaligned (kv), u64x8_splat (key));
+  m &= 0x55;
+  m = (m | (m >> 1)) & 0x33;
+  return (m | (m >> 2)) & 0xf;
+#elif defined (CLIB_HAVE_VEC256)
+  u64x4 k = u64x4_splat (key);
+  u32 m0 = u64x4_msb_mask ((u64x4) (u64x4_load_unaligned (kv) == k));
+  u32 m1 = u64x4_msb_mask ((u64x4) (u64x4_load_unaligned (kv + 4) == k));
+  return (m0 & 1) | ((m0 >> 1) & 2) | ((m1 & 1) << 2) | ((m1 << 1) & 8);
+#else
+  return ((kv[0] == key) | ((kv[2] == key) << 1) |
+	  ((kv[4] == key) << 2) | ((kv[6] == key) << 3));
+#endif
+}
+
+/** Match a 16 byte key against 4 (key,value) pairs, i.e. 12 u64s. Key
+    words are at u64 positions 0,1 3,4 6,7 9,10 and a pair matches when
+    both of its key words do.
+    @param kv - the first (key,value) pair
+    @param key - the key to look for
+    @return bitmap of the matching pairs
+*/
+static_always_inline u32
+clib_kv_match4_16_8 (u64 * kv, u64 * key)
+{
+  u64 k0 = key[0], k1 = key[1];
+  u32 e;
+#if defined (CLIB_HAVE_VEC512)
+  u64x8 p0 = { k0, k1, 0, k0, k1, 0, k0, k1 };
+  u64x8 p1 = { 0, k0, k1, 0, 0, 0, 0, 0 };
+  e = u64x8_is_equal_mask (u64x8_load_unaligned (kv), p0);
+  e |= u64x8_is_equal_mask (u64x8_mask_load_zero (kv + 8, 0xf), p1) << 8;
+#elif defined (CLIB_HAVE_VEC256)
+  u64x4 p0 = { k0, k1, 0, k0 };
+  u64x4 p1 = { k1, 0, k0, k1 };
+  u64x4 p2 = { 0, k0, k1, 0 };
+  e = u64x4_msb_mask ((u64x4) (u64x4_load_unaligned (kv) == p0));
+  e |= u64x4_msb_mask ((u64x4) (u64x4_load_unaligned (kv + 4) == p1)) << 4;
+  e |= u64x4_msb_mask ((u64x4) (u64x4_load_unaligned (kv + 8) == p2)) << 8;
+#else
+  int i;
+  for (e = 0, i = 0; i < 4; i++)
+    e |= ((kv[3 * i] == k0) | ((kv[3 * i + 1] == k1) << 1)) << (3 * i);
+#endif
+  e &= 0x6db;
+  e &= e >> 1;
+  return (e & 1) | ((e >> 2) & 2) | ((e >> 4) & 4) | ((e >> 6) & 8);
+}
+
+/** Match a 24 byte key against 4 (key,value) pairs, i.e. 16 u64s. A
+    pair matches when its 3 key words do.
+    @param kv - the first (key,value) pair
+    @param key - the key to look for
+    @return bitmap of the matching pairs
+*/
+static_always_inline u32
+clib_kv_match4_24_8 (u64 * kv, u64 * key)
+{
+  u64 k0 = key[0], k1 = key[1], k2 = key[2];
+  u32 e;
+#if defined (CLIB_HAVE_VEC512)
+  u64x8 p = { k0, k1, k2, 0, k0, k1, k2, 0 };
+  e = u64x8_is_equal_mask (u64x8_load_unaligned (kv), p);
+  e |= u64x8_is_equal_mask (u64x8_load_unaligned (kv + 8), p) << 8;
+#elif defined (CLIB_HAVE_VEC256)
+  u64x4 p = { k0, k1, k2, 0 };
+  int i;
+  for (e = 0, i = 0; i < 4; i++)
+    e |= u64x4_msb_mask ((u64x4) (u64x4_load_unaligned (kv + 4 * i) == p))
+      << (4 * i);
+#else
+  int i;
+  for (e = 0, i = 0; i < 4; i++)
+    e |= ((kv[4 * i] == k0) | ((kv[4 * i + 1] == k1) << 1) |
+	  ((kv[4 * i + 2] == k2) << 2)) << (4 * i);
+#endif
+  e &= 0x7777;
+  e &= (e >> 1) & (e >> 2);
+  return (e & 1) | ((e >> 3) & 2) | ((e >> 6) & 4) | ((e >> 9) & 8);
+}
+
+#endif /* __included_kv_match_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
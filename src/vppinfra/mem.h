@@ -60,6 +60,81 @@
 /* Per CPU heaps. */
 extern void *clib_per_cpu_mheaps[CLIB_MAX_MHEAPS];
 
+#if USE_DLMALLOC != 0
+/*
+ * Per thread cache of small heap objects in front of the (locked) heap.
+ *
+ * Cached objects stay allocated as far as the heap is concerned, so they
+ * remain valid heap objects of the heap they came from. The cache is only
+ * used while the thread runs on the heap it was enabled for, and only for
+ * allocations without an alignment request. Objects are kept in size
+ * classes of powers of two and 1.5x powers of two, and a class is half
+ * flushed back to the heap when full. Any thread may free any object,
+ * it lands in the freeing thread's cache.
+ */
+#define CLIB_MEM_TCACHE_N_CLASSES 11
+#define CLIB_MEM_TCACHE_MIN_SIZE 32
+#define CLIB_MEM_TCACHE_MAX_SIZE 1024
+#define CLIB_MEM_TCACHE_OBJECTS_PER_CLASS 64
+
+typedef struct
+{
+  /** heap the cached objects belong to */
+  void *heap;
+
+  /** cache not used, e.g. while heap allocations are traced */
+  volatile u8 bypass;
+
+  u32 n_cached[CLIB_MEM_TCACHE_N_CLASSES];
+  void *objects[CLIB_MEM_TCACHE_N_CLASSES][CLIB_MEM_TCACHE_OBJECTS_PER_CLASS];
+
+  /** allocations served from and missing the cache */
+  u64 hits, misses;
+
+  /** frees kept in the cache, and flushed back to the heap */
+  u64 frees_cached, frees_flushed;
+} clib_mem_tcache_t;
+
+extern clib_mem_tcache_t *clib_mem_tcaches[CLIB_MAX_MHEAPS];
+
+void clib_mem_tcache_enable (void);
+void clib_mem_tcache_disable (void);
+void clib_mem_tcache_update_bypass (void);
+void clib_mem_tcache_flush_class (clib_mem_tcache_t * tc, u32 size_class);
+u8 *format_clib_mem_tcache (u8 * s, va_list * args);
+
+/* smallest class holding size bytes, size <= CLIB_MEM_TCACHE_MAX_SIZE */
+always_inline u32
+clib_mem_tcache_class_for_size (uword size)
+{
+  u32 l;
+
+  if (size <= CLIB_MEM_TCACHE_MIN_SIZE)
+    return 0;
+
+  l = min_log2 (size - 1);
+  return 2 * (l - 5) + (size > (3ULL << (l - 1)) ? 2 : 1);
+}
+
+/* largest class an object of usable_size bytes can serve */
+always_inline u32
+clib_mem_tcache_class_for_object (uword usable_size)
+{
+  u32 l = min_log2 (usable_size);
+  u32 size_class = 2 * (l - 5) + (usable_size >= (3ULL << (l - 1)));
+
+  return clib_min (size_class, CLIB_MEM_TCACHE_N_CLASSES - 1);
+}
+
+always_inline uword
+clib_mem_tcache_class_size (u32 size_class)
+{
+  if (size_class & 1)
+    return 3ULL << (4 + size_class / 2);
+  return 1ULL << (5 + size_class / 2);
+}
+#endif /* USE_DLMALLOC */
+
 always_inline void
 clib_mem_set_thread_index (void)
 {
@@ -134,6 +209,27 @@ clib_mem_alloc_aligned_at_offset (uword size, uword align, uword align_offset,
   if (PREDICT_TRUE (offset != ~0))
     p = heap + offset;
 #else
+  clib_mem_tcache_t *tc = clib_mem_tcaches[cpu];
+
+  /* mspace_get_aligned ignores alignments below a word as well */
+  if (tc && tc->heap == heap && !tc->bypass && align < sizeof (uword)
+      && size <= CLIB_MEM_TCACHE_MAX_SIZE)
+    {
+      u32 size_class = clib_mem_tcache_class_for_size (size);
+
+      if (PREDICT_TRUE (tc->n_cached[size_class] > 0))
+	{
+	  tc->hits++;
+	  p = tc->objects[size_class][--tc->n_cached[size_class]];
+	  CLIB_MEM_UNPOISON (p, size);
+	  return p;
+	}
+
+      /* allocate the full class size so the object can be cached later */
+      tc->misses++;
+      size = clib_mem_tcache_class_size (size_class);
+    }
+
   p = mspace_get_aligned (heap, size, align, align_offset);
 #endif /* USE_DLMALLOC */
 
@@ -226,15 +322,36 @@ always_inline void
 clib_mem_free (void *p)
 {
   u8 *heap = clib_mem_get_per_cpu_heap ();
+  uword size;
 
   /* Make sure object is in the correct heap. */
   ASSERT (clib_mem_is_heap_object (p));
 
-  CLIB_MEM_POISON (p, clib_mem_size_nocheck (p));
+  size = clib_mem_size_nocheck (p);
+  CLIB_MEM_POISON (p, size);
 
 #if USE_DLMALLOC == 0
   mheap_put (heap, (u8 *) p - heap);
 #else
+  clib_mem_tcache_t *tc = clib_mem_tcaches[os_get_thread_index ()];
+
+  /* only objects allocated without alignment, i.e. with a zero
+     mspace_get_aligned delta, can be handed out again as such */
+  if (tc && tc->heap == heap && !tc->bypass
+      && size >= CLIB_MEM_TCACHE_MIN_SIZE
+      && size <= 2 * CLIB_MEM_TCACHE_MAX_SIZE && ((u32 *) p)[-1] == 0)
+    {
+      u32 size_class = clib_mem_tcache_class_for_object (size);
+
+      if (PREDICT_FALSE (tc->n_cached[size_class] ==
+			 CLIB_MEM_TCACHE_OBJECTS_PER_CLASS))
+	clib_mem_tcache_flush_class (tc, size_class);
+
+      tc->frees_cached++;
+      tc->objects[size_class][tc->n_cached[size_class]++] = p;
+      return;
+    }
+
   mspace_put (heap, p);
 #endif
 }
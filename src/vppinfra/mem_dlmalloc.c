@@ -22,6 +22,7 @@
 #include <vppinfra/sanitizer.h>
 
 void *clib_per_cpu_mheaps[CLIB_MAX_MHEAPS];
+clib_mem_tcache_t *clib_mem_tcaches[CLIB_MAX_MHEAPS];
 
 typedef struct
 {
@@ -428,6 +429,9 @@ clib_mem_trace (int enable)
   tm->enabled = enable;
   mheap_trace (current_heap, enable);
 
+  /* traced allocations must reach the heap */
+  clib_mem_tcache_update_bypass ();
+
   if (enable)
     tm->current_traced_mheap = current_heap;
   else
@@ -451,6 +455,120 @@ clib_mem_trace_enable_disable (uword enable)
   return rv;
 }
 
+/**
+ * @brief Enable the small object cache for the calling thread
+ *
+ * Objects are cached for the heap current at the time of the call.
+ */
+void
+clib_mem_tcache_enable (void)
+{
+  uword thread_index = os_get_thread_index ();
+  clib_mem_tcache_t *tc;
+
+  if (clib_mem_tcaches[thread_index])
+    return;
+
+  tc = clib_mem_alloc_aligned (sizeof (*tc), CLIB_CACHE_LINE_BYTES);
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->heap = clib_mem_get_heap ();
+  tc->bypass = mspace_is_traced (tc->heap);
+  clib_mem_tcaches[thread_index] = tc;
+}
+
+/**
+ * @brief Disable the calling thread's small object cache
+ *
+ * All cached objects are returned to their heap.
+ */
+void
+clib_mem_tcache_disable (void)
+{
+  uword thread_index = os_get_thread_index ();
+  clib_mem_tcache_t *tc = clib_mem_tcaches[thread_index];
+  u32 size_class, i;
+
+  if (tc == 0)
+    return;
+
+  clib_mem_tcaches[thread_index] = 0;
+  for (size_class = 0; size_class < CLIB_MEM_TCACHE_N_CLASSES;
+       size_class++)
+    for (i = 0; i < tc->n_cached[size_class]; i++)
+      {
+	void *p = tc->objects[size_class][i];
+	CLIB_MEM_UNPOISON (p, clib_mem_size_nocheck (p));
+	mspace_put (tc->heap, p);
+      }
+
+  mspace_put (tc->heap, tc);
+}
+
+/**
+ * @brief Bypass the small object caches of threads whose heap is traced
+ *
+ * Cached objects are kept, they are used again once tracing stops.
+ */
+void
+clib_mem_tcache_update_bypass (void)
+{
+  clib_mem_tcache_t *tc;
+  int i;
+
+  for (i = 0; i < ARRAY_LEN (clib_mem_tcaches); i++)
+    if ((tc = clib_mem_tcaches[i]))
+      tc->bypass = mspace_is_traced (tc->heap);
+}
+
+/* Return the older half of a full class to the heap */
+void
+clib_mem_tcache_flush_class (clib_mem_tcache_t * tc, u32 size_class)
+{
+  u32 i, n = tc->n_cached[size_class] / 2;
+  void **objects = tc->objects[size_class];
+
+  for (i = 0; i < n; i++)
+    {
+      CLIB_MEM_UNPOISON (objects[i], clib_mem_size_nocheck (objects[i]));
+      mspace_put (tc->heap, objects[i]);
+    }
+
+  memmove (objects, objects + n,
+	   (tc->n_cached[size_class] - n) * sizeof (void *));
+  tc->n_cached[size_class] -= n;
+  tc->frees_flushed += n;
+}
+
+u8 *
+format_clib_mem_tcache (u8 * s, va_list * va)
+{
+  clib_mem_tcache_t *tc = va_arg (*va, clib_mem_tcache_t *);
+  u32 indent = format_get_indent (s);
+  uword size_class, n_objects = 0, n_bytes = 0;
+  f64 lookups;
+
+  if (tc == 0)
+    return format (s, "thread cache disabled");
+
+  for (size_class = 0; size_class < CLIB_MEM_TCACHE_N_CLASSES;
+       size_class++)
+    {
+      n_objects += tc->n_cached[size_class];
+      n_bytes += tc->n_cached[size_class] *
+	clib_mem_tcache_class_size (size_class);
+    }
+
+  lookups = tc->hits + tc->misses;
+  s = format (s, "thread cache%s: %lu hits, %lu misses, hit rate %.1f%%",
+	      tc->bypass ? " (bypassed)" : "", tc->hits, tc->misses,
+	      lookups ? 100.0 * tc->hits / lookups : 0.0);
+  s = format (s, "\n%U%lu objects cached, at least %U, %lu frees cached, "
+	      "%lu flushed", format_white_space, indent, n_objects,
+	      format_memory_size, n_bytes, tc->frees_cached,
+	      tc->frees_flushed);
+  return s;
+}
+
 /*
  * These API functions seem like layering violations, but
  * by introducing them we greatly reduce the number
@@ -147,6 +147,19 @@ clib_memcpy_fast (void *dst, const void *src, size_t n)
   size_t dstofss;
   size_t bits;
 
+#if defined (__AVX512BW__)
+  /* one masked load and store, no branching on size. Constant sizes
+     are left to the code below, which the compiler reduces to the
+     exact moves needed. */
+  if (!__builtin_constant_p (n) && n < 64)
+    {
+      u64 mask = pow2_mask (n);
+      __m512i zmm0 = _mm512_maskz_loadu_epi8 (mask, src);
+      _mm512_mask_storeu_epi8 (dst, mask, zmm0);
+      return ret;
+    }
+#endif
+
 	/**
          * Copy less than 16 bytes
          */
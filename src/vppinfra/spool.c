@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vppinfra/spool.h>
+#include <vppinfra/mem.h>
+
+/** Initialize a segmented pool
+    @param sp - the segmented pool
+    @param name - name, for show commands
+    @param elt_size - element size in bytes
+    @param align - element alignment, 0 for natural word alignment
+    @param max_elts - maximum number of elements
+    @param n_threads - number of threads using the pool, 0 for
+                       os_get_nthreads()
+*/
+void
+clib_spool_init (clib_spool_t * sp, char *name, u32 elt_size, u32 align,
+		 u32 max_elts, u32 n_threads)
+{
+  u32 n_segments;
+
+  ASSERT (elt_size > 0 && max_elts > 0);
+
+  if (align == 0)
+    align = sizeof (uword);
+  ASSERT (is_pow2 (align));
+
+  if (n_threads == 0)
+    n_threads = os_get_nthreads ();
+
+  clib_memset (sp, 0, sizeof (*sp));
+  sp->name = format (0, "%s%c", name, 0);
+  sp->elt_size = round_pow2 (elt_size, align);
+  sp->max_elts = max_elts;
+
+  /* small pools get small segments, one bitmap word at least */
+  sp->log2_segment_elts = clib_min (CLIB_SPOOL_LOG2_SEGMENT_ELTS,
+				    max_log2 (max_elts));
+  sp->log2_segment_elts = clib_max (sp->log2_segment_elts,
+				    min_log2 (BITS (uword)));
+  sp->segment_mask = pow2_mask (sp->log2_segment_elts);
+
+  n_segments = (((u64) max_elts - 1) >> sp->log2_segment_elts) + 1;
+  vec_validate (sp->segments, n_segments - 1);
+  vec_validate (sp->used_bitmaps, n_segments - 1);
+
+  vec_validate_aligned (sp->per_thread, n_threads - 1,
+			CLIB_CACHE_LINE_BYTES);
+  clib_spinlock_init (&sp->lock);
+}
+
+/** Free a segmented pool and all its elements */
+void
+clib_spool_free (clib_spool_t * sp)
+{
+  clib_spool_per_thread_t *ptd;
+  u32 i;
+
+  for (i = 0; i < sp->n_segments; i++)
+    {
+      clib_mem_free (sp->segments[i]);
+      clib_mem_free (sp->used_bitmaps[i]);
+    }
+  vec_free (sp->segments);
+  vec_free (sp->used_bitmaps);
+
+  vec_foreach (ptd, sp->per_thread) vec_free (ptd->free_indices);
+  vec_free (sp->per_thread);
+
+  vec_free (sp->free_indices);
+  vec_free (sp->name);
+  clib_spinlock_free (&sp->lock);
+  clib_memset (sp, 0, sizeof (*sp));
+}
+
+static int
+clib_spool_add_segment (clib_spool_t * sp)
+{
+  u32 segment_elts = 1 << sp->log2_segment_elts;
+  u32 s = sp->n_segments;
+
+  if (s == vec_len (sp->segments))
+    return -1;
+
+  sp->segments[s] = clib_mem_alloc_aligned ((uword) segment_elts *
+					    sp->elt_size,
+					    CLIB_CACHE_LINE_BYTES);
+  sp->used_bitmaps[s] = clib_mem_alloc_aligned (segment_elts / 8,
+						CLIB_CACHE_LINE_BYTES);
+  clib_memset (sp->used_bitmaps[s], 0, segment_elts / 8);
+
+  /* make the segment visible before any index in it is handed out */
+  clib_atomic_store_rel_n (&sp->n_segments, s + 1);
+  return 0;
+}
+
+/** Refill a thread's free index cache, slow path of clib_spool_get
+    @return number of free indices in the cache, 0 when the pool is full
+*/
+u32
+clib_spool_refill (clib_spool_t * sp, clib_spool_per_thread_t * ptd)
+{
+  u32 n, len, i;
+
+  clib_spinlock_lock (&sp->lock);
+
+  /* recycled indices first */
+  len = vec_len (sp->free_indices);
+  if (len)
+    {
+      n = clib_min (len, CLIB_SPOOL_BATCH);
+      vec_add (ptd->free_indices, sp->free_indices + len - n, n);
+      _vec_len (sp->free_indices) = len - n;
+      goto done;
+    }
+
+  /* then never used ones, growing the pool when needed */
+  n = clib_min (CLIB_SPOOL_BATCH, sp->max_elts - sp->next_fresh_index);
+  if (n == 0)
+    goto done;
+
+  while (((sp->next_fresh_index + n - 1) >> sp->log2_segment_elts) >=
+	 sp->n_segments)
+    if (clib_spool_add_segment (sp))
+      goto done;
+
+  /* hand out in descending order so the cache pops ascending */
+  for (i = 0; i < n; i++)
+    vec_add1 (ptd->free_indices, sp->next_fresh_index + n - 1 - i);
+  sp->next_fresh_index += n;
+
+done:
+  clib_spinlock_unlock (&sp->lock);
+  return vec_len (ptd->free_indices);
+}
+
+/** Return a batch from a thread's free index cache to the shared list */
+void
+clib_spool_drain (clib_spool_t * sp, clib_spool_per_thread_t * ptd)
+{
+  u32 len = vec_len (ptd->free_indices);
+
+  clib_spinlock_lock (&sp->lock);
+  vec_add (sp->free_indices, ptd->free_indices + len - 2 * CLIB_SPOOL_BATCH,
+	   2 * CLIB_SPOOL_BATCH);
+  clib_spinlock_unlock (&sp->lock);
+
+  _vec_len (ptd->free_indices) = len - 2 * CLIB_SPOOL_BATCH;
+}
+
+/** Number of elements in use */
+uword
+clib_spool_elts (clib_spool_t * sp)
+{
+  clib_spool_per_thread_t *ptd;
+  i64 n = 0;
+
+  vec_foreach (ptd, sp->per_thread) n += ptd->n_in_use;
+  return n;
+}
+
+u8 *
+format_clib_spool (u8 * s, va_list * args)
+{
+  clib_spool_t *sp = va_arg (*args, clib_spool_t *);
+  int verbose = va_arg (*args, int);
+  clib_spool_per_thread_t *ptd;
+  u32 indent = format_get_indent (s);
+  u32 segment_elts = 1 << sp->log2_segment_elts;
+
+  s = format (s, "%s: %lu elts in use, max %u, elt size %u", sp->name,
+	      clib_spool_elts (sp), sp->max_elts, sp->elt_size);
+  s = format (s, "\n%U%u of %u segments of %u elts, %U, %u shared free",
+	      format_white_space, indent + 2, sp->n_segments,
+	      vec_len (sp->segments), segment_elts, format_memory_size,
+	      (uword) sp->n_segments * segment_elts * sp->elt_size,
+	      vec_len (sp->free_indices));
+
+  if (verbose)
+    vec_foreach (ptd, sp->per_thread)
+      s = format (s, "\n%Uthread %u: %u free cached, %ld gets - puts",
+		  format_white_space, indent + 2, ptd - sp->per_thread,
+		  vec_len (ptd->free_indices), ptd->n_in_use);
+
+  return s;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+    @brief Segmented pool of fixed-size objects
+
+    Like a pool, elements are addressed by u32 index and recycled, but
+    storage is a set of fixed-size segments instead of one vector.
+    Growing the pool allocates a new segment, existing elements never
+    move, so element pointers stay valid for the life of the element and
+    readers on other threads need no barrier while the pool grows.
+
+    Index to pointer translation is a shift, a mask and one load from the
+    segment table, which is sized for max_elts at init time and never
+    reallocated.
+
+    Each thread allocates from and frees to its own free index cache.
+    A cache which runs dry is refilled from a shared free list, or with
+    never used indices, a batch at a time under a spinlock. A cache which
+    grows too large, e.g. on a thread which frees objects allocated by
+    others, returns a batch to the shared list. Indices cached by other
+    threads are not available to a thread, so a pool which should hold
+    N elements needs max_elts of about N + n_threads * CLIB_SPOOL_BATCH.
+*/
+
+#ifndef included_clib_spool_h
+#define included_clib_spool_h
+
+#include <vppinfra/clib.h>
+#include <vppinfra/vec.h>
+#include <vppinfra/lock.h>
+#include <vppinfra/atomics.h>
+#include <vppinfra/format.h>
+#include <vppinfra/os.h>
+
+/** Default number of elements per segment, log2 */
+#define CLIB_SPOOL_LOG2_SEGMENT_ELTS 12
+
+/** Number of indices moved between a thread cache and the shared list */
+#define CLIB_SPOOL_BATCH 64
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /** free indices owned by this thread */
+  u32 *free_indices;
+
+  /** gets minus puts done by this thread, may go negative */
+  i64 n_in_use;
+} clib_spool_per_thread_t;
+
+typedef struct
+{
+  /** segment base addresses, sized for max_elts at init */
+  u8 **segments;
+
+  /** per segment bitmaps of elements in use */
+  uword **used_bitmaps;
+
+  /** segments allocated so far */
+  u32 n_segments;
+
+  /** element size, rounded up to the alignment */
+  u32 elt_size;
+
+  u32 log2_segment_elts;
+  u32 segment_mask;
+
+  /** maximum number of elements */
+  u32 max_elts;
+
+  /** first index never handed out */
+  u32 next_fresh_index;
+
+  /** shared free list, refill and segment allocation */
+  clib_spinlock_t lock;
+  u32 *free_indices;
+
+  /** per-thread free index caches */
+  clib_spool_per_thread_t *per_thread;
+
+  /** name, for show commands */
+  u8 *name;
+} clib_spool_t;
+
+void clib_spool_init (clib_spool_t * sp, char *name, u32 elt_size,
+		      u32 align, u32 max_elts, u32 n_threads);
+void clib_spool_free (clib_spool_t * sp);
+u32 clib_spool_refill (clib_spool_t * sp, clib_spool_per_thread_t * ptd);
+void clib_spool_drain (clib_spool_t * sp, clib_spool_per_thread_t * ptd);
+uword clib_spool_elts (clib_spool_t * sp);
+format_function_t format_clib_spool;
+
+/** Translate an index into an element pointer */
+always_inline void *
+clib_spool_elt_at_index (clib_spool_t * sp, u32 index)
+{
+  u8 *s;
+
+  ASSERT ((index >> sp->log2_segment_elts) < sp->n_segments);
+  s = sp->segments[index >> sp->log2_segment_elts];
+  return s + (uword) (index & sp->segment_mask) * sp->elt_size;
+}
+
+/** Is an index free, i.e. not handed out by clib_spool_get */
+always_inline int
+clib_spool_is_free_index (clib_spool_t * sp, u32 index)
+{
+  u32 segment = index >> sp->log2_segment_elts;
+  u32 offset = index & sp->segment_mask;
+  uword *used;
+
+  if (segment >= clib_atomic_load_acq_n (&sp->n_segments))
+    return 1;
+
+  used = sp->used_bitmaps[segment];
+  return (used[offset / BITS (uword)] & (1ULL << (offset % BITS (uword))))
+    == 0;
+}
+
+static_always_inline void
+clib_spool_set_used (clib_spool_t * sp, u32 index, int is_used)
+{
+  u32 offset = index & sp->segment_mask;
+  uword *word = sp->used_bitmaps[index >> sp->log2_segment_elts] +
+    offset / BITS (uword);
+  uword bit = 1ULL << (offset % BITS (uword));
+
+  /* other threads may flip neighbouring bits */
+  if (is_used)
+    clib_atomic_fetch_or (word, bit);
+  else
+    clib_atomic_fetch_and (word, ~bit);
+}
+
+/** Allocate an element on the calling thread
+    @param sp - the segmented pool
+    @param index - set to the element index
+    @return the element, or 0 when the pool is full
+*/
+always_inline void *
+clib_spool_get (clib_spool_t * sp, u32 * index)
+{
+  clib_spool_per_thread_t *ptd;
+  u32 i, len;
+
+  ASSERT (os_get_thread_index () < vec_len (sp->per_thread));
+  ptd = vec_elt_at_index (sp->per_thread, os_get_thread_index ());
+  len = vec_len (ptd->free_indices);
+
+  if (PREDICT_FALSE (len == 0))
+    {
+      len = clib_spool_refill (sp, ptd);
+      if (PREDICT_FALSE (len == 0))
+	return 0;
+    }
+
+  i = ptd->free_indices[len - 1];
+  _vec_len (ptd->free_indices) = len - 1;
+  ptd->n_in_use++;
+
+  ASSERT (clib_spool_is_free_index (sp, i));
+  clib_spool_set_used (sp, i, 1);
+  *index = i;
+  return clib_spool_elt_at_index (sp, i);
+}
+
+/** Allocate a zeroed element on the calling thread */
+always_inline void *
+clib_spool_get_zero (clib_spool_t * sp, u32 * index)
+{
+  void *e = clib_spool_get (sp, index);
+  if (PREDICT_TRUE (e != 0))
+    clib_memset (e, 0, sp->elt_size);
+  return e;
+}
+
+/** Free an element, any thread may free any element */
+always_inline void
+clib_spool_put_index (clib_spool_t * sp, u32 index)
+{
+  clib_spool_per_thread_t *ptd;
+
+  ASSERT (os_get_thread_index () < vec_len (sp->per_thread));
+  ASSERT (!clib_spool_is_free_index (sp, index));
+
+  ptd = vec_elt_at_index (sp->per_thread, os_get_thread_index ());
+  clib_spool_set_used (sp, index, 0);
+  vec_add1 (ptd->free_indices, index);
+  ptd->n_in_use--;
+
+  if (PREDICT_FALSE (vec_len (ptd->free_indices) >= 4 * CLIB_SPOOL_BATCH))
+    clib_spool_drain (sp, ptd);
+}
+
+/** Iterate over the indices of all elements in use.
+    Only meaningful while no other thread allocates or frees. */
+#define clib_spool_foreach_index(I,SP,BODY)				\
+do {									\
+  u32 _spool_s, _spool_w;						\
+  uword _spool_bits;							\
+  for (_spool_s = 0; _spool_s < (SP)->n_segments; _spool_s++)		\
+    for (_spool_w = 0;							\
+         _spool_w < (1 << (SP)->log2_segment_elts) / BITS (uword);	\
+         _spool_w++)							\
+      {									\
+        _spool_bits = (SP)->used_bitmaps[_spool_s][_spool_w];		\
+        while (_spool_bits)						\
+          {								\
+            (I) = (_spool_s << (SP)->log2_segment_elts) +		\
+              _spool_w * BITS (uword) + count_trailing_zeros (_spool_bits); \
+            _spool_bits &= _spool_bits - 1;				\
+            do { BODY; } while (0);					\
+          }								\
+      }									\
+} while (0)
+
+#endif /* included_clib_spool_h */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
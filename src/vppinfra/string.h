@@ -305,6 +305,10 @@ clib_memset_u64 (void *p, u64 val, uword count)
     }
   if (count == 0)
     return;
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u64x8_mask_store (v512, ptr, pow2_mask (count));
+  return;
+#endif
 #endif
 #if defined(CLIB_HAVE_VEC256)
   u64x4 v256 = u64x4_splat (val);
@@ -316,6 +320,10 @@ clib_memset_u64 (void *p, u64 val, uword count)
     }
   if (count == 0)
     return;
+#if defined(CLIB_HAVE_VEC256_MASK_LOAD_STORE)
+  u64x4_mask_store (v256, ptr, u64x4_first_n_mask (count));
+  return;
+#endif
 #else
   while (count >= 4)
     {
@@ -342,6 +350,10 @@ clib_memset_u32 (void *p, u32 val, uword count)
     }
   if (count == 0)
     return;
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u32x16_mask_store (v512, ptr, pow2_mask (count));
+  return;
+#endif
 #endif
 #if defined(CLIB_HAVE_VEC256)
   u32x8 v256 = u32x8_splat (val);
@@ -353,6 +365,10 @@ clib_memset_u32 (void *p, u32 val, uword count)
     }
   if (count == 0)
     return;
+#if defined(CLIB_HAVE_VEC256_MASK_LOAD_STORE)
+  u32x8_mask_store (v256, ptr, u32x8_first_n_mask (count));
+  return;
+#endif
 #endif
 #if defined(CLIB_HAVE_VEC128) && defined(CLIB_HAVE_VEC128_UNALIGNED_LOAD_STORE)
   u32x4 v128 = u32x4_splat (val);
@@ -388,6 +404,10 @@ clib_memset_u16 (void *p, u16 val, uword count)
     }
   if (count == 0)
     return;
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u16x32_mask_store (v512, ptr, pow2_mask (count));
+  return;
+#endif
 #endif
 #if defined(CLIB_HAVE_VEC256)
   u16x16 v256 = u16x16_splat (val);
@@ -434,6 +454,10 @@ clib_memset_u8 (void *p, u8 val, uword count)
     }
   if (count == 0)
     return;
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u8x64_mask_store (v512, ptr, pow2_mask (count));
+  return;
+#endif
 #endif
 #if defined(CLIB_HAVE_VEC256)
   u8x32 v256 = u8x32_splat (val);
@@ -480,7 +504,26 @@ clib_count_equal_u64 (u64 * data, uword max_count)
   count = 0;
   first = data[0];
 
-#if defined(CLIB_HAVE_VEC256)
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u64x8 splat512 = u64x8_splat (first);
+  u8 bmp512, mask512;
+  while (count + 8 <= max_count)
+    {
+      bmp512 = u64x8_is_equal_mask (u64x8_load_unaligned (data), splat512);
+      if (bmp512 != 0xff)
+	return count + count_trailing_zeros (~bmp512);
+      data += 8;
+      count += 8;
+    }
+  if (count == max_count)
+    return count;
+
+  /* masked load, nothing past max_count is read */
+  mask512 = pow2_mask (max_count - count);
+  bmp512 = u64x8_is_equal_mask (u64x8_mask_load_zero (data, mask512),
+				splat512);
+  return count + count_trailing_zeros (~(bmp512 & mask512));
+#elif defined(CLIB_HAVE_VEC256)
   u64x4 splat = u64x4_splat (first);
   while (1)
     {
@@ -530,7 +573,26 @@ clib_count_equal_u32 (u32 * data, uword max_count)
   count = 0;
   first = data[0];
 
-#if defined(CLIB_HAVE_VEC256)
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u32x16 splat512 = u32x16_splat (first);
+  u16 bmp512, mask512;
+  while (count + 16 <= max_count)
+    {
+      bmp512 = u32x16_is_equal_mask (u32x16_load_unaligned (data), splat512);
+      if (bmp512 != 0xffff)
+	return count + count_trailing_zeros (~bmp512);
+      data += 16;
+      count += 16;
+    }
+  if (count == max_count)
+    return count;
+
+  /* masked load, nothing past max_count is read */
+  mask512 = pow2_mask (max_count - count);
+  bmp512 = u32x16_is_equal_mask (u32x16_mask_load_zero (data, mask512),
+				 splat512);
+  return count + count_trailing_zeros (~(bmp512 & mask512));
+#elif defined(CLIB_HAVE_VEC256)
   u32x8 splat = u32x8_splat (first);
   while (1)
     {
@@ -598,7 +660,26 @@ clib_count_equal_u16 (u16 * data, uword max_count)
   count = 0;
   first = data[0];
 
-#if defined(CLIB_HAVE_VEC256)
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u16x32 splat512 = u16x32_splat (first);
+  u32 bmp512, mask512;
+  while (count + 32 <= max_count)
+    {
+      bmp512 = u16x32_is_equal_mask (u16x32_load_unaligned (data), splat512);
+      if (bmp512 != 0xffffffff)
+	return count + count_trailing_zeros (~bmp512);
+      data += 32;
+      count += 32;
+    }
+  if (count == max_count)
+    return count;
+
+  /* masked load, nothing past max_count is read */
+  mask512 = pow2_mask (max_count - count);
+  bmp512 = u16x32_is_equal_mask (u16x32_mask_load_zero (data, mask512),
+				 splat512);
+  return count + count_trailing_zeros (~(bmp512 & mask512));
+#elif defined(CLIB_HAVE_VEC256)
   u16x16 splat = u16x16_splat (first);
   while (1)
     {
@@ -666,7 +747,26 @@ clib_count_equal_u8 (u8 * data, uword max_count)
   count = 0;
   first = data[0];
 
-#if defined(CLIB_HAVE_VEC256)
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  u8x64 splat512 = u8x64_splat (first);
+  u64 bmp512, mask512;
+  while (count + 64 <= max_count)
+    {
+      bmp512 = u8x64_is_equal_mask (u8x64_load_unaligned (data), splat512);
+      if (bmp512 != ~0ULL)
+	return count + count_trailing_zeros (~bmp512);
+      data += 64;
+      count += 64;
+    }
+  if (count == max_count)
+    return count;
+
+  /* masked load, nothing past max_count is read */
+  mask512 = pow2_mask (max_count - count);
+  bmp512 = u8x64_is_equal_mask (u8x64_mask_load_zero (data, mask512),
+				splat512);
+  return count + count_trailing_zeros (~(bmp512 & mask512));
+#elif defined(CLIB_HAVE_VEC256)
   u8x32 splat = u8x32_splat (first);
   while (1)
     {
@@ -43,6 +43,7 @@ typedef struct
   uword *key_hash;
   u64 *keys;
   uword hash_memory_size;
+  char *file_path;
     BVT (clib_bihash) hash;
   clib_time_t clib_time;
   void *global_heap;
@@ -146,6 +147,192 @@ test_bihash_stale_overwrite (test_main_t * tm)
   return 0;
 }
 
+static clib_error_t *
+test_bihash_resize_check (test_main_t * tm, int n_added, int n_deleted)
+{
+  BVT (clib_bihash) * h = &tm->hash;
+  BVT (clib_bihash_kv) kv;
+  int i, rv;
+
+  for (i = 0; i < n_added; i++)
+    {
+      kv.key = tm->keys[i];
+      rv = BV (clib_bihash_search) (h, &kv, &kv);
+      if (i < n_deleted && rv == 0)
+	return clib_error_return (0, "deleted key %lld found", tm->keys[i]);
+      if (i >= n_deleted && (rv < 0 || kv.value != (u64) (i + 1)))
+	return clib_error_return (0, "key %lld not found (%d buckets%s)",
+				  tm->keys[i], h->nbuckets,
+				  h->old_buckets ? ", resizing" : "");
+    }
+  return 0;
+}
+
+static clib_error_t *
+test_bihash_resize (test_main_t * tm)
+{
+  BVT (clib_bihash_init2_args) _a, *a = &_a;
+  BVT (clib_bihash) * h = &tm->hash;
+  BVT (clib_bihash_kv) kv;
+  clib_error_t *error;
+  u32 check_every = clib_max (tm->nitems / 16, 1);
+  u32 start_nbuckets = 1 << max_log2 (tm->nbuckets);
+  int i, n_deleted = 0;
+
+  clib_memset (a, 0, sizeof (*a));
+  a->h = h;
+  a->name = "test";
+  a->nbuckets = tm->nbuckets;
+  a->memory_size = tm->hash_memory_size;
+  a->auto_grow = 1;
+  BV (clib_bihash_init2) (a);
+
+  fformat (stdout, "Add %d items to %d growing buckets\n", tm->nitems,
+	   start_nbuckets);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      vec_add1 (tm->keys, random_u64 (&tm->seed));
+      kv.key = tm->keys[i];
+      kv.value = i + 1;
+      if (BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */ ))
+	return clib_error_return (0, "add of key %lld failed", kv.key);
+
+      /* Migrate a few buckets at a time, as the resize process does */
+      BV (clib_bihash_resize_work) (h, 1);
+
+      /* Delete some keys mid-resize */
+      if (h->old_buckets && (i % 3) == 0 && n_deleted < i / 4)
+	{
+	  kv.key = tm->keys[n_deleted];
+	  if (BV (clib_bihash_add_del) (h, &kv, 0 /* is_add */ ))
+	    return clib_error_return (0, "delete of key %lld failed",
+				      kv.key);
+	  n_deleted++;
+	}
+
+      if ((i % check_every) == 0 &&
+	  (error = test_bihash_resize_check (tm, i + 1, n_deleted)))
+	return error;
+    }
+
+  while (BV (clib_bihash_resize_work) (h, 64))
+    ;
+
+  if ((error = test_bihash_resize_check (tm, tm->nitems, n_deleted)))
+    return error;
+
+  if (tm->nitems > start_nbuckets * BIHASH_KVP_PER_PAGE &&
+      h->nbuckets == start_nbuckets)
+    return clib_error_return (0, "table did not grow");
+
+  fformat (stdout, "Grew to %d buckets, %d items deleted while resizing\n",
+	   h->nbuckets, n_deleted);
+
+  for (i = n_deleted; i < tm->nitems; i++)
+    {
+      kv.key = tm->keys[i];
+      if (BV (clib_bihash_add_del) (h, &kv, 0 /* is_add */ ))
+	return clib_error_return (0, "delete of key %lld failed", kv.key);
+    }
+
+  if (h->n_elts != 0)
+    return clib_error_return (0, "%lld items left", h->n_elts);
+
+  fformat (stdout, "%U", BV (format_bihash), h, 0);
+
+  BV (clib_bihash_free) (h);
+
+  return 0;
+}
+
+static clib_error_t *
+test_bihash_search_multi (test_main_t * tm)
+{
+  BVT (clib_bihash) * h = &tm->hash;
+  BVT (clib_bihash_kv) kv, keys[BIHASH_SEARCH_MULTI_MAX];
+  BVT (clib_bihash_kv) values[BIHASH_SEARCH_MULTI_MAX];
+  u64 hashes[BIHASH_SEARCH_MULTI_MAX];
+  u32 i, j, k, n, found;
+  uword total_searches;
+  f64 before, scalar, multi;
+
+  BV (clib_bihash_init) (h, "test", tm->nbuckets, tm->hash_memory_size);
+
+  fformat (stdout, "Add %d items to %d buckets\n", tm->nitems, tm->nbuckets);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      vec_add1 (tm->keys, random_u64 (&tm->seed));
+      kv.key = tm->keys[i];
+      kv.value = i + 1;
+      BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */ );
+    }
+
+  total_searches = (uword) tm->search_iter * (uword) tm->nitems;
+
+  before = clib_time_now (&tm->clib_time);
+  for (j = 0; j < tm->search_iter; j++)
+    {
+      for (i = 0; i < tm->nitems; i++)
+	{
+	  kv.key = tm->keys[i];
+	  if (BV (clib_bihash_search_inline_2_with_hash)
+	      (h, BV (clib_bihash_hash) (&kv), &kv, &kv) < 0 ||
+	      kv.value != (u64) (i + 1))
+	    return clib_error_return (0, "scalar search for %lld failed",
+				      tm->keys[i]);
+	}
+    }
+  scalar = clib_time_now (&tm->clib_time) - before;
+
+  before = clib_time_now (&tm->clib_time);
+  for (j = 0; j < tm->search_iter; j++)
+    {
+      for (i = 0; i < tm->nitems; i += n)
+	{
+	  n = clib_min (tm->nitems - i, BIHASH_SEARCH_MULTI_MAX);
+	  for (k = 0; k < n; k++)
+	    {
+	      keys[k].key = tm->keys[i + k];
+	      hashes[k] = BV (clib_bihash_hash) (&keys[k]);
+	    }
+
+	  found = BV (clib_bihash_search_multi) (h, hashes, keys, values, n);
+
+	  if (found != pow2_mask (n))
+	    return clib_error_return (0, "multi search for %d keys at %d "
+				      "found %x", n, i, found);
+	  for (k = 0; k < n; k++)
+	    if (values[k].value != (u64) (i + k + 1))
+	      return clib_error_return (0, "multi search for %lld returned "
+					"%lld", keys[k].key, values[k].value);
+	}
+    }
+  multi = clib_time_now (&tm->clib_time) - before;
+
+  /* Keys not in the table are not found */
+  for (k = 0; k < BIHASH_SEARCH_MULTI_MAX; k++)
+    {
+      keys[k].key = random_u64 (&tm->seed);
+      hashes[k] = BV (clib_bihash_hash) (&keys[k]);
+    }
+  found = BV (clib_bihash_search_multi) (h, hashes, keys, values,
+					 BIHASH_SEARCH_MULTI_MAX);
+  if (found)
+    return clib_error_return (0, "multi search found absent keys %x",
+			      found);
+
+  fformat (stdout, "%lld searches, scalar %.2f Mlookups/sec, "
+	   "multi %.2f Mlookups/sec (x%.2f)\n", total_searches,
+	   (f64) total_searches / scalar / 1e6,
+	   (f64) total_searches / multi / 1e6, scalar / multi);
+
+  BV (clib_bihash_free) (h);
+
+  return 0;
+}
+
 void *
 test_bihash_thread_fn (void *arg)
 {
@@ -450,11 +637,227 @@ test_bihash (test_main_t * tm)
   return 0;
 }
 
+#if BIHASH_32_64_SVM == 0
+/* Map the table the way a restarted process would */
+static clib_error_t *
+test_bihash_file_attach (test_main_t * tm, u32 nbuckets, int *attached)
+{
+  BVT (clib_bihash_init2_args) _a, *a = &_a;
+  clib_error_t *error;
+  f64 before;
+
+  clib_memset (a, 0, sizeof (*a));
+  a->h = &tm->hash;
+  a->name = "test";
+  a->nbuckets = nbuckets;
+  a->memory_size = tm->hash_memory_size;
+
+  before = clib_time_now (&tm->clib_time);
+  error = BV (clib_bihash_init_file) (a, tm->file_path, attached);
+  fformat (stdout, "%s %s in %.3f ms\n", tm->file_path,
+	   *attached ? "attached" : "created",
+	   (clib_time_now (&tm->clib_time) - before) * 1e3);
+  return error;
+}
+
+/* Drop the mapping without a clean detach, as a crash would */
+static void
+test_bihash_file_crash (test_main_t * tm)
+{
+  BVT (clib_bihash) * h = &tm->hash;
+
+  munmap ((void *) (uword) alloc_arena (h), alloc_arena_size (h));
+  close (h->file_fd);
+  vec_free (h->freelists);
+  vec_free (h->working_copies);
+  vec_free (h->working_copy_lengths);
+  clib_memset (h, 0, sizeof (*h));
+}
+
+static clib_error_t *
+test_bihash_file_check (test_main_t * tm, int n_added, int n_deleted)
+{
+  BVT (clib_bihash) * h = &tm->hash;
+  BVT (clib_bihash_kv) kv;
+  int i, rv;
+
+  for (i = 0; i < n_added; i++)
+    {
+      kv.key = tm->keys[i];
+      rv = BV (clib_bihash_search) (h, &kv, &kv);
+      if (i < n_deleted && rv == 0)
+	return clib_error_return (0, "deleted key %lld found", tm->keys[i]);
+      if (i >= n_deleted && (rv < 0 || kv.value != (u64) (i + 1)))
+	return clib_error_return (0, "key %lld not found", tm->keys[i]);
+    }
+  return 0;
+}
+
+/* Delete and re-add the first n keys, which needs working copies */
+static clib_error_t *
+test_bihash_file_churn (test_main_t * tm, int n)
+{
+  BVT (clib_bihash) * h = &tm->hash;
+  BVT (clib_bihash_kv) kv;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      kv.key = tm->keys[i];
+      if (BV (clib_bihash_add_del) (h, &kv, 0 /* is_add */ ))
+	return clib_error_return (0, "delete of key %lld failed", kv.key);
+    }
+  for (i = 0; i < n; i++)
+    {
+      kv.key = tm->keys[i];
+      kv.value = i + 1;
+      if (BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */ ))
+	return clib_error_return (0, "re-add of key %lld failed", kv.key);
+    }
+  return 0;
+}
+
+static clib_error_t *
+test_bihash_file (test_main_t * tm)
+{
+  BVT (clib_bihash) * h = &tm->hash, _h2, *h2 = &_h2;
+  BVT (clib_bihash_init2_args) _a, *a = &_a;
+  BVT (clib_bihash_kv) kv;
+  clib_error_t *error;
+  int i, attached, n_deleted = tm->nitems / 2;
+  u64 arena_next = 0;
+
+  unlink (tm->file_path);
+
+  if ((error = test_bihash_file_attach (tm, tm->nbuckets, &attached)))
+    return error;
+  if (attached)
+    return clib_error_return (0, "attached to a new file");
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      vec_add1 (tm->keys, random_u64 (&tm->seed));
+      kv.key = tm->keys[i];
+      kv.value = i + 1;
+      if (BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */ ))
+	return clib_error_return (0, "add of key %lld failed", kv.key);
+    }
+  BV (clib_bihash_free) (h);
+
+  /* Clean restart */
+  if ((error = test_bihash_file_attach (tm, tm->nbuckets, &attached)))
+    return error;
+  if (!attached)
+    return clib_error_return (0, "clean detach not reattached");
+  if ((error = test_bihash_file_check (tm, tm->nitems, 0)))
+    return error;
+
+  /* Deletes free pages, the freelists must survive too */
+  for (i = 0; i < n_deleted; i++)
+    {
+      kv.key = tm->keys[i];
+      if (BV (clib_bihash_add_del) (h, &kv, 0 /* is_add */ ))
+	return clib_error_return (0, "delete of key %lld failed", kv.key);
+    }
+  test_bihash_file_crash (tm);
+
+  /* Restart after a crash, the table is checked before use */
+  if ((error = test_bihash_file_attach (tm, tm->nbuckets, &attached)))
+    return error;
+  if (!attached)
+    return clib_error_return (0, "consistent table not reattached");
+  if ((error = test_bihash_file_check (tm, tm->nitems, n_deleted)))
+    return error;
+  if (h->n_elts != tm->nitems - n_deleted)
+    return clib_error_return (0, "%lld elts counted, expected %d",
+			      h->n_elts, tm->nitems - n_deleted);
+
+  /* Reuse pages from the recovered freelists */
+  for (i = 0; i < n_deleted; i++)
+    {
+      kv.key = tm->keys[i];
+      kv.value = i + 1;
+      if (BV (clib_bihash_add_del) (h, &kv, 1 /* is_add */ ))
+	return clib_error_return (0, "re-add of key %lld failed", kv.key);
+    }
+  if ((error = test_bihash_file_check (tm, tm->nitems, 0)))
+    return error;
+
+  /* Working copies are reused by the next owner, restarts don't grow
+   * the arena */
+  for (i = 0; i < 3; i++)
+    {
+      BV (clib_bihash_free) (h);
+      if ((error = test_bihash_file_attach (tm, tm->nbuckets, &attached)))
+	return error;
+      if ((error = test_bihash_file_churn (tm, n_deleted)))
+	return error;
+      if (i == 1)
+	arena_next = alloc_arena_next (h);
+      else if (i == 2 && alloc_arena_next (h) != arena_next)
+	return clib_error_return (0, "arena grew from %lld to %lld on "
+				  "reattach", arena_next,
+				  alloc_arena_next (h));
+    }
+
+  /* The table is ours while mapped */
+  clib_memset (a, 0, sizeof (*a));
+  clib_memset (h2, 0, sizeof (*h2));
+  a->h = h2;
+  a->name = "test2";
+  a->nbuckets = tm->nbuckets;
+  a->memory_size = tm->hash_memory_size;
+  a->dont_add_to_all_bihash_list = 1;
+  error = BV (clib_bihash_init_file) (a, tm->file_path, &attached);
+  if (!error)
+    return clib_error_return (0, "second owner attached");
+  fformat (stdout, "second owner refused: %U\n", format_clib_error, error);
+  clib_error_free (error);
+
+  fformat (stdout, "%U", BV (format_bihash), h, 0);
+
+  /* A writer died holding a bucket lock, the table is discarded */
+  for (i = 0; i < h->nbuckets; i++)
+    if (h->buckets[i].as_u64)
+      {
+	h->buckets[i].lock = 1;
+	break;
+      }
+  test_bihash_file_crash (tm);
+  if ((error = test_bihash_file_attach (tm, tm->nbuckets, &attached)))
+    return error;
+  if (attached)
+    return clib_error_return (0, "attached to an inconsistent table");
+  kv.key = tm->keys[tm->nitems - 1];
+  if (BV (clib_bihash_search) (h, &kv, &kv) == 0)
+    return clib_error_return (0, "discarded table still has keys");
+  BV (clib_bihash_free) (h);
+
+  /* A differently sized table is not attached */
+  if ((error = test_bihash_file_attach (tm, tm->nbuckets * 2, &attached)))
+    return error;
+  if (attached)
+    return clib_error_return (0, "attached with a different bucket count");
+  BV (clib_bihash_free) (h);
+
+  unlink (tm->file_path);
+  fformat (stdout, "File backed table OK\n");
+  return 0;
+}
+#else
+static clib_error_t *
+test_bihash_file (test_main_t * tm)
+{
+  return clib_error_return (0, "file backed tables need the non-SVM layout");
+}
+#endif
+
 clib_error_t *
 test_bihash_main (test_main_t * tm)
 {
   unformat_input_t *i = tm->input;
   clib_error_t *error;
+  u8 *file_path = 0;
   int which = 0;
 
   tm->report_every_n = 1;
@@ -492,6 +895,17 @@ test_bihash_main (test_main_t * tm)
 	tm->verbose = 1;
       else if (unformat (i, "stale-overwrite"))
 	which = 3;
+      else if (unformat (i, "resize"))
+	which = 4;
+      else if (unformat (i, "search-multi"))
+	which = 5;
+      else if (unformat (i, "path %s", &file_path))
+	{
+	  vec_add1 (file_path, 0);
+	  tm->file_path = (char *) file_path;
+	}
+      else if (unformat (i, "file"))
+	which = 6;
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, i);
@@ -521,6 +935,20 @@ test_bihash_main (test_main_t * tm)
       error = test_bihash_stale_overwrite (tm);
       break;
 
+    case 4:
+      error = test_bihash_resize (tm);
+      break;
+
+    case 5:
+      error = test_bihash_search_multi (tm);
+      break;
+
+    case 6:
+      if (tm->file_path == 0)
+	tm->file_path = "/tmp/test_bihash_file";
+      error = test_bihash_file (tm);
+      break;
+
     default:
       return clib_error_return (0, "no such test?");
     }
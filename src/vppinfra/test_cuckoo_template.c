@@ -239,6 +239,68 @@ test_cuckoo (test_main_t * tm)
   return 0;
 }
 
+/* a second instantiation in the same translation unit */
+#include <vppinfra/cuckoo_16_8.h>
+#include <vppinfra/cuckoo_template.c>
+
+static clib_error_t *
+test_cuckoo_16_8 (test_main_t * tm)
+{
+  clib_cuckoo_16_8_t _h, *h = &_h;
+  clib_cuckoo_kv_16_8_t kv;
+  u32 i;
+
+  clib_memset (h, 0, sizeof (*h));
+  clib_cuckoo_init_16_8 (h, "test 16_8", tm->nbuckets, 0, 0);
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key[0] = tm->keys[i];
+      kv.key[1] = ~tm->keys[i];
+      kv.value = i;
+      clib_cuckoo_add_del_16_8 (h, &kv, 1 /* is_add */ );
+    }
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key[0] = tm->keys[i];
+      kv.key[1] = ~tm->keys[i];
+      if (clib_cuckoo_search_16_8 (h, &kv, &kv) != CLIB_CUCKOO_ERROR_SUCCESS
+	  || kv.value != i)
+	return clib_error_return (0, "16_8 search for key %lld failed",
+				  tm->keys[i]);
+      /* only the first key word matches */
+      kv.key[1] = tm->keys[i];
+      if (clib_cuckoo_search_16_8 (h, &kv, &kv) !=
+	  CLIB_CUCKOO_ERROR_NOT_FOUND)
+	return clib_error_return (0, "16_8 search for partial key %lld "
+				  "succeeded", tm->keys[i]);
+    }
+
+  for (i = 0; i < tm->nitems; i += 2)
+    {
+      kv.key[0] = tm->keys[i];
+      kv.key[1] = ~tm->keys[i];
+      clib_cuckoo_add_del_16_8 (h, &kv, 0 /* is_add */ );
+    }
+
+  for (i = 0; i < tm->nitems; i++)
+    {
+      kv.key[0] = tm->keys[i];
+      kv.key[1] = ~tm->keys[i];
+      if ((clib_cuckoo_search_16_8 (h, &kv, &kv) ==
+	   CLIB_CUCKOO_ERROR_SUCCESS) != (i & 1))
+	return clib_error_return (0, "16_8 search for key %lld after "
+				  "deletes failed", tm->keys[i]);
+    }
+
+  fformat (stdout, "16_8: %d items, %d deleted, OK\n", tm->nitems,
+	   (tm->nitems + 1) / 2);
+  clib_cuckoo_free_16_8 (h);
+
+  return 0;
+}
+
 clib_error_t *
 test_cuckoo_main (test_main_t * tm)
 {
@@ -270,6 +332,9 @@ test_cuckoo_main (test_main_t * tm)
 
   error = test_cuckoo (tm);
 
+  if (!error)
+    error = test_cuckoo_16_8 (tm);
+
   return error;
 }
 
@@ -41,6 +41,159 @@
 #include <vppinfra/random.h>
 #include <vppinfra/serialize.h>
 #include <vppinfra/unix.h>
+#include <pthread.h>
+
+typedef struct
+{
+  elog_main_t *em;
+  u32 thread_index;
+  u32 n_events;
+  elog_track_t track;
+} elog_test_thread_t;
+
+static void *
+elog_test_thread_fn (void *arg)
+{
+  elog_test_thread_t *tt = arg;
+  u32 i, *d;
+  ELOG_TYPE_DECLARE (e) =
+  {
+  .format = "seq %d",.format_args = "i4",};
+
+  os_set_thread_index (tt->thread_index);
+  clib_per_cpu_mheaps[tt->thread_index] = clib_per_cpu_mheaps[0];
+  for (i = 0; i < tt->n_events; i++)
+    {
+      d = ELOG_TRACK_DATA (tt->em, e, tt->track);
+      d[0] = i;
+    }
+  return 0;
+}
+
+/*
+ * Writers log a sequence number each into per-thread rings, while the
+ * main thread streams the rings out. Every event must be exported or
+ * counted as dropped, in order, and the import sorted by time.
+ */
+static clib_error_t *
+test_elog_threads (u32 n_threads, u32 n_events, u32 ring_size)
+{
+  elog_main_t _em, *em = &_em, _im, *im = &_im;
+  elog_test_thread_t *tts = 0, *tt;
+  elog_export_t _x = { 0 }, *x = &_x;
+  pthread_t *tids = 0;
+  u32 *next_seq = 0, *seq;
+  elog_event_t *e;
+  u8 *stream = 0;
+  clib_error_t *error = 0;
+  u32 i, n_running;
+  f64 t0;
+
+  elog_init (em, ring_size);
+  em->lock = clib_mem_alloc_aligned (CLIB_CACHE_LINE_BYTES,
+				     CLIB_CACHE_LINE_BYTES);
+  em->lock[0] = 0;
+  elog_alloc_thread_rings (em, n_threads + 1);
+  elog_enable_disable (em, 1);
+
+  vec_validate (tts, n_threads - 1);
+  vec_validate (tids, n_threads - 1);
+  vec_foreach (tt, tts)
+  {
+    tt->em = em;
+    tt->thread_index = 1 + tt - tts;
+    tt->n_events = n_events;
+    tt->track.name = (char *) format (0, "thread %d%c", tt->thread_index, 0);
+    elog_track_register (em, &tt->track);
+  }
+
+  t0 = unix_time_now ();
+  vec_foreach (tt, tts)
+    pthread_create (tids + (tt - tts), NULL, elog_test_thread_fn, tt);
+
+  /* Drain while the writers run */
+  do
+    {
+      n_running = 0;
+      vec_foreach (tt, tts)
+	n_running += em->thread_rings[tt->thread_index].n_total_events <
+	n_events;
+      stream = elog_export_chunk (em, x, stream);
+    }
+  while (n_running);
+
+  for (i = 0; i < n_threads; i++)
+    pthread_join (tids[i], 0);
+  t0 = unix_time_now () - t0;
+
+  /* The newest event of each ring is published by the next one */
+  vec_foreach (tt, tts)
+  {
+    ELOG_TYPE_DECLARE (e) =
+    {
+    .format = "done",.format_args = "",};
+    os_set_thread_index (tt->thread_index);
+    ELOG_TRACK_DATA (em, e, tt->track);
+  }
+  os_set_thread_index (0);
+  stream = elog_export_chunk (em, x, stream);
+
+  fformat (stdout, "%u threads logged %u events in %.3f ms, "
+	   "%lu exported, %lu dropped, %u byte stream\n", n_threads,
+	   n_threads * n_events, t0 * 1e3, x->n_events, x->n_dropped,
+	   vec_len (stream));
+
+  if (x->n_events + x->n_dropped != n_threads * n_events)
+    {
+      error = clib_error_return (0, "%lu events unaccounted for",
+				 n_threads * n_events - x->n_events -
+				 x->n_dropped);
+      goto done;
+    }
+
+  elog_init (im, 0);
+  if ((error = elog_import_chunks (im, stream, vec_len (stream))))
+    goto done;
+  if (vec_len (im->events) != x->n_events)
+    {
+      error = clib_error_return (0, "imported %u of %lu events",
+				 vec_len (im->events), x->n_events);
+      goto done;
+    }
+
+  vec_validate (next_seq, n_threads + 1);
+  vec_foreach (e, im->events)
+  {
+    if (e > im->events && e[-1].time > e->time)
+      {
+	error = clib_error_return (0, "events not sorted by time");
+	goto done;
+      }
+    seq = (u32 *) e->data;
+    if (seq[0] < next_seq[e->track])
+      {
+	error = clib_error_return (0, "%U: seq %u after %u",
+				   format_elog_track_name, im, e, seq[0],
+				   next_seq[e->track]);
+	goto done;
+      }
+    next_seq[e->track] = seq[0] + 1;
+  }
+
+  if (vec_len (im->tracks) != vec_len (em->tracks))
+    error = clib_error_return (0, "%u tracks imported, %u registered",
+			       vec_len (im->tracks), vec_len (em->tracks));
+  else
+    fformat (stdout, "PASS\n");
+
+done:
+  vec_free (next_seq);
+  vec_free (stream);
+  vec_free (tids);
+  vec_free (tts);
+  elog_export_free (x);
+  return error;
+}
 
 int
 test_elog_main (unformat_input_t * input)
@@ -54,6 +207,7 @@ test_elog_main (unformat_input_t * input)
   u8 *tag, **tags;
   f64 align_tweak;
   f64 *align_tweaks;
+  u32 n_threads = 0;
 
   n_iter = 100;
   max_events = 100000;
@@ -88,6 +242,8 @@ test_elog_main (unformat_input_t * input)
 	;
       else if (unformat (input, "align-tweak %f", &align_tweak))
 	vec_add1 (align_tweaks, align_tweak);
+      else if (unformat (input, "threads %d", &n_threads))
+	;
       else
 	{
 	  error = clib_error_create ("unknown input `%U'\n",
@@ -96,6 +252,12 @@ test_elog_main (unformat_input_t * input)
 	}
     }
 
+  if (n_threads)
+    {
+      error = test_elog_threads (n_threads, n_iter, max_events);
+      goto done;
+    }
+
 #ifdef CLIB_UNIX
   if (load_file)
     {
@@ -48,26 +48,68 @@ format_test1 (u8 * s, va_list * va)
   return format (s, "%12d %12f%12.4e", x, y, y);
 }
 
+static int
+check_result (const char *exp, char *fmt, char *how)
+{
+  int ret = 0;
+
+  vec_add1 (test_vec, 0);
+  if (strcmp (exp, (char *) test_vec))
+    {
+      fformat (stdout, "FAIL: %s%s (expected vs. result)\n\"%s\"\n\"%v\"\n",
+	       fmt, how, exp, test_vec);
+      ret = 1;
+    }
+  else if (verbose)
+    fformat (stdout, "PASS: %s%s\n", fmt, how);
+  vec_delete (test_vec, vec_len (test_vec), 0);
+  return ret;
+}
+
+static u8 *
+program_format (u8 * s, clib_format_program_t * p, ...)
+{
+  va_list va;
+  va_start (va, p);
+  s = va_format_program (s, p, &va);
+  va_end (va);
+  return s;
+}
+
 static int
 expectation (const char *exp, char *fmt, ...)
 {
+  clib_format_program_t *p;
+  u8 *blob = 0;
   int ret = 0;
 
   va_list va;
   va_start (va, fmt);
   test_vec = va_format (test_vec, fmt, &va);
   va_end (va);
+  ret |= check_result (exp, fmt, "");
 
-  vec_add1 (test_vec, 0);
-  if (strcmp (exp, (char *) test_vec))
+  /* compiled formats must give the same result */
+  p = clib_format_compile (fmt);
+  if (!p)
     {
-      fformat (stdout, "FAIL: %s (expected vs. result)\n\"%s\"\n\"%v\"\n",
-	       fmt, exp, test_vec);
-      ret = 1;
+      fformat (stdout, "FAIL: %s does not compile\n", fmt);
+      return 1;
     }
-  else if (verbose)
-    fformat (stdout, "PASS: %s\n", fmt);
-  vec_delete (test_vec, vec_len (test_vec), 0);
+
+  va_start (va, fmt);
+  test_vec = va_format_program (test_vec, p, &va);
+  va_end (va);
+  ret |= check_result (exp, fmt, " (compiled)");
+
+  va_start (va, fmt);
+  blob = clib_format_capture (blob, p, &va);
+  va_end (va);
+  test_vec = clib_format_replay (test_vec, p, blob);
+  ret |= check_result (exp, fmt, " (replayed)");
+
+  vec_free (blob);
+  clib_format_program_free (p);
   return ret;
 }
 
@@ -100,6 +142,30 @@ test_format_main (unformat_input_t * input)
   ret |= expectation ("foo", "%.*v", 3, food);
   ret |= expectation ("foobar", "%.*v%s", 3, food, "bar");
   ret |= expectation ("foo bar", "%S", "foo_bar");
+  ret |= expectation ("fo ba", "%.5S", "fo_bar");
+  ret |= expectation ("-1 ffffffff 18446744073709551615", "%d %x %Lu",
+		      -1, -1, (u64) ~ 0);
+  ret |= expectation ("[       foo] [0x1234]", "[%*s] [%p]", 10, "foo",
+		      (void *) 0x1234);
+  ret |= expectation ("100% of 3 trailing", "%d%% of %u trailing%", 100, 3);
+  if (clib_format_compile ("%k") != 0)
+    {
+      fformat (stdout, "FAIL: unknown conversion compiled\n");
+      ret = 1;
+    }
+
+  /* programs do not depend on the format string they were compiled from */
+  {
+    clib_format_program_t *p;
+    u8 *fmt = format (0, "literal %s %%d%c", "42", 0);
+
+    p = clib_format_compile ((char *) fmt);
+    clib_memset (fmt, 'x', vec_len (fmt) - 1);
+    vec_free (fmt);
+    test_vec = program_format (test_vec, p, 7);
+    ret |= check_result ("literal 42 7", "literal 42 %d", " (freed fmt)");
+    clib_format_program_free (p);
+  }
   vec_free (food);
   vec_free (test_vec);
   return ret;
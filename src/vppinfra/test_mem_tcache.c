@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <vppinfra/mem.h>
+#include <vppinfra/mheap.h>
+#include <vppinfra/vec.h>
+#include <vppinfra/random.h>
+#include <vppinfra/time.h>
+#include <vppinfra/format.h>
+#include <vppinfra/error.h>
+
+typedef struct
+{
+  u32 seed;
+  u32 n_objects;
+  u32 n_iter;
+  void **objects;
+} tcache_test_main_t;
+
+tcache_test_main_t tcache_test_main;
+
+static clib_error_t *
+test_size_classes (void)
+{
+  uword size, class;
+
+  for (size = 1; size <= CLIB_MEM_TCACHE_MAX_SIZE; size++)
+    {
+      class = clib_mem_tcache_class_for_size (size);
+      if (clib_mem_tcache_class_size (class) < size ||
+	  (class && clib_mem_tcache_class_size (class - 1) >= size))
+	return clib_error_return (0, "size %lu got class %lu", size, class);
+    }
+
+  for (size = CLIB_MEM_TCACHE_MIN_SIZE;
+       size <= 2 * CLIB_MEM_TCACHE_MAX_SIZE; size++)
+    {
+      class = clib_mem_tcache_class_for_object (size);
+      if (clib_mem_tcache_class_size (class) > size ||
+	  (class < CLIB_MEM_TCACHE_N_CLASSES - 1 &&
+	   clib_mem_tcache_class_size (class + 1) <= size))
+	return clib_error_return (0, "object size %lu got class %lu", size,
+				  class);
+    }
+
+  return 0;
+}
+
+static void
+fill (u8 * p, uword size, u8 v)
+{
+  clib_memset (p, v, size);
+}
+
+static int
+check (u8 * p, uword size, u8 v)
+{
+  uword i;
+  for (i = 0; i < size; i++)
+    if (p[i] != v)
+      return 0;
+  return 1;
+}
+
+/* random mix of allocations, frees and vector growth */
+static clib_error_t *
+test_churn (tcache_test_main_t * tm)
+{
+  uword *sizes = 0;
+  u8 **vecs = 0;
+  u32 i, j;
+
+  vec_validate (tm->objects, tm->n_objects - 1);
+  vec_validate (sizes, tm->n_objects - 1);
+  vec_validate (vecs, 63);
+
+  for (i = 0; i < tm->n_iter; i++)
+    {
+      j = random_u32 (&tm->seed) % tm->n_objects;
+      if (tm->objects[j])
+	{
+	  if (!check (tm->objects[j], sizes[j], j))
+	    return clib_error_return (0, "object %u corrupted", j);
+	  clib_mem_free (tm->objects[j]);
+	  tm->objects[j] = 0;
+	}
+      else
+	{
+	  sizes[j] = 1 + random_u32 (&tm->seed) % 1500;
+	  /* some aligned allocations, which bypass the cache */
+	  if ((i & 7) == 0)
+	    tm->objects[j] = clib_mem_alloc_aligned (sizes[j], 64);
+	  else
+	    tm->objects[j] = clib_mem_alloc (sizes[j]);
+	  if (clib_mem_size (tm->objects[j]) < sizes[j])
+	    return clib_error_return (0, "object %u too small", j);
+	  fill (tm->objects[j], sizes[j], j);
+	}
+
+      j = i & 63;
+      vec_add1 (vecs[j], i);
+      if (vec_len (vecs[j]) > 700)
+	{
+	  if (vecs[j][699] != (u8) (vecs[j][0] + 699 * 64))
+	    return clib_error_return (0, "vector %u corrupted", j);
+	  vec_free (vecs[j]);
+	}
+    }
+
+  for (i = 0; i < tm->n_objects; i++)
+    if (tm->objects[i])
+      {
+	clib_mem_free (tm->objects[i]);
+	tm->objects[i] = 0;
+      }
+  for (i = 0; i < 64; i++)
+    vec_free (vecs[i]);
+  vec_free (vecs);
+  vec_free (sizes);
+  return 0;
+}
+
+static void *
+test_remote_alloc_thread (void *arg)
+{
+  tcache_test_main_t *tm = &tcache_test_main;
+  u32 i;
+
+  os_set_thread_index (1);
+  clib_per_cpu_mheaps[1] = clib_per_cpu_mheaps[0];
+  clib_mem_tcache_enable ();
+
+  for (i = 0; i < tm->n_objects; i++)
+    {
+      tm->objects[i] = clib_mem_alloc (64 + i % 200);
+      fill (tm->objects[i], 64 + i % 200, i);
+    }
+
+  clib_mem_tcache_disable ();
+  return 0;
+}
+
+/* objects allocated on one thread, freed into another's cache */
+static clib_error_t *
+test_remote_free (tcache_test_main_t * tm)
+{
+  pthread_t tid;
+  u32 i;
+
+  if (pthread_create (&tid, NULL, test_remote_alloc_thread, 0))
+    return clib_error_return_unix (0, "pthread_create");
+  pthread_join (tid, 0);
+
+  for (i = 0; i < tm->n_objects; i++)
+    {
+      if (!check (tm->objects[i], 64 + i % 200, i))
+	return clib_error_return (0, "remote object %u corrupted", i);
+      clib_mem_free (tm->objects[i]);
+      tm->objects[i] = 0;
+    }
+  return 0;
+}
+
+static f64
+time_alloc_free (tcache_test_main_t * tm)
+{
+  f64 before = unix_time_now ();
+  u32 i, j;
+
+  for (j = 0; j < 100; j++)
+    {
+      for (i = 0; i < 32; i++)
+	tm->objects[i] = clib_mem_alloc (16 + 24 * i);
+      for (i = 0; i < 32; i++)
+	clib_mem_free (tm->objects[i]);
+    }
+  return (unix_time_now () - before) / (100 * 32);
+}
+
+static clib_error_t *
+test_mem_tcache (tcache_test_main_t * tm)
+{
+  clib_mem_tcache_t *tc;
+  clib_mem_usage_t u0, u1;
+  clib_error_t *error;
+  f64 t_heap, t_cache;
+  u64 hits, frees_cached;
+  void *p;
+
+  if ((error = test_size_classes ()))
+    return error;
+
+  mheap_usage (clib_mem_get_heap (), &u0);
+  clib_mem_tcache_enable ();
+  tc = clib_mem_tcaches[0];
+
+  if ((error = test_churn (tm)))
+    return error;
+  if (tc->hits == 0 || tc->frees_cached == 0)
+    return clib_error_return (0, "cache not used");
+  fformat (stdout, "churn: %U\n", format_clib_mem_tcache, tc);
+
+  if ((error = test_remote_free (tm)))
+    return error;
+  fformat (stdout, "remote free: %U\n", format_clib_mem_tcache, tc);
+
+  /* a traced heap sees every allocation */
+  clib_mem_trace (1);
+  hits = tc->hits;
+  frees_cached = tc->frees_cached;
+  p = clib_mem_alloc (100);
+  clib_mem_free (p);
+  if (!tc->bypass || tc->hits != hits || tc->frees_cached != frees_cached)
+    return clib_error_return (0, "trace does not bypass the cache");
+  clib_mem_trace (0);
+  if (tc->bypass)
+    return clib_error_return (0, "cache still bypassed");
+
+  t_cache = time_alloc_free (tm);
+  clib_mem_tcache_disable ();
+  t_heap = time_alloc_free (tm);
+  fformat (stdout, "alloc + free: heap %.2f ns, cache %.2f ns\n",
+	   t_heap * 1e9, t_cache * 1e9);
+
+  /* everything went back to the heap */
+  vec_free (tm->objects);
+  mheap_usage (clib_mem_get_heap (), &u1);
+  if (u1.bytes_used > u0.bytes_used)
+    return clib_error_return (0, "%lu bytes leaked",
+			      u1.bytes_used - u0.bytes_used);
+
+  fformat (stdout, "PASS\n");
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  tcache_test_main_t *tm = &tcache_test_main;
+  unformat_input_t _i, *i = &_i;
+  clib_error_t *error;
+
+  clib_mem_init (0, 1ULL << 30);
+
+  tm->seed = 0xdeadbeef;
+  tm->n_objects = 10000;
+  tm->n_iter = 1000000;
+
+  unformat_init_command_line (i, argv);
+  while (unformat_check_input (i) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (i, "seed %u", &tm->seed))
+	;
+      else if (unformat (i, "objects %u", &tm->n_objects))
+	;
+      else if (unformat (i, "iter %u", &tm->n_iter))
+	;
+      else
+	{
+	  clib_warning ("unknown input '%U'", format_unformat_error, i);
+	  return 1;
+	}
+    }
+  unformat_free (i);
+
+  if ((error = test_mem_tcache (tm)))
+    {
+      clib_error_report (error);
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
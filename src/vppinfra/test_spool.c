@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <vppinfra/spool.h>
+#include <vppinfra/pool.h>
+#include <vppinfra/time.h>
+#include <vppinfra/error.h>
+
+typedef struct
+{
+  u32 thread_index;
+  u32 seq;
+  u64 pad[5];
+} spool_test_elt_t;
+
+typedef struct
+{
+  u32 thread_index;
+  u32 *indices;
+  spool_test_elt_t **elts;
+  u32 n_errors;
+} spool_test_thread_t;
+
+typedef struct
+{
+  clib_spool_t spool;
+  spool_test_thread_t *threads;
+  u32 n_threads;
+  u32 n_elts;
+  u32 phase;
+} spool_test_main_t;
+
+spool_test_main_t spool_test_main;
+
+static void *
+spool_test_thread_fn (void *arg)
+{
+  spool_test_main_t *tm = &spool_test_main;
+  spool_test_thread_t *tt = arg, *peer;
+  spool_test_elt_t *e;
+  u32 i, index;
+
+  /* thread 0 is main, test threads take the next indices */
+  tt->thread_index = 1 + (tt - tm->threads);
+  os_set_thread_index (tt->thread_index);
+  clib_per_cpu_mheaps[tt->thread_index] = clib_per_cpu_mheaps[0];
+
+  if (tm->phase == 0)
+    {
+      /* allocate, the pool grows under us while other threads allocate */
+      for (i = 0; i < tm->n_elts; i++)
+	{
+	  e = clib_spool_get (&tm->spool, &index);
+	  if (e == 0)
+	    {
+	      tt->n_errors++;
+	      break;
+	    }
+	  e->thread_index = tt - tm->threads;
+	  e->seq = i;
+	  vec_add1 (tt->indices, index);
+	  vec_add1 (tt->elts, e);
+	}
+
+      /* addresses are stable and nobody else got our elements */
+      for (i = 0; i < vec_len (tt->indices); i++)
+	{
+	  e = clib_spool_elt_at_index (&tm->spool, tt->indices[i]);
+	  if (e != tt->elts[i] || e->thread_index != tt - tm->threads
+	      || e->seq != i)
+	    tt->n_errors++;
+	}
+    }
+  else
+    {
+      /* free the elements allocated by the next thread */
+      peer = tm->threads + ((tt - tm->threads) + 1) % tm->n_threads;
+      for (i = 0; i < vec_len (peer->indices); i++)
+	clib_spool_put_index (&tm->spool, peer->indices[i]);
+    }
+
+  return 0;
+}
+
+static void
+spool_test_run_threads (spool_test_main_t * tm)
+{
+  pthread_t *tids = 0;
+  u32 i;
+
+  vec_validate (tids, tm->n_threads - 1);
+  for (i = 0; i < tm->n_threads; i++)
+    if (pthread_create (tids + i, NULL, spool_test_thread_fn,
+			tm->threads + i))
+      clib_unix_warning ("pthread_create");
+  for (i = 0; i < tm->n_threads; i++)
+    pthread_join (tids[i], 0);
+  vec_free (tids);
+}
+
+static clib_error_t *
+spool_test_perf (spool_test_main_t * tm)
+{
+  spool_test_elt_t *pool = 0, *e;
+  clib_spool_t _sp, *sp = &_sp;
+  u32 i, j, *indices = 0, n = tm->n_elts;
+  f64 before, t_pool, t_spool;
+
+  vec_validate (indices, n - 1);
+
+  before = unix_time_now ();
+  for (j = 0; j < 10; j++)
+    {
+      for (i = 0; i < n; i++)
+	{
+	  pool_get (pool, e);
+	  indices[i] = e - pool;
+	}
+      for (i = 0; i < n; i++)
+	pool_put_index (pool, indices[i]);
+    }
+  t_pool = unix_time_now () - before;
+
+  clib_spool_init (sp, "perf", sizeof (spool_test_elt_t), 0, n, 1);
+  before = unix_time_now ();
+  for (j = 0; j < 10; j++)
+    {
+      for (i = 0; i < n; i++)
+	clib_spool_get (sp, indices + i);
+      for (i = 0; i < n; i++)
+	clib_spool_put_index (sp, indices[i]);
+    }
+  t_spool = unix_time_now () - before;
+
+  fformat (stdout, "get + put: pool %.2f ns, spool %.2f ns\n",
+	   t_pool * 1e9 / (10.0 * n), t_spool * 1e9 / (10.0 * n));
+
+  clib_spool_free (sp);
+  pool_free (pool);
+  vec_free (indices);
+  return 0;
+}
+
+static clib_error_t *
+spool_test_full (void)
+{
+  clib_spool_t _sp, *sp = &_sp;
+  u32 i, index;
+
+  clib_spool_init (sp, "full", sizeof (spool_test_elt_t), 0, 100, 1);
+  for (i = 0; i < 100; i++)
+    if (clib_spool_get (sp, &index) == 0 || index != i)
+      return clib_error_return (0, "get %u failed", i);
+  if (clib_spool_get (sp, &index))
+    return clib_error_return (0, "full pool handed out index %u", index);
+
+  clib_spool_put_index (sp, 42);
+  if (clib_spool_get (sp, &index) == 0 || index != 42)
+    return clib_error_return (0, "freed index not reused");
+
+  clib_spool_free (sp);
+  return 0;
+}
+
+static clib_error_t *
+spool_test (spool_test_main_t * tm)
+{
+  clib_spool_t *sp = &tm->spool;
+  spool_test_thread_t *tt;
+  clib_error_t *error;
+  u32 i, n_segments, n_found = 0, n_errors = 0;
+
+  if ((error = spool_test_full ()))
+    return error;
+
+  vec_validate (tm->threads, tm->n_threads - 1);
+
+  /* other threads may hold up to a batch of free indices each */
+  clib_spool_init (sp, "test", sizeof (spool_test_elt_t), 0,
+		   tm->n_threads * (tm->n_elts + CLIB_SPOOL_BATCH),
+		   tm->n_threads + 1);
+
+  tm->phase = 0;
+  spool_test_run_threads (tm);
+
+  vec_foreach (tt, tm->threads) n_errors += tt->n_errors;
+  if (n_errors)
+    return clib_error_return (0, "%u element errors", n_errors);
+
+  if (clib_spool_elts (sp) != tm->n_threads * tm->n_elts)
+    return clib_error_return (0, "%lu elts in use, expected %u",
+			      clib_spool_elts (sp),
+			      tm->n_threads * tm->n_elts);
+
+  /* *INDENT-OFF* */
+  clib_spool_foreach_index (i, sp,
+  ({
+    n_found++;
+  }));
+  /* *INDENT-ON* */
+  if (n_found != tm->n_threads * tm->n_elts)
+    return clib_error_return (0, "foreach found %u elts", n_found);
+
+  fformat (stdout, "%U\n", format_clib_spool, sp, 1 /* verbose */ );
+
+  /* free everything from a different thread than the allocating one */
+  tm->phase = 1;
+  spool_test_run_threads (tm);
+
+  if (clib_spool_elts (sp) != 0)
+    return clib_error_return (0, "%lu elts in use after free",
+			      clib_spool_elts (sp));
+  for (i = 0; i < sp->max_elts; i++)
+    if (!clib_spool_is_free_index (sp, i))
+      return clib_error_return (0, "index %u not free", i);
+
+  /* reallocating reuses freed elements, the pool does not grow */
+  n_segments = sp->n_segments;
+  vec_foreach (tt, tm->threads)
+  {
+    vec_reset_length (tt->indices);
+    vec_reset_length (tt->elts);
+  }
+  tm->phase = 0;
+  spool_test_run_threads (tm);
+
+  vec_foreach (tt, tm->threads) n_errors += tt->n_errors;
+  if (n_errors)
+    return clib_error_return (0, "%u element errors on reuse", n_errors);
+  if (sp->n_segments != n_segments)
+    return clib_error_return (0, "pool grew from %u to %u segments",
+			      n_segments, sp->n_segments);
+
+  fformat (stdout, "%U\n", format_clib_spool, sp, 1 /* verbose */ );
+
+  vec_foreach (tt, tm->threads)
+  {
+    vec_free (tt->indices);
+    vec_free (tt->elts);
+  }
+  vec_free (tm->threads);
+  clib_spool_free (sp);
+  fformat (stdout, "PASS\n");
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  spool_test_main_t *tm = &spool_test_main;
+  unformat_input_t _i, *i = &_i;
+  clib_error_t *error;
+  int perf = 0;
+
+  clib_mem_init (0, 1ULL << 30);
+
+  tm->n_threads = 4;
+  tm->n_elts = 100000;
+
+  unformat_init_command_line (i, argv);
+  while (unformat_check_input (i) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (i, "threads %u", &tm->n_threads))
+	;
+      else if (unformat (i, "elts %u", &tm->n_elts))
+	;
+      else if (unformat (i, "perf"))
+	perf = 1;
+      else
+	{
+	  clib_warning ("unknown input '%U'", format_unformat_error, i);
+	  return 1;
+	}
+    }
+  unformat_free (i);
+
+  error = perf ? spool_test_perf (tm) : spool_test (tm);
+  if (error)
+    {
+      clib_error_report (error);
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Correctness checks and cycles per call of the vector string primitives.
+ * Built once with the default flags and once per CPU variant, e.g.
+ * test_string_funcs_avx512, so each implementation can be compared.
+ */
+
+#include <sys/mman.h>
+#include <vppinfra/string.h>
+#include <vppinfra/cpu.h>
+#include <vppinfra/time.h>
+#include <vppinfra/format.h>
+#include <vppinfra/error.h>
+
+#define GUARD 64
+#define MAX_BYTES 2048
+
+typedef struct
+{
+  u8 *src, *dst;
+  u32 n_iter;
+} string_test_main_t;
+
+string_test_main_t string_test_main;
+
+static clib_error_t *
+check_guard (u8 * p, uword len, u8 v)
+{
+  uword i;
+
+  for (i = 0; i < GUARD; i++)
+    if (p[-1 - i] != v || p[len + i] != v)
+      return clib_error_return (0, "write outside of %lu bytes", len);
+  return 0;
+}
+
+static clib_error_t *
+test_memcpy (string_test_main_t * tm)
+{
+  clib_error_t *error;
+  uword n, off, i;
+
+  for (off = 0; off < 64; off += 7)
+    for (n = 0; n <= MAX_BYTES; n += (n < 300 ? 1 : 61))
+      {
+	u8 *src = tm->src + GUARD + off, *dst = tm->dst + GUARD + 64 - off;
+	clib_memset (tm->dst, 0xaa, 2 * GUARD + 64 + MAX_BYTES);
+	for (i = 0; i < n; i++)
+	  src[i] = i + off;
+
+	clib_memcpy_fast (dst, src, n);
+
+	if (memcmp (dst, src, n))
+	  return clib_error_return (0, "memcpy %lu bytes offset %lu", n, off);
+	if ((error = check_guard (dst, n, 0xaa)))
+	  return error;
+      }
+
+  /* constant sizes take a different path */
+#define _(n)								\
+  clib_memset (tm->dst, 0xaa, 2 * GUARD + n);				\
+  clib_memcpy_fast (tm->dst + GUARD, tm->src, n);			\
+  if (memcmp (tm->dst + GUARD, tm->src, n))				\
+    return clib_error_return (0, "memcpy constant %u bytes", n);	\
+  if ((error = check_guard (tm->dst + GUARD, n, 0xaa)))			\
+    return error;
+  _(1) _(3) _(8) _(14) _(16) _(33) _(64) _(100) _(128) _(256)
+#undef _
+    return 0;
+}
+
+#define foreach_memset_test _(8) _(16) _(32) _(64)
+
+#define _(b)								\
+static clib_error_t *							\
+test_memset_u##b (string_test_main_t * tm)				\
+{									\
+  u##b *p = (u##b *) (tm->dst + GUARD), val = (u##b) 0x0123456789abcdefULL; \
+  clib_error_t *error;							\
+  uword n, i;								\
+									\
+  for (n = 0; n <= MAX_BYTES / (b / 8); n += (n < 200 ? 1 : 37))	\
+    {									\
+      clib_memset (tm->dst, 0xaa, 2 * GUARD + MAX_BYTES);		\
+      clib_memset_u##b (p, val, n);					\
+      for (i = 0; i < n; i++)						\
+	if (p[i] != val)						\
+	  return clib_error_return (0, "memset_u%u %lu elts", b, n);	\
+      if ((error = check_guard ((u8 *) p, n * (b / 8), 0xaa)))		\
+	return error;							\
+    }									\
+  return 0;								\
+}									\
+									\
+static clib_error_t *							\
+test_count_equal_u##b (string_test_main_t * tm, u8 * page_end)		\
+{									\
+  u##b *p = (u##b *) (tm->dst);						\
+  uword n, len, r;							\
+									\
+  for (len = 1; len <= 256; len++)					\
+    for (n = 1; n <= len; n++)						\
+      {									\
+	clib_memset (p, 0x11, len * (b / 8));				\
+	if (n < len)							\
+	  p[n] = 0x22;							\
+	r = clib_count_equal_u##b (p, len);				\
+	if (r != n)							\
+	  return clib_error_return (0, "count_equal_u%u %lu of %lu "	\
+				    "returned %lu", b, n, len, r);	\
+      }									\
+									\
+  /* data ending at an unmapped page, the masked tail must not fault */ \
+  if (page_end)								\
+    for (len = 1; len <= 200; len++)					\
+      {									\
+	p = (u##b *) page_end - len;					\
+	clib_memset (p, 0x11, len * (b / 8));				\
+	if (clib_count_equal_u##b (p, len) != len)			\
+	  return clib_error_return (0, "count_equal_u%u at page end", b); \
+      }									\
+  return 0;								\
+}
+foreach_memset_test
+#undef _
+
+static u8 *
+guarded_page_end (void)
+{
+#if defined(CLIB_HAVE_VEC512_MASK_LOAD_STORE)
+  uword page_size = clib_mem_get_page_size ();
+  u8 *p = mmap (0, 2 * page_size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (p == MAP_FAILED || mprotect (p + page_size, page_size, PROT_NONE))
+    return 0;
+  return p + page_size;
+#else
+  /* the non masked implementations may read a vector past the end */
+  return 0;
+#endif
+}
+
+static f64
+cycles_per_call (u64 t0, u64 t1, u32 n_iter)
+{
+  return (f64) (t1 - t0) / n_iter;
+}
+
+/* sizes are loaded through a volatile so the compiler cannot specialize */
+static void
+perf_memcpy (string_test_main_t * tm)
+{
+  static uword sizes[] = { 1, 8, 15, 16, 31, 32, 48, 63, 64, 100, 128, 200,
+    256, 512, 1024, 1500, 2048
+  };
+  volatile uword vn;
+  uword i, j, n;
+  u64 t0, t1;
+
+  fformat (stdout, "\nclib_memcpy_fast, variable size\n");
+  for (i = 0; i < ARRAY_LEN (sizes); i++)
+    {
+      vn = sizes[i];
+      n = vn;
+      t0 = clib_cpu_time_now ();
+      for (j = 0; j < tm->n_iter; j++)
+	{
+	  clib_memcpy_fast (tm->dst + (j & 7), tm->src, n);
+	  asm volatile ("":::"memory");
+	}
+      t1 = clib_cpu_time_now ();
+      fformat (stdout, "  %5lu bytes %8.2f cycles/call\n", n,
+	       cycles_per_call (t0, t1, tm->n_iter));
+    }
+
+  fformat (stdout, "clib_memcpy_fast, constant size\n");
+#define _(n)								\
+  t0 = clib_cpu_time_now ();						\
+  for (j = 0; j < tm->n_iter; j++)					\
+    {									\
+      clib_memcpy_fast (tm->dst + (j & 7), tm->src, n);			\
+      asm volatile ("":::"memory");						\
+    }									\
+  t1 = clib_cpu_time_now ();						\
+  fformat (stdout, "  %5u bytes %8.2f cycles/call\n", n,		\
+	   cycles_per_call (t0, t1, tm->n_iter));
+  _(8) _(16) _(40) _(64) _(128)
+#undef _
+}
+
+#define _(b)								\
+static void								\
+perf_memset_u##b (string_test_main_t * tm)				\
+{									\
+  static uword counts[] = { 1, 3, 7, 15, 16, 31, 64, 100, 256 };	\
+  volatile uword vn;							\
+  uword i, j, n;							\
+  u64 t0, t1;								\
+									\
+  fformat (stdout, "clib_memset_u%u\n", b);				\
+  for (i = 0; i < ARRAY_LEN (counts); i++)				\
+    {									\
+      vn = counts[i];							\
+      n = vn;								\
+      t0 = clib_cpu_time_now ();					\
+      for (j = 0; j < tm->n_iter; j++)					\
+	{								\
+	  clib_memset_u##b (tm->dst, j, n);				\
+	  asm volatile ("":::"memory");					\
+	}								\
+      t1 = clib_cpu_time_now ();					\
+      fformat (stdout, "  %5lu elts %8.2f cycles/call\n", n,		\
+	       cycles_per_call (t0, t1, tm->n_iter));			\
+    }									\
+}									\
+									\
+static void								\
+perf_count_equal_u##b (string_test_main_t * tm)			\
+{									\
+  static uword counts[] = { 2, 3, 7, 15, 16, 31, 64, 100, 256 };	\
+  volatile uword vn;							\
+  u##b *p = (u##b *) tm->src;						\
+  uword i, j, n, r = 0;							\
+  u64 t0, t1;								\
+									\
+  clib_memset (p, 0, 256 * sizeof (p[0]));				\
+  fformat (stdout, "clib_count_equal_u%u\n", b);			\
+  for (i = 0; i < ARRAY_LEN (counts); i++)				\
+    {									\
+      vn = counts[i];							\
+      n = vn;								\
+      t0 = clib_cpu_time_now ();					\
+      for (j = 0; j < tm->n_iter; j++)					\
+	{								\
+	  r += clib_count_equal_u##b (p, n);				\
+	  asm volatile ("":::"memory");					\
+	}								\
+      t1 = clib_cpu_time_now ();					\
+      fformat (stdout, "  %5lu elts %8.2f cycles/call\n", n,		\
+	       cycles_per_call (t0, t1, tm->n_iter));			\
+    }									\
+  if (r != (uword) tm->n_iter * (2 + 3 + 7 + 15 + 16 + 31 + 64 + 100 + 256)) \
+    fformat (stdout, "  unexpected result %lu\n", r);			\
+}
+foreach_memset_test
+#undef _
+
+static clib_error_t *
+test_string_funcs (string_test_main_t * tm, int perf)
+{
+  clib_error_t *error;
+  u8 *page_end;
+  uword i;
+
+#if defined(__AVX512F__)
+  if (!clib_cpu_supports_avx512f ())
+    {
+      fformat (stdout, "SKIP: cpu does not support avx512\n");
+      return 0;
+    }
+#elif defined(__AVX2__)
+  if (!clib_cpu_supports_avx2 ())
+    {
+      fformat (stdout, "SKIP: cpu does not support avx2\n");
+      return 0;
+    }
+#endif
+
+  tm->src = clib_mem_alloc_aligned (2 * GUARD + 64 + MAX_BYTES,
+				    CLIB_CACHE_LINE_BYTES);
+  tm->dst = clib_mem_alloc_aligned (2 * GUARD + 64 + MAX_BYTES,
+				    CLIB_CACHE_LINE_BYTES);
+  for (i = 0; i < 2 * GUARD + 64 + MAX_BYTES; i++)
+    tm->src[i] = i;
+
+  page_end = guarded_page_end ();
+
+  if ((error = test_memcpy (tm)))
+    return error;
+#define _(b)								\
+  if ((error = test_memset_u##b (tm)))					\
+    return error;							\
+  if ((error = test_count_equal_u##b (tm, page_end)))			\
+    return error;
+  foreach_memset_test
+#undef _
+    fformat (stdout, "PASS%s\n",
+	     page_end ? ", including masked reads at a page end" : "");
+
+  if (perf)
+    {
+      perf_memcpy (tm);
+#define _(b) perf_memset_u##b (tm);
+      foreach_memset_test
+#undef _
+#define _(b) perf_count_equal_u##b (tm);
+	foreach_memset_test
+#undef _
+    }
+
+  clib_mem_free (tm->src);
+  clib_mem_free (tm->dst);
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  string_test_main_t *tm = &string_test_main;
+  unformat_input_t _i, *i = &_i;
+  clib_error_t *error;
+  int perf = 0;
+
+  clib_mem_init (0, 64ULL << 20);
+
+  tm->n_iter = 1000000;
+
+  unformat_init_command_line (i, argv);
+  while (unformat_check_input (i) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (i, "iter %u", &tm->n_iter))
+	;
+      else if (unformat (i, "perf"))
+	perf = 1;
+      else
+	{
+	  clib_warning ("unknown input '%U'", format_unformat_error, i);
+	  return 1;
+	}
+    }
+  unformat_free (i);
+
+  if ((error = test_string_funcs (tm, perf)))
+    {
+      clib_error_report (error);
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
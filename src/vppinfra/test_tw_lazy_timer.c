@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vppinfra/time.h>
+#include <vppinfra/cache.h>
+#include <vppinfra/error.h>
+#include <vppinfra/random.h>
+#include <vppinfra/tw_timer_16t_2w_512sl.h>
+#include <vppinfra/tw_lazy_16t_2w_512sl.h>
+
+typedef struct
+{
+  /** Handle returned from tw_lazy_timer_start */
+  u32 stop_timer_handle;
+
+  /** Test item should expire at this clock tick */
+  u64 expected_to_expire;
+} tw_lazy_test_elt_t;
+
+typedef struct
+{
+  /** Pool of test objects */
+  tw_lazy_test_elt_t *test_elts;
+
+  /** The lazy wheel */
+  tw_lazy_timer_wheel_16t_2w_512sl_t lazy_wheel;
+
+  /** The regular wheel, for comparison */
+  tw_timer_wheel_16t_2w_512sl_t double_wheel;
+
+  /** random number seed */
+  u32 seed;
+
+  /** number of timers */
+  u32 ntimers;
+
+  /** number of "churn" iterations */
+  u32 niter;
+
+  /** number of clock ticks per churn iteration */
+  u32 ticks_per_iter;
+
+  /** longest timer interval */
+  u32 max_interval;
+
+  /** expirations seen, and expirations at the wrong tick */
+  u64 n_expired;
+  u64 n_errors;
+} tw_lazy_test_main_t;
+
+tw_lazy_test_main_t tw_lazy_test_main;
+
+static void
+expired_timer_lazy_callback (u32 * expired_timers)
+{
+  tw_lazy_test_main_t *tm = &tw_lazy_test_main;
+  tw_lazy_test_elt_t *e;
+  u32 i, pool_index;
+
+  for (i = 0; i < vec_len (expired_timers); i++)
+    {
+      pool_index = expired_timers[i] & 0x0FFFFFFF;
+      e = pool_elt_at_index (tm->test_elts, pool_index);
+
+      /* The callback runs before the tick is accounted */
+      if (e->expected_to_expire != tm->lazy_wheel.current_tick)
+	{
+	  if (tm->n_errors++ < 10)
+	    fformat (stdout, "[%d] expired at %lld not %lld\n", pool_index,
+		     tm->lazy_wheel.current_tick, e->expected_to_expire);
+	}
+      tm->n_expired++;
+      pool_put (tm->test_elts, e);
+    }
+}
+
+static void
+expired_timer_double_callback (u32 * expired_timers)
+{
+  tw_lazy_test_main_t *tm = &tw_lazy_test_main;
+  tm->n_expired += vec_len (expired_timers);
+}
+
+static void
+run_lazy_wheel (tw_lazy_timer_wheel_16t_2w_512sl_t * tw, u32 n_ticks)
+{
+  u32 i;
+  f64 now = tw->last_run_time + 1.01;
+
+  for (i = 0; i < n_ticks; i++)
+    {
+      tw_lazy_timer_expire_timers_16t_2w_512sl (tw, now);
+      now += 1.01;
+    }
+}
+
+static void
+run_double_wheel (tw_timer_wheel_16t_2w_512sl_t * tw, u32 n_ticks)
+{
+  u32 i;
+  f64 now = tw->last_run_time + 1.01;
+
+  for (i = 0; i < n_ticks; i++)
+    {
+      tw_timer_expire_timers_16t_2w_512sl (tw, now);
+      now += 1.01;
+    }
+}
+
+static u64
+random_interval (tw_lazy_test_main_t * tm)
+{
+  return 1 + random_u32 (&tm->seed) % tm->max_interval;
+}
+
+static void
+start_one (tw_lazy_test_main_t * tm)
+{
+  tw_lazy_timer_wheel_16t_2w_512sl_t *tw = &tm->lazy_wheel;
+  tw_lazy_test_elt_t *e;
+  u64 interval = random_interval (tm);
+
+  pool_get (tm->test_elts, e);
+  e->expected_to_expire = tw->current_tick + interval;
+  e->stop_timer_handle =
+    tw_lazy_timer_start_16t_2w_512sl (tw, e - tm->test_elts,
+				      random_u32 (&tm->seed) & 15, interval);
+}
+
+static clib_error_t *
+test_correctness (tw_lazy_test_main_t * tm)
+{
+  tw_lazy_timer_wheel_16t_2w_512sl_t *tw = &tm->lazy_wheel;
+  tw_lazy_test_elt_t *e;
+  u32 i, j, *indices = 0;
+  u64 interval, n_stopped = 0, n_started = 0;
+
+  tw_lazy_timer_wheel_init_16t_2w_512sl (tw, expired_timer_lazy_callback,
+					 1.0 /* timer interval */ , ~0);
+
+  for (i = 0; i < tm->ntimers; i++)
+    start_one (tm);
+  n_started = tm->ntimers;
+
+  for (i = 0; i < tm->niter; i++)
+    {
+      vec_reset_length (indices);
+      /* *INDENT-OFF* */
+      pool_foreach (e, tm->test_elts,
+      ({
+        if (random_u32 (&tm->seed) & 3)
+          continue;
+        vec_add1 (indices, e - tm->test_elts);
+      }));
+      /* *INDENT-ON* */
+
+      for (j = 0; j < vec_len (indices); j++)
+	{
+	  e = pool_elt_at_index (tm->test_elts, indices[j]);
+	  switch (random_u32 (&tm->seed) % 4)
+	    {
+	    case 0:
+	      /* stop */
+	      tw_lazy_timer_stop_16t_2w_512sl (tw, e->stop_timer_handle);
+	      pool_put (tm->test_elts, e);
+	      n_stopped++;
+	      break;
+	    case 1:
+	      /* stop and restart */
+	      tw_lazy_timer_stop_16t_2w_512sl (tw, e->stop_timer_handle);
+	      pool_put (tm->test_elts, e);
+	      n_stopped++;
+	      start_one (tm);
+	      n_started++;
+	      break;
+	    default:
+	      /* update, moving the expiration later or earlier */
+	      interval = random_interval (tm);
+	      e->expected_to_expire = tw->current_tick + interval;
+	      tw_lazy_timer_update_16t_2w_512sl (tw, e->stop_timer_handle,
+						 interval);
+	      break;
+	    }
+	}
+
+      run_lazy_wheel (tw, tm->ticks_per_iter);
+    }
+
+  /* Drain the wheel */
+  run_lazy_wheel (tw, tm->max_interval + 1);
+
+  fformat (stdout, "started %lld stopped %lld expired %lld, "
+	   "relinked %lld reaped %lld\n", n_started, n_stopped,
+	   tm->n_expired, tw->n_relinked, tw->n_stopped_reaped);
+
+  if (tm->n_errors)
+    return clib_error_return (0, "%lld timers expired at the wrong tick",
+			      tm->n_errors);
+  if (pool_elts (tm->test_elts))
+    return clib_error_return (0, "%d timers never expired",
+			      pool_elts (tm->test_elts));
+  if (n_started != n_stopped + tm->n_expired)
+    return clib_error_return (0, "started != stopped + expired");
+  if (pool_elts (tw->timers))
+    return clib_error_return (0, "%d timers left on the wheel",
+			      pool_elts (tw->timers));
+
+  tw_lazy_timer_wheel_free_16t_2w_512sl (tw);
+  pool_free (tm->test_elts);
+  vec_free (indices);
+  fformat (stdout, "PASS\n");
+  return 0;
+}
+
+static clib_error_t *
+test_performance (tw_lazy_test_main_t * tm)
+{
+  tw_lazy_timer_wheel_16t_2w_512sl_t *lw = &tm->lazy_wheel;
+  tw_timer_wheel_16t_2w_512sl_t *dw = &tm->double_wheel;
+  u32 i, j, *handles = 0, *regular_handles = 0, *intervals = 0;
+  f64 before, lazy[3], regular[3];
+
+  /* tw_timer_16t_2w_512sl has no overflow vector */
+  tm->max_interval = clib_min (tm->max_interval, (1 << 18) - 1);
+
+  tw_lazy_timer_wheel_init_16t_2w_512sl (lw, expired_timer_double_callback,
+					 1.0 /* timer interval */ , ~0);
+  tw_timer_wheel_init_16t_2w_512sl (dw, expired_timer_double_callback,
+				    1.0 /* timer interval */ , ~0);
+
+  vec_validate (handles, tm->ntimers - 1);
+  vec_validate (regular_handles, tm->ntimers - 1);
+  vec_validate (intervals, tm->ntimers - 1);
+  for (i = 0; i < tm->ntimers; i++)
+    intervals[i] = random_interval (tm);
+
+  /* start */
+  before = unix_time_now ();
+  for (i = 0; i < tm->ntimers; i++)
+    regular_handles[i] =
+      tw_timer_start_16t_2w_512sl (dw, i, 0, intervals[i]);
+  regular[0] = unix_time_now () - before;
+
+  before = unix_time_now ();
+  for (i = 0; i < tm->ntimers; i++)
+    handles[i] = tw_lazy_timer_start_16t_2w_512sl (lw, i, 0, intervals[i]);
+  lazy[0] = unix_time_now () - before;
+
+  /* keepalive churn, every timer is pushed out once per tick */
+  before = unix_time_now ();
+  for (j = 0; j < tm->niter; j++)
+    {
+      for (i = 0; i < tm->ntimers; i++)
+	tw_timer_update_16t_2w_512sl (dw, regular_handles[i],
+				      tm->max_interval);
+      run_double_wheel (dw, 1);
+    }
+  regular[1] = unix_time_now () - before;
+
+  before = unix_time_now ();
+  for (j = 0; j < tm->niter; j++)
+    {
+      tw_lazy_timer_update_multi_16t_2w_512sl (lw, handles, tm->ntimers,
+					       tm->max_interval);
+      run_lazy_wheel (lw, 1);
+    }
+  lazy[1] = unix_time_now () - before;
+
+  /* stop everything and let the wheels run dry */
+  before = unix_time_now ();
+  for (i = 0; i < tm->ntimers; i++)
+    tw_timer_stop_16t_2w_512sl (dw, regular_handles[i]);
+  run_double_wheel (dw, tm->max_interval + 1);
+  regular[2] = unix_time_now () - before;
+
+  before = unix_time_now ();
+  for (i = 0; i < tm->ntimers; i++)
+    tw_lazy_timer_stop_16t_2w_512sl (lw, handles[i]);
+  run_lazy_wheel (lw, tm->max_interval + 1);
+  lazy[2] = unix_time_now () - before;
+
+  fformat (stdout, "%d timers, %d update rounds, max interval %d ticks\n",
+	   tm->ntimers, tm->niter, tm->max_interval);
+  fformat (stdout, "%-12s %12s %12s\n", "", "tw_timer", "tw_lazy");
+  fformat (stdout, "%-12s %9.2f ns %9.2f ns\n", "start",
+	   regular[0] * 1e9 / tm->ntimers, lazy[0] * 1e9 / tm->ntimers);
+  fformat (stdout, "%-12s %9.2f ns %9.2f ns\n", "update",
+	   regular[1] * 1e9 / ((f64) tm->ntimers * tm->niter),
+	   lazy[1] * 1e9 / ((f64) tm->ntimers * tm->niter));
+  fformat (stdout, "%-12s %9.2f ns %9.2f ns\n", "stop + drain",
+	   regular[2] * 1e9 / tm->ntimers, lazy[2] * 1e9 / tm->ntimers);
+  fformat (stdout, "lazy wheel relinked %lld reaped %lld\n",
+	   lw->n_relinked, lw->n_stopped_reaped);
+
+  if (pool_elts (lw->timers))
+    return clib_error_return (0, "%d timers left on the lazy wheel",
+			      pool_elts (lw->timers));
+
+  tw_timer_wheel_free_16t_2w_512sl (dw);
+  tw_lazy_timer_wheel_free_16t_2w_512sl (lw);
+  vec_free (handles);
+  vec_free (regular_handles);
+  vec_free (intervals);
+  return 0;
+}
+
+static clib_error_t *
+lazy_timer_test_command_fn (tw_lazy_test_main_t * tm,
+			    unformat_input_t * input)
+{
+  int is_perf = 0;
+
+  clib_memset (tm, 0, sizeof (*tm));
+  /* Default values */
+  tm->ntimers = 100000;
+  tm->seed = 0xDEADDABE;
+  tm->niter = 200;
+  tm->ticks_per_iter = 727;
+  tm->max_interval = 300000;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "seed %d", &tm->seed))
+	;
+      else if (unformat (input, "perf"))
+	is_perf = 1;
+      else if (unformat (input, "ntimers %d", &tm->ntimers))
+	;
+      else if (unformat (input, "niter %d", &tm->niter))
+	;
+      else if (unformat (input, "ticks_per_iter %d", &tm->ticks_per_iter))
+	;
+      else if (unformat (input, "max_interval %d", &tm->max_interval))
+	;
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
+
+  if (tm->ntimers == 0 || tm->max_interval == 0)
+    return clib_error_return (0, "ntimers and max_interval must be > 0");
+
+  if (is_perf)
+    return test_performance (tm);
+
+  return test_correctness (tm);
+}
+
+#ifdef CLIB_UNIX
+int
+main (int argc, char *argv[])
+{
+  unformat_input_t i;
+  clib_error_t *error;
+  tw_lazy_test_main_t *tm = &tw_lazy_test_main;
+
+  clib_mem_init (0, 3ULL << 30);
+
+  unformat_init_command_line (&i, argv);
+  error = lazy_timer_test_command_fn (tm, &i);
+  unformat_free (&i);
+
+  if (error)
+    {
+      clib_error_report (error);
+      return 1;
+    }
+  return 0;
+}
+#endif /* CLIB_UNIX */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __included_tw_lazy_16t_2w_512sl_h__
+#define __included_tw_lazy_16t_2w_512sl_h__
+
+#undef TWL_TIMER_WHEELS
+#undef TWL_SLOTS_PER_RING
+#undef TWL_RING_SHIFT
+#undef TWL_RING_MASK
+#undef TWL_TIMERS_PER_OBJECT
+#undef LOG2_TWL_TIMERS_PER_OBJECT
+#undef TWL_SUFFIX
+
+#define TWL_TIMER_WHEELS 2
+#define TWL_SLOTS_PER_RING 512
+#define TWL_RING_SHIFT 9
+#define TWL_RING_MASK (TWL_SLOTS_PER_RING -1)
+#define TWL_TIMERS_PER_OBJECT 16
+#define LOG2_TWL_TIMERS_PER_OBJECT 4
+#define TWL_SUFFIX _16t_2w_512sl
+
+#include <vppinfra/tw_lazy_template.h>
+
+#endif /* __included_tw_lazy_16t_2w_512sl_h__ */
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ *  @brief Lazy hierarchical timer wheel template.
+ *
+ * A timer is linked into the slot of the lowest wheel on which its
+ * expiration tick and the current tick differ only in that wheel's
+ * digit, i.e. the slot which is reached exactly at the expiration tick
+ * or at the cascade point just before it. Cascading relinks timers one
+ * wheel lower, relative to the tick being processed.
+ *
+ * Since a slot is never reached later than the tick it was linked for,
+ * a timer whose expiration only moved later is simply relinked when its
+ * slot is reached. A stopped timer is freed at the same point.
+ */
+
+static inline u32
+TWL (make_internal_timer_handle) (u32 pool_index, u32 timer_id)
+{
+  u32 handle;
+
+  ASSERT (timer_id < TWL_TIMERS_PER_OBJECT);
+#if LOG2_TWL_TIMERS_PER_OBJECT > 0
+  ASSERT (pool_index < (1 << (32 - LOG2_TWL_TIMERS_PER_OBJECT)));
+
+  handle = (timer_id << (32 - LOG2_TWL_TIMERS_PER_OBJECT)) | (pool_index);
+#else
+  handle = pool_index;
+#endif
+  return handle;
+}
+
+static inline void
+TWL (timer_link) (TWLT (tw_lazy_timer_wheel) * tw,
+		  TWLT (tw_lazy_timer) * t, u64 now_tick)
+{
+  u64 diff = t->expires ^ now_tick;
+  u32 ring, slot, index = t - tw->timers;
+  u32 *head;
+
+  ASSERT (t->expires >= now_tick);
+
+  for (ring = 0; ring < TWL_TIMER_WHEELS - 1; ring++)
+    if ((diff >> ((ring + 1) * TWL_RING_SHIFT)) == 0)
+      break;
+
+  slot = (t->expires >> (ring * TWL_RING_SHIFT)) & TWL_RING_MASK;
+  head = &tw->w[ring][slot];
+
+  t->ring = ring;
+  t->slot = slot;
+  t->linked_expires = t->expires;
+  t->prev = ~0;
+  t->next = head[0];
+  if (head[0] != ~0)
+    pool_elt_at_index (tw->timers, head[0])->prev = index;
+  head[0] = index;
+}
+
+static inline void
+TWL (timer_unlink) (TWLT (tw_lazy_timer_wheel) * tw,
+		    TWLT (tw_lazy_timer) * t)
+{
+  if (t->prev != ~0)
+    pool_elt_at_index (tw->timers, t->prev)->next = t->next;
+  else
+    tw->w[t->ring][t->slot] = t->next;
+
+  if (t->next != ~0)
+    pool_elt_at_index (tw->timers, t->next)->prev = t->prev;
+}
+
+/**
+ * @brief Start a lazy timer
+ * @param tw_lazy_timer_wheel_t * tw timer wheel object pointer
+ * @param u32 pool_index user pool index, presumably for a tw session
+ * @param u32 timer_id app-specific timer ID. 4 bits.
+ * @param u64 interval timer interval in ticks, at least 1
+ * @returns handle needed to stop or update the timer
+ */
+u32
+TWL (tw_lazy_timer_start) (TWLT (tw_lazy_timer_wheel) * tw, u32 pool_index,
+			   u32 timer_id, u64 interval)
+{
+  TWLT (tw_lazy_timer) * t;
+
+  ASSERT (interval);
+
+  pool_get (tw->timers, t);
+  t->user_handle = TWL (make_internal_timer_handle) (pool_index, timer_id);
+  t->stopped = 0;
+  t->expires = tw->current_tick + interval;
+  TWL (timer_link) (tw, t, tw->current_tick);
+
+  return t - tw->timers;
+}
+
+/**
+ * @brief Stop a lazy timer
+ *
+ * Only marks the timer, it is unlinked and freed when its slot is reached.
+ * Stopping an already stopped or freed timer is a no-op.
+ *
+ * @param tw_lazy_timer_wheel_t * tw timer wheel object pointer
+ * @param u32 handle timer returned by tw_lazy_timer_start
+ */
+void
+TWL (tw_lazy_timer_stop) (TWLT (tw_lazy_timer_wheel) * tw, u32 handle)
+{
+  if (pool_is_free_index (tw->timers, handle))
+    return;
+
+  pool_elt_at_index (tw->timers, handle)->stopped = 1;
+}
+
+int
+TWL (tw_lazy_timer_handle_is_free) (TWLT (tw_lazy_timer_wheel) * tw,
+				    u32 handle)
+{
+  if (pool_is_free_index (tw->timers, handle))
+    return 1;
+  return pool_elt_at_index (tw->timers, handle)->stopped;
+}
+
+static_always_inline void
+TWL (timer_update_inline) (TWLT (tw_lazy_timer_wheel) * tw,
+			   TWLT (tw_lazy_timer) * t, u64 interval)
+{
+  ASSERT (interval);
+  ASSERT (!t->stopped);
+
+  t->expires = tw->current_tick + interval;
+
+  /* Expiration moved earlier than the slot the timer sits in */
+  if (PREDICT_FALSE (t->expires < t->linked_expires))
+    {
+      TWL (timer_unlink) (tw, t);
+      TWL (timer_link) (tw, t, tw->current_tick);
+    }
+}
+
+/**
+ * @brief Update a lazy timer with a new interval
+ * @param tw_lazy_timer_wheel_t * tw timer wheel object pointer
+ * @param u32 handle timer returned by tw_lazy_timer_start
+ * @param u64 interval timer interval in ticks, at least 1
+ */
+void
+TWL (tw_lazy_timer_update) (TWLT (tw_lazy_timer_wheel) * tw, u32 handle,
+			    u64 interval)
+{
+  TWL (timer_update_inline) (tw, pool_elt_at_index (tw->timers, handle),
+			     interval);
+}
+
+/**
+ * @brief Update a batch of lazy timers with the same new interval
+ * @param tw_lazy_timer_wheel_t * tw timer wheel object pointer
+ * @param u32 * handles timers returned by tw_lazy_timer_start
+ * @param u32 n_handles number of handles
+ * @param u64 interval timer interval in ticks, at least 1
+ */
+void
+TWL (tw_lazy_timer_update_multi) (TWLT (tw_lazy_timer_wheel) * tw,
+				  u32 * handles, u32 n_handles, u64 interval)
+{
+  TWLT (tw_lazy_timer) * t;
+
+  while (n_handles >= 8)
+    {
+      CLIB_PREFETCH (pool_elt_at_index (tw->timers, handles[4]),
+		     sizeof (*t), STORE);
+      CLIB_PREFETCH (pool_elt_at_index (tw->timers, handles[5]),
+		     sizeof (*t), STORE);
+      CLIB_PREFETCH (pool_elt_at_index (tw->timers, handles[6]),
+		     sizeof (*t), STORE);
+      CLIB_PREFETCH (pool_elt_at_index (tw->timers, handles[7]),
+		     sizeof (*t), STORE);
+
+      TWL (timer_update_inline) (tw, tw->timers + handles[0], interval);
+      TWL (timer_update_inline) (tw, tw->timers + handles[1], interval);
+      TWL (timer_update_inline) (tw, tw->timers + handles[2], interval);
+      TWL (timer_update_inline) (tw, tw->timers + handles[3], interval);
+
+      handles += 4;
+      n_handles -= 4;
+    }
+
+  while (n_handles)
+    {
+      t = pool_elt_at_index (tw->timers, handles[0]);
+      TWL (timer_update_inline) (tw, t, interval);
+      handles += 1;
+      n_handles -= 1;
+    }
+}
+
+/**
+ * @brief Initialize a lazy timer wheel template instance
+ * @param tw_lazy_timer_wheel_t * tw timer wheel object pointer
+ * @param void * expired_timer_callback. Passed a u32 * vector of
+ *   expired timer handles. The callback is optional.
+ * @param f64 timer_interval_in_seconds
+ */
+void
+TWL (tw_lazy_timer_wheel_init) (TWLT (tw_lazy_timer_wheel) * tw,
+				void *expired_timer_callback,
+				f64 timer_interval_in_seconds,
+				u32 max_expirations)
+{
+  clib_memset (tw, 0, sizeof (*tw));
+  tw->expired_timer_callback = expired_timer_callback;
+  tw->max_expirations = max_expirations;
+  if (timer_interval_in_seconds == 0.0)
+    {
+      clib_warning ("timer interval is zero");
+      abort ();
+    }
+  tw->timer_interval = timer_interval_in_seconds;
+  tw->ticks_per_second = 1.0 / timer_interval_in_seconds;
+  clib_memset (tw->w, 0xff, sizeof (tw->w));
+
+  vec_validate (tw->expired_timer_handles, 0);
+  _vec_len (tw->expired_timer_handles) = 0;
+}
+
+/**
+ * @brief Free a lazy timer wheel template instance
+ * @param tw_lazy_timer_wheel_t * tw timer wheel object pointer
+ */
+void
+TWL (tw_lazy_timer_wheel_free) (TWLT (tw_lazy_timer_wheel) * tw)
+{
+  pool_free (tw->timers);
+  vec_free (tw->expired_timer_handles);
+  clib_memset (tw, 0, sizeof (*tw));
+}
+
+/* Detach a slot and relink its timers relative to tick, freeing the
+   stopped ones and collecting the expired ones */
+static inline u32 *
+TWL (timer_process_slot) (TWLT (tw_lazy_timer_wheel) * tw, u32 ring,
+			  u32 slot, u64 tick, u32 * callback_vector)
+{
+  TWLT (tw_lazy_timer) * t;
+  u32 next_index = tw->w[ring][slot];
+
+  tw->w[ring][slot] = ~0;
+
+  while (next_index != ~0)
+    {
+      t = pool_elt_at_index (tw->timers, next_index);
+      next_index = t->next;
+      if (next_index != ~0)
+	CLIB_PREFETCH (pool_elt_at_index (tw->timers, next_index),
+		       sizeof (*t), STORE);
+
+      if (t->stopped)
+	{
+	  tw->n_stopped_reaped++;
+	  pool_put (tw->timers, t);
+	}
+      else if (t->expires <= tick)
+	{
+	  ASSERT (t->expires == tick);
+	  vec_add1 (callback_vector, t->user_handle);
+	  pool_put (tw->timers, t);
+	}
+      else
+	{
+	  if (t->expires != t->linked_expires)
+	    tw->n_relinked++;
+	  TWL (timer_link) (tw, t, tick);
+	}
+    }
+
+  return callback_vector;
+}
+
+/**
+ * @brief Advance a lazy timer wheel. Calls the expired timer callback
+ * as needed. This routine should be called once every timer_interval seconds
+ * @param tw_lazy_timer_wheel_t * tw timer wheel template instance pointer
+ * @param f64 now the current time, e.g. from vlib_time_now(vm)
+ * @returns u32 * vector of expired user handles
+ */
+static inline u32 *
+TWL (tw_lazy_timer_expire_timers_internal) (TWLT (tw_lazy_timer_wheel) * tw,
+					    f64 now, u32 * callback_vector_arg)
+{
+  u32 *callback_vector;
+  u32 nticks, i;
+  u64 tick;
+  int ring;
+
+  /* Shouldn't happen */
+  if (PREDICT_FALSE (now < tw->next_run_time))
+    return callback_vector_arg;
+
+  /* Number of ticks which have occurred */
+  nticks = tw->ticks_per_second * (now - tw->last_run_time);
+  if (nticks == 0)
+    return callback_vector_arg;
+
+  /* Remember when we ran, compute next runtime */
+  tw->next_run_time = (now + tw->timer_interval);
+
+  if (callback_vector_arg == 0)
+    {
+      _vec_len (tw->expired_timer_handles) = 0;
+      callback_vector = tw->expired_timer_handles;
+    }
+  else
+    callback_vector = callback_vector_arg;
+
+  for (i = 0; i < nticks; i++)
+    {
+      tick = tw->current_tick;
+
+      /* Cascade the slower wheels whose lower digits just wrapped */
+      for (ring = TWL_TIMER_WHEELS - 1; ring > 0; ring--)
+	{
+	  if (tick & ((1ULL << (ring * TWL_RING_SHIFT)) - 1))
+	    continue;
+	  callback_vector =
+	    TWL (timer_process_slot) (tw, ring,
+				      (tick >> (ring * TWL_RING_SHIFT)) &
+				      TWL_RING_MASK, tick, callback_vector);
+	}
+
+      callback_vector = TWL (timer_process_slot) (tw, 0, tick & TWL_RING_MASK,
+						  tick, callback_vector);
+
+      /* If any timers expired, tell the user */
+      if (callback_vector_arg == 0 && vec_len (callback_vector))
+	{
+	  /* The callback is optional. We return the u32 * handle vector */
+	  if (tw->expired_timer_callback)
+	    {
+	      tw->expired_timer_callback (callback_vector);
+	      vec_reset_length (callback_vector);
+	    }
+	  tw->expired_timer_handles = callback_vector;
+	}
+
+      tw->current_tick++;
+
+      if (vec_len (callback_vector) >= tw->max_expirations)
+	{
+	  i++;
+	  break;
+	}
+    }
+
+  if (callback_vector_arg == 0)
+    tw->expired_timer_handles = callback_vector;
+
+  tw->last_run_time += i * tw->timer_interval;
+  return callback_vector;
+}
+
+u32 *
+TWL (tw_lazy_timer_expire_timers) (TWLT (tw_lazy_timer_wheel) * tw, f64 now)
+{
+  return TWL (tw_lazy_timer_expire_timers_internal) (tw, now, 0);
+}
+
+u32 *
+TWL (tw_lazy_timer_expire_timers_vec) (TWLT (tw_lazy_timer_wheel) * tw,
+				       f64 now, u32 * vec)
+{
+  return TWL (tw_lazy_timer_expire_timers_internal) (tw, now, vec);
+}
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TWL_SUFFIX
+#error do not include tw_lazy_template.h directly
+#endif
+
+#include <vppinfra/clib.h>
+#include <vppinfra/pool.h>
+
+#ifndef _twlt
+#define _twlt(a,b) a##b##_t
+#define __twlt(a,b) _twlt(a,b)
+#define TWLT(a) __twlt(a,TWL_SUFFIX)
+
+#define _twl(a,b) a##b
+#define __twl(a,b) _twl(a,b)
+#define TWL(a) __twl(a,TWL_SUFFIX)
+#endif
+
+/** @file
+    @brief Lazy hierarchical timer wheel template header file, do not
+    compile directly
+
+A drop-in alternative to tw_timer_template.h for very large numbers of
+timers which are mostly restarted or stopped rather than expired, e.g.
+session idle and keepalive timers.
+
+Every timer records the tick it expires at. Moving the expiration later,
+the keepalive case, only rewrites that field: the timer stays linked in
+its slot and is relinked when the slot is reached. Stopping a timer only
+marks it, it is unlinked and freed when its slot is reached. Neither
+touches the slot lists or other timers. Moving the expiration earlier
+relinks the timer.
+
+Wheel geometry follows tw_timer_template.h:
+
+    #define TWL_TIMER_WHEELS 2
+    #define TWL_SLOTS_PER_RING 512
+    #define TWL_RING_SHIFT 9
+    #define TWL_RING_MASK (TWL_SLOTS_PER_RING -1)
+    #define TWL_TIMERS_PER_OBJECT 16
+    #define LOG2_TWL_TIMERS_PER_OBJECT 4
+    #define TWL_SUFFIX _16t_2w_512sl
+
+Timers farther out than the wheels reach are parked in the last wheel and
+relinked as often as needed, there is no separate overflow list.
+
+As with tw_timer_template.h, the expired timer callback receives the
+user handles of all timers which expired during one
+tw_lazy_timer_expire_timers call as a single vector.
+*/
+
+#if (TWL_TIMER_WHEELS != 1 && TWL_TIMER_WHEELS != 2 && TWL_TIMER_WHEELS != 3)
+#error TWL_TIMER_WHEELS must be 1, 2 or 3
+#endif
+
+typedef struct
+{
+  /** next, previous timer in the slot list */
+  u32 next;
+  u32 prev;
+
+  /** user timer handle */
+  u32 user_handle;
+
+  /** ring and slot the timer is linked into */
+  u16 slot;
+  u8 ring;
+
+  /** timer was stopped, it is freed when its slot is reached */
+  u8 stopped;
+
+  /** tick the timer expires at */
+  u64 expires;
+
+  /** expiration tick the timer was linked for */
+  u64 linked_expires;
+} TWLT (tw_lazy_timer);
+
+typedef struct
+{
+  /** Timer pool */
+  TWLT (tw_lazy_timer) * timers;
+
+  /** Next time the wheel should run */
+  f64 next_run_time;
+
+  /** Last time the wheel ran */
+  f64 last_run_time;
+
+  /** Timer ticks per second */
+  f64 ticks_per_second;
+
+  /** Timer interval, also needed to avoid fp divide in speed path */
+  f64 timer_interval;
+
+  /** next tick to process */
+  u64 current_tick;
+
+  /** slot list heads, ~0 when empty */
+  u32 w[TWL_TIMER_WHEELS][TWL_SLOTS_PER_RING];
+
+  /** expired timer callback, receives a vector of handles */
+  void (*expired_timer_callback) (u32 * expired_timer_handles);
+
+  /** vectors of expired timers */
+  u32 *expired_timer_handles;
+
+  /** maximum expirations */
+  u32 max_expirations;
+
+  /** timers relinked because their expiration moved later */
+  u64 n_relinked;
+
+  /** stopped timers freed when their slot was reached */
+  u64 n_stopped_reaped;
+} TWLT (tw_lazy_timer_wheel);
+
+u32 TWL (tw_lazy_timer_start) (TWLT (tw_lazy_timer_wheel) * tw,
+			       u32 pool_index, u32 timer_id, u64 interval);
+void TWL (tw_lazy_timer_stop) (TWLT (tw_lazy_timer_wheel) * tw, u32 handle);
+int TWL (tw_lazy_timer_handle_is_free) (TWLT (tw_lazy_timer_wheel) * tw,
+					u32 handle);
+void TWL (tw_lazy_timer_update) (TWLT (tw_lazy_timer_wheel) * tw,
+				 u32 handle, u64 interval);
+void TWL (tw_lazy_timer_update_multi) (TWLT (tw_lazy_timer_wheel) * tw,
+				       u32 * handles, u32 n_handles,
+				       u64 interval);
+
+void TWL (tw_lazy_timer_wheel_init) (TWLT (tw_lazy_timer_wheel) * tw,
+				     void *expired_timer_callback,
+				     f64 timer_interval, u32 max_expirations);
+void TWL (tw_lazy_timer_wheel_free) (TWLT (tw_lazy_timer_wheel) * tw);
+
+u32 *TWL (tw_lazy_timer_expire_timers) (TWLT (tw_lazy_timer_wheel) * tw,
+					f64 now);
+u32 *TWL (tw_lazy_timer_expire_timers_vec) (TWLT (tw_lazy_timer_wheel) *
+					    tw, f64 now, u32 * vec);
+
+/*
+ * fd.io coding-style-patch-verification: ON
+ *
+ * Local Variables:
+ * eval: (c-set-style "gnu")
+ * End:
+ */
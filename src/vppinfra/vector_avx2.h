@@ -110,6 +110,12 @@ u8x32_msb_mask (u8x32 v)
   return _mm256_movemask_epi8 ((__m256i) v);
 }
 
+static_always_inline u32
+u64x4_msb_mask (u64x4 v)
+{
+  return _mm256_movemask_pd ((__m256d) v);
+}
+
 /* _extend_to_ */
 /* *INDENT-OFF* */
 #define _(f,t,i) \
@@ -291,6 +297,48 @@ u32x8_min_scalar (u32x8 v)
 				      u32x8_extract_hi (v)));
 }
 
+/* lane masks with the first n lanes set, for masked loads and stores */
+static_always_inline u32x8
+u32x8_first_n_mask (u32 n)
+{
+  u32x8 lanes = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  return (u32x8) (u32x8_splat (n) > lanes);
+}
+
+static_always_inline u64x4
+u64x4_first_n_mask (u32 n)
+{
+  u64x4 lanes = { 0, 1, 2, 3 };
+  return (u64x4) (u64x4_splat (n) > lanes);
+}
+
+static_always_inline u32x8
+u32x8_mask_load_zero (void *p, u32x8 mask)
+{
+  return (u32x8) _mm256_maskload_epi32 ((int *) p, (__m256i) mask);
+}
+
+static_always_inline void
+u32x8_mask_store (u32x8 v, void *p, u32x8 mask)
+{
+  _mm256_maskstore_epi32 ((int *) p, (__m256i) mask, (__m256i) v);
+}
+
+static_always_inline u64x4
+u64x4_mask_load_zero (void *p, u64x4 mask)
+{
+  return (u64x4) _mm256_maskload_epi64 ((long long *) p, (__m256i) mask);
+}
+
+static_always_inline void
+u64x4_mask_store (u64x4 v, void *p, u64x4 mask)
+{
+  _mm256_maskstore_epi64 ((long long *) p, (__m256i) mask, (__m256i) v);
+}
+
+/* 32 and 64 bit elements only */
+#define CLIB_HAVE_VEC256_MASK_LOAD_STORE
+
 static_always_inline void
 u32x8_transpose (u32x8 a[8])
 {
@@ -139,6 +139,85 @@ u64x8_permute (u64x8 a, u64x8 b, u64x8 mask)
 					    (__m512i) b);
 }
 
+static_always_inline u8
+u64x8_is_equal_mask (u64x8 a, u64x8 b)
+{
+  return _mm512_cmpeq_epu64_mask ((__m512i) a, (__m512i) b);
+}
+
+static_always_inline u64x8
+u64x8_mask_load_zero (void *p, u8 mask)
+{
+  return (u64x8) _mm512_maskz_loadu_epi64 (mask, p);
+}
+
+/* masked loads and stores do not touch memory of lanes with the mask bit
+   clear, so they are safe for the tail of a buffer */
+static_always_inline void
+u64x8_mask_store (u64x8 v, void *p, u8 mask)
+{
+  _mm512_mask_storeu_epi64 (p, mask, (__m512i) v);
+}
+
+static_always_inline u32x16
+u32x16_mask_load_zero (void *p, u16 mask)
+{
+  return (u32x16) _mm512_maskz_loadu_epi32 (mask, p);
+}
+
+static_always_inline void
+u32x16_mask_store (u32x16 v, void *p, u16 mask)
+{
+  _mm512_mask_storeu_epi32 (p, mask, (__m512i) v);
+}
+
+static_always_inline u16
+u32x16_is_equal_mask (u32x16 a, u32x16 b)
+{
+  return _mm512_cmpeq_epu32_mask ((__m512i) a, (__m512i) b);
+}
+
+#if defined (__AVX512BW__)
+static_always_inline u16x32
+u16x32_mask_load_zero (void *p, u32 mask)
+{
+  return (u16x32) _mm512_maskz_loadu_epi16 (mask, p);
+}
+
+static_always_inline void
+u16x32_mask_store (u16x32 v, void *p, u32 mask)
+{
+  _mm512_mask_storeu_epi16 (p, mask, (__m512i) v);
+}
+
+static_always_inline u32
+u16x32_is_equal_mask (u16x32 a, u16x32 b)
+{
+  return _mm512_cmpeq_epu16_mask ((__m512i) a, (__m512i) b);
+}
+
+static_always_inline u8x64
+u8x64_mask_load_zero (void *p, u64 mask)
+{
+  return (u8x64) _mm512_maskz_loadu_epi8 (mask, p);
+}
+
+static_always_inline void
+u8x64_mask_store (u8x64 v, void *p, u64 mask)
+{
+  _mm512_mask_storeu_epi8 (p, mask, (__m512i) v);
+}
+
+static_always_inline u64
+u8x64_is_equal_mask (u8x64 a, u8x64 b)
+{
+  return _mm512_cmpeq_epu8_mask ((__m512i) a, (__m512i) b);
+}
+
+/* all of the above, for all element sizes */
+#define CLIB_HAVE_VEC512_MASK_LOAD_STORE
+#endif
+
 
 #define u32x16_ternary_logic(a, b, c, d) \
   (u32x16) _mm512_ternarylogic_epi32 ((__m512i) a, (__m512i) b, (__m512i) c, d)
@@ -41,6 +41,16 @@ class TestBihash(VppTestCase):
             self.logger.critical(error)
             self.assertNotIn('failed', error)
 
+    def test_bihash_resize_thread(self):
+        """ Bihash Resize Thread Test """
+
+        error = self.vapi.cli("test bihash resize-threads 4 nbuckets 2" +
+                              " nitems 50000")
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn('failed', error)
+
     def test_bihash_vec64(self):
         """ Bihash vec64 Test """
 
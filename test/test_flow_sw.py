@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+""" Software flow offload tests """
+
+import unittest
+
+from scapy.packet import Raw
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, UDP
+from scapy.layers.vxlan import VXLAN
+
+from framework import VppTestCase, VppTestRunner
+
+
+class TestFlowSw(VppTestCase):
+    """ Software Flow Offload Test Case """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestFlowSw, cls).setUpClass()
+        cls.create_pg_interfaces(range(2))
+        for i in cls.pg_interfaces:
+            i.admin_up()
+        cls.pg0.config_ip4()
+        cls.pg0.resolve_arp()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.pg0.unconfig_ip4()
+        for i in cls.pg_interfaces:
+            i.admin_down()
+        super(TestFlowSw, cls).tearDownClass()
+
+    def vxlan_packets(self, vni, n):
+        pkts = []
+        for i in range(n):
+            inner = (Ether(src="00:00:00:00:00:%02x" % (i + 1),
+                           dst="00:00:00:00:01:01") /
+                     IP(src="10.0.0.1", dst="10.0.0.2") /
+                     UDP(sport=1234, dport=1234) /
+                     Raw(b"\xa5" * 64))
+            pkts.append(Ether(src=self.pg0.remote_mac,
+                              dst=self.pg0.local_mac) /
+                        IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+                        UDP(sport=4789, dport=4789, chksum=0) /
+                        VXLAN(vni=vni, flags=0x08) /
+                        inner)
+        return pkts
+
+    def test_flow_sw(self):
+        """ Software flow mark, redirect and drop on device-input """
+        matched = "/err/flow-sw-offload/flow matched"
+        dropped = "/err/flow-sw-offload/flow drop action"
+        decap = "/err/vxlan4-input/good packets decapsulated"
+        n_pkts = 5
+
+        # vxlan tunnel into a bridge with pg1, its rx flow offloaded. pg has
+        # no flow ops, so the software backend is used (flow index 0)
+        r = self.vapi.vxlan_add_del_tunnel(src_address=self.pg0.local_ip4n,
+                                           dst_address=self.pg0.remote_ip4n,
+                                           vni=10)
+        self.vapi.sw_interface_set_l2_bridge(r.sw_if_index, bd_id=10)
+        self.vapi.sw_interface_set_l2_bridge(self.pg1.sw_if_index, bd_id=10)
+        reply = self.vapi.cli("set flow-offload vxlan hw pg0 rx "
+                              "vxlan_tunnel0")
+        self.assertNotIn("error", reply)
+
+        # The flow marks the packets with the tunnel and redirects them to
+        # vxlan-flow-input, bypassing ip4 and vxlan4-input
+        rx = self.send_and_expect(self.pg0, self.vxlan_packets(10, n_pkts),
+                                  self.pg1)
+        for p in rx:
+            self.assertEqual(p[Ether].dst, "00:00:00:00:01:01")
+            self.assertEqual(p[IP].dst, "10.0.0.2")
+        self.assert_error_counter_equal(matched, n_pkts)
+        self.assert_error_counter_equal(decap, 0)
+
+        # Other vnis don't match and take the regular path
+        self.send_and_assert_no_replies(self.pg0,
+                                        self.vxlan_packets(11, n_pkts))
+        self.assert_error_counter_equal(matched, n_pkts)
+
+        # Drop flow on the ip4 n-tuple, flow index 1
+        self.vapi.cli("test flow add dst-ip %s/32 proto udp dst-port 5000 "
+                      "drop count" % self.pg0.local_ip4)
+        reply = self.vapi.cli("test flow enable index 1 pg0")
+        self.assertNotIn("error", reply)
+        p = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+             IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+             UDP(sport=1234, dport=5000) /
+             Raw(b"\xa5" * 64))
+        self.send_and_assert_no_replies(self.pg0, p * n_pkts)
+        self.assert_error_counter_equal(matched, 2 * n_pkts)
+        self.assert_error_counter_equal(dropped, n_pkts)
+        self.assertIn("software, %d hits" % n_pkts,
+                      self.vapi.cli("show flow entry index 1"))
+
+        # Disabled flows no longer match
+        self.vapi.cli("test flow disable index 1 pg0")
+        self.vapi.cli("set flow-offload vxlan hw pg0 rx vxlan_tunnel0 del")
+        self.send_and_expect(self.pg0, self.vxlan_packets(10, n_pkts),
+                             self.pg1)
+        self.assert_error_counter_equal(matched, 2 * n_pkts)
+        self.assert_error_counter_equal(decap, n_pkts)
+
+        self.vapi.sw_interface_set_l2_bridge(self.pg1.sw_if_index, bd_id=10,
+                                             enable=0)
+        self.vapi.sw_interface_set_l2_bridge(r.sw_if_index, bd_id=10,
+                                             enable=0)
+        self.vapi.vxlan_add_del_tunnel(src_address=self.pg0.local_ip4n,
+                                       dst_address=self.pg0.remote_ip4n,
+                                       vni=10, is_add=0)
+
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+""" Static http server tests """
+
+import os
+import unittest
+
+from scapy.packet import Raw
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, TCP
+
+from framework import VppTestCase, VppTestRunner
+from vpp_pg_interface import CaptureTimeoutError
+
+
+class TestHttpStatic(VppTestCase):
+    """ Static HTTP Server Test Case """
+
+    files = {"a.html": b"<html><body>first pipelined</body></html>\n",
+             "b.html": b"<html><body>second pipelined</body></html>\n"}
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestHttpStatic, cls).setUpClass()
+        cls.create_pg_interfaces(range(1))
+        cls.pg0.admin_up()
+        cls.pg0.config_ip4()
+        cls.pg0.resolve_arp()
+
+        cls.www_root = os.path.join(cls.tempdir, "www")
+        os.mkdir(cls.www_root)
+        for name, data in cls.files.items():
+            with open(os.path.join(cls.www_root, name), "wb") as f:
+                f.write(data)
+
+        cls.vapi.session_enable_disable(is_enabled=1)
+        cls.vapi.cli("http static server www-root %s uri tcp://%s/80" %
+                     (cls.www_root, cls.pg0.local_ip4))
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.pg0.unconfig_ip4()
+        cls.pg0.admin_down()
+        super(TestHttpStatic, cls).tearDownClass()
+
+    def test_http_static_parser(self):
+        """ HTTP static server request parser """
+        error = self.vapi.cli("test http static parser")
+        if error:
+            self.logger.critical(error)
+        self.assertNotIn("FAIL", error)
+        self.assertIn("SUCCESS", error)
+
+    def test_http_static_pipelined(self):
+        """ HTTP static server pipelined requests on one connection """
+        sport = 23456
+        seq = 1000
+        ip = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+              IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4))
+
+        # Handshake
+        syn = ip / TCP(sport=sport, dport=80, flags="S", seq=seq,
+                       window=65535, options=[("MSS", 1460)])
+        rx = self.send_and_expect(self.pg0, [syn], self.pg0)
+        self.assertEqual(rx[0][TCP].flags & 0x12, 0x12)
+        ack = rx[0][TCP].seq + 1
+        seq += 1
+
+        # Both requests in one segment, the second asks to close
+        req = (b"GET /a.html HTTP/1.1\r\nHost: vpp\r\n\r\n"
+               b"GET /b.html HTTP/1.1\r\nHost: vpp\r\n"
+               b"Connection: close\r\n\r\n")
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg0.add_stream([ip / TCP(sport=sport, dport=80, flags="A",
+                                      seq=seq, ack=ack, window=65535),
+                             ip / TCP(sport=sport, dport=80, flags="PA",
+                                      seq=seq, ack=ack, window=65535) /
+                             Raw(req)])
+        self.pg_start()
+
+        # Collect the responses, in sequence order, until the server closes
+        segments = {}
+        fin = False
+        while not fin:
+            try:
+                p = self.pg0.wait_for_packet(2)
+            except CaptureTimeoutError:
+                break
+            if TCP not in p or p[TCP].dport != sport:
+                continue
+            self.assertFalse(p[TCP].flags & 0x04, "unexpected reset")
+            if Raw in p:
+                segments[p[TCP].seq] = p[Raw].load
+            fin = bool(p[TCP].flags & 0x01)
+        self.assertTrue(fin, "server should close after the second reply")
+
+        data = b"".join(segments[s] for s in sorted(segments))
+        replies = data.split(b"HTTP/1.1 200 OK\r\n")
+        self.assertEqual(replies[0], b"")
+        self.assertEqual(len(replies), 3, data)
+        self.assertIn(b"Connection: keep-alive\r\n", replies[1])
+        self.assertTrue(replies[1].endswith(self.files["a.html"]))
+        self.assertIn(b"Connection: close\r\n", replies[2])
+        self.assertTrue(replies[2].endswith(self.files["b.html"]))
+
+
+if __name__ == '__main__':
+    unittest.main(testRunner=VppTestRunner)
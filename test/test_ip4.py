@@ -2155,5 +2155,79 @@ class TestIPCover(VppTestCase):
         # remove the default route
         r.remove_vpp_config()
 
+
+class TestIPRouteCounters(VppTestCase):
+    """ IPv4 Route Counter Modes """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestIPRouteCounters, cls).setUpClass()
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TestIPRouteCounters, cls).tearDownClass()
+
+    def setUp(self):
+        super(TestIPRouteCounters, self).setUp()
+
+        self.create_pg_interfaces(range(2))
+
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    def tearDown(self):
+        self.vapi.cli("set fib counters full no-export")
+        super(TestIPRouteCounters, self).tearDown()
+        for i in self.pg_interfaces:
+            i.unconfig_ip4()
+            i.admin_down()
+
+    def test_ip_route_counters(self):
+        """ IP Route Counters off/sampled/full """
+
+        route = VppIpRoute(self, "10.0.0.1", 32,
+                           [VppRoutePath(self.pg1.remote_ip4,
+                                         self.pg1.sw_if_index)])
+        route.add_vpp_config()
+
+        p = (Ether(src=self.pg0.remote_mac,
+                   dst=self.pg0.local_mac) /
+             IP(src=self.pg0.remote_ip4, dst="10.0.0.1") /
+             UDP(sport=1234, dport=1234) /
+             Raw(b'\xa5' * 100))
+
+        #
+        # full; every packet is counted
+        #
+        self.send_and_expect(self.pg0, p * 64, self.pg1)
+        self.assertEqual(route.get_stats_to()['packets'], 64)
+
+        #
+        # off; no packets are counted
+        #
+        self.vapi.cli("set fib counters off")
+        self.assertIn("counters: off", self.vapi.cli("show load-balance"))
+        self.send_and_expect(self.pg0, p * 64, self.pg1)
+        self.assertEqual(route.get_stats_to()['packets'], 0)
+
+        #
+        # sampled; 1 in every 8 packets is counted, scaled by 8
+        #
+        self.vapi.cli("set fib counters sampled 8 export")
+        self.assertIn("counters: sampled, 1 in 8 packets",
+                      self.vapi.cli("show load-balance"))
+        self.send_and_expect(self.pg0, p * 64, self.pg1)
+        self.assertEqual(route.get_stats_to()['packets'], 64)
+        self.assertEqual(route.get_stats_to()['bytes'],
+                         64 * len(p[IP]))
+
+        names = self.statistics.get_counter("/net/route/names")
+        self.assertEqual(names[route.stats_index], "0:10.0.0.1/32")
+
+        route.remove_vpp_config()
+
+
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)
@@ -2389,6 +2389,90 @@ class TestIP6Input(VppTestCase):
         self.pg_start()
 
 
+class TestIP6SourceCheck(VppTestCase):
+    """ IPv6 Unicast Source Check Test Case """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestIP6SourceCheck, cls).setUpClass()
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TestIP6SourceCheck, cls).tearDownClass()
+
+    def setUp(self):
+        super(TestIP6SourceCheck, self).setUp()
+
+        self.create_pg_interfaces(range(3))
+
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip6()
+            i.resolve_ndp()
+
+    def tearDown(self):
+        super(TestIP6SourceCheck, self).tearDown()
+        for i in self.pg_interfaces:
+            i.unconfig_ip6()
+            i.admin_down()
+
+    def stream(self, src):
+        return (Ether(src=self.pg0.remote_mac,
+                      dst=self.pg0.local_mac) /
+                IPv6(src=src, dst=self.pg1.remote_ip6) /
+                inet6.UDP(sport=1234, dport=1234) /
+                Raw(b'\xa5' * 100)) * NUM_PKTS
+
+    def test_ip6_source_check(self):
+        """ IPv6 strict and loose unicast source check """
+        fails = "/err/ip6-input/ip6 unicast source check fails"
+        remote = "2001:db8:1::1"
+
+        self.vapi.cli("set interface ip6 source-check pg0 strict")
+
+        # the source is connected on the rx interface
+        self.send_and_expect(self.pg0, self.stream(self.pg0.remote_ip6),
+                             self.pg1)
+        self.assert_error_counter_equal(fails, 0)
+
+        # no route back to the source
+        self.send_and_assert_no_replies(self.pg0, self.stream(remote))
+        self.assert_error_counter_equal(fails, NUM_PKTS)
+
+        # a route back, but not through the rx interface
+        route = VppIpRoute(self, "2001:db8:1::", 64,
+                           [VppRoutePath(self.pg2.remote_ip6,
+                                         self.pg2.sw_if_index)])
+        route.add_vpp_config()
+        self.send_and_assert_no_replies(self.pg0, self.stream(remote))
+        self.assert_error_counter_equal(fails, 2 * NUM_PKTS)
+
+        # loose only asks for a route back, through any interface
+        self.vapi.cli("set interface ip6 source-check pg0 strict del")
+        self.vapi.cli("set interface ip6 source-check pg0 loose")
+        self.send_and_expect(self.pg0, self.stream(remote), self.pg1)
+        self.assert_error_counter_equal(fails, 2 * NUM_PKTS)
+        route.remove_vpp_config()
+        self.send_and_assert_no_replies(self.pg0, self.stream(remote))
+        self.assert_error_counter_equal(fails, 3 * NUM_PKTS)
+
+        # strict with the route back through the rx interface
+        self.vapi.cli("set interface ip6 source-check pg0 loose del")
+        self.vapi.cli("set interface ip6 source-check pg0 strict")
+        route = VppIpRoute(self, "2001:db8:1::", 64,
+                           [VppRoutePath(self.pg0.remote_ip6,
+                                         self.pg0.sw_if_index)])
+        route.add_vpp_config()
+        self.send_and_expect(self.pg0, self.stream(remote), self.pg1)
+        self.assert_error_counter_equal(fails, 3 * NUM_PKTS)
+
+        # and disabled, nothing is checked
+        route.remove_vpp_config()
+        self.vapi.cli("set interface ip6 source-check pg0 del")
+        self.send_and_expect(self.pg0, self.stream(remote), self.pg1)
+        self.assert_error_counter_equal(fails, 3 * NUM_PKTS)
+
+
 class TestIPReplace(VppTestCase):
     """ IPv6 Table Replace """
 
@@ -62,6 +62,7 @@
 
 import unittest
 import random
+import re
 
 from scapy.packet import Raw
 from scapy.layers.l2 import Ether
@@ -529,5 +530,38 @@ class TestL2fib(VppTestCase):
         self.assertEqual(len(learned_macs ^ macs), 0)
 
 
+class TestL2fibCuckoo(TestL2fib):
+    """ L2 FIB Cuckoo Lookup Test Case """
+
+    @classmethod
+    def setUpConstants(cls):
+        # Forward and learn using the cuckoo copy of the mac table
+        cls.extra_vpp_punt_config = ["l2fib", "{", "cuckoo-lookup", "}"]
+        super(TestL2fibCuckoo, cls).setUpConstants()
+
+    def cuckoo_used_slots(self):
+        out = self.vapi.cli("show l2fib raw")
+        m = re.search(r"Cuckoo Lookup Table:.*?Used slots: (\d+)", out, re.S)
+        self.assertIsNotNone(m, "no cuckoo lookup table")
+        return int(m.group(1))
+
+    def test_l2_fib_cuckoo_add_del(self):
+        """ L2 FIB - cuckoo lookup table follows adds and deletes
+        """
+        bd_id = 1
+        hosts = self.create_hosts(10, subnet=39)
+        n = sum(len(hosts[self.pg_interfaces[i].sw_if_index])
+                for i in self.bd_ifs(bd_id))
+
+        base = self.cuckoo_used_slots()
+        self.config_l2_fib_entries(bd_id, hosts)
+        self.assertEqual(self.cuckoo_used_slots(), base + n)
+        self.run_verify_test(bd_id, hosts, hosts)
+
+        self.delete_l2_fib_entry(bd_id, hosts)
+        self.assertEqual(self.cuckoo_used_slots(), base)
+        self.run_verify_negat_test(bd_id, hosts, hosts)
+
+
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)
@@ -1,9 +1,14 @@
 #!/usr/bin/env python3
 
+import re
 import unittest
 
-from framework import VppTestCase, VppTestRunner
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, TCP
+
+from framework import VppTestCase, VppTestRunner, running_extended_tests
 from vpp_ip_route import VppIpTable, VppIpRoute, VppRoutePath
+from vpp_neighbor import VppNeighbor
 
 
 class TestTCP(VppTestCase):
@@ -84,6 +89,229 @@ class TestTCP(VppTestCase):
         ip_t10.remove_vpp_config()
 
 
+class TestTCPCongestionControl(VppTestCase):
+    """ TCP Congestion Control Test Case """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestTCPCongestionControl, cls).setUpClass()
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TestTCPCongestionControl, cls).tearDownClass()
+
+    def setUp(self):
+        super(TestTCPCongestionControl, self).setUp()
+        self.vapi.session_enable_disable(is_enabled=1)
+        self.create_loopback_interfaces(2)
+
+        table_id = 0
+
+        for i in self.lo_interfaces:
+            i.admin_up()
+
+            if table_id != 0:
+                tbl = VppIpTable(self, table_id)
+                tbl.add_vpp_config()
+
+            i.set_table_ip4(table_id)
+            i.config_ip4()
+            table_id += 1
+
+        self.vapi.app_namespace_add_del(namespace_id=b"0",
+                                        sw_if_index=self.loop0.sw_if_index)
+        self.vapi.app_namespace_add_del(namespace_id=b"1",
+                                        sw_if_index=self.loop1.sw_if_index)
+
+        # Send traffic for each table out of the other table's interface.
+        # The loopback hands it back to that interface's input, in its
+        # table, so every packet crosses an interface output where nsim
+        # can delay or drop it.
+        self.routes = []
+        self.nbrs = []
+        for dst, out, table_id in [(self.loop0, self.loop0, 1),
+                                   (self.loop1, self.loop1, 0)]:
+            nbr = VppNeighbor(self, out.sw_if_index, out.local_mac,
+                              out.remote_ip4)
+            nbr.add_vpp_config()
+            self.nbrs.append(nbr)
+            route = VppIpRoute(self, dst.local_ip4, 32,
+                               [VppRoutePath(out.remote_ip4,
+                                             out.sw_if_index)],
+                               table_id=table_id)
+            route.add_vpp_config()
+            self.routes.append(route)
+
+    def tearDown(self):
+        for i in self.lo_interfaces:
+            self.vapi.cli("nsim output-feature enable-disable %s disable" %
+                          i.name)
+        for route in self.routes:
+            route.remove_vpp_config()
+        for nbr in self.nbrs:
+            nbr.remove_vpp_config()
+        for i in self.lo_interfaces:
+            i.unconfig_ip4()
+            i.set_table_ip4(0)
+            i.admin_down()
+        self.vapi.session_enable_disable(is_enabled=0)
+        super(TestTCPCongestionControl, self).tearDown()
+
+    def transfer(self, cc_algo, uri):
+        """ Run one echo client transfer, return goodput in gbit/s """
+        self.vapi.cli("set tcp cc-algo " + cc_algo)
+        reply = self.vapi.cli("test echo client mbytes 4 appns 1 " +
+                              "fifo-size 512 test-bytes syn-timeout 2 " +
+                              "test-timeout 60 uri " + uri)
+        self.logger.info(reply)
+        self.assertNotIn("failed", reply)
+        m = re.search(r"([0-9.]+) gbit/second", reply)
+        self.assertIsNotNone(m)
+        return float(m.group(1))
+
+    def test_tcp_cc_lossy_long_haul(self):
+        """ TCP newreno, cubic and bbr transfers on a lossy path """
+
+        # 100 Mbps, 20 ms round-trip, 1% random loss in each direction
+        reply = self.vapi.cli("set nsim delay 10 ms bandwidth 0.1 gbit " +
+                              "packet-size 1500 drop-fraction 0.01")
+        self.assertNotIn("error", reply)
+        for i in self.lo_interfaces:
+            self.vapi.cli("nsim output-feature enable-disable %s" % i.name)
+
+        uri = "tcp://" + self.loop0.local_ip4 + "/1234"
+        error = self.vapi.cli("test echo server appns 0 fifo-size 512 " +
+                              "uri " + uri)
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+        goodput = {}
+        for cc_algo in ["newreno", "cubic", "bbr"]:
+            goodput[cc_algo] = self.transfer(cc_algo, uri)
+        self.vapi.cli("set tcp cc-algo newreno")
+        self.logger.info("goodput (gbit/s): %s" % goodput)
+
+        # Loss does not collapse bbr's window. Goodput over a random loss
+        # pattern varies from run to run, so only compare on extended runs
+        if running_extended_tests:
+            self.assertGreater(goodput["bbr"], goodput["newreno"])
+            self.assertGreater(goodput["bbr"], goodput["cubic"])
+
+
+class TestTCPSynCookies(VppTestCase):
+    """ TCP SYN Cookies Test Case """
+
+    @classmethod
+    def setUpConstants(cls):
+        # Answer every SYN with a cookie
+        cls.extra_vpp_punt_config = [
+            "tcp", "{", "syn-cookie-threshold", "0", "}"]
+        super(TestTCPSynCookies, cls).setUpConstants()
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestTCPSynCookies, cls).setUpClass()
+        cls.create_pg_interfaces(range(1))
+        cls.pg0.admin_up()
+        cls.pg0.config_ip4()
+        cls.pg0.resolve_arp()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.pg0.unconfig_ip4()
+        cls.pg0.admin_down()
+        super(TestTCPSynCookies, cls).tearDownClass()
+
+    def setUp(self):
+        super(TestTCPSynCookies, self).setUp()
+        self.vapi.session_enable_disable(is_enabled=1)
+        self.create_loopback_interfaces(2)
+
+        table_id = 0
+
+        for i in self.lo_interfaces:
+            i.admin_up()
+
+            if table_id != 0:
+                tbl = VppIpTable(self, table_id)
+                tbl.add_vpp_config()
+
+            i.set_table_ip4(table_id)
+            i.config_ip4()
+            table_id += 1
+
+        self.vapi.app_namespace_add_del(namespace_id=b"0",
+                                        sw_if_index=self.loop0.sw_if_index)
+        self.vapi.app_namespace_add_del(namespace_id=b"1",
+                                        sw_if_index=self.loop1.sw_if_index)
+
+        self.routes = [
+            VppIpRoute(self, self.loop1.local_ip4, 32,
+                       [VppRoutePath("0.0.0.0", 0xffffffff,
+                                     nh_table_id=1)]),
+            VppIpRoute(self, self.loop0.local_ip4, 32,
+                       [VppRoutePath("0.0.0.0", 0xffffffff,
+                                     nh_table_id=0)], table_id=1)]
+        for route in self.routes:
+            route.add_vpp_config()
+
+    def tearDown(self):
+        for route in self.routes:
+            route.remove_vpp_config()
+        for i in self.lo_interfaces:
+            i.unconfig_ip4()
+            i.set_table_ip4(0)
+            i.admin_down()
+        self.vapi.session_enable_disable(is_enabled=0)
+        super(TestTCPSynCookies, self).tearDown()
+
+    def send_stray_ack(self):
+        """ Send ACK that matches no cookie to the listener, expect RST """
+        p = (Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) /
+             IP(src=self.pg0.remote_ip4, dst=self.loop0.local_ip4) /
+             TCP(sport=40000, dport=1234, flags="A", seq=1000, ack=12345))
+        rx = self.send_and_expect(self.pg0, [p], self.pg0)
+        self.assertEqual(len(rx), 1)
+        self.assertTrue(rx[0][TCP].flags & 0x04)
+        self.assertEqual(rx[0][TCP].dport, 40000)
+
+    def test_tcp_syn_cookies(self):
+        """ TCP echo client/server connections over syn cookies """
+        sent = "/err/tcp4-listen/SYN cookies sent"
+        rcvd = "/err/tcp4-listen/Valid SYN cookies received"
+        invalid = "/err/tcp4-listen/Invalid SYN cookies received"
+        n_clients = 10
+
+        uri = "tcp://" + self.loop0.local_ip4 + "/1234"
+        error = self.vapi.cli("test echo server appns 0 fifo-size 4 uri " +
+                              uri)
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+        # No cookies sent yet, stray ACKs are not checked as cookies
+        self.send_stray_ack()
+        self.assert_error_counter_equal(invalid, 0)
+
+        error = self.vapi.cli("test echo client nclients %d " % n_clients +
+                              "bytes 10000 appns 1 fifo-size 4 " +
+                              "no-output test-bytes syn-timeout 2 " +
+                              "uri " + uri)
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+        self.assert_error_counter_equal(sent, n_clients)
+        self.assert_error_counter_equal(rcvd, n_clients)
+        self.assert_error_counter_equal(invalid, 0)
+
+        # Cookies were sent recently, stray ACKs are checked and rejected
+        self.send_stray_ack()
+        self.assert_error_counter_equal(invalid, 1)
+        self.assert_error_counter_equal(rcvd, n_clients)
+
+
 class TestTCPUnitTests(VppTestCase):
     "TCP Unit Tests"
 
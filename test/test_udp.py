@@ -325,5 +325,118 @@ class TestUDP(VppTestCase):
         ip_t10.remove_vpp_config()
 
 
+class TestUDPSessionGso(VppTestCase):
+    """ UDP session dgram batching and gso """
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestUDPSessionGso, cls).setUpClass()
+        cls.create_pg_interfaces(range(1))
+        for i in cls.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    @classmethod
+    def tearDownClass(cls):
+        for i in cls.pg_interfaces:
+            i.unconfig_ip4()
+            i.admin_down()
+        super(TestUDPSessionGso, cls).tearDownClass()
+
+    def setUp(self):
+        super(TestUDPSessionGso, self).setUp()
+        self.vapi.session_enable_disable(is_enabled=1)
+
+    def tearDown(self):
+        self.vapi.cli("set interface feature gso pg0 disable")
+        self.vapi.session_enable_disable(is_enabled=0)
+        super(TestUDPSessionGso, self).tearDown()
+
+    def gso_ip4_vectors(self):
+        """ Buffers that went through the gso-ip4 node """
+        n = 0
+        for line in self.vapi.cli("show runtime gso-ip4").splitlines():
+            fields = line.split()
+            if len(fields) > 3 and fields[0] == "gso-ip4":
+                n += int(fields[3])
+        return n
+
+    def send_dgrams(self, sizes):
+        """ Send dgrams of the given sizes from a connected udp session,
+            with one tx event """
+        self.vapi.cli("clear runtime")
+        self.pg0.enable_capture()
+        uri = "udp://%s/1234" % self.pg0.remote_ip4
+        error = self.vapi.cli("test echo client bytes %u dgram-size %u "
+                              "no-return no-output syn-timeout 2 uri %s" %
+                              (sum(sizes), sizes[0], uri))
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+        rx = self.pg0.get_capture(len(sizes))
+
+        offset = 0
+        for p, size in zip(rx, sizes):
+            self.assertEqual(p[IP].src, self.pg0.local_ip4)
+            self.assertEqual(p[IP].dst, self.pg0.remote_ip4)
+            self.assertEqual(p[IP].len, 20 + 8 + size)
+            self.assertEqual(p[UDP].dport, 1234)
+            self.assertEqual(p[UDP].len, 8 + size)
+            payload = bytes(bytearray((offset + j) & 0xff
+                                      for j in range(size)))
+            self.assertEqual(p[Raw].load, payload)
+            self.assert_packet_checksums_valid(p)
+            offset += size
+
+    def test_udp_gso_tx(self):
+        """ UDP connected session tx, dgrams chained for gso """
+
+        # Eight equal dgrams go out as one super segment, split by the
+        # gso node, and the shorter last one on its own
+        self.vapi.cli("set interface feature gso pg0 enable")
+        self.send_dgrams([1000] * 8 + [500])
+        self.assertEqual(self.gso_ip4_vectors(), 2)
+
+        # Without the gso feature, the egress check fails and dgrams are
+        # sent one per buffer
+        self.vapi.cli("set interface feature gso pg0 disable")
+        self.send_dgrams([1000] * 8)
+        self.assertEqual(self.gso_ip4_vectors(), 0)
+
+    def test_udp_connected_rx(self):
+        """ UDP connected sessions rx, interleaved flows """
+
+        uri = "udpc://%s/1234" % self.pg0.local_ip4
+        error = self.vapi.cli("test echo server uri %s" % uri)
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
+
+        # Consecutive dgrams of a flow skip the session lookup in
+        # udp-input, flow changes must not reuse the previous session
+        sports = [10001, 10001, 10002, 10002, 10001, 10002, 10002]
+        pkts = []
+        for i, sport in enumerate(sports):
+            pkts.append(Ether(src=self.pg0.remote_mac,
+                              dst=self.pg0.local_mac) /
+                        IP(src=self.pg0.remote_ip4, dst=self.pg0.local_ip4) /
+                        UDP(sport=sport, dport=1234) /
+                        Raw(b"flow %u dgram %u" % (sport, i)))
+
+        rx = self.send_and_expect(self.pg0, pkts, self.pg0)
+        self.assertEqual(len(rx), len(pkts))
+        for p in rx:
+            # Echoed by the session the dgram was delivered to
+            sport = int(p[Raw].load.split()[1])
+            self.assertEqual(p[IP].dst, self.pg0.remote_ip4)
+            self.assertEqual(p[UDP].sport, 1234)
+            self.assertEqual(p[UDP].dport, sport)
+        self.assertEqual(sorted(p[Raw].load for p in rx),
+                         sorted(p[Raw].load for p in pkts))
+
+        self.vapi.cli("test echo server stop")
+
+
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)
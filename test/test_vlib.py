@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 
+import re
 import unittest
 
 from framework import VppTestCase, VppTestRunner, running_extended_tests
@@ -183,5 +184,30 @@ class TestVlib(VppTestCase):
                 else:
                     self.logger.info(cmd + " FAIL retval " + str(r.retval))
 
+    def test_vlib_log_binary_mode(self):
+        """ Vlib log binary mode """
+
+        binary_msg = "binary log entry 0x1234 42"
+        text_msg = "text log entry 0x5678 43"
+        self.vapi.cli("set logging mode binary")
+        self.vapi.cli("test log notice fib entry " + binary_msg)
+        self.vapi.cli("set logging mode text")
+        self.vapi.cli("test log notice fib entry " + text_msg)
+
+        # Entries logged in binary mode are decoded when shown
+        log = self.vapi.cli("show logging")
+        for msg in (binary_msg, text_msg):
+            self.assertRegex(log, re.compile(r"notice\s+fib/entry\s+%s$" %
+                                             re.escape(msg), re.M))
+
+        # and when dumped
+        dump = {d.message.rstrip("\x00"): d
+                for d in self.vapi.log_dump(start_timestamp=0.0)}
+        for msg in (binary_msg, text_msg):
+            self.assertIn(msg, dump)
+            self.assertEqual(dump[msg].msg_class.rstrip("\x00"),
+                             "fib/entry")
+
+
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)
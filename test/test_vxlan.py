@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 
+import re
 import socket
 from util import ip4n_range, ip4_range, reassemble4
 import unittest
@@ -269,5 +270,38 @@ class TestVxlan(BridgeDomain, VppTestCase):
         self.logger.info(self.vapi.cli("show vxlan tunnel"))
 
 
+class TestVxlanCuckoo(TestVxlan):
+    """ VXLAN Cuckoo Lookup Test Case """
+
+    @classmethod
+    def setUpConstants(cls):
+        # Decap ip4 tunnels using the cuckoo copy of the tunnel table
+        cls.extra_vpp_punt_config = ["vxlan", "{", "cuckoo-lookup", "}"]
+        super(TestVxlanCuckoo, cls).setUpConstants()
+
+    def cuckoo_used_slots(self):
+        out = self.vapi.cli("show vxlan tunnel raw")
+        m = re.search(r"IPv4 Cuckoo Lookup Table:.*?Used slots: (\d+)",
+                      out, re.S)
+        self.assertIsNotNone(m, "no cuckoo lookup table")
+        return int(m.group(1))
+
+    def test_cuckoo_tunnel_add_del(self):
+        """ Cuckoo lookup table follows tunnel adds and deletes
+        """
+        base = self.cuckoo_used_slots()
+        self.assertGreater(base, 0)
+
+        self.vapi.vxlan_add_del_tunnel(src_address=self.pg0.local_ip4n,
+                                       dst_address=self.pg0.remote_ip4n,
+                                       vni=100)
+        self.assertEqual(self.cuckoo_used_slots(), base + 1)
+
+        self.vapi.vxlan_add_del_tunnel(src_address=self.pg0.local_ip4n,
+                                       dst_address=self.pg0.remote_ip4n,
+                                       vni=100, is_add=0)
+        self.assertEqual(self.cuckoo_used_slots(), base)
+
+
 if __name__ == '__main__':
     unittest.main(testRunner=VppTestRunner)